@@ -43,7 +43,7 @@ function(set_optimization_flags target)
         $<$<CONFIG:Release>:
             -O3
             -flto
-            -fomit-frame-pointer
+            ${DMP_RELEASE_FRAME_POINTER_FLAG}
             -funroll-loops
             -ffast-math
             -DNDEBUG
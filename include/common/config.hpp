@@ -17,6 +17,7 @@
 #include <thread>
 #include <functional>
 #include <set>
+#include <vector>
 
 namespace dmp {
 
@@ -103,11 +104,175 @@ struct MonitoringConfig {
     uint16_t prometheus_port = 9090;
     uint32_t metrics_interval_seconds = 1;
     std::string metrics_path = "/metrics";
+    uint32_t render_cache_ms = 1000;  // Minimum interval between exposition re-renders
+    uint32_t latency_window_seconds = 60;  // Rolling window for P50/P95/P99 reports
     
     static Result<MonitoringConfig> from_toml(const toml::table& table);
     bool is_valid() const;
 };
 
+/**
+ * @brief Request tracing configuration
+ */
+struct TracingConfig {
+    bool enabled = true;
+    double sample_rate = 0.01;              // Fraction of requests always traced
+    float slow_request_threshold_ms = 50.0f; // Requests slower than this are always kept
+    uint32_t ring_buffer_spans = 8192;      // Spans retained per thread
+    std::string export_directory = "logs/traces";
+    
+    static Result<TracingConfig> from_toml(const toml::table& table);
+    bool is_valid() const;
+};
+
+/**
+ * @brief Binary per-request performance log configuration
+ */
+struct PerfLogConfig {
+    bool enabled = true;
+    std::string directory = "logs/perf";  // Files are named dmp_perf_<unix_ms>[_<seq>].bin
+    uint32_t max_file_mb = 256;           // Rotate after this many megabytes
+    uint32_t max_files = 8;               // Oldest files beyond this are deleted
+    uint32_t queue_capacity = 65536;      // Records buffered for the writer thread
+    
+    static Result<PerfLogConfig> from_toml(const toml::table& table);
+    bool is_valid() const;
+};
+
+/**
+ * @brief Hardware performance counters sampled around pipeline stages (Linux only)
+ */
+struct HardwareCountersConfig {
+    bool enabled = false;
+    uint32_t sample_every = 64;  // Measure one decision in N per thread
+    
+    static Result<HardwareCountersConfig> from_toml(const toml::table& table);
+    bool is_valid() const;
+};
+
+/**
+ * @brief In-process sampling profiler (Linux only)
+ */
+struct ProfilerConfig {
+    bool enabled = false;                         // Allow starting via POST /debug/profile or SIGUSR2
+    uint32_t frequency_hz = 99;                   // Samples per second of process CPU time
+    uint32_t max_stack_depth = 64;                // Frames kept per sample (at most 128)
+    uint32_t queue_capacity = 4096;               // Samples buffered between handler and drain thread
+    uint32_t max_duration_s = 300;                // Sessions stop and dump after this long
+    std::string output_directory = "logs/profiles";
+    
+    static Result<ProfilerConfig> from_toml(const toml::table& table);
+    bool is_valid() const;
+};
+
+/**
+ * @brief Placement of large long-lived tables and the process memory budget
+ */
+struct MemoryConfig {
+    std::string huge_pages = "transparent";  // off, transparent (madvise) or explicit (MAP_HUGETLB)
+    std::string numa_policy = "local";       // local, interleave, or shard (bind each shard to a node)
+    bool prefault = true;                    // Touch pages at allocation, not on first request
+    uint32_t pool_size_mb = 512;             // Cap on mapped table memory ([performance] memory_pool_size_mb)
+    uint32_t soft_limit_percent = 80;        // Of max_memory_gb: shrink caches, trim the heap
+    uint32_t hard_limit_percent = 95;        // Evict aggregation state, refuse reloads
+    uint32_t check_interval_ms = 1000;       // Memory accountant sampling period
+    
+    static Result<MemoryConfig> from_toml(const toml::table& table);
+    bool is_valid() const;
+};
+
+/**
+ * @brief Startup warm-up run before the service reports ready
+ */
+struct WarmupConfig {
+    bool enabled = true;
+    std::string corpus_path;                 // Recorded requests, one JSON per line; empty = synthetic
+    uint32_t transactions_per_thread = 2000;
+    uint32_t threads = 0;                    // Serving threads to warm; 0 = [server] threads
+    uint32_t timeout_ms = 60000;             // Stop warming after this long
+    bool ready_on_failure = false;           // Report ready even if warm-up failed or timed out
+    
+    static Result<WarmupConfig> from_toml(const toml::table& table);
+    bool is_valid() const;
+};
+
+/**
+ * @brief Configuration artifact watching for the ReloadCoordinator
+ */
+struct ReloadConfig {
+    bool enabled = true;
+    uint32_t check_interval_ms = 2000;  // File modification poll interval
+    uint32_t settle_ms = 500;           // Ignore files modified more recently than this
+    std::string rules_path = "config/rules.json";
+    std::string blacklist_path = "data/blocklist.txt";
+    std::string whitelist_path = "data/whitelist.txt";
+    std::string models_path = "config/models.toml";
+    bool preflight = true;                // Cost-check rules and patterns before publishing
+    uint32_t preflight_corpus_size = 500; // Synthetic transactions per check
+    double rules_budget_ms = 5.0;         // P99 rule evaluation budget per transaction
+    double patterns_budget_ms = 2.0;      // P99 pattern matching budget per transaction
+    
+    static Result<ReloadConfig> from_toml(const toml::table& table);
+    bool is_valid() const;
+};
+
+/**
+ * @brief Single model entry from models.toml
+ */
+struct ModelSpec {
+    std::string key;      // TOML table name (e.g. primary_model)
+    std::string name;
+    std::string path;     // Model file path
+    std::string version;
+    bool enabled = true;
+    float weight = 1.0f;  // Ensemble weight
+};
+
+/**
+ * @brief Model configuration loaded from models.toml
+ *
+ * Every top-level table with a "path" key is a model; [inference]
+ * holds the runtime settings shared by all models.
+ */
+struct ModelsConfig {
+    std::vector<ModelSpec> models;
+    uint32_t batch_size = 32;
+    uint32_t timeout_ms = 100;
+    uint32_t threads = 2;
+    std::string provider = "CPU";
+    
+    /**
+     * @brief Load and validate model configuration from TOML file
+     * @param config_path Path to models.toml
+     * @return Result with config or error details
+     */
+    static Result<ModelsConfig> load_from_file(const std::string& config_path);
+    bool is_valid() const;
+};
+
+/**
+ * @brief Immutable, versioned view of every configuration section
+ *
+ * A new snapshot is published on each (re)load; existing snapshots are
+ * never modified, so readers need no locking while they hold one.
+ */
+struct ConfigSnapshot {
+    uint64_t version = 0;  // 1 for the initial load, +1 per successful reload
+    ServerConfig server;
+    FeatureConfig feature;
+    LoggingConfig logging;
+    MonitoringConfig monitoring;
+    TracingConfig tracing;
+    PerfLogConfig perf_log;
+    HardwareCountersConfig hardware_counters;
+    ProfilerConfig profiler;
+    ReloadConfig reload;
+    MemoryConfig memory;
+    WarmupConfig warmup;
+    
+    bool is_valid() const;
+};
+
 /**
  * @brief Complete system configuration
  * 
@@ -139,7 +304,8 @@ public:
      * @param callback Optional callback for config changes
      * 
      * Monitors configuration file for changes and automatically
-     * reloads when modifications are detected.
+     * reloads when modifications are detected. Prefer ReloadCoordinator,
+     * which reloads this file together with the rules and patterns.
      */
     void enable_hot_reload(uint32_t check_interval_ms = 5000,
                           std::function<void(const SystemConfig&)> callback = nullptr);
@@ -155,30 +321,89 @@ public:
      */
     Result<void> reload();
     
+    /**
+     * @brief Current configuration snapshot
+     * @return Snapshot that stays valid for as long as it is held
+     * 
+     * A reload publishes a new snapshot; the previous one is freed when its
+     * last holder lets go. Per-request readers pin one snapshot and read
+     * all their settings from it.
+     * Performance: one atomic load and reference count increment, no mutex
+     * Thread-safe: Yes
+     */
+    std::shared_ptr<const ConfigSnapshot> snapshot() const;
+    
+    /**
+     * @brief Version of the current snapshot
+     */
+    uint64_t version() const;
+    
     /**
      * @brief Get server configuration (thread-safe)
-     * @return Server configuration copy
+     * @return Copy of the server configuration in the current snapshot
      */
     ServerConfig get_server_config() const;
     
     /**
      * @brief Get feature configuration (thread-safe)
-     * @return Feature configuration copy
+     * @return Copy of the feature configuration in the current snapshot
      */
     FeatureConfig get_feature_config() const;
     
     /**
      * @brief Get logging configuration (thread-safe)
-     * @return Logging configuration copy
+     * @return Copy of the logging configuration in the current snapshot
      */
     LoggingConfig get_logging_config() const;
     
     /**
      * @brief Get monitoring configuration (thread-safe)
-     * @return Monitoring configuration copy
+     * @return Copy of the monitoring configuration in the current snapshot
      */
     MonitoringConfig get_monitoring_config() const;
     
+    /**
+     * @brief Get tracing configuration (thread-safe)
+     * @return Copy of the tracing configuration in the current snapshot
+     */
+    TracingConfig get_tracing_config() const;
+    
+    /**
+     * @brief Get performance log configuration (thread-safe)
+     * @return Copy of the performance log configuration in the current snapshot
+     */
+    PerfLogConfig get_perf_log_config() const;
+    
+    /**
+     * @brief Get hardware counter configuration (thread-safe)
+     * @return Copy of the hardware counter configuration in the current snapshot
+     */
+    HardwareCountersConfig get_hardware_counters_config() const;
+    
+    /**
+     * @brief Get sampling profiler configuration (thread-safe)
+     * @return Copy of the profiler configuration in the current snapshot
+     */
+    ProfilerConfig get_profiler_config() const;
+    
+    /**
+     * @brief Get reload configuration (thread-safe)
+     * @return Copy of the reload configuration in the current snapshot
+     */
+    ReloadConfig get_reload_config() const;
+    
+    /**
+     * @brief Get large table memory configuration (thread-safe)
+     * @return Copy of the memory configuration in the current snapshot
+     */
+    MemoryConfig get_memory_config() const;
+    
+    /**
+     * @brief Get startup warm-up configuration (thread-safe)
+     * @return Copy of the warm-up configuration in the current snapshot
+     */
+    WarmupConfig get_warmup_config() const;
+    
     /**
      * @brief Check if configuration is valid
      * @return true if all sections are valid
@@ -201,12 +426,17 @@ private:
     SystemConfig() = default;
     
     /**
-     * @brief Load and parse TOML configuration
+     * @brief Parse TOML configuration and publish it as a new snapshot
      * @param table Parsed TOML table
-     * @return Result indicating success or failure
+     * @return Result indicating success or failure (nothing is published on failure)
      */
     Result<void> load_from_toml(const toml::table& table);
     
+    /**
+     * @brief Number and publish a snapshot
+     */
+    void publish(std::shared_ptr<ConfigSnapshot> snapshot);
+    
     /**
      * @brief Check if configuration file has been modified
      * @return true if file was modified since last load
@@ -218,12 +448,12 @@ private:
      */
     void hot_reload_worker();
 
-    // Configuration sections
+    // Latest snapshot; publish_mutex_ serializes publishers so versions stay in order
+    std::mutex publish_mutex_;
+    std::atomic<std::shared_ptr<const ConfigSnapshot>> snapshot_{std::make_shared<const ConfigSnapshot>()};
+    
+    // File metadata and hot reload state
     mutable std::shared_mutex config_mutex_;
-    ServerConfig server_config_;
-    FeatureConfig feature_config_;
-    LoggingConfig logging_config_;
-    MonitoringConfig monitoring_config_;
     
     // File monitoring for hot reload
     std::string config_file_path_;
@@ -236,8 +466,7 @@ private:
     
 public:
     // Singleton instance for global access
-    static std::shared_ptr<SystemConfig> instance_;
-    static std::mutex instance_mutex_;
+    static std::atomic<std::shared_ptr<SystemConfig>> instance_;
 };
 
 /**
@@ -249,6 +478,16 @@ public:
  */
 std::shared_ptr<SystemConfig> get_system_config();
 
+/**
+ * @brief Current snapshot of the global configuration
+ * @return Snapshot, or nullptr if no global configuration has been set
+ * 
+ * Intended for per-request reads: pin the result once and read every
+ * setting from it. Replaced instances and snapshots are freed once the
+ * last request holding them finishes.
+ */
+std::shared_ptr<const ConfigSnapshot> current_config();
+
 /**
  * @brief Set global system configuration instance
  * @param config Shared pointer to config instance
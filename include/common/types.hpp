@@ -41,6 +41,42 @@ using FeatureVector = std::vector<float>;
 static constexpr size_t FEATURE_VECTOR_SIZE = 64;
 using FixedFeatureVector = std::array<float, FEATURE_VECTOR_SIZE>;
 
+/**
+ * @brief Decision pipeline stages used for latency accounting
+ *
+ * Shared by metrics, tracing and performance logs so that every consumer
+ * names and orders stages the same way.
+ */
+enum class PipelineStage : uint8_t {
+    PARSE = 0,               // JSON parsing and request validation
+    PATTERN_MATCH = 1,       // Blacklist/whitelist pattern scanning
+    FEATURE_EXTRACTION = 2,  // Feature lookup and computation
+    RULE_EVALUATION = 3,     // Rule engine evaluation
+    MODEL_INFERENCE = 4,     // ML model scoring
+    SERIALIZE = 5,           // Response serialization
+    DECISION = 6,            // End-to-end decision processing
+    HTTP_REQUEST = 7         // Full HTTP request handling
+};
+
+static constexpr size_t PIPELINE_STAGE_COUNT = 8;
+
+/**
+ * @brief Stable lowercase name of a pipeline stage (used as metric label)
+ */
+inline constexpr const char* pipeline_stage_name(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::PARSE: return "parse";
+        case PipelineStage::PATTERN_MATCH: return "pattern_match";
+        case PipelineStage::FEATURE_EXTRACTION: return "feature_extraction";
+        case PipelineStage::RULE_EVALUATION: return "rule_evaluation";
+        case PipelineStage::MODEL_INFERENCE: return "model_inference";
+        case PipelineStage::SERIALIZE: return "serialize";
+        case PipelineStage::DECISION: return "decision";
+        case PipelineStage::HTTP_REQUEST: return "http_request";
+    }
+    return "unknown";
+}
+
 /**
  * @brief Performance metrics structures
  */
@@ -70,6 +106,8 @@ enum class ErrorCode : uint32_t {
     MODEL_INFERENCE_FAILED = 2003,
     CACHE_ERROR = 3001,
     DATABASE_ERROR = 3002,
+    RESOURCE_EXHAUSTED = 4001,
+    DEADLINE_EXCEEDED = 4002,
     INTERNAL_ERROR = 9999
 };
 
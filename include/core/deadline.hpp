@@ -0,0 +1,69 @@
+/**
+ * @file deadline.hpp
+ * @brief Absolute request deadline propagated to downstream calls
+ * @author Stan Jiang
+ * @date 2025-09-18
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace dmp {
+
+/**
+ * @brief Point in time by which a request must be answered
+ *
+ * Set once when the request arrives and handed down unchanged, so every
+ * downstream call sees the time actually left rather than a fixed
+ * per-call timeout: a slow first dependency shrinks the budget of the
+ * ones after it. Calls derive their own deadline with capped() and leave
+ * room for the work that follows them with reserve().
+ */
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Deadline() : at_(Clock::time_point::max()) {}
+    explicit Deadline(Clock::time_point at) : at_(at) {}
+
+    static Deadline after(std::chrono::microseconds budget) { return Deadline(Clock::now() + budget); }
+    static Deadline never() { return Deadline(); }
+
+    Clock::time_point at() const { return at_; }
+    bool is_set() const { return at_ != Clock::time_point::max(); }
+    bool expired() const { return Clock::now() >= at_; }
+
+    /**
+     * @brief Time left, zero once expired (a day for an unset deadline)
+     */
+    std::chrono::microseconds remaining() const {
+        if (!is_set()) {
+            return std::chrono::hours(24);
+        }
+        auto left = std::chrono::duration_cast<std::chrono::microseconds>(at_ - Clock::now());
+        return std::max(left, std::chrono::microseconds::zero());
+    }
+
+    /**
+     * @brief The earlier of this deadline and now + budget
+     */
+    Deadline capped(std::chrono::microseconds budget) const {
+        return Deadline(std::min(at_, Clock::now() + budget));
+    }
+
+    /**
+     * @brief This deadline moved earlier by tail, keeping time for later stages
+     */
+    Deadline reserve(std::chrono::microseconds tail) const {
+        if (!is_set()) {
+            return *this;
+        }
+        return Deadline(at_ - tail);
+    }
+
+private:
+    Clock::time_point at_;
+};
+
+} // namespace dmp
@@ -0,0 +1,54 @@
+/**
+ * @file decision.hpp
+ * @brief Decision pipeline shared by the request handler, warm-up, tools and tests
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "core/reload_coordinator.hpp"
+#include "core/remote_lookup.hpp"
+#include "core/transaction.hpp"
+#include <simdjson.h>
+#include <string>
+
+namespace dmp {
+
+/**
+ * @brief Decide one validated transaction on a pinned generation
+ * @param generation Rules and patterns to evaluate; missing artifacts are skipped
+ * @param request Parsed and validated transaction
+ * @return Response with decision, risk score and triggered rules
+ *
+ * The rule score is mapped through the rule set's thresholds. A blacklist
+ * match declines the transaction unless a whitelist pattern matched too.
+ * A pattern scan that stopped at its time cap turns APPROVE into REVIEW.
+ * latency_ms is left at 0 for the caller to fill in.
+ */
+TransactionResponse decide(const ReloadGeneration& generation, const TransactionRequest& request);
+
+/**
+ * @brief Decide one validated transaction after enriching it
+ * @param generation Rules and patterns to evaluate
+ * @param request Parsed and validated transaction
+ * @param enrichment Values fetched from the request's remote dependencies
+ * @return Response as for decide(generation, request)
+ *
+ * A missing dependency never approves on its own: when any dependency was
+ * degraded, APPROVE becomes REVIEW. DECLINE and REVIEW are kept.
+ */
+TransactionResponse decide(const ReloadGeneration& generation, const TransactionRequest& request,
+                           const EnrichmentResult& enrichment);
+
+/**
+ * @brief Parse, validate and decide one request body
+ * @param generation Rules and patterns to evaluate
+ * @param parser Parser owned by the calling thread, reused across calls
+ * @param body JSON request body
+ * @return Response, or the error the request handler would report
+ */
+Result<TransactionResponse> decide(const ReloadGeneration& generation, simdjson::dom::parser& parser,
+                                   const std::string& body);
+
+} // namespace dmp
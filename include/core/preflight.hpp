@@ -0,0 +1,123 @@
+/**
+ * @file preflight.hpp
+ * @brief Pre-flight validation and cost estimation of candidate rules and patterns
+ * @author Stan Jiang
+ * @date 2025-09-11
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "common/config.hpp"
+#include "engine/rule_engine.hpp"
+#include "engine/pattern_matcher.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dmp {
+
+struct ReloadSources;
+
+/**
+ * @brief Corpus size and latency budgets for a pre-flight check
+ */
+struct PreflightOptions {
+    size_t corpus_size = 2000;          // Synthetic transactions evaluated
+    uint64_t seed = 42;                 // Corpus seed, fixed so runs are comparable
+    double rules_budget_ms = 5.0;       // P99 rule evaluation per transaction
+    double patterns_budget_ms = 2.0;    // P99 pattern matching per transaction
+    size_t max_pattern_profiles = 256;  // Patterns costed individually (0 = none)
+
+    /**
+     * @brief Options used by the ReloadCoordinator for the [reload] section
+     */
+    static PreflightOptions from_config(const ReloadConfig& config);
+};
+
+/**
+ * @brief Estimated evaluation cost of one rule
+ */
+struct RuleCost {
+    std::string id;
+    double mean_us = 0.0;   // Per evaluation
+    double hit_rate = 0.0;  // Percent of corpus transactions that triggered it
+};
+
+/**
+ * @brief Estimated matching cost of one pattern
+ */
+struct PatternCost {
+    uint32_t id = 0;
+    std::string name;
+    std::string category;
+    double mean_us = 0.0;   // Per transaction, all fields
+};
+
+/**
+ * @brief Outcome of a pre-flight check
+ */
+struct PreflightReport {
+    size_t rule_count = 0;
+    size_t pattern_count = 0;
+    size_t model_count = 0;
+    double rules_compile_ms = 0.0;
+    double patterns_compile_ms = 0.0;
+    int64_t memory_delta_kb = 0;       // RSS growth while loading, approximate
+
+    size_t transactions = 0;
+    double rules_mean_us = 0.0;
+    double rules_p99_us = 0.0;
+    double patterns_mean_us = 0.0;
+    double patterns_p99_us = 0.0;
+
+    std::vector<RuleCost> rule_costs;        // Most expensive first
+    std::vector<PatternCost> pattern_costs;  // Most expensive first, profiled subset
+
+    PreflightOptions options;
+    std::vector<std::string> violations;     // Budget breaches; empty when passed
+
+    bool passed() const { return violations.empty(); }
+
+    /**
+     * @brief Human-readable report
+     * @param top_n Number of rules and patterns listed by cost
+     */
+    std::string to_text(size_t top_n = 10) const;
+};
+
+/**
+ * @brief Compiles candidate configuration and estimates its cost on synthetic traffic
+ *
+ * Runs a deterministic TransactionGenerator corpus through the rule engine
+ * and pattern matcher and compares P99 per-transaction cost against the
+ * budgets. Used by dmp_check before a push and by the ReloadCoordinator
+ * before publishing a generation.
+ */
+class PreflightChecker {
+public:
+    explicit PreflightChecker(PreflightOptions options = {});
+
+    /**
+     * @brief Load, compile and check every artifact of a candidate configuration
+     * @param sources Candidate files; an empty system_config_path is skipped
+     * @return Report (possibly with budget violations) or error if any
+     *         artifact fails to load or compile
+     */
+    Result<PreflightReport> check_files(const ReloadSources& sources) const;
+
+    /**
+     * @brief Check already staged artifacts
+     * @param rules Rule engine to evaluate, or nullptr to skip
+     * @param patterns Pattern matcher to evaluate, or nullptr to skip
+     * @return Report with budget violations, if any
+     *
+     * Evaluations are recorded in the artifacts' statistics; pass staged
+     * instances, not the ones serving traffic.
+     */
+    Result<PreflightReport> check(RuleEngine* rules, PatternMatcher* patterns) const;
+
+private:
+    PreflightOptions options_;
+};
+
+} // namespace dmp
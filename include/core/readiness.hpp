@@ -0,0 +1,60 @@
+/**
+ * @file readiness.hpp
+ * @brief Service lifecycle state reported by readiness probes
+ * @author Stan Jiang
+ * @date 2025-09-13
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace dmp {
+
+/**
+ * @brief Service lifecycle, in order
+ */
+enum class ReadinessState : uint8_t {
+    STARTING = 0,    // Loading configuration and artifacts
+    WARMING_UP = 1,  // Running the warm-up corpus
+    READY = 2,       // Taking traffic
+    STOPPING = 3     // Draining before shutdown
+};
+
+const char* readiness_state_name(ReadinessState state);
+
+/**
+ * @brief Process-wide readiness, read by /ready and the health handlers
+ *
+ * Only READY means the instance should receive traffic; load balancers
+ * and Kubernetes see 503 in every other state.
+ */
+class Readiness {
+public:
+    static Readiness& instance();
+
+    void set_state(ReadinessState state) { state_.store(state, std::memory_order_release); }
+    ReadinessState state() const { return state_.load(std::memory_order_acquire); }
+    bool is_ready() const { return state() == ReadinessState::READY; }
+
+    /**
+     * @brief Record warm-up progress across all warm-up threads
+     */
+    void set_warmup_total(uint64_t total) { warmup_total_.store(total, std::memory_order_relaxed); }
+    void add_warmup_done(uint64_t count) { warmup_done_.fetch_add(count, std::memory_order_relaxed); }
+
+    /**
+     * @brief Readiness as JSON: state and warm-up progress
+     */
+    std::string to_json() const;
+
+private:
+    Readiness() = default;
+
+    std::atomic<ReadinessState> state_{ReadinessState::STARTING};
+    std::atomic<uint64_t> warmup_done_{0};
+    std::atomic<uint64_t> warmup_total_{0};
+};
+
+} // namespace dmp
@@ -0,0 +1,213 @@
+/**
+ * @file reload_coordinator.hpp
+ * @brief Coordinated hot reload of rules, patterns, models and system configuration
+ * @author Stan Jiang
+ * @date 2025-09-10
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "common/config.hpp"
+#include "engine/rule_engine.hpp"
+#include "engine/pattern_matcher.hpp"
+#include "core/preflight.hpp"
+#include <optional>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace dmp {
+
+/**
+ * @brief One consistent set of every reloadable artifact
+ *
+ * Generations are immutable once published. A request that pins a
+ * generation sees rules, patterns, models and system configuration that
+ * were validated together, even if a reload completes mid-request.
+ */
+struct ReloadGeneration {
+    uint64_t id = 0;  // 1 for the initial load, +1 per published reload
+    std::chrono::system_clock::time_point published_at;
+    std::shared_ptr<SystemConfig> system_config;
+    std::shared_ptr<RuleEngine> rule_engine;
+    std::shared_ptr<PatternMatcher> pattern_matcher;
+    std::shared_ptr<const ModelsConfig> models;
+};
+
+/**
+ * @brief Files watched by the ReloadCoordinator
+ */
+struct ReloadSources {
+    std::string system_config_path;
+    std::string rules_path;
+    std::string blacklist_path;
+    std::string whitelist_path;
+    std::string models_path;
+
+    /**
+     * @brief Build sources from the [reload] configuration section
+     * @param system_config_path Path of the server TOML file itself
+     * @param config Reload configuration
+     */
+    static ReloadSources from_config(const std::string& system_config_path,
+                                     const ReloadConfig& config);
+};
+
+/**
+ * @brief Watches every configuration artifact and publishes them as one generation
+ *
+ * A single polling thread replaces the per-component hot reload threads.
+ * When files change, only the changed artifacts are staged (in parallel,
+ * off the request path), each is validated, and the new generation is
+ * published atomically only if all of them succeed; unchanged artifacts
+ * are shared with the previous generation. A failed reload keeps the
+ * current generation and is not retried until a file changes again.
+ *
+ * Artifact paths are re-derived from the [reload] section of each newly
+ * staged system configuration: a path whose setting changed since the
+ * previous generation is watched and staged from its new location. Paths
+ * whose setting did not change keep the value given to the constructor.
+ */
+class ReloadCoordinator {
+public:
+    /**
+     * @brief Called on the reload thread after a generation is published
+     */
+    using PublishCallback = std::function<void(const ReloadGeneration&)>;
+
+    /**
+     * @brief Constructor
+     * @param sources Files to watch
+     * @param settle_ms Defer reloading while any changed file is younger than this
+     */
+    explicit ReloadCoordinator(ReloadSources sources, uint32_t settle_ms = 500);
+
+    /**
+     * @brief Destructor - stops the polling thread
+     */
+    ~ReloadCoordinator();
+
+    ReloadCoordinator(const ReloadCoordinator&) = delete;
+    ReloadCoordinator& operator=(const ReloadCoordinator&) = delete;
+
+    /**
+     * @brief Load every artifact and publish generation 1
+     * @return Result indicating success or the first artifact that failed
+     */
+    Result<void> load_initial();
+
+    /**
+     * @brief Check files now and publish a new generation if any changed
+     * @param force Restage every artifact regardless of modification times
+     * @return true if a generation was published, false if nothing changed,
+     *         or error if staging or validation failed
+     */
+    Result<bool> reload_now(bool force = false);
+
+    /**
+     * @brief Start the polling thread
+     * @param check_interval_ms Interval between file modification checks
+     */
+    void start(uint32_t check_interval_ms);
+
+    /**
+     * @brief Stop the polling thread
+     */
+    void stop();
+
+    /**
+     * @brief Set callback invoked after each publish
+     */
+    void on_publish(PublishCallback callback);
+
+    /**
+     * @brief Current generation
+     * @return Generation that stays valid for as long as it is held
+     *
+     * Performance: one atomic load and a reference count increment
+     * Thread-safe: Yes
+     */
+    std::shared_ptr<const ReloadGeneration> current() const;
+
+    uint64_t generation_id() const { return generation_id_.load(std::memory_order_relaxed); }
+    uint64_t failures() const { return failures_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Require restaged rules and patterns to pass a pre-flight check
+     * @param options Corpus size and latency budgets
+     *
+     * A candidate generation whose P99 rule or pattern cost exceeds its
+     * budget is rejected like one that fails to compile.
+     */
+    void enable_preflight(const PreflightOptions& options);
+
+    /**
+     * @brief Load and validate a rule engine off the request path
+     * @param path rules.json path
+     * @return New engine or error if loading or compilation failed
+     */
+    static Result<std::shared_ptr<RuleEngine>> stage_rules(const std::string& path);
+
+    /**
+     * @brief Load and compile a pattern matcher off the request path
+     * @return New matcher or error if loading or compilation failed
+     */
+    static Result<std::shared_ptr<PatternMatcher>> stage_patterns(const std::string& blacklist_path,
+                                                                  const std::string& whitelist_path);
+
+    /**
+     * @brief Load and validate model configuration
+     * @return Immutable config or error
+     */
+    static Result<std::shared_ptr<const ModelsConfig>> stage_models(const std::string& path);
+
+private:
+    enum Artifact : size_t { SYSTEM_CONFIG, RULES, BLACKLIST, WHITELIST, MODELS, ARTIFACT_COUNT };
+
+    using FileTimes = std::array<std::filesystem::file_time_type, ARTIFACT_COUNT>;
+
+    /**
+     * @brief Stage the changed artifacts and publish them with the rest of current
+     * @param changed Artifacts to rebuild
+     * @param times Modification times the staged files were read at
+     */
+    Result<void> stage_and_publish(std::array<bool, ARTIFACT_COUNT> changed, FileTimes times);
+
+    static std::array<std::string, ARTIFACT_COUNT> to_paths(ReloadSources sources);
+    void publish(std::shared_ptr<ReloadGeneration> generation);
+    FileTimes read_file_times() const;
+    void run();
+
+    const std::chrono::milliseconds settle_;
+
+    // Published generation
+    std::atomic<std::shared_ptr<const ReloadGeneration>> generation_{std::make_shared<const ReloadGeneration>()};
+    std::atomic<uint64_t> generation_id_{0};
+
+    // Reload state, touched only while holding reload_mutex_
+    std::mutex reload_mutex_;
+    std::array<std::string, ARTIFACT_COUNT> paths_;
+    FileTimes published_times_{};
+    FileTimes failed_times_{};
+    bool has_failed_times_ = false;
+    PublishCallback publish_callback_;
+    std::optional<PreflightOptions> preflight_;
+    uint64_t last_staging_bytes_ = 0;   // Resident growth of the previous staging pass
+    std::atomic<uint64_t> failures_{0};
+
+    // Polling thread
+    std::thread worker_;
+    std::mutex worker_mutex_;
+    std::condition_variable worker_cv_;
+    bool stop_requested_ = false;
+    uint32_t check_interval_ms_ = 2000;
+};
+
+} // namespace dmp
@@ -0,0 +1,164 @@
+/**
+ * @file remote_lookup.hpp
+ * @brief Deadline-bounded lookups against remote dependencies (L3 cache, model server, intel feeds)
+ * @author Stan Jiang
+ * @date 2025-09-18
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "core/deadline.hpp"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief Value returned by a remote lookup
+ */
+struct LookupValue {
+    bool found = false;
+    std::string value;
+};
+
+/**
+ * @brief A remote key -> value dependency
+ *
+ * Implementations must return by the deadline: DEADLINE_EXCEEDED when the
+ * remote side is too slow, another error code when it fails. They are
+ * called concurrently from request threads.
+ */
+class RemoteLookup {
+public:
+    virtual ~RemoteLookup() = default;
+
+    /**
+     * @brief Look up one key
+     * @param key Key to fetch
+     * @param deadline Absolute time by which to give up
+     * @return Value (found or not) or error
+     */
+    virtual Result<LookupValue> lookup(const std::string& key, const Deadline& deadline) = 0;
+};
+
+/**
+ * @brief GET over the Redis protocol (RESP2), the L3 feature cache client
+ *
+ * Connections are pooled. Connecting, sending and reading are all bounded
+ * by the deadline; a connection that timed out or saw a protocol error is
+ * closed rather than reused, so a late reply can never be read as the
+ * answer to the next request. A pooled connection the server closed while
+ * idle (timeout, restart) is retried once on a fresh connection.
+ *
+ * The host is resolved in the constructor, not per connection, so a new
+ * connection never waits on DNS. If resolution fails there, lookups fail
+ * fast while a background thread retries at most once per
+ * kResolveRetryInterval.
+ */
+class RespLookup : public RemoteLookup {
+public:
+    static constexpr std::chrono::seconds kResolveRetryInterval{1};
+
+    /**
+     * @brief Constructor
+     * @param host Server host name or address
+     * @param port Server port
+     * @param max_idle_connections Connections kept open between lookups
+     */
+    RespLookup(std::string host, uint16_t port, size_t max_idle_connections = 8);
+    ~RespLookup() override;
+
+    RespLookup(const RespLookup&) = delete;
+    RespLookup& operator=(const RespLookup&) = delete;
+
+    Result<LookupValue> lookup(const std::string& key, const Deadline& deadline) override;
+
+private:
+    struct Endpoint {
+        sockaddr_storage address{};
+        socklen_t length = 0;
+        int family = 0;
+        int protocol = 0;
+    };
+
+    struct Connection {
+        int fd = -1;
+        bool reused = false;  // Taken from the idle pool
+    };
+
+    Result<void> resolve();
+    Result<std::vector<Endpoint>> endpoints();
+    Result<Connection> acquire(const Deadline& deadline, bool fresh);
+    void release(int fd);
+
+    std::string host_;
+    uint16_t port_;
+    size_t max_idle_connections_;
+    std::mutex idle_mutex_;
+    std::vector<int> idle_;
+
+    std::mutex resolve_mutex_;
+    std::vector<Endpoint> endpoints_;
+    std::chrono::steady_clock::time_point last_resolve_{};
+    bool resolving_ = false;  // A background resolve is in flight
+    std::thread resolver_;
+};
+
+/**
+ * @brief A named dependency with its own per-call timeout
+ */
+struct RemoteDependency {
+    std::string name;
+    std::shared_ptr<RemoteLookup> lookup;
+    std::chrono::microseconds timeout{10000};  // Upper bound per call; the request deadline may cut it shorter
+};
+
+/**
+ * @brief Values gathered for one request
+ */
+struct EnrichmentResult {
+    std::vector<LookupValue> values;    // One per dependency; not found when degraded
+    std::vector<std::string> degraded;  // Dependencies that timed out, failed or were skipped
+
+    bool is_degraded() const { return !degraded.empty(); }
+};
+
+/**
+ * @brief Queries a request's remote dependencies within its deadline
+ *
+ * Dependencies are called in order, each bounded by the earlier of its own
+ * timeout and the request deadline minus the reserve kept for the stages
+ * after enrichment. One that fails, times out, or has no budget left is
+ * recorded as degraded and the decision proceeds without its value, so a
+ * slow dependency costs at most the deadline instead of a stalled request.
+ */
+class DependencySet {
+public:
+    /**
+     * @brief Constructor
+     * @param dependencies Dependencies in call order
+     * @param reserve Time kept back from the request deadline for rules, models and the response
+     */
+    explicit DependencySet(std::vector<RemoteDependency> dependencies,
+                           std::chrono::microseconds reserve = std::chrono::milliseconds(5));
+
+    /**
+     * @brief Look up one key per dependency
+     * @param keys Keys in dependency order
+     * @param deadline Request deadline
+     */
+    EnrichmentResult fetch(const std::vector<std::string>& keys, const Deadline& deadline) const;
+
+    size_t size() const { return dependencies_.size(); }
+
+private:
+    std::vector<RemoteDependency> dependencies_;
+    std::chrono::microseconds reserve_;
+};
+
+} // namespace dmp
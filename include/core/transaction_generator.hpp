@@ -0,0 +1,77 @@
+/**
+ * @file transaction_generator.hpp
+ * @brief Deterministic synthetic transaction source for validation and load testing
+ * @author Stan Jiang
+ * @date 2025-09-11
+ */
+#pragma once
+
+#include "core/transaction.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief Shape of the generated transaction mix
+ */
+struct TransactionGeneratorOptions {
+    uint64_t seed = 42;               // Same seed, same sequence
+    uint32_t merchant_count = 500;
+    uint32_t customer_count = 10000;
+    double blacklist_ratio = 0.02;    // Fraction using blocklisted merchants or IP ranges
+    double high_amount_ratio = 0.01;  // Fraction with amounts above 10,000
+    double repeat_customer_ratio = 0.0;  // Fraction drawn from the hot returning-customer set
+    uint32_t hot_customer_count = 200;
+    double attack_burst_ratio = 0.0;  // Per-transaction chance that a card-testing burst starts
+    uint32_t attack_burst_length = 25;  // Transactions in one burst
+};
+
+/**
+ * @brief Generates realistic-looking TransactionRequests
+ *
+ * Amounts are log-normal, merchants and customers are drawn from fixed
+ * populations, and a configurable share of requests hits the sample
+ * blocklist, so rules and patterns see both matching and clean traffic.
+ * Optionally a share of traffic comes from a small set of returning
+ * customers, and card-testing bursts (one card, many small e-commerce
+ * amounts on fresh devices) are interleaved. Both are off by default so
+ * existing seeds keep producing the same sequence.
+ * Not thread-safe; use one generator per thread.
+ */
+class TransactionGenerator {
+public:
+    explicit TransactionGenerator(TransactionGeneratorOptions options = {});
+
+    /**
+     * @brief Produce the next transaction in the sequence
+     */
+    TransactionRequest next();
+
+    /**
+     * @brief Produce a batch of transactions
+     * @param count Number of transactions
+     */
+    std::vector<TransactionRequest> generate(size_t count);
+
+private:
+    template<size_t N>
+    const char* pick(const char* const (&values)[N]) {
+        return values[std::uniform_int_distribution<size_t>(0, N - 1)(rng_)];
+    }
+
+    bool chance(double probability) {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < probability;
+    }
+
+    void apply_attack_burst(TransactionRequest& request);
+
+    TransactionGeneratorOptions options_;
+    std::mt19937_64 rng_;
+    uint64_t sequence_ = 0;
+    uint32_t burst_remaining_ = 0;
+    uint64_t burst_card_ = 0;
+};
+
+} // namespace dmp
@@ -0,0 +1,95 @@
+/**
+ * @file warmup.hpp
+ * @brief Startup warm-up that primes per-thread caches before the service reports ready
+ * @author Stan Jiang
+ * @date 2025-09-13
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "common/config.hpp"
+#include "core/reload_coordinator.hpp"
+#include "core/transaction.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief Outcome of a warm-up run
+ */
+struct WarmupReport {
+    size_t threads = 0;
+    uint64_t transactions = 0;
+    uint64_t errors = 0;             // Corpus entries that failed to parse or validate
+    double elapsed_ms = 0.0;
+    double first_mean_us = 0.0;      // Mean per transaction over the first 10% of each thread
+    double last_mean_us = 0.0;       // Mean per transaction over the last 10% of each thread
+    bool timed_out = false;
+};
+
+/**
+ * @brief Runs a corpus through the decision path so the first real requests are warm
+ *
+ * Each transaction is serialized, parsed with simdjson, evaluated by the
+ * rule engine and pattern matcher, and its response serialized, which
+ * compiles the thread's ExprTk expressions, exercises the pattern
+ * database and scratch, grows the thread's allocator arena and trains
+ * the branch predictors. Compiled rules, parser buffers and arenas are
+ * per thread, so the warm-up has to run on the threads that will serve
+ * traffic: run() hands one task per thread to a dispatcher owned by
+ * whoever owns those threads, and request workers that start later call
+ * warm_thread() themselves. Warm-up traffic is removed from rule and
+ * pattern statistics afterwards.
+ */
+class WarmupRunner {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /**
+     * @brief Runs task(i) once on each of the first `threads` serving threads
+     *
+     * Must return only after every task has finished.
+     */
+    using Dispatch = std::function<void(size_t threads, const std::function<void(size_t)>& task)>;
+
+    explicit WarmupRunner(WarmupConfig config);
+
+    /**
+     * @brief Load the recorded corpus, if configured
+     * @return Number of recorded requests (0 for a synthetic corpus) or error
+     */
+    Result<size_t> load_corpus();
+
+    /**
+     * @brief Warm the calling thread
+     * @param generation Artifacts that will serve traffic
+     * @param thread_index Selects the corpus slice and synthetic seed
+     * @param deadline Stop early after this point
+     */
+    WarmupReport warm_thread(const ReloadGeneration& generation, size_t thread_index,
+                             Clock::time_point deadline) const;
+
+    /**
+     * @brief Warm the serving threads
+     * @param generation Artifacts that will serve traffic
+     * @param threads Number of serving threads
+     * @param dispatch Runs warm_thread() on each of them
+     * @return Merged report; readiness progress is updated as threads advance
+     */
+    Result<WarmupReport> run(const ReloadGeneration& generation, size_t threads,
+                             const Dispatch& dispatch) const;
+    
+    /**
+     * @brief Dispatcher for a process whose requests run on the calling thread
+     */
+    static Dispatch on_calling_thread();
+
+private:
+    WarmupConfig config_;
+    std::vector<TransactionRequest> corpus_;  // Recorded requests; empty = synthetic
+};
+
+} // namespace dmp
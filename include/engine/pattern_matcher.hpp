@@ -9,6 +9,7 @@
 #include "common/types.hpp"
 #include "core/transaction.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <unordered_set>
@@ -75,8 +76,10 @@ struct PatternMatchResults {
     double evaluation_time_us;                // Total evaluation time
     size_t patterns_checked;                  // Number of patterns evaluated
     size_t texts_processed;                   // Number of input texts processed
+    size_t texts_over_budget;                 // Texts whose scan stopped at the time cap
     
-    PatternMatchResults() : evaluation_time_us(0.0), patterns_checked(0), texts_processed(0) {}
+    PatternMatchResults()
+        : evaluation_time_us(0.0), patterns_checked(0), texts_processed(0), texts_over_budget(0) {}
     
     /**
      * @brief Check if any blacklist patterns matched
@@ -122,6 +125,27 @@ struct PatternMatchResults {
     }
 };
 
+/**
+ * @brief Bounds on the work a single text scan may do
+ *
+ * Inputs are attacker-controlled, so a scan must not be able to take
+ * arbitrarily long. Texts longer than max_text_bytes are scanned up to
+ * that length only; the std::regex backend additionally stops evaluating
+ * further patterns once a text has used max_scan_us, counting the text in
+ * PatternMatchResults::texts_over_budget. Hyperscan scans in linear time
+ * and only applies the length limit.
+ *
+ * The time cap is checked between patterns: it cannot interrupt a single
+ * std::regex_search, so one pathological pattern still runs to completion
+ * (bounded only by max_text_bytes and the pre-flight check). A scan that
+ * stops early has skipped patterns, blacklist ones included; callers must
+ * not approve on such a result (decide() forces REVIEW).
+ */
+struct PatternScanLimits {
+    size_t max_text_bytes = 512;    // The request parser's field limit; nothing longer reaches a scan
+    uint32_t max_scan_us = 5000;    // Per text; 0 = unlimited
+};
+
 /**
  * @brief Pattern matching engine with multiple backend support
  * 
@@ -221,6 +245,19 @@ public:
     PatternMatchResults match_batch(const std::vector<std::string>& texts,
                                    const std::string& category = "");
     
+    /**
+     * @brief Set per-text scan limits
+     * @param limits Length and time caps applied to every scanned text
+     *
+     * Not synchronized with matching: call before the matcher is shared.
+     */
+    void set_scan_limits(const PatternScanLimits& limits);
+    
+    /**
+     * @brief Get per-text scan limits
+     */
+    PatternScanLimits get_scan_limits() const;
+    
     /**
      * @brief Get information about loaded patterns
      * @return Vector of all loaded pattern definitions
@@ -244,6 +281,11 @@ public:
      */
     void reset_statistics();
     
+    /**
+     * @brief Texts whose scan stopped at the time cap, across all matchers since start
+     */
+    static uint64_t scans_over_budget();
+    
     /**
      * @brief Check if pattern matcher is properly initialized
      * @return true if loaded and compiled for matching
@@ -291,10 +333,24 @@ Result<std::vector<Pattern>> parse_pattern_file(const std::string& file_path,
  * @return Equivalent regex pattern
  * 
  * Converts simple wildcard patterns (e.g., "MERCH_*") to
- * equivalent regex patterns for matching engines.
+ * equivalent regex patterns for matching engines. Runs of '*'
+ * collapse into a single ".*".
  */
 std::string wildcard_to_regex(const std::string& wildcard_pattern);
 
+/**
+ * @brief Match a wildcard pattern against a whole text without backtracking
+ * @param wildcard_pattern Pattern with * and ? wildcards
+ * @param text Input text
+ * @param case_sensitive Whether letters must match exactly
+ * @return true if the regex from wildcard_to_regex would match text
+ *
+ * O(pattern x text) in the worst case, where std::regex on the
+ * converted pattern backtracks O(text^stars). Like the ECMAScript '.',
+ * wildcards do not match '\n' or '\r'.
+ */
+bool wildcard_match(std::string_view wildcard_pattern, std::string_view text, bool case_sensitive = true);
+
 /**
  * @brief Convert CIDR notation to regex pattern
  * @param cidr_pattern CIDR pattern (e.g., "192.168.1.0/24")
@@ -229,6 +229,15 @@ public:
      */
     Result<void> load_rules(const std::string& config_path);
     
+    /**
+     * @brief Check that every enabled rule compiles and thresholds are ordered
+     * @return Result indicating success or the first failing rule
+     * 
+     * Compiles into a scratch symbol table without touching the per-thread
+     * caches; used to validate a staged engine before it is published.
+     */
+    Result<void> validate() const;
+    
     /**
      * @brief Enable hot reloading of rule configuration
      * @param check_interval_ms Interval between file checks in milliseconds
@@ -237,6 +246,8 @@ public:
      * 
      * Starts a background thread that monitors the configuration file
      * for changes and automatically reloads rules when detected.
+     * Prefer ReloadCoordinator, which swaps rules together with the
+     * pattern database and system configuration.
      */
     Result<void> enable_hot_reload(uint32_t check_interval_ms = 5000, 
                                   HotReloadCallback callback = nullptr);
@@ -263,6 +274,12 @@ public:
      */
     RuleConfig get_current_config() const;
     
+    /**
+     * @brief Get decision thresholds of the current rule set
+     * @return Thresholds, without copying the rules
+     */
+    RuleThresholds get_thresholds() const;
+    
     /**
      * @brief Get aggregated rule statistics
      * @return Map of rule ID to hit count, evaluation count, etc.
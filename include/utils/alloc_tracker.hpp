@@ -0,0 +1,82 @@
+/**
+ * @file alloc_tracker.hpp
+ * @brief Opt-in heap allocation accounting through global operator new/delete hooks
+ * @author Stan Jiang
+ * @date 2025-09-14
+ */
+#pragma once
+
+#include <cstdint>
+
+#ifndef DMP_ENABLE_ALLOC_TRACKING
+#define DMP_ENABLE_ALLOC_TRACKING 0
+#endif
+
+namespace dmp {
+
+/**
+ * @brief Heap operations counted by the tracker
+ */
+struct AllocationStats {
+    uint64_t allocations = 0;    // operator new calls
+    uint64_t deallocations = 0;  // operator delete calls (null excluded)
+    uint64_t bytes = 0;          // Bytes requested from operator new
+
+    AllocationStats operator-(const AllocationStats& earlier) const {
+        return {allocations - earlier.allocations, deallocations - earlier.deallocations,
+                bytes - earlier.bytes};
+    }
+};
+
+/**
+ * @brief Process-wide allocation counters
+ *
+ * Built with -DDMP_ENABLE_ALLOC_TRACKING=ON, dmp_core replaces the global
+ * operator new/delete with versions that bump per-thread counters before
+ * forwarding to malloc/free. Each thread writes only its own counter slot
+ * (no locked instructions on the allocation path); totals are summed on
+ * read. Without the option nothing is replaced and every call returns
+ * zeros.
+ */
+class AllocationTracker {
+public:
+    /**
+     * @brief Whether the hooks are compiled in
+     */
+    static constexpr bool enabled() { return DMP_ENABLE_ALLOC_TRACKING != 0; }
+
+    /**
+     * @brief Cumulative counters of the calling thread
+     */
+    static AllocationStats thread_stats();
+
+    /**
+     * @brief Cumulative counters of all threads, including exited ones
+     */
+    static AllocationStats process_stats();
+};
+
+/**
+ * @brief Scoped probe measuring the calling thread's heap activity
+ *
+ * Usage:
+ *   AllocationProbe probe;
+ *   engine.evaluate_rules(request);
+ *   EXPECT_LE(probe.delta().allocations, kRuleBudget);
+ */
+class AllocationProbe {
+public:
+    AllocationProbe() : start_(AllocationTracker::thread_stats()) {}
+
+    /**
+     * @brief Activity since construction (or the last reset)
+     */
+    AllocationStats delta() const { return AllocationTracker::thread_stats() - start_; }
+
+    void reset() { start_ = AllocationTracker::thread_stats(); }
+
+private:
+    AllocationStats start_;
+};
+
+} // namespace dmp
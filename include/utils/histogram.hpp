@@ -0,0 +1,200 @@
+/**
+ * @file histogram.hpp
+ * @brief HDR-style log-linear latency histograms for DMP metrics
+ * @author Stan Jiang
+ * @date 2025-09-02
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief Bucket layout shared by all latency histograms
+ *
+ * Values (nanoseconds) below kSubBucketCount get one bucket each; above that
+ * every power of two is split into kSubBucketCount / 2 linear buckets, which
+ * bounds the relative error to ~1.6% while covering 1ns .. ~18 minutes in
+ * about a thousand buckets. Larger values are clamped into the last bucket.
+ */
+struct HistogramLayout {
+    static constexpr uint32_t kSubBucketBits = 6;
+    static constexpr uint64_t kSubBucketCount = 1ULL << kSubBucketBits;      // 64
+    static constexpr uint64_t kSubBucketHalf = kSubBucketCount / 2;         // 32
+    static constexpr uint32_t kMaxValueBits = 40;                           // ~1099s in ns
+    static constexpr uint64_t kMaxTrackableValue = (1ULL << kMaxValueBits) - 1;
+    static constexpr size_t kBucketCount =
+        kSubBucketCount + (kMaxValueBits - kSubBucketBits) * kSubBucketHalf;
+
+    /**
+     * @brief Map a value to its bucket index
+     * @param value Value in nanoseconds
+     * @return Bucket index in [0, kBucketCount)
+     */
+    static size_t bucket_index(uint64_t value) {
+        if (value > kMaxTrackableValue) {
+            value = kMaxTrackableValue;
+        }
+        if (value < kSubBucketCount) {
+            return static_cast<size_t>(value);
+        }
+        const uint32_t msb = 63u - static_cast<uint32_t>(__builtin_clzll(value));
+        const uint32_t shift = msb - (kSubBucketBits - 1);
+        return static_cast<size_t>(kSubBucketCount + (shift - 1) * kSubBucketHalf +
+                                   ((value >> shift) - kSubBucketHalf));
+    }
+
+    /**
+     * @brief Lowest value that maps to a bucket
+     */
+    static uint64_t bucket_lower_bound(size_t index) {
+        if (index < kSubBucketCount) {
+            return index;
+        }
+        const uint64_t offset = index - kSubBucketCount;
+        const uint32_t shift = static_cast<uint32_t>(offset / kSubBucketHalf) + 1;
+        return ((offset % kSubBucketHalf) + kSubBucketHalf) << shift;
+    }
+
+    /**
+     * @brief Highest value that maps to a bucket
+     */
+    static uint64_t bucket_upper_bound(size_t index) {
+        if (index < kSubBucketCount) {
+            return index;
+        }
+        const uint32_t shift = static_cast<uint32_t>((index - kSubBucketCount) / kSubBucketHalf) + 1;
+        return bucket_lower_bound(index) + (1ULL << shift) - 1;
+    }
+};
+
+/**
+ * @brief Plain (non-atomic) histogram used for merging, windows and reporting
+ *
+ * Produced from LatencyHistogram shards on scrape. Cheap to merge and
+ * subtract, which is what rolling windows and regression tools need.
+ */
+class HistogramSnapshot {
+public:
+    HistogramSnapshot() : buckets_(HistogramLayout::kBucketCount, 0) {}
+
+    /**
+     * @brief Record a value directly (single-threaded use only)
+     * @param value_ns Value in nanoseconds
+     * @param count Number of occurrences
+     */
+    void record(uint64_t value_ns, uint64_t count = 1);
+
+    /**
+     * @brief Add all observations of another snapshot
+     */
+    void merge(const HistogramSnapshot& other);
+
+    /**
+     * @brief Remove observations of an older cumulative snapshot
+     *
+     * Turns two cumulative snapshots into the delta between them. Min/max
+     * cannot be subtracted and are recomputed from the remaining buckets.
+     */
+    void subtract(const HistogramSnapshot& older);
+
+    /**
+     * @brief Value at a quantile
+     * @param quantile Quantile in [0.0, 1.0]
+     * @return Representative value in nanoseconds (0 if empty)
+     */
+    uint64_t value_at_quantile(double quantile) const;
+
+    uint64_t count() const { return count_; }
+    uint64_t sum() const { return sum_; }
+    uint64_t min() const { return count_ > 0 ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ > 0 ? static_cast<double>(sum_) / count_ : 0.0; }
+    bool empty() const { return count_ == 0; }
+
+    /**
+     * @brief Number of observations known to be <= value (cumulative buckets)
+     *
+     * Counts only buckets whose upper bound is <= value, so the result never
+     * includes a larger observation; it may miss values that share a bucket
+     * with the bound (at most ~1.6% of the bound away from it).
+     */
+    uint64_t count_at_or_below(uint64_t value_ns) const;
+
+    /**
+     * @brief Reset to empty
+     */
+    void reset();
+
+    const std::vector<uint64_t>& buckets() const { return buckets_; }
+
+private:
+    friend class LatencyHistogram;
+
+    void recompute_bounds();
+
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+/**
+ * @brief Single-writer concurrent-reader latency histogram
+ *
+ * Lives inside a per-thread metrics shard: only the owning thread records,
+ * scrapers read concurrently. Updates are relaxed load+store pairs rather
+ * than read-modify-write instructions, so recording never issues a locked
+ * instruction or contends on a cache line with another worker.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one observation (owning thread only)
+     * @param value_ns Value in nanoseconds
+     *
+     * Performance: a handful of instructions, no locks, no allocation
+     */
+    void record(uint64_t value_ns) {
+        bump(buckets_[HistogramLayout::bucket_index(value_ns)], 1);
+        bump(count_, 1);
+        bump(sum_, value_ns);
+        if (value_ns > max_.load(std::memory_order_relaxed)) {
+            max_.store(value_ns, std::memory_order_relaxed);
+        }
+        if (value_ns < min_.load(std::memory_order_relaxed)) {
+            min_.store(value_ns, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Add this histogram's contents to a snapshot (any thread)
+     */
+    void accumulate_into(HistogramSnapshot& snapshot) const;
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+    static void bump(std::atomic<uint64_t>& cell, uint64_t delta) {
+        cell.store(cell.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, HistogramLayout::kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace dmp
@@ -0,0 +1,217 @@
+/**
+ * @file hw_counters.hpp
+ * @brief Per-thread hardware performance counters (perf_event_open) around pipeline stages
+ * @author Stan Jiang
+ * @date 2025-09-15
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace dmp {
+
+struct HardwareCountersConfig;
+
+/**
+ * @brief Hardware events counted per thread
+ */
+enum class HwEvent : uint8_t {
+    CYCLES = 0,     // CPU cycles (user space)
+    INSTRUCTIONS,   // Retired instructions
+    LLC_MISSES,     // Last-level cache misses
+    BRANCH_MISSES,  // Mispredicted branches
+    kCount
+};
+
+static constexpr size_t HW_EVENT_COUNT = static_cast<size_t>(HwEvent::kCount);
+
+/**
+ * @brief Stable lowercase name of a hardware event (used as metric label)
+ */
+inline constexpr const char* hw_event_name(HwEvent event) {
+    switch (event) {
+        case HwEvent::CYCLES: return "cycles";
+        case HwEvent::INSTRUCTIONS: return "instructions";
+        case HwEvent::LLC_MISSES: return "llc_misses";
+        case HwEvent::BRANCH_MISSES: return "branch_misses";
+        case HwEvent::kCount: break;
+    }
+    return "unknown";
+}
+
+/**
+ * @brief One reading (or difference of readings) of every event
+ *
+ * Events the CPU or kernel does not provide stay zero; see
+ * HwCounters::available_events().
+ */
+struct HwCounterValues {
+    std::array<uint64_t, HW_EVENT_COUNT> values{};
+
+    uint64_t operator[](HwEvent event) const { return values[static_cast<size_t>(event)]; }
+
+    HwCounterValues operator-(const HwCounterValues& earlier) const {
+        HwCounterValues delta;
+        for (size_t i = 0; i < HW_EVENT_COUNT; ++i) {
+            delta.values[i] = values[i] - earlier.values[i];
+        }
+        return delta;
+    }
+};
+
+/**
+ * @brief Process-wide access to per-thread hardware counters
+ *
+ * Each thread lazily opens one perf_event_open group (cycles leading,
+ * user space only) counting itself on whatever CPU it runs on; a single
+ * read() returns all events of the group consistently. Reads cost a
+ * system call, so decisions are measured one in sample_every per thread
+ * and stages outside a sampled request cost one thread-local check.
+ *
+ * Linux only. Needs kernel.perf_event_paranoid <= 2 (or CAP_PERFMON) and
+ * a PMU exposed to the guest when virtualized; otherwise reads fail and
+ * a warning is logged once. Disabled by default.
+ */
+class HwCounters {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static HwCounters& instance();
+
+    /**
+     * @brief Apply configuration ([hardware_counters] in server.toml)
+     */
+    void configure(const HardwareCountersConfig& config);
+
+    /**
+     * @brief Whether decisions are being sampled
+     */
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether this build can use perf_event_open at all
+     */
+    static constexpr bool supported() {
+#if defined(__linux__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Read the calling thread's counters, opening them on first use
+     * @param out Receives cumulative event counts
+     * @return false if counters are unavailable on this thread
+     *
+     * Works whether or not sampling is enabled (used by the benchmarks).
+     */
+    bool read(HwCounterValues& out);
+
+    /**
+     * @brief Bitmask (1 << HwEvent) of events opened successfully on any thread
+     */
+    uint32_t available_events() const { return available_events_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Decide whether the request starting on this thread is measured
+     * @return true if stage spans should read counters until end_request()
+     */
+    bool begin_request();
+
+    /**
+     * @brief End the request started by begin_request()
+     */
+    void end_request();
+
+    /**
+     * @brief Whether the calling thread is inside a sampled request
+     */
+    bool request_sampled() const;
+
+    /**
+     * @brief Read counters and record the delta since start for a stage
+     * @param stage Pipeline stage
+     * @param start Reading taken when the stage began
+     */
+    void record_span(PipelineStage stage, const HwCounterValues& start);
+
+private:
+    HwCounters() = default;
+
+    HwCounters(const HwCounters&) = delete;
+    HwCounters& operator=(const HwCounters&) = delete;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint32_t> sample_every_{64};
+    std::atomic<uint32_t> available_events_{0};
+    std::atomic<bool> warned_{false};
+};
+
+/**
+ * @brief RAII request scope: begin_request / end_request
+ */
+class HwCounterRequestScope {
+public:
+    HwCounterRequestScope()
+        : active_(HwCounters::instance().enabled() && HwCounters::instance().begin_request()) {
+    }
+
+    ~HwCounterRequestScope() {
+        if (active_) {
+            HwCounters::instance().end_request();
+        }
+    }
+
+    HwCounterRequestScope(const HwCounterRequestScope&) = delete;
+    HwCounterRequestScope& operator=(const HwCounterRequestScope&) = delete;
+
+private:
+    bool active_;
+};
+
+/**
+ * @brief RAII stage measurement; free outside a sampled request
+ */
+class HwCounterSpan {
+public:
+    explicit HwCounterSpan(PipelineStage stage)
+        : stage_(stage)
+        , active_(HwCounters::instance().request_sampled() && HwCounters::instance().read(start_)) {
+    }
+
+    ~HwCounterSpan() {
+        if (active_) {
+            HwCounters::instance().record_span(stage_, start_);
+        }
+    }
+
+    HwCounterSpan(const HwCounterSpan&) = delete;
+    HwCounterSpan& operator=(const HwCounterSpan&) = delete;
+
+private:
+    PipelineStage stage_;
+    HwCounterValues start_;
+    bool active_;
+};
+
+#define DMP_HW_COUNTERS_CONCAT_INNER(a, b) a##b
+#define DMP_HW_COUNTERS_CONCAT(a, b) DMP_HW_COUNTERS_CONCAT_INNER(a, b)
+
+/**
+ * @brief Count hardware events of the enclosing scope as one pipeline stage
+ *
+ * Usage:
+ * {
+ *     DMP_HW_COUNTERS(PipelineStage::PATTERN_MATCH);
+ *     // ... stage work ...
+ * }
+ */
+#define DMP_HW_COUNTERS(stage) \
+    dmp::HwCounterSpan DMP_HW_COUNTERS_CONCAT(_dmp_hw_, __LINE__)(stage)
+
+} // namespace dmp
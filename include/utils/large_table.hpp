@@ -0,0 +1,170 @@
+/**
+ * @file large_table.hpp
+ * @brief Huge-page and NUMA-aware allocation for large long-lived tables
+ * @author Stan Jiang
+ * @date 2025-09-12
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "common/config.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief How table pages are backed
+ */
+enum class HugePageMode : uint8_t {
+    OFF,          // Regular 4 KiB pages
+    TRANSPARENT,  // 2 MiB-aligned mapping with madvise(MADV_HUGEPAGE)
+    EXPLICIT      // MAP_HUGETLB from the reserved pool, transparent if none left
+};
+
+/**
+ * @brief Where table pages are placed on multi-socket hosts
+ */
+enum class NumaPolicy : uint8_t {
+    LOCAL,       // First touch (the allocating thread's node)
+    INTERLEAVE,  // Spread pages over all nodes, for tables read from every core
+    SHARD        // Bind each shard's table to one node, round-robin by shard index
+};
+
+/**
+ * @brief Large table allocator counters
+ */
+struct LargeTableStats {
+    uint64_t tables = 0;                  // Live mappings
+    uint64_t mapped_bytes = 0;            // Bytes mapped for live tables
+    uint64_t explicit_huge_bytes = 0;     // Of which backed by MAP_HUGETLB
+    uint64_t transparent_huge_bytes = 0;  // Of which advised for transparent huge pages
+    uint64_t heap_fallbacks = 0;          // Large requests served by malloc (budget or mmap failure)
+};
+
+/**
+ * @brief Allocates large long-lived tables directly from mmap
+ *
+ * Tables of at least kMinMappedBytes get their own mapping, rounded to
+ * 2 MiB, backed by huge pages and placed according to the NUMA policy so
+ * that random lookups into multi-GB tables do not miss the TLB on every
+ * access. Smaller requests and requests beyond the configured pool go to
+ * malloc. Not for hot-path allocation: every mapping takes a mutex and a
+ * system call.
+ */
+class LargeTableAllocator {
+public:
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+    static constexpr size_t kMinMappedBytes = kHugePageSize;  // Smaller requests use malloc
+
+    /**
+     * @brief Get singleton allocator
+     */
+    static LargeTableAllocator& instance();
+
+    /**
+     * @brief Apply configuration to subsequent allocations
+     * @param config Huge page mode, NUMA policy and pool size
+     * @return Success or error for unknown mode names
+     */
+    Result<void> configure(const MemoryConfig& config);
+
+    /**
+     * @brief Allocate a table
+     * @param bytes Table size
+     * @param shard Shard index for NumaPolicy::SHARD, or -1 for unsharded tables
+     * @return Zero-filled memory aligned to at least 16 bytes, or nullptr
+     */
+    void* allocate(size_t bytes, int shard = -1);
+
+    /**
+     * @brief Release a table returned by allocate()
+     */
+    void deallocate(void* ptr) noexcept;
+
+    /**
+     * @brief Release a table when its size is known (skips the lookup for small ones)
+     */
+    void deallocate(void* ptr, size_t bytes) noexcept;
+
+    /**
+     * @brief NUMA node serving a shard, or -1 on single-node hosts
+     */
+    int node_for_shard(size_t shard) const;
+
+    /**
+     * @brief Number of online NUMA nodes (1 when unknown)
+     */
+    size_t numa_nodes() const { return nodes_.empty() ? 1 : nodes_.size(); }
+
+    LargeTableStats stats() const;
+
+private:
+    struct Mapping {
+        size_t length = 0;
+        bool explicit_huge = false;
+        bool transparent_huge = false;
+    };
+
+    LargeTableAllocator();
+
+    void* map_table(size_t length, int shard, Mapping& mapping);
+    void place(void* ptr, size_t length, int shard);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<void*, Mapping> mappings_;
+    LargeTableStats stats_;
+    HugePageMode huge_pages_ = HugePageMode::TRANSPARENT;
+    NumaPolicy numa_policy_ = NumaPolicy::LOCAL;
+    bool prefault_ = true;
+    size_t pool_bytes_ = size_t{512} << 20;
+    std::vector<int> nodes_;              // Online NUMA node ids
+    bool warned_budget_ = false;
+    bool warned_hugetlb_ = false;
+    bool warned_mbind_ = false;
+};
+
+/**
+ * @brief Standard allocator over LargeTableAllocator for table containers
+ *
+ * Lets vectors and flat hash maps holding large tables use huge pages,
+ * e.g. std::vector<Entry, LargeTableStdAllocator<Entry>> table(n, {}, {shard}).
+ */
+template<typename T>
+class LargeTableStdAllocator {
+public:
+    using value_type = T;
+
+    LargeTableStdAllocator() noexcept = default;
+    explicit LargeTableStdAllocator(int shard) noexcept : shard_(shard) {}
+    template<typename U>
+    LargeTableStdAllocator(const LargeTableStdAllocator<U>& other) noexcept : shard_(other.shard()) {}
+
+    T* allocate(size_t n) {
+        void* ptr = LargeTableAllocator::instance().allocate(n * sizeof(T), shard_);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        LargeTableAllocator::instance().deallocate(ptr, n * sizeof(T));
+    }
+
+    int shard() const noexcept { return shard_; }
+
+    template<typename U>
+    bool operator==(const LargeTableStdAllocator<U>& other) const noexcept { return shard_ == other.shard(); }
+    template<typename U>
+    bool operator!=(const LargeTableStdAllocator<U>& other) const noexcept { return shard_ != other.shard(); }
+
+private:
+    int shard_ = -1;
+};
+
+} // namespace dmp
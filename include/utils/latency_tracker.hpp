@@ -0,0 +1,129 @@
+/**
+ * @file latency_tracker.hpp
+ * @brief Rolling-window latency percentiles and throughput for DMP
+ * @author Stan Jiang
+ * @date 2025-09-05
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "utils/metrics.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief Latency and throughput over the most recent window
+ */
+struct LatencyReport {
+    std::array<LatencyMetrics, PIPELINE_STAGE_COUNT> stages{};  // Per pipeline stage
+    LatencyMetrics end_to_end{};      // Whole decision pipeline
+    ThroughputMetrics throughput{};   // RPS over the last interval, totals since start
+    uint64_t window_samples = 0;      // End-to-end observations in the window
+    uint32_t window_seconds = 0;      // Covered window (shorter while warming up)
+    uint64_t timestamp_ms = 0;        // When the report was computed
+    bool slo_violated = false;        // End-to-end P99 above the configured target
+
+    const LatencyMetrics& stage(PipelineStage s) const {
+        return stages[static_cast<size_t>(s)];
+    }
+};
+
+/**
+ * @brief Rolling-window percentile tracker
+ *
+ * Every interval the tracker takes a merged snapshot of the collector's
+ * cumulative stage histograms and keeps a ring of them; the window is the
+ * difference between the newest and the oldest entry. Percentiles are
+ * therefore exact to histogram resolution (~3%) over the full window,
+ * instead of averages of per-interval percentiles.
+ */
+class LatencyTracker {
+public:
+    /**
+     * @brief Constructor
+     * @param collector Metrics source
+     * @param interval_seconds Report interval (metrics_interval_seconds)
+     * @param window_seconds Rolling window length
+     * @param slo_p99_ms End-to-end P99 target used for slo_violated
+     */
+    LatencyTracker(MetricsCollector& collector, uint32_t interval_seconds,
+                   uint32_t window_seconds, float slo_p99_ms);
+
+    /**
+     * @brief Destructor - stops the background thread and unregisters gauges
+     */
+    ~LatencyTracker();
+
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker& operator=(const LatencyTracker&) = delete;
+
+    /**
+     * @brief Start periodic reporting and register Prometheus gauges
+     */
+    void start();
+
+    /**
+     * @brief Stop periodic reporting
+     */
+    void stop();
+
+    /**
+     * @brief Take one sample and recompute the report
+     *
+     * Called by the background thread; exposed so callers without a
+     * running thread (tools, tests) can drive the tracker manually.
+     */
+    void tick();
+
+    /**
+     * @brief Most recent report
+     *
+     * Thread-safe: Yes
+     */
+    LatencyReport latest() const;
+
+    /**
+     * @brief Convert a histogram to latency metrics in milliseconds
+     */
+    static LatencyMetrics to_latency_metrics(const HistogramSnapshot& histogram);
+
+private:
+    void worker();
+
+    /**
+     * @brief Cumulative state captured at one tick
+     */
+    struct Sample {
+        std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT> stages;
+        uint64_t errors = 0;
+    };
+
+    MetricsCollector& collector_;
+    const uint32_t interval_seconds_;
+    const size_t ring_size_;
+    const float slo_p99_ms_;
+
+    // Ring of cumulative samples, only touched by tick()
+    std::mutex tick_mutex_;
+    std::vector<std::unique_ptr<Sample>> ring_;
+    size_t ring_head_ = 0;
+    size_t ring_filled_ = 0;
+
+    mutable std::mutex report_mutex_;
+    LatencyReport report_;
+
+    std::atomic<bool> running_{false};
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    std::unique_ptr<std::thread> worker_thread_;
+    bool gauges_registered_ = false;
+};
+
+} // namespace dmp
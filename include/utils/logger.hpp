@@ -11,48 +11,92 @@
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/daily_file_sink.h>
 #include <spdlog/async.h>
+#include <spdlog/fmt/fmt.h>
+#include "utils/trace_id.hpp"
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
-#include <random>
-#include <sstream>
-#include <iomanip>
+#include <vector>
 #include <chrono>
 
+/**
+ * @brief Compile-time log levels (values match spdlog::level::level_enum)
+ *
+ * DMP_LOG_ACTIVE_LEVEL (set by the DMP_LOG_ACTIVE_LEVEL CMake option)
+ * is the lowest level compiled in; everything below it disappears.
+ */
+#define DMP_LOG_LEVEL_TRACE 0
+#define DMP_LOG_LEVEL_DEBUG 1
+#define DMP_LOG_LEVEL_INFO  2
+#define DMP_LOG_LEVEL_ERROR 4
+#define DMP_LOG_LEVEL_FATAL 5
+
+#ifndef DMP_LOG_ACTIVE_LEVEL
+#define DMP_LOG_ACTIVE_LEVEL DMP_LOG_LEVEL_TRACE
+#endif
+
 namespace dmp {
 
 /**
- * @brief Thread-local trace ID generator and storage
+ * @brief Thread-local trace ID storage
+ *
+ * The current id is a trivially copyable TraceId, so reading it on every
+ * log call costs a 16-byte copy; hex text is only produced when a record
+ * is actually written.
  */
 class TraceContext {
 public:
     /**
      * @brief Get current thread's trace ID
-     * @return Current trace ID as string
+     * @return Current trace ID (empty if none)
      */
-    static std::string get_trace_id();
+    static TraceId current() noexcept { return current_trace_id_; }
     
     /**
      * @brief Set current thread's trace ID
      * @param trace_id New trace ID
      */
+    static void set(TraceId trace_id) noexcept { current_trace_id_ = trace_id; }
+    
+    /**
+     * @brief Generate and install a new trace ID for current thread
+     * @return Generated trace ID
+     */
+    static TraceId generate() noexcept;
+    
+    /**
+     * @brief Clear current thread's trace ID
+     */
+    static void clear() noexcept { current_trace_id_ = TraceId{}; }
+    
+    /**
+     * @brief Get current thread's trace ID as hex text (empty if none)
+     */
+    static std::string get_trace_id();
+    
+    /**
+     * @brief Set current thread's trace ID from hex text
+     * @param trace_id 32-character hex ID; anything else clears the ID
+     */
     static void set_trace_id(const std::string& trace_id);
     
     /**
      * @brief Generate new trace ID for current thread
-     * @return Generated trace ID
+     * @return Generated trace ID as hex text
      */
     static std::string generate_trace_id();
     
     /**
      * @brief Clear current thread's trace ID
      */
-    static void clear_trace_id();
+    static void clear_trace_id() { clear(); }
 
 private:
-    static thread_local std::string current_trace_id_;
-    static std::random_device rd_;
-    static std::mt19937_64 gen_;
+    static inline thread_local TraceId current_trace_id_{};
 };
 
 /**
@@ -60,15 +104,32 @@ private:
  */
 class TraceScope {
 public:
+    explicit TraceScope(TraceId trace_id);
     explicit TraceScope(const std::string& trace_id);
     explicit TraceScope(); // Generate new trace ID
     ~TraceScope();
     
-    const std::string& get_trace_id() const { return trace_id_; }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    
+    TraceId get_trace_id() const { return trace_id_; }
 
 private:
-    std::string trace_id_;
-    std::string previous_trace_id_;
+    TraceId trace_id_;
+    TraceId previous_trace_id_;
+};
+
+/**
+ * @brief Slot of a cached logger handle
+ *
+ * The built-in loggers have fixed ids; other names are assigned a slot on
+ * first use via Logger::logger_id().
+ */
+enum class LoggerId : uint16_t {
+    DEFAULT = 0,
+    AUDIT = 1,
+    PERFORMANCE = 2,
+    FIRST_DYNAMIC = 3
 };
 
 /**
@@ -101,85 +162,190 @@ public:
      */
     static std::shared_ptr<spdlog::logger> get_logger(const std::string& name);
     
+    /**
+     * @brief Cached logger for a slot
+     * @param id Logger slot
+     * @return Logger pointer, valid until the next initialize()/shutdown()
+     *
+     * Performance: one acquire load once the slot has been resolved; the
+     * registry is only consulted the first time a slot is used.
+     */
+    static spdlog::logger* handle(LoggerId id) {
+        auto* logger = slots_[static_cast<size_t>(id)].load(std::memory_order_acquire);
+        return logger ? logger : resolve_slot(id);
+    }
+    
+    /**
+     * @brief Get (or assign) the slot for a named logger
+     * @param name Logger name
+     * @return Slot id; DEFAULT if the slot table is full
+     *
+     * Takes a mutex; call once per call site (LOG_NAMED_* caches the result).
+     */
+    static LoggerId logger_id(std::string_view name);
+    
     /**
      * @brief Set global log level
      * @param level Log level (FATAL=0, ERROR=1, INFO=2, DEBUG=3)
      */
     static void set_level(spdlog::level::level_enum level);
     
+    /**
+     * @brief Check the cached default-logger level
+     * @param level Level of the statement about to be logged
+     * @return true if the statement would be emitted
+     *
+     * Performance: one relaxed atomic load, no registry access
+     */
+    static bool should_log(spdlog::level::level_enum level) noexcept {
+        return static_cast<int>(level) >= active_level_.load(std::memory_order_relaxed);
+    }
+    
     /**
      * @brief Flush all loggers
      */
     static void flush_all();
+    
+    /**
+     * @brief Messages dropped because the async queue was full
+     * @return Overrun plus discarded message count since initialization
+     */
+    static uint64_t dropped_messages();
 
 private:
     static bool initialized_;
     static std::shared_ptr<spdlog::logger> default_logger_;
+    static inline std::atomic<int> active_level_{spdlog::level::info};
     static std::string log_pattern_;
     
+    // Async pipeline settings ([async] section of logging.toml)
+    static size_t async_queue_size_;
+    static size_t async_threads_;
+    static uint32_t flush_interval_ms_;
+    static spdlog::async_overflow_policy overflow_policy_;
+    static spdlog::async_overflow_policy audit_overflow_policy_;
+    static std::shared_ptr<spdlog::details::thread_pool> thread_pool_;
+    
+    // Cached handles: slots_ hold raw pointers, slot_owners_ keep them alive
+    static constexpr size_t kMaxLoggers = 64;
+    static inline std::array<std::atomic<spdlog::logger*>, kMaxLoggers> slots_{};
+    static std::array<std::shared_ptr<spdlog::logger>, kMaxLoggers> slot_owners_;
+    static std::array<std::string, kMaxLoggers> slot_names_;
+    static size_t slot_count_;
+    static std::vector<std::shared_ptr<spdlog::logger>> retired_loggers_;
+    static std::mutex slots_mutex_;
+    
+    static spdlog::logger* resolve_slot(LoggerId id);
+    static void reset_slots();
+    static std::shared_ptr<spdlog::logger> fallback_logger();
+    
     static bool load_config(const std::string& config_path);
     static void setup_sinks();
     static void setup_async_logging();
+    static std::shared_ptr<spdlog::logger> make_async_logger(const std::string& name,
+                                                             std::vector<spdlog::sink_ptr> sinks,
+                                                             spdlog::async_overflow_policy policy);
 };
 
 } // namespace dmp
 
+/**
+ * @brief Format TraceId straight from a stack buffer (no string allocation)
+ */
+template<>
+struct fmt::formatter<dmp::TraceId> : fmt::formatter<std::string_view> {
+    template<typename FormatContext>
+    auto format(const dmp::TraceId& trace_id, FormatContext& ctx) const {
+        char buffer[dmp::TraceId::kHexLength];
+        trace_id.format_to(buffer);
+        return fmt::formatter<std::string_view>::format(
+            std::string_view(buffer, sizeof(buffer)), ctx);
+    }
+};
+
 // Enhanced logging macros with trace ID support
 #define DMP_LOG_WITH_LOCATION(logger, level, fmt_str, ...) \
     logger->log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, level, fmt_str, ##__VA_ARGS__)
 
 // Main logging macros
-#define LOG_FATAL(fmt_str, ...) \
+//
+// Each macro checks the cached level before touching the trace id or
+// evaluating any argument, so disabled statements cost one relaxed load.
+// Levels below DMP_LOG_ACTIVE_LEVEL are compiled out entirely (the
+// arguments are still type-checked but never evaluated).
+#define DMP_LOG_TRACED(level, fmt_str, ...) \
     do { \
-        auto trace_id = dmp::TraceContext::get_trace_id(); \
-        if (!trace_id.empty()) { \
-            DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(), spdlog::level::critical, "[{}] " fmt_str, trace_id, ##__VA_ARGS__); \
-        } else { \
-            DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(), spdlog::level::critical, fmt_str, ##__VA_ARGS__); \
+        if (dmp::Logger::should_log(level)) { \
+            const auto trace_id = dmp::TraceContext::current(); \
+            if (!trace_id.empty()) { \
+                DMP_LOG_WITH_LOCATION(dmp::Logger::handle(dmp::LoggerId::DEFAULT), level, "[{}] " fmt_str, trace_id, ##__VA_ARGS__); \
+            } else { \
+                DMP_LOG_WITH_LOCATION(dmp::Logger::handle(dmp::LoggerId::DEFAULT), level, fmt_str, ##__VA_ARGS__); \
+            } \
         } \
     } while(0)
 
-#define LOG_ERROR(fmt_str, ...) \
+#define DMP_LOG_COMPILED_OUT(level, fmt_str, ...) \
     do { \
-        auto trace_id = dmp::TraceContext::get_trace_id(); \
-        if (!trace_id.empty()) { \
-            DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(), spdlog::level::err, "[{}] " fmt_str, trace_id, ##__VA_ARGS__); \
-        } else { \
-            DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(), spdlog::level::err, fmt_str, ##__VA_ARGS__); \
+        if (false) { \
+            DMP_LOG_WITH_LOCATION(dmp::Logger::handle(dmp::LoggerId::DEFAULT), level, fmt_str, ##__VA_ARGS__); \
         } \
     } while(0)
 
-#define LOG_INFO(fmt_str, ...) \
-    do { \
-        auto trace_id = dmp::TraceContext::get_trace_id(); \
-        if (!trace_id.empty()) { \
-            DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(), spdlog::level::info, "[{}] " fmt_str, trace_id, ##__VA_ARGS__); \
-        } else { \
-            DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(), spdlog::level::info, fmt_str, ##__VA_ARGS__); \
-        } \
-    } while(0)
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_FATAL
+#define LOG_FATAL(fmt_str, ...) DMP_LOG_TRACED(spdlog::level::critical, fmt_str, ##__VA_ARGS__)
+#else
+#define LOG_FATAL(fmt_str, ...) DMP_LOG_COMPILED_OUT(spdlog::level::critical, fmt_str, ##__VA_ARGS__)
+#endif
 
-#define LOG_DEBUG(fmt_str, ...) \
-    do { \
-        auto trace_id = dmp::TraceContext::get_trace_id(); \
-        if (!trace_id.empty()) { \
-            DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(), spdlog::level::debug, "[{}] " fmt_str, trace_id, ##__VA_ARGS__); \
-        } else { \
-            DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(), spdlog::level::debug, fmt_str, ##__VA_ARGS__); \
-        } \
-    } while(0)
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt_str, ...) DMP_LOG_TRACED(spdlog::level::err, fmt_str, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt_str, ...) DMP_LOG_COMPILED_OUT(spdlog::level::err, fmt_str, ##__VA_ARGS__)
+#endif
+
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_INFO
+#define LOG_INFO(fmt_str, ...) DMP_LOG_TRACED(spdlog::level::info, fmt_str, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt_str, ...) DMP_LOG_COMPILED_OUT(spdlog::level::info, fmt_str, ##__VA_ARGS__)
+#endif
+
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt_str, ...) DMP_LOG_TRACED(spdlog::level::debug, fmt_str, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(fmt_str, ...) DMP_LOG_COMPILED_OUT(spdlog::level::debug, fmt_str, ##__VA_ARGS__)
+#endif
+
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_TRACE
+#define LOG_TRACE(fmt_str, ...) DMP_LOG_TRACED(spdlog::level::trace, fmt_str, ##__VA_ARGS__)
+#else
+#define LOG_TRACE(fmt_str, ...) DMP_LOG_COMPILED_OUT(spdlog::level::trace, fmt_str, ##__VA_ARGS__)
+#endif
 
 // Named logger macros
-#define LOG_NAMED_FATAL(name, fmt_str, ...) DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(name), spdlog::level::critical, fmt_str, ##__VA_ARGS__)
-#define LOG_NAMED_ERROR(name, fmt_str, ...) DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(name), spdlog::level::err, fmt_str, ##__VA_ARGS__)
-#define LOG_NAMED_INFO(name, fmt_str, ...) DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(name), spdlog::level::info, fmt_str, ##__VA_ARGS__)
-#define LOG_NAMED_DEBUG(name, fmt_str, ...) DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger(name), spdlog::level::debug, fmt_str, ##__VA_ARGS__)
+//
+// The slot for `name` is looked up once per call site, so `name` must be
+// the same at every execution of a given statement.
+#define DMP_LOGGER_HANDLE(name) \
+    dmp::Logger::handle([&]() { \
+        static const dmp::LoggerId _dmp_logger_id = dmp::Logger::logger_id(name); \
+        return _dmp_logger_id; \
+    }())
+
+#define LOG_NAMED_FATAL(name, fmt_str, ...) DMP_LOG_WITH_LOCATION(DMP_LOGGER_HANDLE(name), spdlog::level::critical, fmt_str, ##__VA_ARGS__)
+#define LOG_NAMED_ERROR(name, fmt_str, ...) DMP_LOG_WITH_LOCATION(DMP_LOGGER_HANDLE(name), spdlog::level::err, fmt_str, ##__VA_ARGS__)
+#define LOG_NAMED_INFO(name, fmt_str, ...) DMP_LOG_WITH_LOCATION(DMP_LOGGER_HANDLE(name), spdlog::level::info, fmt_str, ##__VA_ARGS__)
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_DEBUG
+#define LOG_NAMED_DEBUG(name, fmt_str, ...) DMP_LOG_WITH_LOCATION(DMP_LOGGER_HANDLE(name), spdlog::level::debug, fmt_str, ##__VA_ARGS__)
+#else
+#define LOG_NAMED_DEBUG(name, fmt_str, ...) DMP_LOG_COMPILED_OUT(spdlog::level::debug, fmt_str, ##__VA_ARGS__)
+#endif
 
 // Audit logging (special logger for compliance)
-#define LOG_AUDIT(fmt_str, ...) DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger("audit"), spdlog::level::info, fmt_str, ##__VA_ARGS__)
+#define LOG_AUDIT(fmt_str, ...) DMP_LOG_WITH_LOCATION(dmp::Logger::handle(dmp::LoggerId::AUDIT), spdlog::level::info, fmt_str, ##__VA_ARGS__)
 
 // Performance logging
-#define LOG_PERF(fmt_str, ...) DMP_LOG_WITH_LOCATION(dmp::Logger::get_logger("performance"), spdlog::level::info, fmt_str, ##__VA_ARGS__)
+#define LOG_PERF(fmt_str, ...) DMP_LOG_WITH_LOCATION(dmp::Logger::handle(dmp::LoggerId::PERFORMANCE), spdlog::level::info, fmt_str, ##__VA_ARGS__)
 
 // Conditional logging
 #define LOG_ERROR_IF(condition, fmt_str, ...) \
@@ -0,0 +1,177 @@
+/**
+ * @file memory_accountant.hpp
+ * @brief Process memory budget with per-consumer accounting and graded reclaim
+ * @author Stan Jiang
+ * @date 2025-09-12
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "common/config.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief Memory pressure grade, ordered by severity
+ */
+enum class MemoryPressure : uint8_t {
+    NORMAL = 0,    // Below the soft limit
+    ELEVATED = 1,  // Above the soft limit: shrink caches, trim the heap
+    CRITICAL = 2   // Above the hard limit: evict state, refuse reloads
+};
+
+const char* memory_pressure_name(MemoryPressure pressure);
+
+/**
+ * @brief Last sampled size of one registered consumer
+ */
+struct MemoryConsumerUsage {
+    std::string name;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief Keeps the process inside max_memory_gb and the container limit
+ *
+ * Caches, pattern databases, aggregation stores and arenas register a
+ * size callback and, optionally, a reclaim callback with the pressure
+ * grade at which it runs. A sampling thread compares resident memory
+ * against the effective limit (the lower of max_memory_gb and the cgroup
+ * limit); above the soft limit ELEVATED reclaimers run and freed heap is
+ * returned to the OS, above the hard limit CRITICAL reclaimers run too.
+ * Reloads ask admit() before staging so a new generation cannot push the
+ * process over the hard limit.
+ */
+class MemoryAccountant {
+public:
+    using SizeFn = std::function<uint64_t()>;
+
+    /**
+     * @brief Release memory
+     * @param excess_bytes Bytes above the soft limit at the time of the call
+     * @return Bytes released (estimate)
+     */
+    using ReclaimFn = std::function<uint64_t(uint64_t excess_bytes)>;
+
+    /**
+     * @brief Get singleton accountant
+     */
+    static MemoryAccountant& instance();
+
+    ~MemoryAccountant();
+
+    /**
+     * @brief Set the budget
+     * @param max_memory_bytes Configured ceiling (ServerConfig::max_memory_gb)
+     * @param config Soft/hard thresholds and sampling period
+     * @return Effective limit in bytes after applying the container limit
+     */
+    Result<uint64_t> configure(uint64_t max_memory_bytes, const MemoryConfig& config);
+
+    /**
+     * @brief Track a memory consumer and export it as dmp_memory_<name>_bytes
+     * @param name Consumer name (metric-safe, e.g. l2_cache)
+     * @param size Current size callback, called from the sampling thread
+     * @param reclaim Optional reclaim callback
+     * @param reclaim_at Lowest pressure grade at which reclaim runs
+     *
+     * Reclaimers run in registration order; register cheap-to-rebuild
+     * consumers (caches) before expensive ones (aggregation state).
+     */
+    void register_consumer(const std::string& name, SizeFn size, ReclaimFn reclaim = {},
+                           MemoryPressure reclaim_at = MemoryPressure::ELEVATED);
+
+    /**
+     * @brief Stop tracking a consumer (required before it is destroyed)
+     */
+    void unregister_consumer(const std::string& name);
+
+    /**
+     * @brief Check whether an allocation of this size still fits under the hard limit
+     * @param what Description used in the error message
+     * @param bytes Expected additional resident bytes
+     * @return Success, or RESOURCE_EXHAUSTED with current usage
+     */
+    Result<void> admit(const std::string& what, uint64_t bytes);
+
+    /**
+     * @brief Sample usage, update the pressure grade and reclaim if needed
+     * @return Pressure after reclaiming
+     */
+    MemoryPressure check_now();
+
+    /**
+     * @brief Start the sampling thread
+     */
+    void start();
+
+    /**
+     * @brief Stop the sampling thread
+     */
+    void stop();
+
+    MemoryPressure pressure() const { return pressure_.load(std::memory_order_relaxed); }
+    uint64_t limit_bytes() const { return limit_bytes_.load(std::memory_order_relaxed); }
+    uint64_t used_bytes() const { return used_bytes_.load(std::memory_order_relaxed); }
+    uint64_t reclaimed_bytes() const { return reclaimed_bytes_.load(std::memory_order_relaxed); }
+    uint64_t refused() const { return refused_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Last sampled size of every consumer
+     */
+    std::vector<MemoryConsumerUsage> usage() const;
+
+    /**
+     * @brief Resident set size of this process
+     */
+    static uint64_t resident_bytes();
+
+    /**
+     * @brief Memory limit of the enclosing cgroup (v2 or v1), 0 if unlimited
+     */
+    static uint64_t container_limit_bytes();
+
+private:
+    struct Consumer {
+        std::string name;
+        SizeFn size;
+        ReclaimFn reclaim;
+        MemoryPressure reclaim_at;
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    MemoryAccountant() = default;
+    MemoryPressure grade(uint64_t used) const;
+    void run();
+
+    std::atomic<uint64_t> limit_bytes_{0};        // 0 = unlimited
+    std::atomic<uint64_t> soft_bytes_{0};
+    std::atomic<uint64_t> hard_bytes_{0};
+    std::atomic<uint64_t> used_bytes_{0};
+    std::atomic<MemoryPressure> pressure_{MemoryPressure::NORMAL};
+    std::atomic<uint64_t> reclaimed_bytes_{0};
+    std::atomic<uint64_t> refused_{0};
+
+    // Consumers; check_mutex_ serializes sampling and reclaim passes
+    mutable std::mutex consumers_mutex_;
+    std::vector<std::shared_ptr<Consumer>> consumers_;
+    std::mutex check_mutex_;
+
+    // Sampling thread
+    std::thread worker_;
+    std::mutex worker_mutex_;
+    std::condition_variable worker_cv_;
+    bool stop_requested_ = false;
+    uint32_t check_interval_ms_ = 1000;
+};
+
+} // namespace dmp
@@ -1,26 +1,117 @@
 /**
  * @file metrics.hpp
- * @brief Simplified metrics collection system for DMP risk control (Phase 1)
+ * @brief Sharded, lock-free metrics collection system for DMP risk control
  * @author Stan Jiang
  * @date 2025-08-28
  */
 #pragma once
 
 #include "common/types.hpp"
+#include "utils/histogram.hpp"
+#include "utils/hw_counters.hpp"
 #include <memory>
 #include <string>
+#include <string_view>
 #include <atomic>
 #include <chrono>
-#include <map>
+#include <functional>
+#include <initializer_list>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace dmp {
 
+class PrometheusExporter;
+
+/**
+ * @brief Unlabeled counters tracked by every metrics shard
+ */
+enum class MetricCounter : uint8_t {
+    HTTP_REQUESTS = 0,
+    DECISIONS_APPROVE,
+    DECISIONS_DECLINE,
+    DECISIONS_REVIEW,
+    ERRORS,
+    RULES_EVALUATED,
+    RULES_TRIGGERED,
+    FEATURE_CACHE_HITS,
+    FEATURE_CACHE_MISSES,
+    FEATURES_EXTRACTED,
+    ML_INFERENCES,
+    DECISION_ALLOCATIONS,      // Heap allocations made by decisions (alloc tracking builds)
+    DECISION_ALLOCATED_BYTES,  // Heap bytes requested by decisions (alloc tracking builds)
+    kCount
+};
+
+static constexpr size_t METRIC_COUNTER_COUNT = static_cast<size_t>(MetricCounter::kCount);
+
+/**
+ * @brief Labeled counter families (label values are interned once)
+ */
+enum class MetricFamily : uint8_t {
+    HTTP_REQUESTS = 0,       // labels: method, path, status
+    ERRORS,                  // labels: type, component
+    ML_INFERENCES,           // labels: model
+    OPERATIONS,              // labels: operation
+    OPERATION_DURATION_US,   // labels: operation
+    LABEL_OVERFLOW,          // series dropped because the label table is full
+    kCount
+};
+
+/**
+ * @brief Static description of a labeled counter family
+ */
+struct MetricFamilyInfo {
+    const char* name;                      // Prometheus metric name
+    const char* help;                      // Help text
+    std::vector<const char*> label_names;  // Ordered label names
+};
+
 /**
- * @brief Simplified metrics collection system for Phase 1
- * 
- * Provides basic metric collection with console output.
- * Thread-safe operations for concurrent access from multiple request handlers.
+ * @brief Get static description of a counter family
+ */
+const MetricFamilyInfo& metric_family_info(MetricFamily family);
+
+/**
+ * @brief Merged value of one labeled series
+ */
+struct LabeledSeriesValue {
+    uint32_t series_id;                    // Stable id, also index into the label table
+    MetricFamily family;                   // Owning family
+    std::vector<std::string> label_values; // Values in family label order
+    uint64_t value;                        // Merged counter value
+};
+
+/**
+ * @brief Point-in-time merge of all metric shards
+ */
+struct MetricsSnapshot {
+    std::array<uint64_t, METRIC_COUNTER_COUNT> counters{};
+    std::vector<LabeledSeriesValue> labeled;                       // Non-zero series only
+    std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT> stage_latency;
+    std::array<HwCounterValues, PIPELINE_STAGE_COUNT> stage_hw_events;  // Summed over sampled stages
+    std::array<uint64_t, PIPELINE_STAGE_COUNT> stage_hw_samples{};      // Stages measured
+    double cpu_usage_percent = 0.0;
+    double memory_usage_mb = 0.0;
+    int64_t active_connections = 0;
+    std::vector<std::pair<std::string, double>> gauges;           // Registered callback gauges
+    size_t shard_count = 0;
+
+    uint64_t counter(MetricCounter c) const { return counters[static_cast<size_t>(c)]; }
+    const HistogramSnapshot& latency(PipelineStage s) const {
+        return stage_latency[static_cast<size_t>(s)];
+    }
+};
+
+/**
+ * @brief Sharded metrics collection system
+ *
+ * Each recording thread owns a shard (counters, labeled counters and
+ * per-stage latency histograms) that only it writes, so the request path
+ * takes no locks and performs no I/O. Shards are merged on scrape via
+ * snapshot(). Shards of exited threads are recycled, keeping counters
+ * monotonic without unbounded growth.
  */
 class MetricsCollector {
 public:
@@ -29,20 +120,22 @@ public:
      * @return Reference to global metrics collector
      */
     static MetricsCollector& instance();
-    
+
     /**
-     * @brief Initialize metrics system
-     * @param port Port for metrics endpoint (placeholder for Phase 1)
-     * @param path Path for metrics endpoint (placeholder for Phase 1)
+     * @brief Initialize metrics system and start the exposition endpoint
+     * @param port Port for metrics endpoint (0 disables the endpoint)
+     * @param path Path for metrics endpoint
+     * @param render_cache_ms Minimum interval between full exposition re-renders
      * @return Success or failure
      */
-    Result<void> initialize(uint16_t port = 9090, const std::string& path = "/metrics");
-    
+    Result<void> initialize(uint16_t port = 9090, const std::string& path = "/metrics",
+                            uint32_t render_cache_ms = 1000);
+
     /**
      * @brief Shutdown metrics system
      */
     void shutdown();
-    
+
     /**
      * @brief Record HTTP request metrics
      * @param method HTTP method (GET, POST, etc.)
@@ -52,7 +145,7 @@ public:
      */
     void record_http_request(const std::string& method, const std::string& path,
                            int status_code, double duration_ms);
-    
+
     /**
      * @brief Record decision metrics
      * @param decision Decision result (APPROVE, DECLINE, REVIEW)
@@ -60,25 +153,25 @@ public:
      * @param processing_time_ms Processing time in milliseconds
      */
     void record_decision(Decision decision, float risk_score, double processing_time_ms);
-    
+
     /**
      * @brief Record rule engine metrics
      * @param rules_evaluated Number of rules evaluated
      * @param rules_triggered Number of rules triggered
      * @param evaluation_time_ms Rule evaluation time
      */
-    void record_rule_evaluation(int rules_evaluated, int rules_triggered, 
+    void record_rule_evaluation(int rules_evaluated, int rules_triggered,
                                double evaluation_time_ms);
-    
+
     /**
      * @brief Record feature extraction metrics
      * @param cache_hit Whether feature was found in cache
      * @param extraction_time_ms Feature extraction time
      * @param feature_count Number of features extracted
      */
-    void record_feature_extraction(bool cache_hit, double extraction_time_ms, 
+    void record_feature_extraction(bool cache_hit, double extraction_time_ms,
                                   int feature_count);
-    
+
     /**
      * @brief Record ML inference metrics
      * @param model_name Name of the model used
@@ -87,7 +180,37 @@ public:
      */
     void record_ml_inference(const std::string& model_name, double inference_time_ms,
                            float prediction_score);
-    
+
+    /**
+     * @brief Record latency of a single pipeline stage
+     * @param stage Pipeline stage
+     * @param duration_ns Stage duration in nanoseconds
+     *
+     * Performance: lock-free, allocation-free histogram update
+     */
+    void record_stage_latency(PipelineStage stage, uint64_t duration_ns);
+
+    /**
+     * @brief Record heap activity of one decision
+     * @param allocations operator new calls made by the decision
+     * @param bytes Bytes requested by those calls
+     */
+    void record_decision_allocations(uint64_t allocations, uint64_t bytes);
+
+    /**
+     * @brief Record hardware events counted during one pipeline stage
+     * @param stage Pipeline stage
+     * @param events Event counts of that stage (see HwCounterSpan)
+     */
+    void record_stage_counters(PipelineStage stage, const HwCounterValues& events);
+
+    /**
+     * @brief Record a named operation duration (used by MetricsTimer)
+     * @param operation Operation name (interned on first use per thread)
+     * @param duration_ms Duration in milliseconds
+     */
+    void record_operation(std::string_view operation, double duration_ms);
+
     /**
      * @brief Update system resource metrics
      * @param cpu_usage_percent CPU usage percentage
@@ -96,66 +219,197 @@ public:
      */
     void update_system_metrics(double cpu_usage_percent, double memory_usage_mb,
                              int active_connections);
-    
+
     /**
      * @brief Record error occurrence
      * @param error_type Type of error
      * @param component Component where error occurred
      */
     void record_error(const std::string& error_type, const std::string& component);
-    
+
+    /**
+     * @brief Register a gauge evaluated at scrape time
+     * @param name Metric name (Prometheus naming rules)
+     * @param help Help text
+     * @param read Callback returning the current value
+     *
+     * Callback gauges cost nothing on the request path; use them to
+     * expose state that other components already track.
+     */
+    void register_gauge(const std::string& name, const std::string& help,
+                        std::function<double()> read);
+
+    /**
+     * @brief Register a monotonic counter evaluated at scrape time
+     * @param name Metric name, ending in _total
+     * @param help Help text
+     * @param read Callback returning the current (never decreasing) value
+     *
+     * Exposed with TYPE counter so rate() and resets behave; removed with
+     * unregister_gauge().
+     */
+    void register_counter(const std::string& name, const std::string& help,
+                          std::function<double()> read);
+
+    /**
+     * @brief Remove a callback gauge (required before its owner is destroyed)
+     * @param name Metric name passed to register_gauge
+     */
+    void unregister_gauge(const std::string& name);
+
+    /**
+     * @brief Merge all shards into a snapshot
+     * @return Merged metrics
+     *
+     * Thread-safe: Yes, may run concurrently with recording threads
+     */
+    MetricsSnapshot snapshot() const;
+
+    /**
+     * @brief Label values of a series id (empty if unknown)
+     */
+    std::vector<std::string> series_labels(uint32_t series_id) const;
+
+    /**
+     * @brief Help text of a registered callback gauge
+     */
+    std::string gauge_help(const std::string& name) const;
+
+    /**
+     * @brief Prometheus type of a registered callback metric ("gauge" or "counter")
+     */
+    const char* gauge_type(const std::string& name) const;
+
     /**
      * @brief Check if metrics system is initialized
      * @return true if initialized and ready
      */
-    bool is_initialized() const { return initialized_.load(); }
+    bool is_initialized() const { return initialized_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Exposition endpoint (nullptr when disabled)
+     *
+     * Other components may register extra admin routes on it.
+     */
+    PrometheusExporter* exporter() { return exporter_.get(); }
+
+    /**
+     * @brief Maximum number of distinct labeled series
+     */
+    static constexpr size_t kMaxLabeledSeries = 512;
+
+    struct Shard;
 
 private:
-    MetricsCollector() = default;
-    ~MetricsCollector() = default;
-    
+    MetricsCollector();
+    ~MetricsCollector();
+
     // Delete copy constructor and assignment operator
     MetricsCollector(const MetricsCollector&) = delete;
     MetricsCollector& operator=(const MetricsCollector&) = delete;
-    
+
+    friend struct ShardLease;
+
     /**
      * @brief Convert decision enum to string
      */
     std::string decision_to_string(Decision decision);
 
-    // Simplified metrics storage
+    /**
+     * @brief Get (or lazily lease) the calling thread's shard
+     */
+    Shard& local_shard();
+
+    /**
+     * @brief Lease a free shard, allocating one if none is free
+     */
+    Shard* acquire_shard();
+
+    /**
+     * @brief Return a shard to the free pool on thread exit
+     */
+    void release_shard(Shard* shard);
+
+    /**
+     * @brief Resolve label values to a stable series id
+     *
+     * Fast path is a thread-local hash lookup; the registry mutex is only
+     * taken the first time a thread sees a label combination.
+     */
+    uint32_t series_id(MetricFamily family, std::initializer_list<std::string_view> values);
+
+    /**
+     * @brief Check that an interned series carries exactly these labels
+     */
+    bool series_matches(uint32_t id, MetricFamily family,
+                        std::initializer_list<std::string_view> values) const;
+
+    /**
+     * @brief Increment a labeled series on the calling thread's shard
+     */
+    void add_labeled(MetricFamily family, std::initializer_list<std::string_view> values,
+                     uint64_t delta);
+
     std::atomic<bool> initialized_{false};
-    std::mutex metrics_mutex_;
-    
-    // Basic counters for Phase 1
-    struct SimpleMetrics {
-        uint64_t http_requests_total = 0;
-        uint64_t decisions_total = 0;
-        uint64_t errors_total = 0;
-        double total_request_time_ms = 0.0;
-        double total_decision_time_ms = 0.0;
-    } metrics_;
+    std::unique_ptr<PrometheusExporter> exporter_;
+
+    // Shard registry (touched on thread start/exit and on scrape only)
+    mutable std::mutex shards_mutex_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<Shard*> free_shards_;
+
+    // Label interning registry
+    struct SeriesInfo {
+        MetricFamily family;
+        std::vector<std::string> label_values;
+    };
+    mutable std::mutex series_mutex_;
+    std::vector<SeriesInfo> series_;
+    std::unordered_map<std::string, uint32_t> series_index_;  // interned key -> id
+
+    // Gauges: single atomic stores, last writer wins
+    std::atomic<double> cpu_usage_percent_{0.0};
+    std::atomic<double> memory_usage_mb_{0.0};
+    std::atomic<int64_t> active_connections_{0};
+
+    struct CallbackGauge {
+        std::string name;
+        std::string help;
+        std::function<double()> read;
+        bool counter = false;
+    };
+
+    void register_callback(const std::string& name, const std::string& help,
+                           std::function<double()> read, bool counter);
+    mutable std::mutex gauges_mutex_;
+    std::vector<CallbackGauge> callback_gauges_;
 };
 
 /**
  * @brief RAII helper for measuring operation duration
- * 
+ *
  * Automatically records operation duration when scope exits.
  * Use this for measuring function execution times.
  */
 class MetricsTimer {
 public:
     /**
-     * @brief Constructor - starts timing
+     * @brief Constructor - starts timing a named operation
      * @param operation_name Name of the operation being timed
      */
     explicit MetricsTimer(const std::string& operation_name);
-    
+
+    /**
+     * @brief Constructor - starts timing a pipeline stage
+     * @param stage Pipeline stage recorded into its latency histogram
+     */
+    explicit MetricsTimer(PipelineStage stage);
+
     /**
      * @brief Destructor - records elapsed time
      */
     ~MetricsTimer();
-    
+
     /**
      * @brief Get elapsed time so far
      * @return Elapsed time in milliseconds
@@ -164,13 +418,15 @@ public:
 
 private:
     std::string operation_name_;
-    std::chrono::high_resolution_clock::time_point start_time_;
+    PipelineStage stage_;
+    bool has_stage_;
+    std::chrono::steady_clock::time_point start_time_;
     bool stopped_;
 };
 
 /**
  * @brief Macro for easy timing of code blocks
- * 
+ *
  * Usage:
  * {
  *     DMP_TIME_OPERATION("decision_processing");
@@ -193,4 +449,4 @@ uint64_t get_current_timestamp_ms();
  */
 std::string format_duration(double duration_ms);
 
-} // namespace dmp
\ No newline at end of file
+} // namespace dmp
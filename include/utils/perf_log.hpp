@@ -0,0 +1,143 @@
+/**
+ * @file perf_log.hpp
+ * @brief Binary per-request stage timing log
+ * @author Stan Jiang
+ * @date 2025-09-08
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "common/config.hpp"
+#include "utils/mpmc_queue.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief One request's stage timings (fixed 64-byte little-endian record)
+ */
+struct PerfRecord {
+    uint64_t timestamp_ns = 0;                     // Request start, Unix epoch nanoseconds
+    uint64_t trace_high = 0;                       // TraceId of the request
+    uint64_t trace_low = 0;
+    uint32_t stage_ns[PIPELINE_STAGE_COUNT] = {};  // Per PipelineStage, saturates at ~4.29 s
+    uint32_t queue_wait_ns = 0;                    // Time queued before processing started
+    uint8_t decision = 0;                          // Decision enum value
+    uint8_t flags = 0;                             // PerfRecord::kError
+    uint16_t reserved = 0;
+
+    static constexpr uint8_t kError = 0x1;         // Request ended with an error
+
+    uint32_t stage(PipelineStage s) const { return stage_ns[static_cast<size_t>(s)]; }
+};
+
+static_assert(sizeof(PerfRecord) == 64, "PerfRecord layout is part of the file format");
+static_assert(std::is_trivially_copyable_v<PerfRecord>, "PerfRecord is written with fwrite");
+
+/**
+ * @brief Header at the start of every performance log file
+ */
+struct PerfLogHeader {
+    char magic[8] = {'D', 'M', 'P', 'P', 'E', 'R', 'F', '\0'};
+    uint32_t version = 1;
+    uint32_t record_size = sizeof(PerfRecord);
+    uint32_t stage_count = PIPELINE_STAGE_COUNT;
+    uint32_t reserved = 0;
+    uint64_t created_unix_ns = 0;
+};
+
+static_assert(sizeof(PerfLogHeader) == 32, "PerfLogHeader layout is part of the file format");
+
+/**
+ * @brief Appends PerfRecords to rotating binary files from a background thread
+ *
+ * submit() copies the record onto a lock-free queue and returns; a full
+ * queue drops the record and counts it. The writer thread batches records
+ * into a buffered file, rotates by size and prunes old files.
+ */
+class PerfLog {
+public:
+    /**
+     * @brief Get singleton performance log
+     */
+    static PerfLog& instance();
+
+    /**
+     * @brief Apply configuration and start the writer thread if enabled
+     * @param config Performance log settings
+     * @return Success or error (directory not writable, already running, etc.)
+     *
+     * Refused while the writer runs, because submitters may be pushing onto
+     * the queue; call stop() first.
+     */
+    Result<void> configure(const PerfLogConfig& config);
+
+    /**
+     * @brief Flush and stop the writer thread
+     */
+    void stop();
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Queue a record for writing
+     *
+     * Performance: lock-free, no allocation, never blocks
+     */
+    void submit(const PerfRecord& record) noexcept;
+
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Read every record of a performance log file
+     * @param path File written by PerfLog
+     * @return Records or error (missing file, bad header, incompatible layout)
+     */
+    static Result<std::vector<PerfRecord>> read_file(const std::string& path);
+
+    /**
+     * @brief Stream every record of a performance log file
+     * @param path File written by PerfLog
+     * @param visit Called once per record, in file order
+     * @return Number of records visited or error
+     *
+     * Reads in fixed-size batches, so memory does not grow with the file.
+     */
+    static Result<size_t> read_file(const std::string& path,
+                                    const std::function<void(const PerfRecord&)>& visit);
+
+private:
+    PerfLog() = default;
+    ~PerfLog();
+
+    PerfLog(const PerfLog&) = delete;
+    PerfLog& operator=(const PerfLog&) = delete;
+
+    void run();
+    bool open_next_file();
+    void prune_old_files();
+
+    PerfLogConfig config_;
+    std::unique_ptr<MpmcQueue<PerfRecord>> queue_;
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::thread writer_;
+
+    // Writer thread state
+    std::FILE* file_ = nullptr;
+    uint64_t file_bytes_ = 0;
+    std::vector<char> file_buffer_;
+};
+
+} // namespace dmp
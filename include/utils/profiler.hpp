@@ -0,0 +1,161 @@
+/**
+ * @file profiler.hpp
+ * @brief In-process sampling CPU profiler writing folded stacks for flame graphs
+ * @author Stan Jiang
+ * @date 2025-09-15
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "common/config.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dmp {
+
+template<typename T>
+class MpmcQueue;
+
+/**
+ * @brief Counters of the current (or last) profiling session
+ */
+struct ProfilerStats {
+    bool running = false;
+    uint64_t samples = 0;         // Stacks folded into the profile
+    uint64_t dropped = 0;         // Samples lost because the queue was full
+    uint64_t unique_stacks = 0;
+    uint64_t elapsed_ms = 0;
+    std::string last_output;      // Path of the last written profile
+};
+
+/**
+ * @brief Process-wide sampling profiler
+ *
+ * While a session runs, ITIMER_PROF delivers SIGPROF at frequency_hz per
+ * second of process CPU time to the thread that is consuming it. The
+ * handler walks the interrupted thread's frame-pointer chain (reading
+ * each frame with process_vm_readv, so a corrupt chain ends the walk
+ * instead of faulting) and pushes the return addresses into a lock-free
+ * queue. A drain thread folds them into a stack -> count map; stopping
+ * symbolizes the stacks with dladdr and writes Brendan Gregg's folded
+ * format ("thread;outer;...;leaf count"), ready for flamegraph.pl or
+ * speedscope.
+ *
+ * Stacks are only complete through code built with frame pointers
+ * (-DDMP_ENABLE_FRAME_POINTERS=ON, the default). Static functions are
+ * named when the executable exports its symbols (ENABLE_EXPORTS);
+ * anything else is written as module+0xoffset for offline addr2line.
+ *
+ * Sessions are started and stopped from /debug/profile on the metrics
+ * listener, or toggled with SIGUSR2; a session stops by itself after
+ * max_duration_s. Linux only.
+ */
+class SamplingProfiler {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static SamplingProfiler& instance();
+
+    /**
+     * @brief Whether this build can profile at all
+     */
+    static constexpr bool supported() {
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Apply configuration and install the SIGUSR2 toggle
+     * @param config Profiler settings
+     * @return Error if the profiler is enabled but unsupported
+     */
+    Result<void> configure(const ProfilerConfig& config);
+
+    /**
+     * @brief Start a profiling session
+     * @param duration_s Stop and dump after this many seconds (0 = max_duration_s)
+     * @return Error if disabled, unsupported or already running
+     */
+    Result<void> start(uint32_t duration_s = 0);
+
+    /**
+     * @brief Stop the session and write the folded profile
+     * @return Path of the written file or error
+     */
+    Result<std::string> stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Counters of the current or last session
+     */
+    ProfilerStats stats() const;
+
+    /**
+     * @brief Stop any session (writing its profile) and the control thread
+     */
+    void shutdown();
+
+    /**
+     * @brief Folded-stack text of the samples collected so far
+     */
+    std::string folded() const;
+
+    struct Sample;
+
+private:
+    SamplingProfiler();
+    ~SamplingProfiler();
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    static void on_sigprof(int signo, siginfo_t* info, void* context);
+    static void on_toggle(int signo);
+
+    void control_loop();
+    void drain();
+    Result<std::string> stop_locked();
+    std::string folded_locked() const;
+    bool arm_timer(uint32_t frequency_hz);
+    void disarm_timer();
+
+    ProfilerConfig config_;
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<bool> toggle_requested_{false};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<int> handlers_in_flight_{0};
+    std::atomic<uint32_t> max_depth_{64};
+    std::unique_ptr<MpmcQueue<Sample>> queue_;
+
+    // Session state (guarded by session_mutex_)
+    mutable std::mutex session_mutex_;
+    std::map<std::pair<std::string, std::vector<uintptr_t>>, uint64_t> stacks_;  // (thread, frames leaf first)
+    uint64_t samples_ = 0;
+    std::chrono::steady_clock::time_point started_at_;
+    std::chrono::steady_clock::time_point stop_at_;
+    std::chrono::steady_clock::time_point stopped_at_;
+    std::string last_output_;
+
+    // Control thread: drains the queue, honours SIGUSR2 and the time limit
+    std::mutex control_mutex_;
+    std::condition_variable control_cv_;
+    bool control_stop_ = false;
+    std::thread control_thread_;
+};
+
+} // namespace dmp
@@ -0,0 +1,149 @@
+/**
+ * @file prometheus_exporter.hpp
+ * @brief Prometheus text-format exposition endpoint for DMP metrics
+ * @author Stan Jiang
+ * @date 2025-09-04
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "utils/metrics.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dmp {
+
+/**
+ * @brief Minimal HTTP/1.1 listener serving merged metrics
+ *
+ * Runs a single background accept loop; scrapes are infrequent, so one
+ * connection at a time is plenty and keeps the exporter off the request
+ * path entirely. Rendering is cached for a configurable interval and the
+ * per-series text prefixes (name plus escaped labels) are built once per
+ * series, so scrape cost stays flat as label cardinality grows.
+ */
+class PrometheusExporter {
+public:
+    /**
+     * @brief Handler for additional routes (e.g. admin endpoints)
+     * @param query Raw query string without the leading '?'
+     * @return Response body (served as text/plain)
+     */
+    using RouteHandler = std::function<std::string(const std::string& query)>;
+
+    /**
+     * @brief Response of a route that chooses its status (e.g. 503 from probes)
+     */
+    struct RouteResponse {
+        int status = 200;  // e.g. 200, 409 or 503
+        std::string body;
+    };
+
+    using StatusRouteHandler = std::function<RouteResponse(const std::string& query)>;
+
+    /**
+     * @brief Constructor
+     * @param collector Metrics source to render
+     */
+    explicit PrometheusExporter(MetricsCollector& collector);
+
+    /**
+     * @brief Destructor - stops the listener
+     */
+    ~PrometheusExporter();
+
+    PrometheusExporter(const PrometheusExporter&) = delete;
+    PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+    /**
+     * @brief Bind and start serving
+     * @param port TCP port (0 picks an ephemeral port)
+     * @param path Metrics path (e.g. "/metrics")
+     * @param render_cache_ms Minimum interval between full re-renders
+     * @return Result indicating success or bind failure
+     */
+    Result<void> start(uint16_t port, const std::string& path, uint32_t render_cache_ms = 1000);
+
+    /**
+     * @brief Stop serving and join the listener thread
+     */
+    void stop();
+
+    /**
+     * @brief Register an extra GET route served by the same listener
+     * @param path Exact request path
+     * @param handler Handler producing the response body
+     */
+    void add_route(const std::string& path, RouteHandler handler);
+
+    /**
+     * @brief Register an extra GET route that sets its own status code
+     * @param path Exact request path
+     * @param handler Handler producing status and body
+     */
+    void add_status_route(const std::string& path, StatusRouteHandler handler);
+
+    /**
+     * @brief Register a POST route, for admin actions with side effects
+     * @param path Exact request path; may also have a GET route
+     * @param handler Handler producing status and body
+     *
+     * Anything that starts work or writes files goes here, so a crawler or
+     * a stray GET on the metrics port cannot trigger it.
+     */
+    void add_post_route(const std::string& path, StatusRouteHandler handler);
+
+    /**
+     * @brief Render metrics in Prometheus text format (cached)
+     * @return Exposition body
+     *
+     * Thread-safe: Yes
+     */
+    std::string render();
+
+    /**
+     * @brief Actual bound port (useful when started with port 0)
+     */
+    uint16_t bound_port() const { return bound_port_.load(); }
+
+    bool is_running() const { return running_.load(); }
+
+private:
+    void serve_loop();
+    void handle_connection(int client_fd);
+    std::string render_uncached(const MetricsSnapshot& snapshot);
+    const std::string& series_prefix(const LabeledSeriesValue& series);
+
+    MetricsCollector& collector_;
+    std::string path_;
+    uint32_t render_cache_ms_ = 1000;
+
+    int listen_fd_ = -1;
+    std::atomic<uint16_t> bound_port_{0};
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> serve_thread_;
+
+    struct Route {
+        std::string method;
+        std::string path;
+        StatusRouteHandler handler;
+    };
+    void add_method_route(const std::string& method, const std::string& path, StatusRouteHandler handler);
+
+    std::mutex routes_mutex_;
+    std::vector<Route> routes_;
+
+    // Render cache
+    std::mutex render_mutex_;
+    std::string cached_body_;
+    std::chrono::steady_clock::time_point cached_at_{};
+    std::vector<std::string> series_prefixes_;  // Indexed by series id
+};
+
+} // namespace dmp
@@ -0,0 +1,224 @@
+/**
+ * @file structured_log.hpp
+ * @brief Binary structured log events formatted off the request path
+ * @author Stan Jiang
+ * @date 2025-09-08
+ */
+#pragma once
+
+#include "utils/logger.hpp"
+#include "utils/mpmc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+namespace dmp {
+
+/**
+ * @brief Static description of one LOG_EVENT_* call site
+ *
+ * Lives in static storage at the call site, so records only carry a pointer.
+ */
+struct LogEventSite {
+    const char* event;
+    spdlog::level::level_enum level;
+    spdlog::source_loc location;
+};
+
+/**
+ * @brief One key/value pair of a structured event, stored by value
+ *
+ * Strings are copied into a small inline buffer (truncated if longer), so
+ * a field never refers to memory owned by the caller.
+ */
+struct LogField {
+    enum class Type : uint8_t { NONE = 0, INT, UINT, DOUBLE, BOOL, TEXT };
+
+    static constexpr size_t kInlineText = 40;
+
+    const char* key = nullptr;   // Must point to static storage (string literal)
+    Type type = Type::NONE;
+    bool truncated = false;
+    uint8_t text_length = 0;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        bool b;
+    } value{};
+    char text[kInlineText];
+};
+
+/**
+ * @brief Make a structured field
+ * @param key Field name (string literal)
+ * @param value Integer, floating point, bool or string-like value
+ */
+template<typename T>
+inline LogField kv(const char* key, const T& value) noexcept {
+    LogField field;
+    field.key = key;
+    if constexpr (std::is_same_v<T, bool>) {
+        field.type = LogField::Type::BOOL;
+        field.value.b = value;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        field.type = LogField::Type::INT;
+        field.value.i = static_cast<int64_t>(value);
+    } else if constexpr (std::is_integral_v<T>) {
+        field.type = LogField::Type::UINT;
+        field.value.u = static_cast<uint64_t>(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        field.type = LogField::Type::DOUBLE;
+        field.value.d = static_cast<double>(value);
+    } else {
+        std::string_view text(value);
+        field.type = LogField::Type::TEXT;
+        field.truncated = text.size() > LogField::kInlineText;
+        field.text_length = static_cast<uint8_t>(field.truncated ? LogField::kInlineText : text.size());
+        std::memcpy(field.text, text.data(), field.text_length);
+    }
+    return field;
+}
+
+/**
+ * @brief Fixed-size event record queued for the formatting thread
+ */
+struct LogRecord {
+    static constexpr size_t kMaxFields = 8;
+
+    spdlog::log_clock::time_point time;
+    TraceId trace_id;
+    const LogEventSite* site = nullptr;
+    uint8_t field_count = 0;
+    LogField fields[kMaxFields];
+};
+
+/**
+ * @brief Queue of binary log records with a background formatter
+ *
+ * emit() copies the fields into a fixed-size record and pushes it onto a
+ * lock-free queue; text formatting and the hand-off to spdlog happen on
+ * the formatter thread. A full queue drops the record and counts it
+ * rather than blocking the caller. Before start() (and after stop())
+ * records are formatted inline. The idle formatter sleeps on a condition
+ * variable; emitters only signal it when it is actually asleep.
+ */
+class StructuredLogger {
+public:
+    /**
+     * @brief Get singleton structured logger
+     */
+    static StructuredLogger& instance();
+
+    /**
+     * @brief Start the formatter thread
+     * @param queue_capacity Maximum queued records (rounded up to a power of two)
+     *
+     * The queue is allocated by the first start() and kept for the logger's
+     * lifetime, so emitters never observe it being replaced; the capacity
+     * of later calls is ignored.
+     */
+    void start(size_t queue_capacity = 4096);
+
+    /**
+     * @brief Drain pending records and stop the formatter thread
+     *
+     * Waits for emit() calls already queueing a record, so every record
+     * pushed before stop() returns is written.
+     */
+    void stop();
+
+    /**
+     * @brief Record an event
+     * @param site Call site description
+     * @param fields Up to LogRecord::kMaxFields fields (extra fields are ignored)
+     *
+     * Performance: no allocation and no formatting on the calling thread
+     */
+    void emit(const LogEventSite& site, std::initializer_list<LogField> fields) noexcept;
+
+    /**
+     * @brief Records dropped because the queue was full
+     */
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Render a record as "event key=value ..." (used by the formatter)
+     */
+    static void format_record(const LogRecord& record, fmt::memory_buffer& out);
+
+private:
+    StructuredLogger() = default;
+    ~StructuredLogger();
+
+    StructuredLogger(const StructuredLogger&) = delete;
+    StructuredLogger& operator=(const StructuredLogger&) = delete;
+
+    void run();
+    void wake_worker();
+    static void write(const LogRecord& record);
+
+    std::unique_ptr<MpmcQueue<LogRecord>> queue_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> in_flight_{0};   // emit() calls between the running_ check and the push
+    std::atomic<uint64_t> dropped_{0};
+    std::mutex lifecycle_mutex_;           // Serializes start() and stop()
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> sleeping_{false};    // Formatter waiting on wake_
+    std::thread worker_;
+};
+
+} // namespace dmp
+
+// Structured event macros
+//
+// Usage: LOG_EVENT_DEBUG("rule_evaluated", dmp::kv("rule", rule.id), dmp::kv("score", score));
+// Arguments are evaluated only when the level is enabled, and levels below
+// DMP_LOG_ACTIVE_LEVEL are compiled out.
+#define DMP_LOG_EVENT(level, event, ...) \
+    do { \
+        if (dmp::Logger::should_log(level)) { \
+            static const dmp::LogEventSite _dmp_event_site{ \
+                event, level, spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}}; \
+            dmp::StructuredLogger::instance().emit(_dmp_event_site, {__VA_ARGS__}); \
+        } \
+    } while(0)
+
+#define DMP_LOG_EVENT_COMPILED_OUT(level, event, ...) \
+    do { \
+        if (false) { \
+            (void)std::initializer_list<dmp::LogField>{__VA_ARGS__}; \
+        } \
+    } while(0)
+
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_ERROR
+#define LOG_EVENT_ERROR(event, ...) DMP_LOG_EVENT(spdlog::level::err, event, ##__VA_ARGS__)
+#else
+#define LOG_EVENT_ERROR(event, ...) DMP_LOG_EVENT_COMPILED_OUT(spdlog::level::err, event, ##__VA_ARGS__)
+#endif
+
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_INFO
+#define LOG_EVENT_INFO(event, ...) DMP_LOG_EVENT(spdlog::level::info, event, ##__VA_ARGS__)
+#else
+#define LOG_EVENT_INFO(event, ...) DMP_LOG_EVENT_COMPILED_OUT(spdlog::level::info, event, ##__VA_ARGS__)
+#endif
+
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_DEBUG
+#define LOG_EVENT_DEBUG(event, ...) DMP_LOG_EVENT(spdlog::level::debug, event, ##__VA_ARGS__)
+#else
+#define LOG_EVENT_DEBUG(event, ...) DMP_LOG_EVENT_COMPILED_OUT(spdlog::level::debug, event, ##__VA_ARGS__)
+#endif
+
+#if DMP_LOG_ACTIVE_LEVEL <= DMP_LOG_LEVEL_TRACE
+#define LOG_EVENT_TRACE(event, ...) DMP_LOG_EVENT(spdlog::level::trace, event, ##__VA_ARGS__)
+#else
+#define LOG_EVENT_TRACE(event, ...) DMP_LOG_EVENT_COMPILED_OUT(spdlog::level::trace, event, ##__VA_ARGS__)
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file trace_id.hpp
+ * @brief 128-bit trace identifier value type
+ * @author Stan Jiang
+ * @date 2025-09-07
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace dmp {
+
+/**
+ * @brief 128-bit trace id (W3C trace-context compatible)
+ *
+ * Trivially copyable and zero-initialized; an all-zero id means "no trace".
+ * Ids are drawn from a per-thread xoshiro256** generator, so generation
+ * takes no locks, and they are only turned into hex text when written out.
+ */
+struct TraceId {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    static constexpr size_t kHexLength = 32;
+
+    constexpr bool empty() const noexcept { return high == 0 && low == 0; }
+
+    /**
+     * @brief Generate a random non-empty id from the calling thread's generator
+     */
+    static TraceId generate() noexcept;
+
+    /**
+     * @brief Parse a 32-character hex id
+     * @param hex Hex text (case-insensitive)
+     * @return Parsed id, or an empty id if the text is malformed
+     */
+    static TraceId from_hex(std::string_view hex) noexcept;
+
+    /**
+     * @brief Write exactly kHexLength lowercase hex characters (no terminator)
+     * @param out Destination buffer of at least kHexLength bytes
+     */
+    void format_to(char* out) const noexcept {
+        static constexpr char kDigits[] = "0123456789abcdef";
+        for (int i = 0; i < 16; ++i) {
+            out[i] = kDigits[(high >> (60 - 4 * i)) & 0xf];
+            out[16 + i] = kDigits[(low >> (60 - 4 * i)) & 0xf];
+        }
+    }
+
+    /**
+     * @brief Hex text (empty string for an empty id)
+     */
+    std::string to_string() const;
+
+    friend constexpr bool operator==(const TraceId& a, const TraceId& b) noexcept {
+        return a.high == b.high && a.low == b.low;
+    }
+    friend constexpr bool operator!=(const TraceId& a, const TraceId& b) noexcept {
+        return !(a == b);
+    }
+};
+
+} // namespace dmp
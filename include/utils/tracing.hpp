@@ -0,0 +1,260 @@
+/**
+ * @file tracing.hpp
+ * @brief Low-overhead per-stage request tracing for DMP risk control
+ * @author Stan Jiang
+ * @date 2025-09-06
+ */
+#pragma once
+
+#include "common/types.hpp"
+#include "common/config.hpp"
+#include "utils/trace_id.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace dmp {
+
+/**
+ * @brief Read the CPU timestamp counter (steady nanoseconds where unavailable)
+ */
+inline uint64_t read_tsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief One completed pipeline stage of one request
+ */
+struct SpanRecord {
+    TraceId trace_id;          // Trace the request belongs to
+    uint64_t request_id = 0;   // Hash of the request id (0 until known)
+    uint64_t start_tsc = 0;
+    uint64_t end_tsc = 0;
+    uint32_t thread_index = 0; // Recording thread (stable small integer)
+    PipelineStage stage = PipelineStage::DECISION;
+    uint8_t flags = 0;         // SpanRecord::kSampled | SpanRecord::kSlow
+
+    static constexpr uint8_t kSampled = 0x1;  // Kept by the sampling rate
+    static constexpr uint8_t kSlow = 0x2;     // Kept because the request was slow
+};
+
+/**
+ * @brief Trace export file formats
+ */
+enum class TraceExportFormat : uint8_t {
+    CHROME = 0,  // chrome://tracing / Perfetto JSON
+    OTLP_JSON    // OpenTelemetry OTLP/JSON (ExportTraceServiceRequest)
+};
+
+/**
+ * @brief Process-wide span recorder
+ *
+ * Spans of the request running on a thread are buffered in a small
+ * thread-local scratch area. When the request ends it is kept only if it
+ * was sampled (deterministically by trace id) or slower than the slow
+ * threshold; kept spans are copied into the thread's ring buffer, which
+ * overwrites its oldest entries. The request path takes no locks and
+ * performs no allocation; exporters read the rings on demand.
+ *
+ * When the PerfLog is enabled every request is also summarized into a
+ * PerfRecord (per-stage durations) regardless of the sampling decision.
+ */
+class Tracer {
+public:
+    /**
+     * @brief Get singleton tracer
+     */
+    static Tracer& instance();
+
+    /**
+     * @brief Apply tracing configuration
+     * @param config Tracing settings
+     */
+    void configure(const TracingConfig& config);
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Start buffering spans for a request on the calling thread
+     *
+     * Spans are attributed to the thread's current trace id (see
+     * TraceContext); a fresh id is used when none is set.
+     */
+    void begin_request();
+
+    /**
+     * @brief Attach the request id once known (e.g. after parsing)
+     * @param request_id External request identifier
+     *
+     * Stored as a hash so spans stay fixed-size; exports carry it next to
+     * the trace id for joining against request logs.
+     */
+    void set_request_id(std::string_view request_id);
+
+    /**
+     * @brief Finish the current request and keep its spans if selected
+     */
+    void end_request();
+
+    /**
+     * @brief Record a completed stage for the current request
+     * @param stage Pipeline stage
+     * @param start_tsc Start timestamp from read_tsc()
+     * @param end_tsc End timestamp from read_tsc()
+     */
+    void record_span(PipelineStage stage, uint64_t start_tsc, uint64_t end_tsc);
+
+    /**
+     * @brief Record how long the current request waited before processing
+     * @param wait_ns Queue wait in nanoseconds
+     */
+    void record_queue_wait(uint64_t wait_ns);
+
+    /**
+     * @brief Record the outcome of the current request for the PerfLog
+     * @param decision Final decision
+     * @param error true if the request failed
+     *
+     * Requests that end without an outcome are logged as errors.
+     */
+    void record_outcome(Decision decision, bool error = false);
+
+    /**
+     * @brief Check whether the calling thread is inside a request
+     */
+    bool request_active() const;
+
+    /**
+     * @brief Copy all retained spans, ordered by start time
+     *
+     * Thread-safe: Yes, may run concurrently with recording threads
+     */
+    std::vector<SpanRecord> collect() const;
+
+    /**
+     * @brief Write retained spans to a file
+     * @param format Output format
+     * @param path Destination file
+     * @return Number of spans written or error
+     */
+    Result<size_t> export_to_file(TraceExportFormat format, const std::string& path) const;
+
+    /**
+     * @brief Write retained spans to a timestamped file in the export directory
+     * @param format Output format
+     * @return Path of the written file or error
+     */
+    Result<std::string> export_snapshot(TraceExportFormat format) const;
+
+    /**
+     * @brief Convert a timestamp counter delta to nanoseconds
+     */
+    double ticks_to_ns(uint64_t ticks) const;
+
+    /**
+     * @brief Convert a timestamp counter value to Unix epoch nanoseconds
+     */
+    uint64_t tsc_to_unix_ns(uint64_t tsc) const;
+
+    struct SpanRing;
+
+private:
+    Tracer();
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    friend struct SpanRingLease;
+
+    SpanRing& local_ring();
+    void release_ring(SpanRing* ring);
+    void calibrate();
+    std::string render(TraceExportFormat format, const std::vector<SpanRecord>& spans) const;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint64_t> sample_threshold_{0};     // sample if trace_id.low < threshold
+    std::atomic<uint64_t> slow_threshold_ticks_{UINT64_MAX};
+    std::atomic<uint32_t> ring_capacity_{8192};
+    std::string export_directory_ = "logs/traces";
+
+    // Clock anchors: tsc_anchor_ corresponds to unix_anchor_ns_
+    uint64_t tsc_anchor_ = 0;
+    uint64_t unix_anchor_ns_ = 0;
+    std::chrono::steady_clock::time_point steady_anchor_;
+    std::atomic<double> ns_per_tick_{1.0};  // Calibrated by the constructor
+
+    mutable std::mutex rings_mutex_;
+    std::vector<std::unique_ptr<SpanRing>> rings_;
+    std::vector<SpanRing*> free_rings_;
+};
+
+/**
+ * @brief RAII request scope: begin_request / end_request
+ */
+class TraceRequestScope {
+public:
+    TraceRequestScope();
+    ~TraceRequestScope();
+
+    TraceRequestScope(const TraceRequestScope&) = delete;
+    TraceRequestScope& operator=(const TraceRequestScope&) = delete;
+
+private:
+    bool active_;
+};
+
+/**
+ * @brief RAII stage span; free when no traced request is active
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(PipelineStage stage)
+        : stage_(stage)
+        , start_tsc_(Tracer::instance().request_active() ? read_tsc() : 0) {
+    }
+
+    ~TraceSpan() {
+        if (start_tsc_ != 0) {
+            Tracer::instance().record_span(stage_, start_tsc_, read_tsc());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    PipelineStage stage_;
+    uint64_t start_tsc_;
+};
+
+#define DMP_TRACE_CONCAT_INNER(a, b) a##b
+#define DMP_TRACE_CONCAT(a, b) DMP_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief Trace the enclosing scope as one pipeline stage
+ *
+ * Usage:
+ * {
+ *     DMP_TRACE_SPAN(PipelineStage::RULE_EVALUATION);
+ *     // ... stage work ...
+ * }
+ */
+#define DMP_TRACE_SPAN(stage) \
+    dmp::TraceSpan DMP_TRACE_CONCAT(_dmp_span_, __LINE__)(stage)
+
+} // namespace dmp
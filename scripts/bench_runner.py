@@ -0,0 +1,304 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+DMP 微基准运行器与回归门禁
+运行全部 bench_* 程序，写出带提交号/CPU/编译参数的 JSON 结果，
+并与存储的基线按噪声自适应阈值比较。
+
+退出码: 0 无显著回归, 1 存在回归, 2 运行失败,
+        77 跳过（基线缺失，或 CPU/构建参数与基线不同；对应 ctest SKIP_RETURN_CODE）
+"""
+
+import argparse
+import datetime
+import json
+import math
+import os
+import platform
+import re
+import subprocess
+import sys
+import tempfile
+from typing import Dict, List, Optional
+
+SCHEMA_VERSION = 1
+EXIT_SKIPPED = 77
+
+
+def run_command(args: List[str], cwd: Optional[str] = None) -> str:
+    """执行命令并返回去掉首尾空白的输出，失败时返回空串"""
+    try:
+        return subprocess.run(args, cwd=cwd, capture_output=True, text=True, check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return ""
+
+
+def cpu_model() -> str:
+    """CPU 型号（Linux 读 /proc/cpuinfo，macOS 用 sysctl）"""
+    try:
+        with open("/proc/cpuinfo", encoding="utf-8") as cpuinfo:
+            for line in cpuinfo:
+                if line.startswith("model name") or line.startswith("Model"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return run_command(["sysctl", "-n", "machdep.cpu.brand_string"]) or platform.processor() or "unknown"
+
+
+def build_info(build_dir: str) -> Dict[str, str]:
+    """从 CMakeCache.txt 读取构建类型、编译器与编译参数"""
+    cache: Dict[str, str] = {}
+    try:
+        with open(os.path.join(build_dir, "CMakeCache.txt"), encoding="utf-8") as cache_file:
+            for line in cache_file:
+                match = re.match(r"^([A-Za-z0-9_]+):[A-Z]+=(.*)$", line.rstrip("\n"))
+                if match:
+                    cache[match.group(1)] = match.group(2)
+    except OSError:
+        pass
+    build_type = cache.get("CMAKE_BUILD_TYPE", "")
+    flags = " ".join(filter(None, [cache.get("CMAKE_CXX_FLAGS", ""),
+                                   cache.get(f"CMAKE_CXX_FLAGS_{build_type.upper()}", "")]))
+    return {
+        "type": build_type,
+        "compiler": cache.get("CMAKE_CXX_COMPILER", ""),
+        "compiler_version": run_command([cache["CMAKE_CXX_COMPILER"], "-dumpversion"])
+        if cache.get("CMAKE_CXX_COMPILER") else "",
+        "flags": flags,
+        "alloc_tracking": cache.get("DMP_ENABLE_ALLOC_TRACKING", "OFF"),
+    }
+
+
+def write_json(path: str, data: Dict) -> None:
+    """写出格式化的 JSON 文件"""
+    with open(path, "w", encoding="utf-8") as output:
+        json.dump(data, output, indent=2, ensure_ascii=False)
+
+
+def discover_benchmarks(build_dir: str) -> List[str]:
+    """在构建目录中查找 bench_* 可执行文件"""
+    found = []
+    for root, _, files in os.walk(build_dir):
+        if "CMakeFiles" in root:
+            continue
+        for name in files:
+            path = os.path.join(root, name)
+            if name.startswith("bench_") and os.access(path, os.X_OK) and "." not in name:
+                found.append(path)
+    return sorted(found)
+
+
+def run_benchmark(path: str, min_time_ms: int, repetitions: int, case_filter: str = "") -> Optional[Dict]:
+    """运行一个基准程序并读取其 --json 输出"""
+    with tempfile.NamedTemporaryFile(suffix=".json", delete=False) as handle:
+        json_path = handle.name
+    command = [path, "--json", json_path, "--min-time-ms", str(min_time_ms), "--repetitions", str(repetitions)]
+    if case_filter:
+        command += ["--filter", case_filter]
+    try:
+        try:
+            completed = subprocess.run(command, capture_output=True, text=True)
+        except OSError as error:
+            print(f"❌ 无法运行 {path}: {error}")
+            return None
+        if completed.returncode != 0:
+            print(f"❌ {path} 退出码 {completed.returncode}\n{completed.stderr}")
+            return None
+        with open(json_path, encoding="utf-8") as result_file:
+            suite = json.load(result_file)
+        suite["path"] = path
+        return suite
+    finally:
+        os.unlink(json_path)
+
+
+def run_benchmarks(paths: List[str], min_time_ms: int, repetitions: int) -> Optional[List[Dict]]:
+    """逐个运行基准程序并收集结果"""
+    suites = []
+    for path in paths:
+        print(f"⏱️  运行 {os.path.basename(path)} ...", flush=True)
+        suite = run_benchmark(path, min_time_ms, repetitions)
+        if suite is None:
+            return None
+        suites.append(suite)
+    return suites
+
+
+def timing_regressions(baseline: Dict, current: Dict, threshold_pct: float, noise_k: float,
+                       min_delta_ns: float) -> List[tuple]:
+    """返回耗时超出阈值的 (套件, 用例) 列表"""
+    base_cases = {(suite["suite"], case["name"]): case
+                  for suite in baseline.get("suites", []) for case in suite.get("benchmarks", [])}
+    flagged = []
+    for suite in current["suites"]:
+        for case in suite["benchmarks"]:
+            base = base_cases.get((suite["suite"], case["name"]))
+            if base and classify(base, case, threshold_pct, noise_k, min_delta_ns)[0] > 0:
+                flagged.append((suite, case))
+    return flagged
+
+
+def classify(base: Dict, case: Dict, threshold_pct: float, noise_k: float,
+             min_delta_ns: float) -> tuple:
+    """
+    比较单个用例耗时，返回 (方向, 变化%, 阈值%)，方向 1 变慢 / -1 变快 / 0 持平
+
+    阈值取 max(threshold_pct, noise_k × 两次运行变异系数的合成)，且变慢需超过 min_delta_ns。
+    """
+    delta_pct = (case["ns_per_op"] - base["ns_per_op"]) / base["ns_per_op"] * 100.0 \
+        if base["ns_per_op"] > 0 else 0.0
+    noise_pct = noise_k * math.hypot(base.get("cv_percent", 0.0), case.get("cv_percent", 0.0))
+    limit_pct = max(threshold_pct, noise_pct)
+    if delta_pct > limit_pct and case["ns_per_op"] - base["ns_per_op"] > min_delta_ns:
+        return 1, delta_pct, limit_pct
+    if delta_pct < -limit_pct:
+        return -1, delta_pct, limit_pct
+    return 0, delta_pct, limit_pct
+
+
+def compare(baseline: Dict, current: Dict, threshold_pct: float, noise_k: float,
+            min_delta_ns: float, alloc_slack: float) -> int:
+    """
+    按用例比较耗时与分配次数，打印对比表并返回回归数量
+
+    分配次数是确定值，超过基线 alloc_slack 即视为回归。
+    """
+    base_cases = {f"{suite['suite']}/{case['name']}": case
+                  for suite in baseline.get("suites", []) for case in suite.get("benchmarks", [])}
+    regressions = 0
+    print(f"\n{'用例':<52} {'基线ns':>10} {'当前ns':>10} {'变化%':>8} {'阈值%':>7} {'分配':>12}  结论")
+    for suite in current["suites"]:
+        for case in suite["benchmarks"]:
+            key = f"{suite['suite']}/{case['name']}"
+            base = base_cases.pop(key, None)
+            if base is None:
+                print(f"{key:<52} {'-':>10} {case['ns_per_op']:>10.1f} {'':>8} {'':>7} {'':>12}  🆕 新用例")
+                continue
+            direction, delta_pct, limit_pct = classify(base, case, threshold_pct, noise_k, min_delta_ns)
+            more_allocs = case["allocs_per_op"] > base["allocs_per_op"] + alloc_slack
+            allocs = f"{base['allocs_per_op']:.1f}→{case['allocs_per_op']:.1f}"
+
+            if direction > 0 or more_allocs:
+                regressions += 1
+                verdict = "❌ 回归" + ("（分配增加）" if more_allocs and direction <= 0 else "")
+            elif direction < 0:
+                verdict = "🚀 提升"
+            else:
+                verdict = "✅"
+            print(f"{key:<52} {base['ns_per_op']:>10.1f} {case['ns_per_op']:>10.1f} "
+                  f"{delta_pct:>+8.1f} {limit_pct:>7.1f} {allocs:>12}  {verdict}")
+    for key in sorted(base_cases):
+        print(f"{key:<52} {'':>10} {'-':>10} {'':>8} {'':>7} {'':>12}  ⚠️  基线中存在但本次未运行")
+    return regressions
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="DMP 微基准运行器与回归门禁")
+    parser.add_argument("--build-dir", default="build", help="CMake 构建目录")
+    parser.add_argument("--source-dir", default=os.path.dirname(os.path.dirname(os.path.abspath(__file__))),
+                        help="源码目录（读取提交号）")
+    parser.add_argument("--bench", action="append", default=[], help="基准程序路径，可重复；缺省时自动发现")
+    parser.add_argument("--baseline", default="", help="基线 JSON 路径")
+    parser.add_argument("--results-dir", default="", help="结果存放目录（默认 <build-dir>/bench_results）")
+    parser.add_argument("--update-baseline", action="store_true", help="用本次结果覆盖基线")
+    parser.add_argument("--min-time-ms", type=int, default=500, help="每个用例的测量时长")
+    parser.add_argument("--repetitions", type=int, default=7, help="每个用例的重复次数")
+    parser.add_argument("--threshold-pct", type=float, default=10.0, help="耗时回归最小阈值 (%%)")
+    parser.add_argument("--noise-k", type=float, default=3.0, help="噪声阈值 = k × 合成变异系数")
+    parser.add_argument("--min-delta-ns", type=float, default=5.0, help="忽略小于该绝对差的变化")
+    parser.add_argument("--alloc-slack", type=float, default=0.5, help="每次操作允许多出的分配次数")
+    parser.add_argument("--confirm-runs", type=int, default=2,
+                        help="耗时疑似回归的用例单独重跑次数，取最快一次（过滤偶发噪声）")
+    parser.add_argument("--force", action="store_true", help="CPU 或构建参数与基线不同也照常判定")
+    args = parser.parse_args()
+
+    benches = args.bench or discover_benchmarks(args.build_dir)
+    if not benches:
+        print(f"❌ 在 {args.build_dir} 中没有找到 bench_* 程序")
+        return 2
+
+    commit = run_command(["git", "rev-parse", "HEAD"], cwd=args.source_dir) or "unknown"
+    dirty = bool(run_command(["git", "status", "--porcelain", "--untracked-files=no"], cwd=args.source_dir))
+    machine = {"cpu_model": cpu_model(), "build": build_info(args.build_dir)}
+
+    # 先判断能否比较，不可比时不必花十几分钟跑基准
+    baseline = None
+    if args.baseline and not args.update_baseline:
+        if not os.path.exists(args.baseline):
+            print(f"⏭️  没有基线 {args.baseline}，跳过（使用 --update-baseline 建立基线）")
+            return EXIT_SKIPPED
+        with open(args.baseline, encoding="utf-8") as baseline_file:
+            baseline = json.load(baseline_file)
+        mismatches = [field for field, base_value, value in [
+            ("CPU", baseline.get("cpu_model"), machine["cpu_model"]),
+            ("构建类型", baseline.get("build", {}).get("type"), machine["build"]["type"]),
+            ("编译参数", baseline.get("build", {}).get("flags"), machine["build"]["flags"]),
+            ("分配统计", baseline.get("build", {}).get("alloc_tracking"), machine["build"]["alloc_tracking"]),
+        ] if base_value != value]
+        if mismatches and not args.force:
+            print(f"⏭️  {', '.join(mismatches)} 与基线不同，结果不可比，跳过（--force 强制比较）")
+            return EXIT_SKIPPED
+
+    suites = run_benchmarks(benches, args.min_time_ms, args.repetitions)
+    if suites is None:
+        return 2
+
+    results = {
+        "schema": SCHEMA_VERSION,
+        "timestamp": datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds"),
+        "commit": commit,
+        "dirty": dirty,
+        "host": platform.node(),
+        "cpu_model": machine["cpu_model"],
+        "cpu_count": os.cpu_count(),
+        "build": machine["build"],
+        "suites": suites,
+    }
+
+    results_dir = args.results_dir or os.path.join(args.build_dir, "bench_results")
+    os.makedirs(results_dir, exist_ok=True)
+    stamp = datetime.datetime.now().strftime("%Y%m%d_%H%M%S")
+    results_path = os.path.join(results_dir, f"{stamp}_{commit[:12]}.json")
+    write_json(results_path, results)
+    print(f"📝 结果已写入 {results_path}")
+
+    if args.update_baseline:
+        if not args.baseline:
+            print("❌ --update-baseline 需要 --baseline")
+            return 2
+        os.makedirs(os.path.dirname(os.path.abspath(args.baseline)), exist_ok=True)
+        write_json(args.baseline, results)
+        print(f"📌 基线已更新: {args.baseline}")
+        return 0
+
+    if baseline is None:
+        print("ℹ️  未指定基线，只记录结果")
+        return 0
+    print(f"🔍 基线提交 {baseline.get('commit', 'unknown')[:12]} ({baseline.get('cpu_model', '?')})"
+          f" 对比 当前 {commit[:12]}{' (有未提交修改)' if dirty else ''}")
+
+    for _ in range(args.confirm_runs):
+        flagged = timing_regressions(baseline, results, args.threshold_pct, args.noise_k, args.min_delta_ns)
+        if not flagged:
+            break
+        print(f"🔁 {len(flagged)} 个用例疑似变慢，重跑确认 ...", flush=True)
+        for suite, case in flagged:
+            rerun = run_benchmark(suite["path"], args.min_time_ms, args.repetitions, case["name"])
+            if rerun is None:
+                return 2
+            for candidate in rerun["benchmarks"]:
+                if candidate["name"] == case["name"] and candidate["ns_per_op"] < case["ns_per_op"]:
+                    case.update(candidate)
+        write_json(results_path, results)
+
+    regressions = compare(baseline, results, args.threshold_pct, args.noise_k,
+                          args.min_delta_ns, args.alloc_slack)
+    if regressions:
+        print(f"\n❌ {regressions} 个用例显著回归")
+        return 1
+    print("\n✅ 没有显著回归")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -6,6 +6,7 @@
 #include <regex>
 #include <iostream>
 #include <iomanip>
+#include <utility>
 
 namespace dmp {
 
@@ -227,8 +228,13 @@ Result<MonitoringConfig> MonitoringConfig::from_toml(const toml::table& table) {
     
     try {
         if (auto monitoring_table = table["monitoring"].as_table()) {
+            // server.toml spells these enable_metrics / metrics_port; accept both
+            config.enable_prometheus = extract_bool(*monitoring_table, "enable_metrics",
+                                                   config.enable_prometheus);
             config.enable_prometheus = extract_bool(*monitoring_table, "enable_prometheus", 
                                                    config.enable_prometheus);
+            config.prometheus_port = extract_integer(*monitoring_table, "metrics_port",
+                                                    config.prometheus_port);
             config.prometheus_port = extract_integer(*monitoring_table, "prometheus_port", 
                                                     config.prometheus_port);
             config.metrics_interval_seconds = extract_integer(*monitoring_table, 
@@ -236,6 +242,10 @@ Result<MonitoringConfig> MonitoringConfig::from_toml(const toml::table& table) {
                                                              config.metrics_interval_seconds);
             config.metrics_path = extract_string(*monitoring_table, "metrics_path", 
                                                 config.metrics_path);
+            config.render_cache_ms = extract_integer(*monitoring_table, "render_cache_ms",
+                                                    config.render_cache_ms);
+            config.latency_window_seconds = extract_integer(*monitoring_table, "latency_window_seconds",
+                                                           config.latency_window_seconds);
         }
     } catch (const toml::parse_error& e) {
         return {config, ErrorCode::INVALID_JSON_FORMAT, 
@@ -252,12 +262,326 @@ Result<MonitoringConfig> MonitoringConfig::from_toml(const toml::table& table) {
 bool MonitoringConfig::is_valid() const {
     return is_valid_port(prometheus_port) &&
            metrics_interval_seconds > 0 && metrics_interval_seconds <= 3600 &&
+           render_cache_ms <= 60000 &&
+           latency_window_seconds >= metrics_interval_seconds && latency_window_seconds <= 3600 &&
            !metrics_path.empty() && metrics_path[0] == '/';
 }
 
+// TracingConfig implementation
+Result<TracingConfig> TracingConfig::from_toml(const toml::table& table) {
+    TracingConfig config;
+    
+    try {
+        if (auto tracing_table = table["tracing"].as_table()) {
+            config.enabled = extract_bool(*tracing_table, "enabled", config.enabled);
+            config.sample_rate = extract_double(*tracing_table, "sample_rate", config.sample_rate);
+            config.slow_request_threshold_ms = static_cast<float>(
+                extract_double(*tracing_table, "slow_request_threshold_ms",
+                              config.slow_request_threshold_ms));
+            config.ring_buffer_spans = extract_integer(*tracing_table, "ring_buffer_spans",
+                                                      config.ring_buffer_spans);
+            config.export_directory = extract_string(*tracing_table, "export_directory",
+                                                    config.export_directory);
+        }
+    } catch (const toml::parse_error& e) {
+        return {config, ErrorCode::INVALID_JSON_FORMAT, 
+               std::string("TOML parsing error: ") + e.what()};
+    }
+    
+    if (!config.is_valid()) {
+        return {config, ErrorCode::INVALID_REQUEST, "Invalid tracing configuration values"};
+    }
+    
+    return {config, ErrorCode::SUCCESS, ""};
+}
+
+bool TracingConfig::is_valid() const {
+    return sample_rate >= 0.0 && sample_rate <= 1.0 &&
+           slow_request_threshold_ms >= 0.0f &&
+           ring_buffer_spans >= 64 && ring_buffer_spans <= (1u << 20) &&
+           !export_directory.empty();
+}
+
+// PerfLogConfig implementation
+Result<PerfLogConfig> PerfLogConfig::from_toml(const toml::table& table) {
+    PerfLogConfig config;
+    
+    try {
+        if (auto perf_table = table["perf_log"].as_table()) {
+            config.enabled = extract_bool(*perf_table, "enabled", config.enabled);
+            config.directory = extract_string(*perf_table, "directory", config.directory);
+            config.max_file_mb = extract_integer(*perf_table, "max_file_mb", config.max_file_mb);
+            config.max_files = extract_integer(*perf_table, "max_files", config.max_files);
+            config.queue_capacity = extract_integer(*perf_table, "queue_capacity", config.queue_capacity);
+        }
+    } catch (const toml::parse_error& e) {
+        return {config, ErrorCode::INVALID_JSON_FORMAT, 
+               std::string("TOML parsing error: ") + e.what()};
+    }
+    
+    if (!config.is_valid()) {
+        return {config, ErrorCode::INVALID_REQUEST, "Invalid perf_log configuration values"};
+    }
+    
+    return {config, ErrorCode::SUCCESS, ""};
+}
+
+bool PerfLogConfig::is_valid() const {
+    return !directory.empty() &&
+           max_file_mb >= 1 && max_file_mb <= 65536 &&
+           max_files >= 1 &&
+           queue_capacity >= 64 && queue_capacity <= (1u << 24);
+}
+
+// HardwareCountersConfig implementation
+Result<HardwareCountersConfig> HardwareCountersConfig::from_toml(const toml::table& table) {
+    HardwareCountersConfig config;
+    
+    try {
+        if (auto counters_table = table["hardware_counters"].as_table()) {
+            config.enabled = extract_bool(*counters_table, "enabled", config.enabled);
+            config.sample_every = extract_integer(*counters_table, "sample_every", config.sample_every);
+        }
+    } catch (const toml::parse_error& e) {
+        return {config, ErrorCode::INVALID_JSON_FORMAT, 
+               std::string("TOML parsing error: ") + e.what()};
+    }
+    
+    if (!config.is_valid()) {
+        return {config, ErrorCode::INVALID_REQUEST, "Invalid hardware_counters configuration values"};
+    }
+    
+    return {config, ErrorCode::SUCCESS, ""};
+}
+
+bool HardwareCountersConfig::is_valid() const {
+    return sample_every >= 1 && sample_every <= 1000000;
+}
+
+// ProfilerConfig implementation
+Result<ProfilerConfig> ProfilerConfig::from_toml(const toml::table& table) {
+    ProfilerConfig config;
+    
+    try {
+        if (auto profiler_table = table["profiler"].as_table()) {
+            config.enabled = extract_bool(*profiler_table, "enabled", config.enabled);
+            config.frequency_hz = extract_integer(*profiler_table, "frequency_hz", config.frequency_hz);
+            config.max_stack_depth = extract_integer(*profiler_table, "max_stack_depth", config.max_stack_depth);
+            config.queue_capacity = extract_integer(*profiler_table, "queue_capacity", config.queue_capacity);
+            config.max_duration_s = extract_integer(*profiler_table, "max_duration_s", config.max_duration_s);
+            config.output_directory = extract_string(*profiler_table, "output_directory", config.output_directory);
+        }
+    } catch (const toml::parse_error& e) {
+        return {config, ErrorCode::INVALID_JSON_FORMAT, 
+               std::string("TOML parsing error: ") + e.what()};
+    }
+    
+    if (!config.is_valid()) {
+        return {config, ErrorCode::INVALID_REQUEST, "Invalid profiler configuration values"};
+    }
+    
+    return {config, ErrorCode::SUCCESS, ""};
+}
+
+bool ProfilerConfig::is_valid() const {
+    return frequency_hz >= 1 && frequency_hz <= 10000 &&
+           max_stack_depth >= 4 && max_stack_depth <= 128 &&
+           queue_capacity >= 64 && queue_capacity <= (1u << 20) &&
+           max_duration_s >= 1 &&
+           !output_directory.empty();
+}
+
+// MemoryConfig implementation
+Result<MemoryConfig> MemoryConfig::from_toml(const toml::table& table) {
+    MemoryConfig config;
+    
+    try {
+        if (auto perf_table = table["performance"].as_table()) {
+            config.pool_size_mb = extract_integer(*perf_table, "memory_pool_size_mb", config.pool_size_mb);
+        }
+        if (auto memory_table = table["memory"].as_table()) {
+            config.huge_pages = extract_string(*memory_table, "huge_pages", config.huge_pages);
+            config.numa_policy = extract_string(*memory_table, "numa_policy", config.numa_policy);
+            config.prefault = extract_bool(*memory_table, "prefault", config.prefault);
+            config.soft_limit_percent = extract_integer(*memory_table, "soft_limit_percent", config.soft_limit_percent);
+            config.hard_limit_percent = extract_integer(*memory_table, "hard_limit_percent", config.hard_limit_percent);
+            config.check_interval_ms = extract_integer(*memory_table, "check_interval_ms", config.check_interval_ms);
+        }
+    } catch (const toml::parse_error& e) {
+        return {config, ErrorCode::INVALID_JSON_FORMAT, 
+               std::string("TOML parsing error: ") + e.what()};
+    }
+    
+    if (!config.is_valid()) {
+        return {config, ErrorCode::INVALID_REQUEST, "Invalid memory configuration values"};
+    }
+    
+    return {config, ErrorCode::SUCCESS, ""};
+}
+
+bool MemoryConfig::is_valid() const {
+    return (huge_pages == "off" || huge_pages == "transparent" || huge_pages == "explicit") &&
+           (numa_policy == "local" || numa_policy == "interleave" || numa_policy == "shard") &&
+           pool_size_mb >= 1 && pool_size_mb <= (1u << 22) &&
+           soft_limit_percent >= 10 && soft_limit_percent < hard_limit_percent &&
+           hard_limit_percent <= 100 &&
+           check_interval_ms >= 10 && check_interval_ms <= 60000;
+}
+
+// WarmupConfig implementation
+Result<WarmupConfig> WarmupConfig::from_toml(const toml::table& table) {
+    WarmupConfig config;
+    
+    try {
+        if (auto warmup_table = table["warmup"].as_table()) {
+            config.enabled = extract_bool(*warmup_table, "enabled", config.enabled);
+            config.corpus_path = extract_string(*warmup_table, "corpus_path", config.corpus_path);
+            config.transactions_per_thread = extract_integer(*warmup_table, "transactions_per_thread",
+                                                             config.transactions_per_thread);
+            config.threads = extract_integer(*warmup_table, "threads", config.threads);
+            config.timeout_ms = extract_integer(*warmup_table, "timeout_ms", config.timeout_ms);
+            config.ready_on_failure = extract_bool(*warmup_table, "ready_on_failure", config.ready_on_failure);
+        }
+    } catch (const toml::parse_error& e) {
+        return {config, ErrorCode::INVALID_JSON_FORMAT, 
+               std::string("TOML parsing error: ") + e.what()};
+    }
+    
+    if (!config.is_valid()) {
+        return {config, ErrorCode::INVALID_REQUEST, "Invalid warmup configuration values"};
+    }
+    
+    return {config, ErrorCode::SUCCESS, ""};
+}
+
+bool WarmupConfig::is_valid() const {
+    return transactions_per_thread >= 1 && transactions_per_thread <= 10000000 &&
+           threads <= 1024 &&
+           timeout_ms >= 100 && timeout_ms <= 3600000;
+}
+
+// ReloadConfig implementation
+Result<ReloadConfig> ReloadConfig::from_toml(const toml::table& table) {
+    ReloadConfig config;
+    
+    try {
+        if (auto reload_table = table["reload"].as_table()) {
+            config.enabled = extract_bool(*reload_table, "enabled", config.enabled);
+            config.check_interval_ms = extract_integer(*reload_table, "check_interval_ms", config.check_interval_ms);
+            config.settle_ms = extract_integer(*reload_table, "settle_ms", config.settle_ms);
+            config.rules_path = extract_string(*reload_table, "rules_path", config.rules_path);
+            config.blacklist_path = extract_string(*reload_table, "blacklist_path", config.blacklist_path);
+            config.whitelist_path = extract_string(*reload_table, "whitelist_path", config.whitelist_path);
+            config.models_path = extract_string(*reload_table, "models_path", config.models_path);
+            config.preflight = extract_bool(*reload_table, "preflight", config.preflight);
+            config.preflight_corpus_size = extract_integer(*reload_table, "preflight_corpus_size", config.preflight_corpus_size);
+            config.rules_budget_ms = extract_double(*reload_table, "rules_budget_ms", config.rules_budget_ms);
+            config.patterns_budget_ms = extract_double(*reload_table, "patterns_budget_ms", config.patterns_budget_ms);
+        }
+    } catch (const toml::parse_error& e) {
+        return {config, ErrorCode::INVALID_JSON_FORMAT, 
+               std::string("TOML parsing error: ") + e.what()};
+    }
+    
+    if (!config.is_valid()) {
+        return {config, ErrorCode::INVALID_REQUEST, "Invalid reload configuration values"};
+    }
+    
+    return {config, ErrorCode::SUCCESS, ""};
+}
+
+bool ReloadConfig::is_valid() const {
+    return check_interval_ms >= 100 && check_interval_ms <= 3600000 &&
+           settle_ms <= 60000 &&
+           !rules_path.empty() && !blacklist_path.empty() &&
+           !whitelist_path.empty() && !models_path.empty() &&
+           preflight_corpus_size >= 1 && preflight_corpus_size <= 1000000 &&
+           rules_budget_ms > 0.0 && patterns_budget_ms > 0.0;
+}
+
+// ModelsConfig implementation
+Result<ModelsConfig> ModelsConfig::load_from_file(const std::string& config_path) {
+    ModelsConfig config;
+    
+    if (!std::filesystem::exists(config_path)) {
+        return {config, ErrorCode::INVALID_REQUEST, 
+               "Model configuration file does not exist: " + config_path};
+    }
+    
+    try {
+        toml::table table = toml::parse_file(config_path);
+        
+        for (const auto& [key, node] : table) {
+            const auto* model_table = node.as_table();
+            if (!model_table || !model_table->contains("path")) {
+                continue;
+            }
+            ModelSpec spec;
+            spec.key = std::string(key.str());
+            spec.name = extract_string(*model_table, "name", spec.key);
+            spec.path = extract_string(*model_table, "path", "");
+            spec.version = extract_string(*model_table, "version", "");
+            spec.enabled = extract_bool(*model_table, "enabled", spec.enabled);
+            spec.weight = static_cast<float>(extract_double(*model_table, "weight", spec.weight));
+            config.models.push_back(std::move(spec));
+        }
+        
+        if (auto inference_table = table["inference"].as_table()) {
+            config.batch_size = extract_integer(*inference_table, "batch_size", config.batch_size);
+            config.timeout_ms = extract_integer(*inference_table, "timeout_ms", config.timeout_ms);
+            config.threads = extract_integer(*inference_table, "threads", config.threads);
+            config.provider = extract_string(*inference_table, "provider", config.provider);
+        }
+    } catch (const toml::parse_error& e) {
+        return {config, ErrorCode::INVALID_JSON_FORMAT, 
+               std::string("TOML parsing failed: ") + e.what()};
+    }
+    
+    if (!config.is_valid()) {
+        return {config, ErrorCode::INVALID_REQUEST, "Invalid model configuration in " + config_path};
+    }
+    
+    // Model files are optional until an inference backend is built in
+    for (const auto& model : config.models) {
+        if (model.enabled && !std::filesystem::exists(model.path)) {
+            LOG_INFO("⚠️  Model {} file not found: {}", model.name, model.path);
+        }
+    }
+    
+    return {config, ErrorCode::SUCCESS, ""};
+}
+
+bool ModelsConfig::is_valid() const {
+    static const std::set<std::string> valid_providers = {
+        "CPU", "CUDA", "TensorRT", "OpenVINO"
+    };
+    for (const auto& model : models) {
+        if (model.path.empty() || model.weight < 0.0f) {
+            return false;
+        }
+    }
+    return batch_size >= 1 && batch_size <= 4096 &&
+           timeout_ms >= 1 &&
+           threads >= 1 && threads <= 256 &&
+           valid_providers.count(provider) > 0;
+}
+
+bool ConfigSnapshot::is_valid() const {
+    return server.is_valid() &&
+           feature.is_valid() &&
+           logging.is_valid() &&
+           monitoring.is_valid() &&
+           tracing.is_valid() &&
+           perf_log.is_valid() &&
+           hardware_counters.is_valid() &&
+           profiler.is_valid() &&
+           reload.is_valid() &&
+           memory.is_valid() &&
+           warmup.is_valid();
+}
+
 // SystemConfig static members
-std::shared_ptr<SystemConfig> SystemConfig::instance_;
-std::mutex SystemConfig::instance_mutex_;
+std::atomic<std::shared_ptr<SystemConfig>> SystemConfig::instance_;
 
 // SystemConfig implementation
 Result<std::shared_ptr<SystemConfig>> SystemConfig::load_from_file(const std::string& config_path) {
@@ -385,54 +709,86 @@ Result<void> SystemConfig::reload() {
                    std::string("TOML parsing failed: ") + e.what()};
         }
         
-        std::unique_lock<std::shared_mutex> lock(config_mutex_);
-        
         auto load_result = load_from_toml(toml_table);
         if (load_result.is_error()) {
             return load_result;
         }
         
-        // Update file modification time
+        // Record the new modification time so the file is not reloaded again
         auto file_time = std::filesystem::last_write_time(config_file_path_);
+        std::unique_lock<std::shared_mutex> lock(config_mutex_);
         last_modified_ = std::chrono::system_clock::from_time_t(
             std::chrono::duration_cast<std::chrono::seconds>(
                 file_time.time_since_epoch()).count());
         
-        LOG_INFO("Configuration reloaded successfully");
-        return {ErrorCode::SUCCESS, ""};
-        
     } catch (const std::exception& e) {
         return {ErrorCode::INTERNAL_ERROR, 
                std::string("Failed to reload configuration: ") + e.what()};
     }
+    
+    return {ErrorCode::SUCCESS, ""};
+}
+
+std::shared_ptr<const ConfigSnapshot> SystemConfig::snapshot() const {
+    return snapshot_.load(std::memory_order_acquire);
+}
+
+uint64_t SystemConfig::version() const {
+    return snapshot()->version;
+}
+
+void SystemConfig::publish(std::shared_ptr<ConfigSnapshot> snapshot) {
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    snapshot->version = snapshot_.load(std::memory_order_relaxed)->version + 1;
+    snapshot_.store(std::move(snapshot), std::memory_order_release);
 }
 
 ServerConfig SystemConfig::get_server_config() const {
-    std::shared_lock<std::shared_mutex> lock(config_mutex_);
-    return server_config_;
+    return snapshot()->server;
 }
 
 FeatureConfig SystemConfig::get_feature_config() const {
-    std::shared_lock<std::shared_mutex> lock(config_mutex_);
-    return feature_config_;
+    return snapshot()->feature;
 }
 
 LoggingConfig SystemConfig::get_logging_config() const {
-    std::shared_lock<std::shared_mutex> lock(config_mutex_);
-    return logging_config_;
+    return snapshot()->logging;
 }
 
 MonitoringConfig SystemConfig::get_monitoring_config() const {
-    std::shared_lock<std::shared_mutex> lock(config_mutex_);
-    return monitoring_config_;
+    return snapshot()->monitoring;
+}
+
+TracingConfig SystemConfig::get_tracing_config() const {
+    return snapshot()->tracing;
+}
+
+PerfLogConfig SystemConfig::get_perf_log_config() const {
+    return snapshot()->perf_log;
+}
+
+HardwareCountersConfig SystemConfig::get_hardware_counters_config() const {
+    return snapshot()->hardware_counters;
+}
+
+ProfilerConfig SystemConfig::get_profiler_config() const {
+    return snapshot()->profiler;
+}
+
+ReloadConfig SystemConfig::get_reload_config() const {
+    return snapshot()->reload;
+}
+
+MemoryConfig SystemConfig::get_memory_config() const {
+    return snapshot()->memory;
+}
+
+WarmupConfig SystemConfig::get_warmup_config() const {
+    return snapshot()->warmup;
 }
 
 bool SystemConfig::is_valid() const {
-    std::shared_lock<std::shared_mutex> lock(config_mutex_);
-    return server_config_.is_valid() &&
-           feature_config_.is_valid() &&
-           logging_config_.is_valid() &&
-           monitoring_config_.is_valid();
+    return snapshot()->is_valid();
 }
 
 std::string SystemConfig::get_config_path() const {
@@ -446,34 +802,86 @@ std::chrono::system_clock::time_point SystemConfig::get_last_modified() const {
 }
 
 Result<void> SystemConfig::load_from_toml(const toml::table& table) {
+    auto snapshot = std::make_shared<ConfigSnapshot>();
+    
     // Load server configuration
     auto server_result = ServerConfig::from_toml(table);
     if (server_result.is_error()) {
         return {server_result.error_code, "Server config: " + server_result.error_message};
     }
-    server_config_ = server_result.value;
+    snapshot->server = server_result.value;
     
     // Load feature configuration
     auto feature_result = FeatureConfig::from_toml(table);
     if (feature_result.is_error()) {
         return {feature_result.error_code, "Feature config: " + feature_result.error_message};
     }
-    feature_config_ = feature_result.value;
+    snapshot->feature = feature_result.value;
     
     // Load logging configuration
     auto logging_result = LoggingConfig::from_toml(table);
     if (logging_result.is_error()) {
         return {logging_result.error_code, "Logging config: " + logging_result.error_message};
     }
-    logging_config_ = logging_result.value;
+    snapshot->logging = logging_result.value;
     
     // Load monitoring configuration
     auto monitoring_result = MonitoringConfig::from_toml(table);
     if (monitoring_result.is_error()) {
         return {monitoring_result.error_code, "Monitoring config: " + monitoring_result.error_message};
     }
-    monitoring_config_ = monitoring_result.value;
+    snapshot->monitoring = monitoring_result.value;
+    
+    // Load tracing configuration
+    auto tracing_result = TracingConfig::from_toml(table);
+    if (tracing_result.is_error()) {
+        return {tracing_result.error_code, "Tracing config: " + tracing_result.error_message};
+    }
+    snapshot->tracing = tracing_result.value;
+    
+    // Load performance log configuration
+    auto perf_log_result = PerfLogConfig::from_toml(table);
+    if (perf_log_result.is_error()) {
+        return {perf_log_result.error_code, "Perf log config: " + perf_log_result.error_message};
+    }
+    snapshot->perf_log = perf_log_result.value;
     
+    // Load hardware counter configuration
+    auto counters_result = HardwareCountersConfig::from_toml(table);
+    if (counters_result.is_error()) {
+        return {counters_result.error_code, "Hardware counters config: " + counters_result.error_message};
+    }
+    snapshot->hardware_counters = counters_result.value;
+    
+    // Load sampling profiler configuration
+    auto profiler_result = ProfilerConfig::from_toml(table);
+    if (profiler_result.is_error()) {
+        return {profiler_result.error_code, "Profiler config: " + profiler_result.error_message};
+    }
+    snapshot->profiler = profiler_result.value;
+    
+    // Load reload coordinator configuration
+    auto reload_result = ReloadConfig::from_toml(table);
+    if (reload_result.is_error()) {
+        return {reload_result.error_code, "Reload config: " + reload_result.error_message};
+    }
+    snapshot->reload = reload_result.value;
+    
+    // Load large table memory configuration
+    auto memory_result = MemoryConfig::from_toml(table);
+    if (memory_result.is_error()) {
+        return {memory_result.error_code, "Memory config: " + memory_result.error_message};
+    }
+    snapshot->memory = memory_result.value;
+    
+    // Load startup warm-up configuration
+    auto warmup_result = WarmupConfig::from_toml(table);
+    if (warmup_result.is_error()) {
+        return {warmup_result.error_code, "Warmup config: " + warmup_result.error_message};
+    }
+    snapshot->warmup = warmup_result.value;
+    
+    publish(std::move(snapshot));
     return {ErrorCode::SUCCESS, ""};
 }
 
@@ -538,13 +946,16 @@ void SystemConfig::hot_reload_worker() {
 
 // Global configuration functions
 std::shared_ptr<SystemConfig> get_system_config() {
-    std::lock_guard<std::mutex> lock(SystemConfig::instance_mutex_);
-    return SystemConfig::instance_;
+    return SystemConfig::instance_.load(std::memory_order_acquire);
 }
 
 void set_system_config(std::shared_ptr<SystemConfig> config) {
-    std::lock_guard<std::mutex> lock(SystemConfig::instance_mutex_);
-    SystemConfig::instance_ = std::move(config);
+    SystemConfig::instance_.store(std::move(config), std::memory_order_release);
+}
+
+std::shared_ptr<const ConfigSnapshot> current_config() {
+    auto config = SystemConfig::instance_.load(std::memory_order_acquire);
+    return config ? config->snapshot() : nullptr;
 }
 
 } // namespace dmp
@@ -0,0 +1,64 @@
+#include "core/decision.hpp"
+#include "utils/hw_counters.hpp"
+#include "utils/tracing.hpp"
+
+namespace dmp {
+
+TransactionResponse decide(const ReloadGeneration& generation, const TransactionRequest& request) {
+    TransactionResponse response;
+    response.request_id = request.request_id;
+    response.decision = Decision::APPROVE;
+    response.risk_score = 0.0f;
+    response.latency_ms = 0.0f;
+    response.timestamp = request.timestamp;
+
+    if (generation.rule_engine) {
+        DMP_TRACE_SPAN(PipelineStage::RULE_EVALUATION);
+        DMP_HW_COUNTERS(PipelineStage::RULE_EVALUATION);
+        auto metrics = generation.rule_engine->evaluate_rules(request);
+        response.risk_score = metrics.total_score;
+        response.decision = generation.rule_engine->get_thresholds().make_decision(metrics.total_score);
+        response.triggered_rules = metrics.get_triggered_rules();
+    }
+
+    if (generation.pattern_matcher) {
+        DMP_TRACE_SPAN(PipelineStage::PATTERN_MATCH);
+        DMP_HW_COUNTERS(PipelineStage::PATTERN_MATCH);
+        auto matches = generation.pattern_matcher->match_transaction(request);
+        if (matches.has_blacklist_matches() && matches.whitelist_matches.empty()) {
+            response.decision = Decision::DECLINE;
+        } else if (matches.texts_over_budget > 0 && response.decision == Decision::APPROVE) {
+            // Patterns were skipped at the time cap; an unscanned blacklist entry must not approve
+            response.decision = Decision::REVIEW;
+        }
+    }
+    return response;
+}
+
+TransactionResponse decide(const ReloadGeneration& generation, const TransactionRequest& request,
+                           const EnrichmentResult& enrichment) {
+    TransactionResponse response = decide(generation, request);
+    if (enrichment.is_degraded() && response.decision == Decision::APPROVE) {
+        response.decision = Decision::REVIEW;
+    }
+    return response;
+}
+
+Result<TransactionResponse> decide(const ReloadGeneration& generation, simdjson::dom::parser& parser,
+                                   const std::string& body) {
+    simdjson::dom::element json;
+    if (auto parse_error = parser.parse(body).get(json)) {
+        return {TransactionResponse{}, ErrorCode::INVALID_JSON_FORMAT,
+                "Invalid JSON format: " + std::string(simdjson::error_message(parse_error))};
+    }
+    auto request = TransactionRequest::from_json(json);
+    if (request.is_error()) {
+        return {TransactionResponse{}, request.error_code, request.error_message};
+    }
+    if (!request.value.is_valid()) {
+        return {TransactionResponse{}, ErrorCode::INVALID_REQUEST, "Invalid transaction data"};
+    }
+    return {decide(generation, request.value), ErrorCode::SUCCESS, ""};
+}
+
+} // namespace dmp
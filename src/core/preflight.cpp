@@ -0,0 +1,232 @@
+#include "core/preflight.hpp"
+#include "core/reload_coordinator.hpp"
+#include "core/transaction_generator.hpp"
+#include "utils/logger.hpp"
+#include "utils/memory_accountant.hpp"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace dmp {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsed_us(Clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+
+    double mean_of(const std::vector<double>& values) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+    }
+
+    double percentile_of(std::vector<double> values, double q) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        size_t rank = std::min(static_cast<size_t>(q * static_cast<double>(values.size())),
+                               values.size() - 1);
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+        return values[rank];
+    }
+}
+
+PreflightOptions PreflightOptions::from_config(const ReloadConfig& config) {
+    PreflightOptions options;
+    options.corpus_size = config.preflight_corpus_size;
+    options.rules_budget_ms = config.rules_budget_ms;
+    options.patterns_budget_ms = config.patterns_budget_ms;
+    options.max_pattern_profiles = 0;  // Per-pattern costing is a dmp_check report; reloads enforce budgets only
+    return options;
+}
+
+std::string PreflightReport::to_text(size_t top_n) const {
+    fmt::memory_buffer buffer;
+    auto out = std::back_inserter(buffer);
+
+    fmt::format_to(out, "rules      {} loaded, compiled in {:.2f} ms\n", rule_count, rules_compile_ms);
+    fmt::format_to(out, "patterns   {} loaded, compiled in {:.2f} ms\n", pattern_count, patterns_compile_ms);
+    fmt::format_to(out, "models     {}\n", model_count);
+    fmt::format_to(out, "memory     {:+} KiB resident while loading\n", memory_delta_kb);
+    fmt::format_to(out, "corpus     {} synthetic transactions\n", transactions);
+    fmt::format_to(out, "\n{:<10} {:>10} {:>10} {:>12}\n", "stage", "mean us", "p99 us", "budget us");
+    fmt::format_to(out, "{:<10} {:>10.2f} {:>10.2f} {:>12.1f}\n", "rules", rules_mean_us, rules_p99_us,
+                   options.rules_budget_ms * 1000.0);
+    fmt::format_to(out, "{:<10} {:>10.2f} {:>10.2f} {:>12.1f}\n", "patterns", patterns_mean_us, patterns_p99_us,
+                   options.patterns_budget_ms * 1000.0);
+
+    if (!rule_costs.empty()) {
+        fmt::format_to(out, "\nmost expensive rules (us per evaluation, hit rate):\n");
+        for (size_t i = 0; i < std::min(top_n, rule_costs.size()); ++i) {
+            fmt::format_to(out, "  {:<32} {:>8.3f} {:>7.2f}%\n", rule_costs[i].id, rule_costs[i].mean_us,
+                       rule_costs[i].hit_rate);
+        }
+    }
+    if (!pattern_costs.empty()) {
+        fmt::format_to(out, "\nmost expensive patterns (us per transaction, {} of {} profiled):\n",
+                       pattern_costs.size(), pattern_count);
+        for (size_t i = 0; i < std::min(top_n, pattern_costs.size()); ++i) {
+            const auto& cost = pattern_costs[i];
+            fmt::format_to(out, "  [{}] {:<28} {:<10} {:>8.3f}\n", cost.id, cost.name, cost.category, cost.mean_us);
+        }
+    }
+
+    fmt::format_to(out, "\nresult: {}\n", passed() ? "PASS" : "FAIL");
+    for (const auto& violation : violations) {
+        fmt::format_to(out, "  - {}\n", violation);
+    }
+    return fmt::to_string(buffer);
+}
+
+PreflightChecker::PreflightChecker(PreflightOptions options) : options_(options) {}
+
+Result<PreflightReport> PreflightChecker::check_files(const ReloadSources& sources) const {
+    const auto rss_before = static_cast<int64_t>(MemoryAccountant::resident_bytes() / 1024);
+
+    if (!sources.system_config_path.empty()) {
+        auto config_result = SystemConfig::load_from_file(sources.system_config_path);
+        if (config_result.is_error()) {
+            return {{}, config_result.error_code, "system config: " + config_result.error_message};
+        }
+    }
+
+    auto models_result = ReloadCoordinator::stage_models(sources.models_path);
+    if (models_result.is_error()) {
+        return {{}, models_result.error_code, "models: " + models_result.error_message};
+    }
+
+    auto start = Clock::now();
+    auto rules_result = ReloadCoordinator::stage_rules(sources.rules_path);
+    if (rules_result.is_error()) {
+        return {{}, rules_result.error_code, "rules: " + rules_result.error_message};
+    }
+    const double rules_compile_ms = elapsed_us(start) / 1000.0;
+
+    start = Clock::now();
+    auto patterns_result = ReloadCoordinator::stage_patterns(sources.blacklist_path, sources.whitelist_path);
+    if (patterns_result.is_error()) {
+        return {{}, patterns_result.error_code, "patterns: " + patterns_result.error_message};
+    }
+    const double patterns_compile_ms = elapsed_us(start) / 1000.0;
+    const auto rss_after = static_cast<int64_t>(MemoryAccountant::resident_bytes() / 1024);
+
+    auto result = check(rules_result.value.get(), patterns_result.value.get());
+    if (result.is_success()) {
+        result.value.model_count = models_result.value->models.size();
+        result.value.rules_compile_ms = rules_compile_ms;
+        result.value.patterns_compile_ms = patterns_compile_ms;
+        result.value.memory_delta_kb = rss_after - rss_before;
+    }
+    return result;
+}
+
+Result<PreflightReport> PreflightChecker::check(RuleEngine* rules, PatternMatcher* patterns) const {
+    PreflightReport report;
+    report.options = options_;
+
+    if (options_.corpus_size == 0) {
+        return {report, ErrorCode::INVALID_REQUEST, "Pre-flight corpus is empty"};
+    }
+    TransactionGeneratorOptions corpus_options;
+    corpus_options.seed = options_.seed;
+    const auto corpus = TransactionGenerator(corpus_options).generate(options_.corpus_size);
+    report.transactions = corpus.size();
+
+    if (rules) {
+        if (!rules->is_initialized()) {
+            return {report, ErrorCode::INVALID_REQUEST, "Rule engine is not loaded"};
+        }
+        report.rule_count = rules->get_current_config().rules.size();
+
+        // First evaluation on this thread compiles every rule; keep it out of the timings
+        rules->evaluate_rules(corpus.front());
+        const auto before = rules->get_rule_statistics();
+
+        std::vector<double> timings;
+        timings.reserve(corpus.size());
+        for (const auto& request : corpus) {
+            auto start = Clock::now();
+            rules->evaluate_rules(request);
+            timings.push_back(elapsed_us(start));
+        }
+
+        for (const auto& [id, stats] : rules->get_rule_statistics()) {
+            auto it = before.find(id);
+            const Rule* base = it != before.end() ? &it->second : nullptr;
+            uint64_t evaluations = stats.evaluation_count - (base ? base->evaluation_count : 0);
+            if (evaluations == 0) {
+                continue;
+            }
+            uint64_t hits = stats.hit_count - (base ? base->hit_count : 0);
+            double total_us = stats.total_evaluation_time_us - (base ? base->total_evaluation_time_us : 0.0);
+            report.rule_costs.push_back({id, total_us / static_cast<double>(evaluations),
+                                         100.0 * static_cast<double>(hits) / static_cast<double>(evaluations)});
+        }
+        std::sort(report.rule_costs.begin(), report.rule_costs.end(),
+                  [](const RuleCost& a, const RuleCost& b) { return a.mean_us > b.mean_us; });
+
+        report.rules_mean_us = mean_of(timings);
+        report.rules_p99_us = percentile_of(timings, 0.99);
+        if (report.rules_p99_us > options_.rules_budget_ms * 1000.0) {
+            report.violations.push_back(fmt::format("rules P99 {:.1f}us exceeds budget {}ms",
+                                                    report.rules_p99_us, options_.rules_budget_ms));
+        }
+    }
+
+    if (patterns) {
+        if (!patterns->is_initialized()) {
+            return {report, ErrorCode::INVALID_REQUEST, "Pattern matcher is not compiled"};
+        }
+        const auto loaded = patterns->get_loaded_patterns();
+        report.pattern_count = loaded.size();
+
+        patterns->match_transaction(corpus.front());
+        std::vector<double> timings;
+        timings.reserve(corpus.size());
+        for (const auto& request : corpus) {
+            auto start = Clock::now();
+            patterns->match_transaction(request);
+            timings.push_back(elapsed_us(start));
+        }
+        report.patterns_mean_us = mean_of(timings);
+        report.patterns_p99_us = percentile_of(timings, 0.99);
+        if (report.patterns_p99_us > options_.patterns_budget_ms * 1000.0) {
+            report.violations.push_back(fmt::format("patterns P99 {:.1f}us exceeds budget {}ms",
+                                                    report.patterns_p99_us, options_.patterns_budget_ms));
+        }
+
+        // Cost each pattern alone against every field the matcher inspects
+        const size_t profiled = std::min(loaded.size(), options_.max_pattern_profiles);
+        if (profiled > 0) {
+            std::vector<std::string> texts;
+            for (const auto& request : corpus) {
+                for (auto& [field, value] : PatternUtils::extract_match_fields(request)) {
+                    if (!value.empty()) {
+                        texts.push_back(std::move(value));
+                    }
+                }
+            }
+            for (size_t i = 0; i < profiled; ++i) {
+                PatternMatcher single;
+                if (single.add_pattern(loaded[i]).is_error() || single.compile_patterns().is_error()) {
+                    continue;
+                }
+                auto start = Clock::now();
+                for (const auto& text : texts) {
+                    single.match_text(text);
+                }
+                report.pattern_costs.push_back({loaded[i].id, loaded[i].name, loaded[i].category,
+                                                elapsed_us(start) / static_cast<double>(corpus.size())});
+            }
+            std::sort(report.pattern_costs.begin(), report.pattern_costs.end(),
+                      [](const PatternCost& a, const PatternCost& b) { return a.mean_us > b.mean_us; });
+        }
+    }
+
+    return {std::move(report), ErrorCode::SUCCESS, ""};
+}
+
+} // namespace dmp
@@ -0,0 +1,33 @@
+#include "core/readiness.hpp"
+#include <sstream>
+
+namespace dmp {
+
+const char* readiness_state_name(ReadinessState state) {
+    switch (state) {
+        case ReadinessState::STARTING: return "starting";
+        case ReadinessState::WARMING_UP: return "warming_up";
+        case ReadinessState::READY: return "ready";
+        case ReadinessState::STOPPING: return "stopping";
+    }
+    return "unknown";
+}
+
+Readiness& Readiness::instance() {
+    static Readiness readiness;
+    return readiness;
+}
+
+std::string Readiness::to_json() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"status\":\"" << readiness_state_name(state()) << "\","
+        << "\"warmup\":{"
+        << "\"done\":" << warmup_done_.load(std::memory_order_relaxed) << ","
+        << "\"total\":" << warmup_total_.load(std::memory_order_relaxed)
+        << "}"
+        << "}";
+    return oss.str();
+}
+
+} // namespace dmp
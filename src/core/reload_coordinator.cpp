@@ -0,0 +1,354 @@
+#include "core/reload_coordinator.hpp"
+#include "utils/logger.hpp"
+#include "utils/memory_accountant.hpp"
+#include <future>
+#include <utility>
+
+namespace dmp {
+
+namespace {
+    constexpr const char* kArtifactNames[] = {
+        "system_config", "rules", "blacklist", "whitelist", "models"
+    };
+}
+
+ReloadSources ReloadSources::from_config(const std::string& system_config_path,
+                                         const ReloadConfig& config) {
+    ReloadSources sources;
+    sources.system_config_path = system_config_path;
+    sources.rules_path = config.rules_path;
+    sources.blacklist_path = config.blacklist_path;
+    sources.whitelist_path = config.whitelist_path;
+    sources.models_path = config.models_path;
+    return sources;
+}
+
+ReloadCoordinator::ReloadCoordinator(ReloadSources sources, uint32_t settle_ms)
+    : settle_(settle_ms), paths_(to_paths(std::move(sources))) {
+}
+
+std::array<std::string, ReloadCoordinator::ARTIFACT_COUNT> ReloadCoordinator::to_paths(ReloadSources sources) {
+    return {std::move(sources.system_config_path), std::move(sources.rules_path),
+            std::move(sources.blacklist_path), std::move(sources.whitelist_path),
+            std::move(sources.models_path)};
+}
+
+ReloadCoordinator::~ReloadCoordinator() {
+    stop();
+}
+
+Result<void> ReloadCoordinator::load_initial() {
+    auto result = reload_now(true);
+    if (result.is_error()) {
+        return {result.error_code, result.error_message};
+    }
+    return {ErrorCode::SUCCESS, ""};
+}
+
+Result<bool> ReloadCoordinator::reload_now(bool force) {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+
+    const bool has_generation = generation_id() != 0;
+    const auto times = read_file_times();
+    const auto now = std::filesystem::file_time_type::clock::now();
+
+    std::array<bool, ARTIFACT_COUNT> changed{};
+    bool any_changed = false;
+    for (size_t i = 0; i < ARTIFACT_COUNT; ++i) {
+        changed[i] = force || !has_generation || times[i] != published_times_[i];
+        if (!changed[i]) {
+            continue;
+        }
+        // Wait for writers to finish so related files are picked up together
+        if (!force && times[i] != std::filesystem::file_time_type::min() && now - times[i] < settle_) {
+            LOG_DEBUG("{} modified {}ms ago, deferring reload", paths_[i],
+                      std::chrono::duration_cast<std::chrono::milliseconds>(now - times[i]).count());
+            return {false, ErrorCode::SUCCESS, ""};
+        }
+        any_changed = true;
+    }
+    if (!any_changed) {
+        return {false, ErrorCode::SUCCESS, ""};
+    }
+
+    // The same broken files were already rejected; wait for them to change
+    if (!force && has_failed_times_ && times == failed_times_) {
+        return {false, ErrorCode::SUCCESS, ""};
+    }
+
+    auto result = stage_and_publish(changed, times);
+    if (result.is_error()) {
+        failed_times_ = times;
+        has_failed_times_ = true;
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR("❌ Reload rejected, keeping generation {}: {}", generation_id(), result.error_message);
+        return {false, result.error_code, result.error_message};
+    }
+    has_failed_times_ = false;
+    return {true, ErrorCode::SUCCESS, ""};
+}
+
+Result<void> ReloadCoordinator::stage_and_publish(std::array<bool, ARTIFACT_COUNT> changed,
+                                                  FileTimes times) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    // Old and new artifacts coexist until readers move on; do not stage what will not fit
+    auto& accountant = MemoryAccountant::instance();
+    auto admitted = accountant.admit("reload", last_staging_bytes_);
+    if (admitted.is_error()) {
+        return admitted;
+    }
+    const uint64_t resident_before = MemoryAccountant::resident_bytes();
+
+    // Unchanged artifacts are shared with the current generation
+    auto generation = std::make_shared<ReloadGeneration>(*current());
+    auto paths = paths_;
+
+    // The system configuration goes first: its [reload] section says where the other artifacts live
+    if (changed[SYSTEM_CONFIG]) {
+        auto system_result = SystemConfig::load_from_file(paths[SYSTEM_CONFIG]);
+        if (system_result.is_error()) {
+            return {system_result.error_code,
+                    std::string(kArtifactNames[SYSTEM_CONFIG]) + ": " + system_result.error_message};
+        }
+        if (generation->system_config) {
+            const auto previous = to_paths(ReloadSources::from_config(
+                paths[SYSTEM_CONFIG], generation->system_config->get_reload_config()));
+            const auto next = to_paths(ReloadSources::from_config(
+                paths[SYSTEM_CONFIG], system_result.value->get_reload_config()));
+            for (size_t i = RULES; i < ARTIFACT_COUNT; ++i) {
+                // Only settings edited in this file move; paths overridden at construction stay
+                if (next[i] == previous[i] || next[i] == paths[i]) {
+                    continue;
+                }
+                LOG_INFO("🔀 {} moved: {} -> {}", kArtifactNames[i], paths[i], next[i]);
+                paths[i] = next[i];
+                changed[i] = true;
+                std::error_code ec;
+                times[i] = std::filesystem::last_write_time(paths[i], ec);
+                if (ec) {
+                    times[i] = std::filesystem::file_time_type::min();
+                }
+            }
+        }
+        generation->system_config = std::move(system_result.value);
+    }
+
+    // Stage every changed artifact concurrently
+    std::future<Result<std::shared_ptr<RuleEngine>>> rules_future;
+    std::future<Result<std::shared_ptr<PatternMatcher>>> patterns_future;
+    std::future<Result<std::shared_ptr<const ModelsConfig>>> models_future;
+
+    if (changed[RULES]) {
+        rules_future = std::async(std::launch::async, stage_rules, paths[RULES]);
+    }
+    if (changed[BLACKLIST] || changed[WHITELIST]) {
+        patterns_future = std::async(std::launch::async, stage_patterns,
+                                     paths[BLACKLIST], paths[WHITELIST]);
+    }
+    if (changed[MODELS]) {
+        models_future = std::async(std::launch::async, stage_models, paths[MODELS]);
+    }
+
+    // Wait for all of them before deciding, so no staging work outlives this call
+    ErrorCode error_code = ErrorCode::SUCCESS;
+    std::string errors;
+    auto collect = [&](auto& future, const char* name, auto& target) {
+        if (!future.valid()) {
+            return;
+        }
+        try {
+            auto result = future.get();
+            if (result.is_success()) {
+                target = std::move(result.value);
+                return;
+            }
+            if (error_code == ErrorCode::SUCCESS) {
+                error_code = result.error_code;
+            }
+            errors += (errors.empty() ? "" : "; ") + std::string(name) + ": " + result.error_message;
+        } catch (const std::exception& e) {
+            if (error_code == ErrorCode::SUCCESS) {
+                error_code = ErrorCode::INTERNAL_ERROR;
+            }
+            errors += (errors.empty() ? "" : "; ") + std::string(name) + ": " + e.what();
+        }
+    };
+    collect(rules_future, kArtifactNames[RULES], generation->rule_engine);
+    collect(patterns_future, "patterns", generation->pattern_matcher);
+    collect(models_future, kArtifactNames[MODELS], generation->models);
+
+    if (error_code != ErrorCode::SUCCESS) {
+        return {error_code, errors};
+    }
+
+    const uint64_t resident_after = MemoryAccountant::resident_bytes();
+    last_staging_bytes_ = resident_after > resident_before ? resident_after - resident_before : 0;
+    admitted = accountant.admit("staged generation", 0);
+    if (admitted.is_error()) {
+        return admitted;
+    }
+
+    // Reject candidates that would blow the latency budget before they serve traffic
+    const bool patterns_changed = changed[BLACKLIST] || changed[WHITELIST];
+    if (preflight_ && (changed[RULES] || patterns_changed)) {
+        auto* staged_rules = changed[RULES] ? generation->rule_engine.get() : nullptr;
+        auto* staged_patterns = patterns_changed ? generation->pattern_matcher.get() : nullptr;
+        auto report = PreflightChecker(*preflight_).check(staged_rules, staged_patterns);
+        if (report.is_error()) {
+            return {report.error_code, "preflight: " + report.error_message};
+        }
+        if (!report.value.passed()) {
+            std::string violations;
+            for (const auto& violation : report.value.violations) {
+                violations += (violations.empty() ? "" : "; ") + violation;
+            }
+            return {ErrorCode::INVALID_REQUEST, "preflight: " + violations};
+        }
+        // Synthetic traffic must not show up in production statistics
+        if (staged_rules) staged_rules->reset_statistics();
+        if (staged_patterns) staged_patterns->reset_statistics();
+    }
+
+    generation->id = generation_id() + 1;
+    generation->published_at = std::chrono::system_clock::now();
+    publish(generation);
+    paths_ = std::move(paths);
+    published_times_ = times;
+
+    if (changed[SYSTEM_CONFIG]) {
+        set_system_config(generation->system_config);
+    }
+
+    std::string reloaded;
+    for (size_t i = 0; i < ARTIFACT_COUNT; ++i) {
+        if (changed[i]) {
+            reloaded += (reloaded.empty() ? "" : ", ") + std::string(kArtifactNames[i]);
+        }
+    }
+    auto elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start_time).count();
+    LOG_INFO("🔄 Published configuration generation {} in {:.1f}ms ({})",
+             generation->id, elapsed_ms, reloaded);
+
+    if (publish_callback_) {
+        try {
+            publish_callback_(*generation);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Reload publish callback failed: {}", e.what());
+        }
+    }
+    return {ErrorCode::SUCCESS, ""};
+}
+
+Result<std::shared_ptr<RuleEngine>> ReloadCoordinator::stage_rules(const std::string& path) {
+    auto engine = std::make_shared<RuleEngine>();
+    auto load_result = engine->load_rules(path);
+    if (load_result.is_error()) {
+        return {nullptr, load_result.error_code, load_result.error_message};
+    }
+    auto validate_result = engine->validate();
+    if (validate_result.is_error()) {
+        return {nullptr, validate_result.error_code, validate_result.error_message};
+    }
+    return {engine, ErrorCode::SUCCESS, ""};
+}
+
+Result<std::shared_ptr<PatternMatcher>> ReloadCoordinator::stage_patterns(const std::string& blacklist_path,
+                                                                          const std::string& whitelist_path) {
+    auto matcher = std::make_shared<PatternMatcher>();
+    auto load_result = matcher->load_patterns(blacklist_path, whitelist_path);
+    if (load_result.is_error()) {
+        return {nullptr, load_result.error_code, load_result.error_message};
+    }
+    auto compile_result = matcher->compile_patterns();
+    if (compile_result.is_error()) {
+        return {nullptr, compile_result.error_code, compile_result.error_message};
+    }
+    return {matcher, ErrorCode::SUCCESS, ""};
+}
+
+Result<std::shared_ptr<const ModelsConfig>> ReloadCoordinator::stage_models(const std::string& path) {
+    auto result = ModelsConfig::load_from_file(path);
+    if (result.is_error()) {
+        return {nullptr, result.error_code, result.error_message};
+    }
+    return {std::make_shared<const ModelsConfig>(std::move(result.value)), ErrorCode::SUCCESS, ""};
+}
+
+void ReloadCoordinator::publish(std::shared_ptr<ReloadGeneration> generation) {
+    const uint64_t id = generation->id;
+    // In-flight requests pinning the previous generation keep it alive
+    generation_.store(std::move(generation), std::memory_order_release);
+    generation_id_.store(id, std::memory_order_relaxed);
+}
+
+ReloadCoordinator::FileTimes ReloadCoordinator::read_file_times() const {
+    FileTimes times;
+    for (size_t i = 0; i < ARTIFACT_COUNT; ++i) {
+        std::error_code ec;
+        times[i] = std::filesystem::last_write_time(paths_[i], ec);
+        if (ec) {
+            times[i] = std::filesystem::file_time_type::min();
+        }
+    }
+    return times;
+}
+
+void ReloadCoordinator::start(uint32_t check_interval_ms) {
+    if (worker_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        stop_requested_ = false;
+        check_interval_ms_ = check_interval_ms;
+    }
+    worker_ = std::thread([this] { run(); });
+    LOG_INFO("Reload coordinator watching {} files every {}ms", ARTIFACT_COUNT, check_interval_ms);
+}
+
+void ReloadCoordinator::stop() {
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        stop_requested_ = true;
+    }
+    worker_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void ReloadCoordinator::enable_preflight(const PreflightOptions& options) {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    preflight_ = options;
+}
+
+void ReloadCoordinator::on_publish(PublishCallback callback) {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    publish_callback_ = std::move(callback);
+}
+
+std::shared_ptr<const ReloadGeneration> ReloadCoordinator::current() const {
+    return generation_.load(std::memory_order_acquire);
+}
+
+void ReloadCoordinator::run() {
+    std::unique_lock<std::mutex> lock(worker_mutex_);
+    while (!stop_requested_) {
+        worker_cv_.wait_for(lock, std::chrono::milliseconds(check_interval_ms_),
+                            [this] { return stop_requested_; });
+        if (stop_requested_) {
+            break;
+        }
+        lock.unlock();
+        try {
+            reload_now(false);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Reload coordinator error: {}", e.what());
+        }
+        lock.lock();
+    }
+}
+
+} // namespace dmp
@@ -0,0 +1,339 @@
+#include "core/remote_lookup.hpp"
+#include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace dmp {
+
+namespace {
+    /**
+     * @brief Wait for a socket event until the deadline
+     * @return true when ready, false on timeout or error
+     */
+    bool wait_for(int fd, short events, const Deadline& deadline) {
+        while (true) {
+            const auto left = deadline.remaining();
+            if (left <= std::chrono::microseconds::zero()) {
+                return false;
+            }
+            pollfd pfd{fd, events, 0};
+            // Round up so a sub-millisecond budget still waits once
+            const int timeout_ms = static_cast<int>(std::min<int64_t>((left.count() + 999) / 1000, 60000));
+            const int ready = ::poll(&pfd, 1, timeout_ms);
+            if (ready > 0) {
+                return (pfd.revents & (events | POLLHUP | POLLERR)) != 0;
+            }
+            if (ready < 0 && errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Open a non-blocking connection to one resolved address
+     */
+    Result<int> connect_to(const sockaddr* address, socklen_t length, int family, int protocol,
+                           const std::string& host, const Deadline& deadline) {
+        int fd = ::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, protocol);
+        if (fd < 0) {
+            return {-1, ErrorCode::CACHE_ERROR, std::string("socket: ") + std::strerror(errno)};
+        }
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (::connect(fd, address, length) != 0 && errno != EINPROGRESS) {
+            const int error = errno;
+            ::close(fd);
+            return {-1, ErrorCode::CACHE_ERROR, std::string("connect: ") + std::strerror(error)};
+        }
+        if (!wait_for(fd, POLLOUT, deadline)) {
+            ::close(fd);
+            return {-1, ErrorCode::DEADLINE_EXCEEDED, "Deadline exceeded connecting to " + host};
+        }
+        int error = 0;
+        socklen_t error_length = sizeof(error);
+        ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_length);
+        if (error != 0) {
+            ::close(fd);
+            return {-1, ErrorCode::CACHE_ERROR, std::string("connect: ") + std::strerror(error)};
+        }
+        return {fd, ErrorCode::SUCCESS, ""};
+    }
+
+    /**
+     * @brief Send a request; peer_closed is set when the server had already closed the connection
+     */
+    Result<void> send_all(int fd, const std::string& data, const Deadline& deadline, bool& peer_closed) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += static_cast<size_t>(n);
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                if (!wait_for(fd, POLLOUT, deadline)) {
+                    return {ErrorCode::DEADLINE_EXCEEDED, "Deadline exceeded sending request"};
+                }
+            } else {
+                peer_closed = errno == EPIPE || errno == ECONNRESET;
+                return {ErrorCode::CACHE_ERROR, std::string("send: ") + std::strerror(errno)};
+            }
+        }
+        return {ErrorCode::SUCCESS, ""};
+    }
+
+    /**
+     * @brief Read one RESP2 reply to GET: bulk string, nil, simple string, integer or error
+     *
+     * peer_closed is set when the connection was closed before any byte of the reply arrived.
+     */
+    Result<LookupValue> read_reply(int fd, const Deadline& deadline, bool& peer_closed) {
+        std::string buffer;
+        char chunk[4096];
+        size_t needed = 0;  // Total bytes of the reply once its header is parsed
+
+        while (true) {
+            const size_t header_end = buffer.find("\r\n");
+            if (header_end != std::string::npos) {
+                const char type = buffer[0];
+                const std::string header = buffer.substr(1, header_end - 1);
+                if (type == '+' || type == ':') {
+                    return {LookupValue{true, header}, ErrorCode::SUCCESS, ""};
+                }
+                if (type == '-') {
+                    return {LookupValue{}, ErrorCode::CACHE_ERROR, "Server error: " + header};
+                }
+                if (type != '$') {
+                    return {LookupValue{}, ErrorCode::CACHE_ERROR,
+                            std::string("Unexpected reply type '") + type + "'"};
+                }
+                const long length = std::strtol(header.c_str(), nullptr, 10);
+                if (length < 0) {
+                    return {LookupValue{}, ErrorCode::SUCCESS, ""};  // Nil: key not cached
+                }
+                needed = header_end + 2 + static_cast<size_t>(length) + 2;
+                if (buffer.size() >= needed) {
+                    return {LookupValue{true, buffer.substr(header_end + 2, static_cast<size_t>(length))},
+                            ErrorCode::SUCCESS, ""};
+                }
+            }
+
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n > 0) {
+                buffer.append(chunk, static_cast<size_t>(n));
+            } else if (n == 0) {
+                peer_closed = buffer.empty();
+                return {LookupValue{}, ErrorCode::CACHE_ERROR, "Connection closed by server"};
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                if (!wait_for(fd, POLLIN, deadline)) {
+                    return {LookupValue{}, ErrorCode::DEADLINE_EXCEEDED, "Deadline exceeded waiting for reply"};
+                }
+            } else {
+                peer_closed = buffer.empty() && errno == ECONNRESET;
+                return {LookupValue{}, ErrorCode::CACHE_ERROR, std::string("recv: ") + std::strerror(errno)};
+            }
+        }
+    }
+}
+
+// ============================================================================
+// RespLookup
+// ============================================================================
+
+RespLookup::RespLookup(std::string host, uint16_t port, size_t max_idle_connections)
+    : host_(std::move(host)), port_(port), max_idle_connections_(max_idle_connections) {
+    auto resolved = resolve();
+    if (resolved.is_error()) {
+        LOG_ERROR("{}; retrying on lookup", resolved.error_message);
+    }
+}
+
+RespLookup::~RespLookup() {
+    if (resolver_.joinable()) {
+        resolver_.join();
+    }
+    for (int fd : idle_) {
+        ::close(fd);
+    }
+}
+
+Result<void> RespLookup::resolve() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const std::string service = std::to_string(port_);
+    const int rc = ::getaddrinfo(host_.c_str(), service.c_str(), &hints, &addresses);
+
+    std::lock_guard<std::mutex> lock(resolve_mutex_);
+    last_resolve_ = std::chrono::steady_clock::now();
+    if (rc != 0) {
+        return {ErrorCode::CACHE_ERROR, "Cannot resolve " + host_ + ": " + ::gai_strerror(rc)};
+    }
+    endpoints_.clear();
+    for (addrinfo* ai = addresses; ai; ai = ai->ai_next) {
+        if (ai->ai_addrlen > sizeof(sockaddr_storage)) {
+            continue;
+        }
+        Endpoint endpoint;
+        std::memcpy(&endpoint.address, ai->ai_addr, ai->ai_addrlen);
+        endpoint.length = ai->ai_addrlen;
+        endpoint.family = ai->ai_family;
+        endpoint.protocol = ai->ai_protocol;
+        endpoints_.push_back(endpoint);
+    }
+    ::freeaddrinfo(addresses);
+    if (endpoints_.empty()) {
+        return {ErrorCode::CACHE_ERROR, "No address for " + host_};
+    }
+    return {ErrorCode::SUCCESS, ""};
+}
+
+Result<std::vector<RespLookup::Endpoint>> RespLookup::endpoints() {
+    std::lock_guard<std::mutex> lock(resolve_mutex_);
+    if (!endpoints_.empty()) {
+        return {endpoints_, ErrorCode::SUCCESS, ""};
+    }
+    // Unresolved: retry in the background, at most one lookup in flight and
+    // one per kResolveRetryInterval, so a DNS outage never blocks requests
+    if (!resolving_ && std::chrono::steady_clock::now() - last_resolve_ >= kResolveRetryInterval) {
+        resolving_ = true;
+        last_resolve_ = std::chrono::steady_clock::now();
+        if (resolver_.joinable()) {
+            resolver_.join();  // Previous attempt has finished (resolving_ was clear)
+        }
+        resolver_ = std::thread([this] {
+            auto resolved = resolve();
+            if (resolved.is_error()) {
+                LOG_ERROR("{}; retrying on lookup", resolved.error_message);
+            }
+            std::lock_guard<std::mutex> lock(resolve_mutex_);
+            resolving_ = false;
+        });
+    }
+    return {{}, ErrorCode::CACHE_ERROR, "Cannot resolve " + host_};
+}
+
+Result<RespLookup::Connection> RespLookup::acquire(const Deadline& deadline, bool fresh) {
+    if (!fresh) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (!idle_.empty()) {
+            int fd = idle_.back();
+            idle_.pop_back();
+            return {Connection{fd, true}, ErrorCode::SUCCESS, ""};
+        }
+    }
+
+    auto resolved = endpoints();
+    if (resolved.is_error()) {
+        return {Connection{}, resolved.error_code, resolved.error_message};
+    }
+    Result<int> connected{-1, ErrorCode::CACHE_ERROR, "No address for " + host_};
+    for (const auto& endpoint : resolved.value) {
+        connected = connect_to(reinterpret_cast<const sockaddr*>(&endpoint.address), endpoint.length,
+                               endpoint.family, endpoint.protocol, host_, deadline);
+        if (connected.is_success() || connected.error_code == ErrorCode::DEADLINE_EXCEEDED) {
+            break;
+        }
+    }
+    if (connected.is_error()) {
+        return {Connection{}, connected.error_code, connected.error_message};
+    }
+    return {Connection{connected.value, false}, ErrorCode::SUCCESS, ""};
+}
+
+void RespLookup::release(int fd) {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (idle_.size() < max_idle_connections_) {
+            idle_.push_back(fd);
+            return;
+        }
+    }
+    ::close(fd);
+}
+
+Result<LookupValue> RespLookup::lookup(const std::string& key, const Deadline& deadline) {
+    if (deadline.expired()) {
+        return {LookupValue{}, ErrorCode::DEADLINE_EXCEEDED, "Deadline exceeded before lookup"};
+    }
+    const std::string command = "*2\r\n$3\r\nGET\r\n$" + std::to_string(key.size()) + "\r\n" + key + "\r\n";
+
+    bool fresh = false;
+    while (true) {
+        auto connection = acquire(deadline, fresh);
+        if (connection.is_error()) {
+            return {LookupValue{}, connection.error_code, connection.error_message};
+        }
+        const int fd = connection.value.fd;
+
+        bool peer_closed = false;
+        auto sent = send_all(fd, command, deadline, peer_closed);
+        Result<LookupValue> reply = sent.is_error()
+            ? Result<LookupValue>{LookupValue{}, sent.error_code, sent.error_message}
+            : read_reply(fd, deadline, peer_closed);
+
+        if (reply.error_code == ErrorCode::DEADLINE_EXCEEDED ||
+            (reply.is_error() && reply.error_message.rfind("Server error", 0) != 0)) {
+            ::close(fd);  // Stream state unknown: never reuse
+        } else {
+            release(fd);
+            return reply;
+        }
+
+        // The server closed a pooled connection while it sat idle; GET is safe to send again
+        if (peer_closed && connection.value.reused && !fresh && !deadline.expired()) {
+            fresh = true;
+            continue;
+        }
+        return reply;
+    }
+}
+
+// ============================================================================
+// DependencySet
+// ============================================================================
+
+DependencySet::DependencySet(std::vector<RemoteDependency> dependencies, std::chrono::microseconds reserve)
+    : dependencies_(std::move(dependencies)), reserve_(reserve) {}
+
+EnrichmentResult DependencySet::fetch(const std::vector<std::string>& keys, const Deadline& deadline) const {
+    EnrichmentResult result;
+    result.values.resize(dependencies_.size());
+    const Deadline enrichment_deadline = deadline.reserve(reserve_);
+
+    for (size_t i = 0; i < dependencies_.size(); ++i) {
+        const auto& dependency = dependencies_[i];
+        if (i >= keys.size() || !dependency.lookup) {
+            continue;
+        }
+        const Deadline call_deadline = enrichment_deadline.capped(dependency.timeout);
+        if (call_deadline.expired()) {
+            result.degraded.push_back(dependency.name);
+            MetricsCollector::instance().record_error("dependency_skipped", dependency.name);
+            continue;
+        }
+
+        auto lookup = dependency.lookup->lookup(keys[i], call_deadline);
+        if (lookup.is_error()) {
+            result.degraded.push_back(dependency.name);
+            MetricsCollector::instance().record_error(
+                lookup.error_code == ErrorCode::DEADLINE_EXCEEDED ? "dependency_deadline_exceeded"
+                                                                  : "dependency_error",
+                dependency.name);
+            LOG_DEBUG("Dependency {} degraded: {}", dependency.name, lookup.error_message);
+            continue;
+        }
+        result.values[i] = std::move(lookup.value);
+    }
+    return result;
+}
+
+} // namespace dmp
@@ -0,0 +1,116 @@
+#include "core/transaction_generator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace dmp {
+
+namespace {
+    constexpr const char* kCurrencies[] = {"USD", "USD", "USD", "EUR", "EUR", "GBP", "CNY", "JPY"};
+    constexpr const char* kEntryModes[] = {"CHIP", "CHIP", "CONTACTLESS", "ECOM", "ECOM", "SWIPE"};
+    constexpr const char* kCountries[] = {"US", "US", "GB", "DE", "FR", "CN", "JP", "BR"};
+    constexpr const char* kBrands[] = {"VISA", "VISA", "MASTERCARD", "MASTERCARD", "AMEX"};
+    constexpr const char* kUserAgents[] = {
+        "Mozilla/5.0 (Windows NT 10.0; Win64; x64)",
+        "Mozilla/5.0 (iPhone; CPU iPhone OS 17_0 like Mac OS X)",
+        "Mozilla/5.0 (Linux; Android 14)",
+        "PaymentTerminal/2.1",
+    };
+    constexpr const char* kBlockedMerchants[] = {"MERCH_FRAUD_001", "MERCH_FRAUD_002", "MERCH_SUSPICIOUS_7"};
+    constexpr uint16_t kMerchantCategories[] = {5411, 5812, 5999, 4111, 5732, 7995, 4829, 5311};
+
+    std::string format_id(const char* prefix, uint64_t value, int width) {
+        char buffer[48];
+        std::snprintf(buffer, sizeof(buffer), "%s%0*llu", prefix, width,
+                      static_cast<unsigned long long>(value));
+        return buffer;
+    }
+}
+
+TransactionGenerator::TransactionGenerator(TransactionGeneratorOptions options)
+    : options_(options), rng_(options.seed) {}
+
+TransactionRequest TransactionGenerator::next() {
+    TransactionRequest request;
+    const uint64_t sequence = ++sequence_;
+    if (burst_remaining_ == 0 && options_.attack_burst_ratio > 0.0 && chance(options_.attack_burst_ratio)) {
+        burst_remaining_ = options_.attack_burst_length;
+        burst_card_ = std::uniform_int_distribution<uint64_t>(1000004, 9999999)(rng_);
+    }
+    request.request_id = format_id("syn_", sequence, 10);
+    request.timestamp = std::chrono::system_clock::now();
+
+    // Amounts: log-normal around ~50 with a thin high-value tail
+    double amount = std::lognormal_distribution<double>(3.9, 1.1)(rng_);
+    if (chance(options_.high_amount_ratio)) {
+        amount = std::uniform_real_distribution<double>(10000.0, 250000.0)(rng_);
+    }
+    request.transaction.amount = std::round(std::clamp(amount, 0.01, 1000000.0) * 100.0) / 100.0;
+    request.transaction.currency = pick(kCurrencies);
+    request.transaction.merchant_category = kMerchantCategories[
+        std::uniform_int_distribution<size_t>(0, std::size(kMerchantCategories) - 1)(rng_)];
+    request.transaction.pos_entry_mode = pick(kEntryModes);
+
+    const bool blocked = chance(options_.blacklist_ratio);
+    if (blocked && chance(0.5)) {
+        request.transaction.merchant_id = pick(kBlockedMerchants);
+    } else {
+        request.transaction.merchant_id = format_id(
+            "MERCH_", std::uniform_int_distribution<uint32_t>(1, options_.merchant_count)(rng_), 5);
+    }
+
+    uint32_t customer_limit = options_.customer_count;
+    if (options_.repeat_customer_ratio > 0.0 && chance(options_.repeat_customer_ratio)) {
+        customer_limit = std::clamp<uint32_t>(options_.hot_customer_count, 1, options_.customer_count);
+    }
+    const uint32_t customer = std::uniform_int_distribution<uint32_t>(1, customer_limit)(rng_);
+    request.card.token = format_id("tok_", static_cast<uint64_t>(customer) * 7919u % 1000003u, 7);
+    request.card.issuer_country = pick(kCountries);
+    request.card.card_brand = pick(kBrands);
+
+    std::uniform_int_distribution<int> octet(1, 254);
+    char ip[16];
+    if (blocked && request.transaction.merchant_id.rfind("MERCH_FRAUD", 0) != 0 &&
+        request.transaction.merchant_id.rfind("MERCH_SUSPICIOUS", 0) != 0) {
+        std::snprintf(ip, sizeof(ip), "192.168.100.%d", octet(rng_));
+    } else {
+        std::snprintf(ip, sizeof(ip), "%d.%d.%d.%d", octet(rng_) % 200 + 11, octet(rng_),
+                      octet(rng_), octet(rng_));
+    }
+    request.device.ip = ip;
+    request.device.fingerprint = format_id("fp_", customer, 6);
+    request.device.user_agent = pick(kUserAgents);
+
+    request.customer.id = format_id("cust_", customer, 6);
+    request.customer.risk_score = std::uniform_real_distribution<float>(0.0f, 100.0f)(rng_);
+    request.customer.account_age_days = std::uniform_int_distribution<uint32_t>(0, 3650)(rng_);
+
+    if (burst_remaining_ > 0) {
+        --burst_remaining_;
+        apply_attack_burst(request);
+    }
+    return request;
+}
+
+void TransactionGenerator::apply_attack_burst(TransactionRequest& request) {
+    // Card testing: one stolen card probing many merchants with tiny amounts
+    request.transaction.amount = std::round(
+        std::uniform_real_distribution<double>(0.5, 5.0)(rng_) * 100.0) / 100.0;
+    request.transaction.pos_entry_mode = "ECOM";
+    request.card.token = format_id("tok_", burst_card_, 7);
+    request.device.fingerprint = format_id("fp_", std::uniform_int_distribution<uint64_t>(1, 999999)(rng_), 6);
+    request.customer.id = format_id("cust_", burst_card_, 7);
+    request.customer.risk_score = std::uniform_real_distribution<float>(60.0f, 100.0f)(rng_);
+    request.customer.account_age_days = std::uniform_int_distribution<uint32_t>(0, 7)(rng_);
+}
+
+std::vector<TransactionRequest> TransactionGenerator::generate(size_t count) {
+    std::vector<TransactionRequest> requests;
+    requests.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        requests.push_back(next());
+    }
+    return requests;
+}
+
+} // namespace dmp
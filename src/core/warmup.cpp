@@ -0,0 +1,165 @@
+#include "core/warmup.hpp"
+#include "core/decision.hpp"
+#include "core/readiness.hpp"
+#include "core/transaction_generator.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <fstream>
+#include <simdjson.h>
+
+namespace dmp {
+
+namespace {
+    constexpr uint64_t kProgressBatch = 64;  // Readiness progress is published in batches
+}
+
+WarmupRunner::WarmupRunner(WarmupConfig config) : config_(std::move(config)) {}
+
+Result<size_t> WarmupRunner::load_corpus() {
+    corpus_.clear();
+    if (config_.corpus_path.empty()) {
+        return {0, ErrorCode::SUCCESS, ""};
+    }
+
+    std::ifstream file(config_.corpus_path);
+    if (!file.is_open()) {
+        return {0, ErrorCode::INVALID_REQUEST, "Cannot open warm-up corpus: " + config_.corpus_path};
+    }
+
+    simdjson::dom::parser parser;
+    std::string line;
+    size_t rejected = 0;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        simdjson::dom::element json;
+        if (parser.parse(line).get(json)) {
+            ++rejected;
+            continue;
+        }
+        auto request = TransactionRequest::from_json(json);
+        if (request.is_error() || !request.value.is_valid()) {
+            ++rejected;
+            continue;
+        }
+        corpus_.push_back(std::move(request.value));
+    }
+
+    if (corpus_.empty()) {
+        return {0, ErrorCode::INVALID_REQUEST, "Warm-up corpus has no valid requests: " + config_.corpus_path};
+    }
+    if (rejected > 0) {
+        LOG_INFO("⚠️  Skipped {} invalid lines in warm-up corpus {}", rejected, config_.corpus_path);
+    }
+    return {corpus_.size(), ErrorCode::SUCCESS, ""};
+}
+
+WarmupReport WarmupRunner::warm_thread(const ReloadGeneration& generation, size_t thread_index,
+                                       Clock::time_point deadline) const {
+    WarmupReport report;
+    report.threads = 1;
+    const auto start = Clock::now();
+    const uint64_t count = config_.transactions_per_thread;
+    const uint64_t window = std::max<uint64_t>(1, count / 10);
+
+    TransactionGeneratorOptions options;
+    options.seed += thread_index;
+    TransactionGenerator generator(options);
+    simdjson::dom::parser parser;
+
+    double first_us = 0.0;
+    double last_us = 0.0;
+    uint64_t first_count = 0;
+    uint64_t last_count = 0;
+    uint64_t unreported = 0;
+
+    for (uint64_t i = 0; i < count; ++i) {
+        if (Clock::now() > deadline) {
+            report.timed_out = true;
+            break;
+        }
+        if (++unreported == kProgressBatch) {
+            Readiness::instance().add_warmup_done(unreported);
+            unreported = 0;
+        }
+        const TransactionRequest request = corpus_.empty()
+            ? generator.next()
+            : corpus_[(thread_index * count + i) % corpus_.size()];
+
+        auto transaction_start = Clock::now();
+        const std::string body = request.to_json();
+        auto response = decide(generation, parser, body);
+        if (response.is_error()) {
+            ++report.errors;
+            continue;
+        }
+        response.value.to_json();
+
+        const double elapsed_us = std::chrono::duration<double, std::micro>(
+            Clock::now() - transaction_start).count();
+        if (i < window) {
+            first_us += elapsed_us;
+            ++first_count;
+        } else if (i >= count - window) {
+            last_us += elapsed_us;
+            ++last_count;
+        }
+
+        ++report.transactions;
+    }
+    Readiness::instance().add_warmup_done(unreported);
+
+    report.elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    report.first_mean_us = first_count > 0 ? first_us / static_cast<double>(first_count) : 0.0;
+    report.last_mean_us = last_count > 0 ? last_us / static_cast<double>(last_count) : 0.0;
+    return report;
+}
+
+Result<WarmupReport> WarmupRunner::run(const ReloadGeneration& generation, size_t threads,
+                                       const Dispatch& dispatch) const {
+    if (threads == 0) {
+        return {WarmupReport{}, ErrorCode::INVALID_REQUEST, "Warm-up needs at least one thread"};
+    }
+    if (!dispatch) {
+        return {WarmupReport{}, ErrorCode::INVALID_REQUEST, "Warm-up needs a dispatcher for the serving threads"};
+    }
+    const auto start = Clock::now();
+    const auto deadline = start + std::chrono::milliseconds(config_.timeout_ms);
+    Readiness::instance().set_warmup_total(static_cast<uint64_t>(threads) * config_.transactions_per_thread);
+
+    std::vector<WarmupReport> reports(threads);
+    dispatch(threads, [this, &generation, &reports, deadline](size_t t) {
+        reports[t] = warm_thread(generation, t, deadline);
+    });
+
+    WarmupReport merged;
+    merged.threads = threads;
+    for (const auto& report : reports) {
+        merged.transactions += report.transactions;
+        merged.errors += report.errors;
+        merged.first_mean_us += report.first_mean_us / static_cast<double>(threads);
+        merged.last_mean_us += report.last_mean_us / static_cast<double>(threads);
+        merged.timed_out = merged.timed_out || report.timed_out;
+    }
+    merged.elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // Synthetic traffic must not show up in production statistics
+    if (generation.rule_engine) {
+        generation.rule_engine->reset_statistics();
+    }
+    if (generation.pattern_matcher) {
+        generation.pattern_matcher->reset_statistics();
+    }
+    return {merged, ErrorCode::SUCCESS, ""};
+}
+
+WarmupRunner::Dispatch WarmupRunner::on_calling_thread() {
+    return [](size_t threads, const std::function<void(size_t)>& task) {
+        for (size_t t = 0; t < threads; ++t) {
+            task(t);
+        }
+    };
+}
+
+} // namespace dmp
@@ -1,8 +1,11 @@
 #include "engine/pattern_matcher.hpp"
 #include "utils/logger.hpp"
+#include "utils/structured_log.hpp"
+#include "utils/large_table.hpp"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <mutex>
 #include <atomic>
@@ -17,6 +20,11 @@
 
 namespace dmp {
 
+namespace {
+    // Survives reloads, unlike the per-backend counter
+    std::atomic<uint64_t> g_scans_over_budget{0};
+}
+
 /**
  * @brief Abstract pattern matching backend interface
  * 
@@ -34,6 +42,19 @@ public:
                                            const std::string& category = "") = 0;
     virtual std::string get_backend_name() const = 0;
     virtual bool is_available() const = 0;
+    virtual void reset_statistics() = 0;
+    
+    void set_scan_limits(const PatternScanLimits& limits) { limits_ = limits; }
+    
+protected:
+    /**
+     * @brief The part of text a scan may look at
+     */
+    std::string_view scan_window(const std::string& text) const {
+        return std::string_view(text).substr(0, limits_.max_text_bytes);
+    }
+    
+    PatternScanLimits limits_;
 };
 
 /**
@@ -41,19 +62,20 @@ public:
  * 
  * Uses std::regex for pattern matching. Compatible with all platforms
  * but has lower performance compared to specialized engines.
+ * Wildcard patterns bypass std::regex: its backtracking makes "*a*a*b"
+ * against a long run of 'a' take O(text^stars) steps.
  */
 class StdRegexBackend : public PatternBackend {
 private:
     struct CompiledPattern {
         Pattern pattern;
+        bool is_wildcard;
         std::regex compiled_regex;
         
-        CompiledPattern(const Pattern& p) : pattern(p) {
-            std::string regex_pattern = p.pattern;
-            
-            // Convert wildcards to regex if needed
-            if (!p.is_regex && regex_pattern.find('*') != std::string::npos) {
-                regex_pattern = PatternUtils::wildcard_to_regex(regex_pattern);
+        CompiledPattern(const Pattern& p)
+            : pattern(p), is_wildcard(!p.is_regex && p.pattern.find('*') != std::string::npos) {
+            if (is_wildcard) {
+                return;  // Matched with PatternUtils::wildcard_match
             }
             
             std::regex_constants::syntax_option_type flags = std::regex_constants::ECMAScript;
@@ -61,7 +83,7 @@ private:
                 flags |= std::regex_constants::icase;
             }
             
-            compiled_regex = std::regex(regex_pattern, flags);
+            compiled_regex = std::regex(p.pattern, flags);
         }
     };
     
@@ -69,6 +91,7 @@ private:
     mutable std::mutex patterns_mutex_;
     std::atomic<uint64_t> match_count_{0};
     std::atomic<uint64_t> total_match_time_us_{0};
+    std::atomic<uint64_t> texts_over_budget_{0};
     
 public:
     Result<void> compile_patterns(const std::vector<Pattern>& patterns) override {
@@ -104,27 +127,58 @@ public:
         PatternMatchResults results;
         results.texts_processed = 1;
         
+        const std::string_view window = scan_window(text);
+        const auto deadline = limits_.max_scan_us == 0
+            ? std::chrono::steady_clock::time_point::max()
+            : std::chrono::steady_clock::now() + std::chrono::microseconds(limits_.max_scan_us);
+        
         {
             std::lock_guard<std::mutex> lock(patterns_mutex_);
-            results.patterns_checked = compiled_patterns_.size();
             
             for (const auto& compiled_pattern : compiled_patterns_) {
                 const auto& pattern = compiled_pattern.pattern;
                 
+                // Time cap: the remaining patterns are skipped rather than stalling the request
+                if (results.patterns_checked > 0 && std::chrono::steady_clock::now() >= deadline) {
+                    results.texts_over_budget = 1;
+                    texts_over_budget_.fetch_add(1, std::memory_order_relaxed);
+                    g_scans_over_budget.fetch_add(1, std::memory_order_relaxed);
+                    LOG_DEBUG("Pattern scan over {}us budget after {} of {} patterns",
+                              limits_.max_scan_us, results.patterns_checked, compiled_patterns_.size());
+                    break;
+                }
+                ++results.patterns_checked;
+                
                 // Category filter
                 if (!category.empty() && pattern.category != category) {
                     continue;
                 }
                 
                 try {
-                    std::smatch match;
-                    if (std::regex_search(text, match, compiled_pattern.compiled_regex)) {
+                    size_t match_position = 0;
+                    size_t match_length = 0;
+                    if (compiled_pattern.is_wildcard) {
+                        if (!PatternUtils::wildcard_match(pattern.pattern, window, pattern.case_sensitive)) {
+                            continue;
+                        }
+                        match_length = window.size();  // Wildcards are anchored at both ends
+                    } else {
+                        std::match_results<std::string_view::const_iterator> match;
+                        if (!std::regex_search(window.begin(), window.end(), match,
+                                               compiled_pattern.compiled_regex)) {
+                            continue;
+                        }
+                        match_position = static_cast<size_t>(match.position());
+                        match_length = static_cast<size_t>(match.length());
+                    }
+                    
+                    {
                         PatternMatch pattern_match(
                             pattern.id,
                             pattern.name,
-                            match.str(),
-                            match.position(),
-                            match.position() + match.length(),
+                            std::string(window.substr(match_position, match_length)),
+                            match_position,
+                            match_position + match_length,
                             pattern.category
                         );
                         
@@ -137,9 +191,10 @@ public:
                             results.whitelist_matches.push_back(pattern_match);
                         }
                         
-                        LOG_DEBUG("🎯 Pattern match [{}]: {} in text '{}'", 
-                                 pattern.name, match.str(), 
-                                 text.length() > 50 ? text.substr(0, 50) + "..." : text);
+                        LOG_EVENT_DEBUG("pattern_match",
+                                        dmp::kv("pattern", pattern.name),
+                                        dmp::kv("match", window.substr(match_position, match_length)),
+                                        dmp::kv("text", window));
                     }
                 } catch (const std::exception& e) {
                     LOG_ERROR("❌ Pattern matching exception [{}]: {}", pattern.id, e.what());
@@ -178,6 +233,7 @@ public:
                                                        text_results.whitelist_matches.end());
             aggregated_results.evaluation_time_us += text_results.evaluation_time_us;
             aggregated_results.patterns_checked = text_results.patterns_checked;
+            aggregated_results.texts_over_budget += text_results.texts_over_budget;
         }
         
         return aggregated_results;
@@ -199,9 +255,32 @@ public:
         uint64_t count = match_count_.load();
         return count > 0 ? static_cast<double>(total_match_time_us_.load()) / count : 0.0;
     }
+    
+    uint64_t get_texts_over_budget() const {
+        return texts_over_budget_.load();
+    }
+    
+    void reset_statistics() override {
+        match_count_.store(0, std::memory_order_relaxed);
+        total_match_time_us_.store(0, std::memory_order_relaxed);
+        texts_over_budget_.store(0, std::memory_order_relaxed);
+    }
 };
 
 #ifdef ENABLE_HYPERSCAN
+namespace {
+    // Pattern databases are large, long-lived and randomly accessed: keep them on huge pages
+    void* allocate_database(size_t size) {
+        return LargeTableAllocator::instance().allocate(size);
+    }
+
+    void free_database(void* ptr) {
+        LargeTableAllocator::instance().deallocate(ptr);
+    }
+
+    std::once_flag g_database_allocator_once;
+}
+
 /**
  * @brief Hyperscan-based backend (high performance)
  * 
@@ -264,6 +343,10 @@ public:
                 ids.push_back(pattern.id);
             }
             
+            std::call_once(g_database_allocator_once, [] {
+                hs_set_database_allocator(allocate_database, free_database);
+            });
+            
             // Compile patterns into database
             hs_compile_error_t* compile_err = nullptr;
             hs_error_t err = hs_compile_multi(
@@ -367,15 +450,19 @@ public:
                         match_ctx->results->whitelist_matches.push_back(pattern_match);
                     }
                     
-                    LOG_DEBUG("🎯 Hyperscan match [{}]: {} at [{}, {})", 
-                             pattern.name, matched_text, from, to);
+                    LOG_EVENT_DEBUG("hyperscan_match",
+                                    dmp::kv("pattern", pattern.name),
+                                    dmp::kv("match", matched_text),
+                                    dmp::kv("from", from),
+                                    dmp::kv("to", to));
                 }
                 
                 return 0; // Continue matching
             };
             
             // Perform scan
-            hs_error_t err = hs_scan(database_, text.c_str(), text.length(), 0,
+            const std::string_view window = scan_window(text);
+            hs_error_t err = hs_scan(database_, window.data(), static_cast<unsigned int>(window.size()), 0,
                                     scratch_, match_callback, &context);
             
             if (err != HS_SUCCESS) {
@@ -416,6 +503,7 @@ public:
                                                        text_results.whitelist_matches.end());
             aggregated_results.evaluation_time_us += text_results.evaluation_time_us;
             aggregated_results.patterns_checked = text_results.patterns_checked;
+            aggregated_results.texts_over_budget += text_results.texts_over_budget;
         }
         
         return aggregated_results;
@@ -454,6 +542,11 @@ public:
         uint64_t count = match_count_.load();
         return count > 0 ? static_cast<double>(total_match_time_us_.load()) / count : 0.0;
     }
+    
+    void reset_statistics() override {
+        match_count_.store(0, std::memory_order_relaxed);
+        total_match_time_us_.store(0, std::memory_order_relaxed);
+    }
 };
 #endif // ENABLE_HYPERSCAN
 
@@ -470,6 +563,7 @@ private:
     std::vector<Pattern> loaded_patterns_;
     bool initialized_;
     std::string last_error_;
+    PatternScanLimits scan_limits_;
     mutable std::mutex impl_mutex_;
     
 public:
@@ -572,11 +666,12 @@ public:
                                                        field_results.whitelist_matches.end());
             aggregated_results.evaluation_time_us += field_results.evaluation_time_us;
             aggregated_results.patterns_checked = field_results.patterns_checked;
+            aggregated_results.texts_over_budget += field_results.texts_over_budget;
         }
         
-        LOG_DEBUG("🔍 Pattern matching completed: {} matches found in {:.2f}ms",
-                 aggregated_results.total_matches(), 
-                 aggregated_results.evaluation_time_us / 1000.0);
+        LOG_EVENT_DEBUG("pattern_matching_completed",
+                        dmp::kv("matches", aggregated_results.total_matches()),
+                        dmp::kv("latency_ms", aggregated_results.evaluation_time_us / 1000.0));
         
         return aggregated_results;
     }
@@ -600,6 +695,17 @@ public:
         return backend_->match_batch(texts, category);
     }
     
+    void set_scan_limits(const PatternScanLimits& limits) {
+        scan_limits_ = limits;
+        if (backend_) {
+            backend_->set_scan_limits(limits);
+        }
+    }
+    
+    PatternScanLimits get_scan_limits() const {
+        return scan_limits_;
+    }
+    
     std::vector<Pattern> get_loaded_patterns() const {
         return loaded_patterns_;
     }
@@ -630,6 +736,7 @@ public:
         if (auto* std_backend = dynamic_cast<StdRegexBackend*>(backend_.get())) {
             stats["match_count"] = std_backend->get_match_count();
             stats["avg_match_time_us"] = static_cast<uint64_t>(std_backend->get_average_match_time_us());
+            stats["scan_budget_exceeded"] = std_backend->get_texts_over_budget();
         }
 #ifdef ENABLE_HYPERSCAN
         else if (auto* hs_backend = dynamic_cast<HyperscanBackend*>(backend_.get())) {
@@ -642,7 +749,9 @@ public:
     }
     
     void reset_statistics() {
-        // Statistics are reset automatically when backends are recreated
+        if (backend_) {
+            backend_->reset_statistics();
+        }
         LOG_INFO("📊 Pattern matcher statistics reset");
     }
     
@@ -790,10 +899,15 @@ std::string wildcard_to_regex(const std::string& wildcard_pattern) {
     
     regex_pattern += "^"; // Anchor to start
     
+    char previous = '\0';
     for (char c : wildcard_pattern) {
+        const bool repeated_star = c == '*' && previous == '*';
+        previous = c;
         switch (c) {
             case '*':
-                regex_pattern += ".*";
+                if (!repeated_star) {
+                    regex_pattern += ".*";
+                }
                 break;
             case '?':
                 regex_pattern += ".";
@@ -823,6 +937,54 @@ std::string wildcard_to_regex(const std::string& wildcard_pattern) {
     return regex_pattern;
 }
 
+bool wildcard_match(std::string_view wildcard_pattern, std::string_view text, bool case_sensitive) {
+    auto same = [case_sensitive](char pattern_char, char text_char) {
+        return pattern_char == text_char ||
+               (!case_sensitive && std::tolower(static_cast<unsigned char>(pattern_char)) ==
+                                   std::tolower(static_cast<unsigned char>(text_char)));
+    };
+    auto any = [](char text_char) { return text_char != '\n' && text_char != '\r'; };
+    
+    // Greedy scan that only ever backtracks to the most recent '*'
+    size_t p = 0;
+    size_t t = 0;
+    size_t star = std::string_view::npos;
+    size_t star_end = 0;  // Text consumed by the most recent '*' ends here
+    while (t < text.size()) {
+        if (p < wildcard_pattern.size() && wildcard_pattern[p] == '*') {
+            star = p++;
+            star_end = t;
+        } else if (p < wildcard_pattern.size() &&
+                   (wildcard_pattern[p] == '?' ? any(text[t]) : same(wildcard_pattern[p], text[t]))) {
+            ++p;
+            ++t;
+        } else if (star != std::string_view::npos && any(text[star_end])) {
+            p = star + 1;
+            t = ++star_end;
+        } else {
+            return false;
+        }
+    }
+    while (p < wildcard_pattern.size() && wildcard_pattern[p] == '*') {
+        ++p;
+    }
+    return p == wildcard_pattern.size();
+}
+
+namespace {
+    std::string escape_dots(const std::string& text) {
+        std::string escaped;
+        escaped.reserve(text.size() * 2);
+        for (char c : text) {
+            if (c == '.') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+}
+
 Result<std::string> cidr_to_regex(const std::string& cidr_pattern) {
     try {
         size_t slash_pos = cidr_pattern.find('/');
@@ -848,18 +1010,14 @@ Result<std::string> cidr_to_regex(const std::string& cidr_pattern) {
             // /24 or smaller - match first 3 octets exactly
             size_t last_dot = ip_part.find_last_of('.');
             if (last_dot != std::string::npos) {
-                std::string prefix = ip_part.substr(0, last_dot);
                 // Escape dots for regex
-                std::replace(prefix.begin(), prefix.end(), '.', '\\');
-                regex_pattern += prefix + "\\.\\d{1,3}";
+                regex_pattern += escape_dots(ip_part.substr(0, last_dot)) + "\\.\\d{1,3}";
             }
         } else if (prefix_length >= 16) {
             // /16 to /23 - match first 2 octets
             size_t second_dot = ip_part.find('.', ip_part.find('.') + 1);
             if (second_dot != std::string::npos) {
-                std::string prefix = ip_part.substr(0, second_dot);
-                std::replace(prefix.begin(), prefix.end(), '.', '\\');
-                regex_pattern += prefix + "\\.\\d{1,3}\\.\\d{1,3}";
+                regex_pattern += escape_dots(ip_part.substr(0, second_dot)) + "\\.\\d{1,3}\\.\\d{1,3}";
             }
         } else {
             // /8 to /15 - match first octet
@@ -964,6 +1122,14 @@ PatternMatchResults PatternMatcher::match_batch(const std::vector<std::string>&
     return pimpl_->match_batch(texts, category);
 }
 
+void PatternMatcher::set_scan_limits(const PatternScanLimits& limits) {
+    pimpl_->set_scan_limits(limits);
+}
+
+PatternScanLimits PatternMatcher::get_scan_limits() const {
+    return pimpl_->get_scan_limits();
+}
+
 std::vector<Pattern> PatternMatcher::get_loaded_patterns() const {
     return pimpl_->get_loaded_patterns();
 }
@@ -980,6 +1146,10 @@ void PatternMatcher::reset_statistics() {
     pimpl_->reset_statistics();
 }
 
+uint64_t PatternMatcher::scans_over_budget() {
+    return g_scans_over_budget.load(std::memory_order_relaxed);
+}
+
 bool PatternMatcher::is_initialized() const {
     return pimpl_->is_initialized();
 }
@@ -1,6 +1,7 @@
 #include "engine/rule_engine.hpp"
 #include "common/types.hpp"
 #include "utils/logger.hpp"
+#include "utils/structured_log.hpp"
 #include <exprtk.hpp>
 #include <simdjson.h>
 #include <fstream>
@@ -16,10 +17,110 @@
 
 namespace dmp {
 
-// Thread-local storage for compiled expressions
-thread_local static std::unordered_map<std::string, std::unique_ptr<exprtk::expression<double>>> tl_compiled_rules;
-thread_local static exprtk::symbol_table<double> tl_symbol_table;
-thread_local static bool tl_symbol_table_initialized = false;
+namespace {
+    /**
+     * @brief Source of rule set generations, unique across all engines
+     *
+     * Thread-local compiled expressions are tagged with the generation they
+     * were built from, so loading new rules (or evaluating through another
+     * engine) invalidates them on every thread, not just the loading one.
+     */
+    std::atomic<uint64_t> g_next_rule_generation{1};
+    
+    /**
+     * @brief Storage for every variable a rule expression may reference
+     *
+     * The symbol table binds these members by address once; each evaluation
+     * copies the request's values in, so compiled expressions stay valid.
+     */
+    struct RuleSymbols {
+        double amount = 0.0;
+        std::string currency;
+        std::string merchant_id;
+        double merchant_category = 0.0;
+        std::string pos_entry_mode;
+        std::string card_token;
+        std::string issuer_country;
+        std::string card_brand;
+        std::string ip_address;
+        std::string device_fingerprint;
+        std::string user_agent;
+        std::string customer_id;
+        double customer_risk_score = 0.0;
+        double account_age_days = 0.0;
+        double merchant_risk = 0.0;
+        double hourly_count = 0.0;
+        double amount_sum = 0.0;
+        double ip_blacklist_match = 0.0;
+        
+        exprtk::symbol_table<double> table;
+        
+        RuleSymbols() {
+            table.add_variable("amount", amount);
+            table.add_stringvar("currency", currency);
+            table.add_stringvar("merchant_id", merchant_id);
+            table.add_variable("merchant_category", merchant_category);
+            table.add_stringvar("pos_entry_mode", pos_entry_mode);
+            
+            table.add_stringvar("card_token", card_token);
+            table.add_stringvar("issuer_country", issuer_country);
+            table.add_stringvar("card_brand", card_brand);
+            
+            table.add_stringvar("ip_address", ip_address);
+            table.add_stringvar("device_fingerprint", device_fingerprint);
+            table.add_stringvar("user_agent", user_agent);
+            
+            table.add_stringvar("customer_id", customer_id);
+            table.add_variable("customer_risk_score", customer_risk_score);
+            table.add_variable("account_age_days", account_age_days);
+            
+            // Derived fields
+            table.add_variable("merchant_risk", merchant_risk);
+            table.add_variable("hourly_count", hourly_count);
+            table.add_variable("amount_sum", amount_sum);
+            table.add_variable("ip_blacklist_match", ip_blacklist_match);
+        }
+        
+        // Bound by address
+        RuleSymbols(const RuleSymbols&) = delete;
+        RuleSymbols& operator=(const RuleSymbols&) = delete;
+        
+        void assign(const RuleContext& context) {
+            amount = context.amount;
+            currency = context.currency;
+            merchant_id = context.merchant_id;
+            merchant_category = static_cast<double>(context.merchant_category);
+            pos_entry_mode = context.pos_entry_mode;
+            card_token = context.card_token;
+            issuer_country = context.issuer_country;
+            card_brand = context.card_brand;
+            ip_address = context.ip_address;
+            device_fingerprint = context.device_fingerprint;
+            user_agent = context.user_agent;
+            customer_id = context.customer_id;
+            customer_risk_score = static_cast<double>(context.customer_risk_score);
+            account_age_days = static_cast<double>(context.account_age_days);
+            merchant_risk = static_cast<double>(context.merchant_risk);
+            hourly_count = static_cast<double>(context.hourly_count);
+            amount_sum = context.amount_sum;
+            ip_blacklist_match = context.ip_blacklist_match ? 1.0 : 0.0;
+        }
+    };
+    
+    /**
+     * @brief Compiled expressions of one rule set generation for one thread
+     *
+     * A null expression marks a rule that failed to compile, so it is not
+     * recompiled on every request.
+     */
+    struct ThreadRuleCache {
+        uint64_t generation = 0;
+        RuleSymbols symbols;
+        std::unordered_map<std::string, std::unique_ptr<exprtk::expression<double>>> compiled;
+    };
+    
+    thread_local ThreadRuleCache tl_rule_cache;
+}
 
 // Memory pool for reducing allocations
 thread_local static std::pmr::unsynchronized_pool_resource tl_memory_pool;
@@ -35,7 +136,15 @@ public:
     std::string config_path_;
     std::string last_error_;
     
-    RuleConfig current_config_;
+    /**
+     * @brief Loaded rules tagged with their generation; replaced, never modified
+     */
+    struct RuleSet {
+        RuleConfig config;
+        uint64_t generation = 0;
+    };
+    
+    std::shared_ptr<const RuleSet> rule_set_ = std::make_shared<const RuleSet>();
     std::filesystem::file_time_type last_file_time_;
     
     // Hot reload thread
@@ -50,6 +159,11 @@ public:
     
     Impl() = default;
     
+    std::shared_ptr<const RuleSet> current_rule_set() const {
+        std::shared_lock<std::shared_mutex> lock(config_mutex_);
+        return rule_set_;
+    }
+    
     ~Impl() {
         disable_hot_reload();
     }
@@ -176,15 +290,19 @@ public:
             std::sort(new_config.rules.begin(), new_config.rules.end(),
                 [](const Rule& a, const Rule& b) { return a.weight > b.weight; });
             
-            // Update configuration atomically
+            auto rule_set = std::make_shared<RuleSet>();
+            rule_set->config = std::move(new_config);
+            rule_set->generation = g_next_rule_generation.fetch_add(1, std::memory_order_relaxed);
+            
+            // Update configuration atomically; every thread recompiles on its next evaluation
             {
                 std::unique_lock<std::shared_mutex> lock(config_mutex_);
-                current_config_ = std::move(new_config);
+                rule_set_ = rule_set;
                 config_path_ = config_path;
                 
                 // Update rule statistics
                 std::lock_guard<std::mutex> stats_lock(stats_mutex_);
-                for (const auto& rule : current_config_.rules) {
+                for (const auto& rule : rule_set->config.rules) {
                     if (rule_stats_.find(rule.id) == rule_stats_.end()) {
                         rule_stats_[rule.id] = rule;
                         // Initialize statistics fields
@@ -195,12 +313,8 @@ public:
                 }
             }
             
-            // Clear thread-local cache to force recompilation
-            tl_compiled_rules.clear();
-            tl_symbol_table_initialized = false;
-            
             initialized_.store(true);
-            LOG_INFO("Loaded {} rules from {}", current_config_.rules.size(), config_path);
+            LOG_INFO("Loaded {} rules from {}", rule_set->config.rules.size(), config_path);
             
             return Result<void>{};
             
@@ -210,48 +324,11 @@ public:
         }
     }
     
-    void initialize_symbol_table(const RuleContext& context) {
-        // Always clear and reinitialize to ensure fresh values
-        tl_symbol_table.clear();
-        
-        // Add all context variables to symbol table
-        tl_symbol_table.add_variable("amount", const_cast<double&>(context.amount));
-        tl_symbol_table.add_stringvar("currency", const_cast<std::string&>(context.currency));
-        tl_symbol_table.add_stringvar("merchant_id", const_cast<std::string&>(context.merchant_id));
-        double merchant_category_val = static_cast<double>(context.merchant_category);
-        tl_symbol_table.add_variable("merchant_category", merchant_category_val);
-        tl_symbol_table.add_stringvar("pos_entry_mode", const_cast<std::string&>(context.pos_entry_mode));
-        
-        tl_symbol_table.add_stringvar("card_token", const_cast<std::string&>(context.card_token));
-        tl_symbol_table.add_stringvar("issuer_country", const_cast<std::string&>(context.issuer_country));
-        tl_symbol_table.add_stringvar("card_brand", const_cast<std::string&>(context.card_brand));
-        
-        tl_symbol_table.add_stringvar("ip_address", const_cast<std::string&>(context.ip_address));
-        tl_symbol_table.add_stringvar("device_fingerprint", const_cast<std::string&>(context.device_fingerprint));
-        tl_symbol_table.add_stringvar("user_agent", const_cast<std::string&>(context.user_agent));
-        
-        tl_symbol_table.add_stringvar("customer_id", const_cast<std::string&>(context.customer_id));
-        double customer_risk_score_val = static_cast<double>(context.customer_risk_score);
-        tl_symbol_table.add_variable("customer_risk_score", customer_risk_score_val);
-        double account_age_days_val = static_cast<double>(context.account_age_days);
-        tl_symbol_table.add_variable("account_age_days", account_age_days_val);
-        
-        // Derived fields
-        double merchant_risk_val = static_cast<double>(context.merchant_risk);
-        tl_symbol_table.add_variable("merchant_risk", merchant_risk_val);
-        double hourly_count_val = static_cast<double>(context.hourly_count);
-        tl_symbol_table.add_variable("hourly_count", hourly_count_val);
-        tl_symbol_table.add_variable("amount_sum", const_cast<double&>(context.amount_sum));
-        double ip_blacklist_match_val = static_cast<double>(context.ip_blacklist_match ? 1.0 : 0.0);
-        tl_symbol_table.add_variable("ip_blacklist_match", ip_blacklist_match_val);
-        
-        tl_symbol_table_initialized = true;
-    }
-    
     std::unique_ptr<exprtk::expression<double>> compile_rule(const std::string& rule_id, 
-                                                           const std::string& expression) {
+                                                           const std::string& expression,
+                                                           exprtk::symbol_table<double>& symbol_table) const {
         auto compiled_expr = std::make_unique<exprtk::expression<double>>();
-        compiled_expr->register_symbol_table(tl_symbol_table);
+        compiled_expr->register_symbol_table(symbol_table);
         
         exprtk::parser<double> parser;
         if (!parser.compile(expression, *compiled_expr)) {
@@ -262,6 +339,35 @@ public:
         return compiled_expr;
     }
     
+    Result<void> validate() const {
+        if (!initialized_.load()) {
+            return Result<void>{ErrorCode::INVALID_REQUEST, "Rules not loaded yet"};
+        }
+        
+        auto rule_set = current_rule_set();
+        const auto& thresholds = rule_set->config.thresholds;
+        if (thresholds.approve_threshold > thresholds.review_threshold) {
+            return Result<void>{ErrorCode::INVALID_REQUEST,
+                "approve_threshold exceeds review_threshold"};
+        }
+        
+        // Scratch symbol table; the expressions are discarded afterwards
+        RuleSymbols symbols;
+        exprtk::parser<double> parser;
+        for (const auto& rule : rule_set->config.rules) {
+            if (!rule.enabled) {
+                continue;
+            }
+            exprtk::expression<double> expression;
+            expression.register_symbol_table(symbols.table);
+            if (!parser.compile(rule.expression, expression)) {
+                return Result<void>{ErrorCode::RULE_EVALUATION_FAILED,
+                    "Rule " + rule.id + " does not compile: " + parser.error()};
+            }
+        }
+        return Result<void>{};
+    }
+    
     void hot_reload_worker() {
         LOG_INFO("Hot reload thread started, checking every {}ms", check_interval_ms_);
         
@@ -290,12 +396,7 @@ public:
                         // Call reload callback if provided
                         if (reload_callback_) {
                             try {
-                                RuleConfig config_copy;
-                                {
-                                    std::shared_lock<std::shared_mutex> lock(config_mutex_);
-                                    config_copy = current_config_;
-                                }
-                                reload_callback_(config_copy);
+                                reload_callback_(current_rule_set()->config);
                             } catch (const std::exception& e) {
                                 LOG_ERROR("Hot reload callback failed: {}", e.what());
                             }
@@ -417,28 +518,32 @@ RuleEvaluationMetrics RuleEngine::evaluate_rules(const TransactionRequest& reque
         return metrics;
     }
     
-    // Initialize thread-local symbol table
-    pimpl_->initialize_symbol_table(context);
+    // Pin the current rule set; a concurrent reload publishes a new one
+    auto rule_set = pimpl_->current_rule_set();
     
-    // Get current enabled rules
-    std::vector<Rule> enabled_rules;
-    {
-        std::shared_lock<std::shared_mutex> lock(pimpl_->config_mutex_);
-        enabled_rules = pimpl_->current_config_.get_enabled_rules();
+    auto& cache = tl_rule_cache;
+    if (cache.generation != rule_set->generation) {
+        cache.compiled.clear();
+        cache.generation = rule_set->generation;
     }
+    cache.symbols.assign(context);
     
-    metrics.rule_results.reserve(enabled_rules.size());
-    metrics.rules_evaluated = enabled_rules.size();
+    const auto& rules = rule_set->config.rules;
+    metrics.rule_results.reserve(rules.size());
     
-    // Evaluate each rule
-    for (const auto& rule : enabled_rules) {
+    // Evaluate each enabled rule
+    for (const auto& rule : rules) {
+        if (!rule.enabled) {
+            continue;
+        }
+        metrics.rules_evaluated++;
         auto rule_start = std::chrono::high_resolution_clock::now();
         
         try {
             // Get or compile expression
-            auto it = tl_compiled_rules.find(rule.id);
-            if (it == tl_compiled_rules.end()) {
-                auto compiled = pimpl_->compile_rule(rule.id, rule.expression);
+            auto it = cache.compiled.find(rule.id);
+            if (it == cache.compiled.end()) {
+                auto compiled = pimpl_->compile_rule(rule.id, rule.expression, cache.symbols.table);
                 if (!compiled) {
                     LOG_ERROR("Failed to compile rule {}, skipping", rule.id);
                     // Initialize statistics even for failed rules
@@ -448,9 +553,11 @@ RuleEvaluationMetrics RuleEngine::evaluate_rules(const TransactionRequest& reque
                             pimpl_->rule_stats_[rule.id] = rule;
                         }
                     }
-                    continue;
                 }
-                it = tl_compiled_rules.emplace(rule.id, std::move(compiled)).first;
+                it = cache.compiled.emplace(rule.id, std::move(compiled)).first;
+            }
+            if (!it->second) {
+                continue;
             }
             
             // Evaluate expression
@@ -493,16 +600,26 @@ RuleEvaluationMetrics RuleEngine::evaluate_rules(const TransactionRequest& reque
     
     metrics.end_time = std::chrono::steady_clock::now();
     
-    LOG_DEBUG("Evaluated {} rules for request {}, score: {:.2f}, triggered: {}, latency: {:.2f}ms",
-        metrics.rules_evaluated, request.request_id, metrics.total_score,
-        metrics.rules_triggered, metrics.get_latency_ms());
+    LOG_EVENT_DEBUG("rules_evaluated",
+        dmp::kv("rules", metrics.rules_evaluated),
+        dmp::kv("request", request.request_id),
+        dmp::kv("score", metrics.total_score),
+        dmp::kv("triggered", metrics.rules_triggered),
+        dmp::kv("latency_ms", metrics.get_latency_ms()));
     
     return metrics;
 }
 
+Result<void> RuleEngine::validate() const {
+    return pimpl_->validate();
+}
+
 RuleConfig RuleEngine::get_current_config() const {
-    std::shared_lock<std::shared_mutex> lock(pimpl_->config_mutex_);
-    return pimpl_->current_config_;
+    return pimpl_->current_rule_set()->config;
+}
+
+RuleThresholds RuleEngine::get_thresholds() const {
+    return pimpl_->current_rule_set()->config.thresholds;
 }
 
 std::unordered_map<std::string, Rule> RuleEngine::get_rule_statistics() const {
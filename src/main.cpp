@@ -9,7 +9,21 @@
 #include "common/types.hpp"
 #include "common/config.hpp"
 #include "core/transaction.hpp"
+#include "core/readiness.hpp"
+#include "core/reload_coordinator.hpp"
+#include "core/warmup.hpp"
+#include "utils/alloc_tracker.hpp"
+#include "utils/hw_counters.hpp"
 #include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+#include "utils/latency_tracker.hpp"
+#include "utils/memory_accountant.hpp"
+#include "utils/large_table.hpp"
+#include "utils/perf_log.hpp"
+#include "utils/profiler.hpp"
+#include "utils/structured_log.hpp"
+#include "utils/prometheus_exporter.hpp"
+#include "utils/tracing.hpp"
 
 using namespace dmp;
 
@@ -119,6 +133,153 @@ bool initialize_system(std::shared_ptr<SystemConfig> config) {
         LOG_INFO("✅ Response serialization test passed");
         
         LOG_INFO("✅ All core components validated successfully");
+
+        // Start metrics collection and the Prometheus exposition endpoint
+        auto monitoring_config = config->get_monitoring_config();
+        uint16_t metrics_port = monitoring_config.enable_prometheus
+                                    ? monitoring_config.prometheus_port : 0;
+        auto metrics_result = MetricsCollector::instance().initialize(
+            metrics_port, monitoring_config.metrics_path, monitoring_config.render_cache_ms);
+        if (metrics_result.is_error()) {
+            std::cerr << "❌ Metrics initialization failed: " << metrics_result.error_message << std::endl;
+            return false;
+        }
+
+        MetricsCollector::instance().register_counter(
+            "dmp_log_messages_dropped_total", "Log records dropped because the async queue was full",
+            [] { return static_cast<double>(Logger::dropped_messages()); });
+        MetricsCollector::instance().register_counter(
+            "dmp_log_events_dropped_total", "Structured log events dropped because the event queue was full",
+            [] { return static_cast<double>(StructuredLogger::instance().dropped()); });
+
+        // Huge-page/NUMA placement for pattern databases and other large tables
+        auto memory_result = LargeTableAllocator::instance().configure(config->get_memory_config());
+        if (memory_result.is_error()) {
+            LOG_ERROR("Large table allocator left at defaults: {}", memory_result.error_message);
+        }
+        MetricsCollector::instance().register_gauge(
+            "dmp_large_table_bytes", "Bytes mapped for large tables",
+            [] { return static_cast<double>(LargeTableAllocator::instance().stats().mapped_bytes); });
+        MetricsCollector::instance().register_gauge(
+            "dmp_large_table_huge_page_bytes", "Large table bytes backed by explicit or transparent huge pages",
+            [] {
+                auto stats = LargeTableAllocator::instance().stats();
+                return static_cast<double>(stats.explicit_huge_bytes + stats.transparent_huge_bytes);
+            });
+
+        // Memory budget: max_memory_gb, capped by the container limit, enforced by graded reclaim
+        auto& accountant = MemoryAccountant::instance();
+        auto budget_result = accountant.configure(
+            static_cast<uint64_t>(config->get_server_config().max_memory_gb) << 30, config->get_memory_config());
+        if (budget_result.is_error()) {
+            LOG_ERROR("Memory budget not enforced: {}", budget_result.error_message);
+        }
+        accountant.register_consumer("large_tables",
+            [] { return LargeTableAllocator::instance().stats().mapped_bytes; });
+        MetricsCollector::instance().register_gauge(
+            "dmp_memory_resident_bytes", "Resident memory at the last sample",
+            [] { return static_cast<double>(MemoryAccountant::instance().used_bytes()); });
+        MetricsCollector::instance().register_gauge(
+            "dmp_memory_limit_bytes", "Effective memory limit (max_memory_gb or container limit)",
+            [] { return static_cast<double>(MemoryAccountant::instance().limit_bytes()); });
+        MetricsCollector::instance().register_gauge(
+            "dmp_memory_pressure", "Memory pressure grade (0 normal, 1 elevated, 2 critical)",
+            [] { return static_cast<double>(MemoryAccountant::instance().pressure()); });
+        MetricsCollector::instance().register_counter(
+            "dmp_memory_reclaimed_bytes_total", "Bytes released by memory consumers under pressure",
+            [] { return static_cast<double>(MemoryAccountant::instance().reclaimed_bytes()); });
+        MetricsCollector::instance().register_counter(
+            "dmp_memory_admissions_refused_total", "Reloads and allocations refused by the memory budget",
+            [] { return static_cast<double>(MemoryAccountant::instance().refused()); });
+        accountant.start();
+
+        // Request tracing; retained spans are exported on demand via the metrics listener
+        Tracer::instance().configure(config->get_tracing_config());
+        
+        // Binary per-request stage timings (analyzed offline with dmp_perfstat)
+        auto perf_log_result = PerfLog::instance().configure(config->get_perf_log_config());
+        if (perf_log_result.is_error()) {
+            LOG_ERROR("Performance log disabled: {}", perf_log_result.error_message);
+        }
+        MetricsCollector::instance().register_counter(
+            "dmp_perf_records_dropped_total", "Performance log records dropped because the queue was full",
+            [] { return static_cast<double>(PerfLog::instance().dropped()); });
+        
+        // Cycles / instructions / LLC and branch misses per stage, one decision in N
+        const auto hw_counters_config = config->get_hardware_counters_config();
+        HwCounters::instance().configure(hw_counters_config);
+        if (HwCounters::instance().enabled()) {
+            LOG_INFO("🔬 Hardware counters sampled every {} decisions per thread",
+                     hw_counters_config.sample_every);
+        }
+        
+        // On-demand CPU profile: POST /debug/profile?action=start|stop or SIGUSR2
+        const auto profiler_config = config->get_profiler_config();
+        auto profiler_result = SamplingProfiler::instance().configure(profiler_config);
+        if (profiler_result.is_error()) {
+            LOG_ERROR("Sampling profiler disabled: {}", profiler_result.error_message);
+        } else if (profiler_config.enabled) {
+            LOG_INFO("🔥 Sampling profiler ready: {} Hz, profiles written to {}",
+                     profiler_config.frequency_hz, profiler_config.output_directory);
+        }
+        if constexpr (AllocationTracker::enabled()) {
+            LOG_INFO("🧾 Heap allocation tracking enabled");
+            MetricsCollector::instance().register_counter(
+                "dmp_heap_allocations_total", "operator new calls since start",
+                [] { return static_cast<double>(AllocationTracker::process_stats().allocations); });
+            MetricsCollector::instance().register_counter(
+                "dmp_heap_allocated_bytes_total", "Bytes requested from operator new since start",
+                [] { return static_cast<double>(AllocationTracker::process_stats().bytes); });
+            MetricsCollector::instance().register_gauge(
+                "dmp_heap_live_allocations", "operator new calls not yet matched by operator delete",
+                [] {
+                    const auto stats = AllocationTracker::process_stats();
+                    return static_cast<double>(stats.allocations - stats.deallocations);
+                });
+        }
+        if (auto* exporter = MetricsCollector::instance().exporter()) {
+            // Actions that write files or start sampling are POST-only; GET only reads status
+            exporter->add_post_route("/debug/traces", [](const std::string& query) {
+                auto format = query.find("format=otlp") != std::string::npos
+                                  ? TraceExportFormat::OTLP_JSON : TraceExportFormat::CHROME;
+                auto result = Tracer::instance().export_snapshot(format);
+                return result.is_success()
+                    ? PrometheusExporter::RouteResponse{200, result.value + "\n"}
+                    : PrometheusExporter::RouteResponse{500, "error: " + result.error_message + "\n"};
+            });
+            exporter->add_post_route("/debug/profile", [](const std::string& query) {
+                auto& profiler = SamplingProfiler::instance();
+                if (query.find("action=start") != std::string::npos) {
+                    uint32_t seconds = 0;
+                    auto pos = query.find("seconds=");
+                    if (pos != std::string::npos) {
+                        seconds = static_cast<uint32_t>(std::strtoul(query.c_str() + pos + 8, nullptr, 10));
+                    }
+                    auto result = profiler.start(seconds);
+                    return result.is_success()
+                        ? PrometheusExporter::RouteResponse{200, "profiling started\n"}
+                        : PrometheusExporter::RouteResponse{409, "error: " + result.error_message + "\n"};
+                }
+                if (query.find("action=stop") != std::string::npos) {
+                    auto result = profiler.stop();
+                    if (result.is_success()) {
+                        return PrometheusExporter::RouteResponse{200, result.value + "\n"};
+                    }
+                    return PrometheusExporter::RouteResponse{
+                        profiler.running() ? 500 : 409, "error: " + result.error_message + "\n"};
+                }
+                return PrometheusExporter::RouteResponse{400, "expected action=start or action=stop\n"};
+            });
+            exporter->add_status_route("/debug/profile", [](const std::string&) {
+                const auto& profiler = SamplingProfiler::instance();
+                auto stats = profiler.stats();
+                return PrometheusExporter::RouteResponse{200, fmt::format(
+                    "{{\"running\":{},\"samples\":{},\"dropped\":{},\"unique_stacks\":{},"
+                    "\"elapsed_ms\":{},\"last_output\":\"{}\"}}\n",
+                    stats.running, stats.samples, stats.dropped, stats.unique_stacks,
+                    stats.elapsed_ms, stats.last_output)};
+            });
+        }
         return true;
         
     } catch (const std::exception& e) {
@@ -158,6 +319,7 @@ int main(int argc, char* argv[]) {
             std::cerr << "❌ Failed to initialize logging system" << std::endl;
             return 1;
         }
+        StructuredLogger::instance().start();
         
         // Setup signal handlers for graceful shutdown
         signal(SIGINT, signal_handler);
@@ -193,6 +355,76 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        // Rules, patterns, models and this file are reloaded together as one generation
+        auto reload_config = config->get_reload_config();
+        ReloadCoordinator reload_coordinator(ReloadSources::from_config(config_path, reload_config),
+                                             reload_config.settle_ms);
+        if (reload_config.preflight) {
+            reload_coordinator.enable_preflight(PreflightOptions::from_config(reload_config));
+        }
+        auto reload_result = reload_coordinator.load_initial();
+        if (reload_result.is_error()) {
+            LOG_ERROR("Hot reload disabled, initial load failed: {}", reload_result.error_message);
+        } else if (reload_config.enabled) {
+            reload_coordinator.start(reload_config.check_interval_ms);
+        }
+        MetricsCollector::instance().register_gauge(
+            "dmp_config_generation", "Published configuration generation",
+            [&reload_coordinator] { return static_cast<double>(reload_coordinator.generation_id()); });
+        MetricsCollector::instance().register_counter(
+            "dmp_pattern_scans_over_budget_total", "Pattern scans stopped at max_scan_us (decision forced to REVIEW)",
+            [] { return static_cast<double>(PatternMatcher::scans_over_budget()); });
+        MetricsCollector::instance().register_counter(
+            "dmp_config_reload_failures_total", "Configuration reloads rejected by staging or validation",
+            [&reload_coordinator] { return static_cast<double>(reload_coordinator.failures()); });
+        
+        // Not ready until the decision path has been warmed on the published generation
+        MetricsCollector::instance().register_gauge(
+            "dmp_ready", "1 when the instance accepts traffic",
+            [] { return Readiness::instance().is_ready() ? 1.0 : 0.0; });
+        if (auto* exporter = MetricsCollector::instance().exporter()) {
+            exporter->add_status_route("/ready", [](const std::string&) {
+                return PrometheusExporter::RouteResponse{
+                    Readiness::instance().is_ready() ? 200 : 503, Readiness::instance().to_json() + "\n"};
+            });
+        }
+        auto warmup_config = config->get_warmup_config();
+        if (reload_result.is_error()) {
+            LOG_ERROR("Not ready: no rules, patterns or models were published");
+        } else if (warmup_config.enabled) {
+            Readiness::instance().set_state(ReadinessState::WARMING_UP);
+            WarmupRunner warmup(warmup_config);
+            auto corpus_result = warmup.load_corpus();
+            if (corpus_result.is_error()) {
+                LOG_ERROR("Warm-up corpus unusable, using synthetic traffic: {}", corpus_result.error_message);
+            }
+            // Phase 1 has no request workers yet, so the thread to warm is this one;
+            // the Phase 2 server passes a dispatcher onto its own worker pool instead
+            auto warmup_result = warmup.run(*reload_coordinator.current(), 1,
+                                            WarmupRunner::on_calling_thread());
+            bool warmed = false;
+            if (warmup_result.is_error()) {
+                LOG_ERROR("Warm-up failed: {}", warmup_result.error_message);
+            } else {
+                const auto& report = warmup_result.value;
+                LOG_INFO("🔥 Warm-up: {} transactions on {} threads in {:.0f} ms, first {:.1f}us → last {:.1f}us{}",
+                         report.transactions, report.threads, report.elapsed_ms,
+                         report.first_mean_us, report.last_mean_us,
+                         report.timed_out ? " (timed out)" : "");
+                warmed = !report.timed_out && report.errors == 0;
+                if (report.errors > 0) {
+                    LOG_ERROR("Warm-up: {} transactions failed to parse or validate", report.errors);
+                }
+            }
+            if (warmed || warmup_config.ready_on_failure) {
+                Readiness::instance().set_state(ReadinessState::READY);
+            } else {
+                LOG_ERROR("Not ready: warm-up did not complete ([warmup] ready_on_failure = false)");
+            }
+        } else {
+            Readiness::instance().set_state(ReadinessState::READY);
+        }
+        
         LOG_INFO("📝 Phase 1 Summary:");
         LOG_INFO("  ✅ Configuration management (TOML parsing, validation)");
         LOG_INFO("  ✅ Core data structures (Transaction, Decision, Features)");
@@ -200,8 +432,18 @@ int main(int argc, char* argv[]) {
         LOG_INFO("  ✅ Result template and error handling");
         LOG_INFO("  ✅ Cache key generation");
         LOG_INFO("  🚧 HTTP server (placeholder - will be added in Phase 2)");
-        LOG_INFO("  🚧 Metrics collection (placeholder - will be added in Phase 2)");
+        LOG_INFO("  ✅ Metrics collection (Prometheus exposition endpoint)");
+        LOG_INFO("  ✅ Coordinated hot reload (rules, patterns, models, configuration)");
+        LOG_INFO("  ✅ Startup warm-up and readiness probe (/ready)");
         
+        // Rolling-window percentiles against the P99 target
+        auto monitoring_config = config->get_monitoring_config();
+        LatencyTracker latency_tracker(MetricsCollector::instance(),
+                                       monitoring_config.metrics_interval_seconds,
+                                       monitoring_config.latency_window_seconds,
+                                       config->get_server_config().target_p99_ms);
+        latency_tracker.start();
+
         // Run main loop (simplified version)
         LOG_INFO("🔄 Running system validation loop...");
         int test_cycles = 0;
@@ -209,14 +451,17 @@ int main(int argc, char* argv[]) {
         while (!shutdown_requested.load() && test_cycles < 10) {
             LOG_INFO("🔍 Validation cycle {}", test_cycles + 1);
             
-            // Test configuration reload
-            auto reload_result = SystemConfig::load_from_file(config_path);
-            if (reload_result.is_error()) {
-                LOG_INFO("⚠️  Configuration reload test failed");
-            } else {
-                LOG_INFO("✅ Configuration reload test passed");
-            }
+            // Configuration reloads are picked up by the coordinator thread
+            const auto generation = reload_coordinator.current();
+            const auto settings = current_config();
+            LOG_INFO("🔧 Configuration generation {} (config v{}, {} rejected reloads)",
+                    generation->id, settings ? settings->version : 0, reload_coordinator.failures());
             
+            auto latency = latency_tracker.latest();
+            LOG_INFO("📈 Decision latency ({}s window): P50 {:.2f}ms, P95 {:.2f}ms, P99 {:.2f}ms, {} rps",
+                    latency.window_seconds, latency.end_to_end.p50_ms, latency.end_to_end.p95_ms,
+                    latency.end_to_end.p99_ms, latency.throughput.requests_per_second);
+
             // Sleep for a bit
             std::this_thread::sleep_for(std::chrono::seconds(2));
             test_cycles++;
@@ -229,6 +474,14 @@ int main(int argc, char* argv[]) {
         }
         
         LOG_INFO("✅ Ready for Phase 2 development");
+        Readiness::instance().set_state(ReadinessState::STOPPING);
+        latency_tracker.stop();
+        reload_coordinator.stop();
+        MemoryAccountant::instance().stop();
+        SamplingProfiler::instance().shutdown();
+        MetricsCollector::instance().shutdown();
+        PerfLog::instance().stop();
+        StructuredLogger::instance().stop();
         
     } catch (const std::exception& e) {
         std::cerr << "❌ Fatal error: " << e.what() << std::endl;
@@ -0,0 +1,109 @@
+#include "utils/histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace dmp {
+
+// HistogramSnapshot implementation
+void HistogramSnapshot::record(uint64_t value_ns, uint64_t count) {
+    if (count == 0) return;
+    buckets_[HistogramLayout::bucket_index(value_ns)] += count;
+    count_ += count;
+    sum_ += value_ns * count;
+    min_ = std::min(min_, value_ns);
+    max_ = std::max(max_, value_ns);
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    if (other.count_ == 0) return;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void HistogramSnapshot::subtract(const HistogramSnapshot& older) {
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        // Guard against shard reuse races producing a transiently smaller older value
+        buckets_[i] = buckets_[i] >= older.buckets_[i] ? buckets_[i] - older.buckets_[i] : 0;
+    }
+    count_ = count_ >= older.count_ ? count_ - older.count_ : 0;
+    sum_ = sum_ >= older.sum_ ? sum_ - older.sum_ : 0;
+    recompute_bounds();
+}
+
+uint64_t HistogramSnapshot::value_at_quantile(double quantile) const {
+    if (count_ == 0) return 0;
+    quantile = std::clamp(quantile, 0.0, 1.0);
+
+    // Rank of the requested observation (1-based), never below the first one
+    uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count_)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            // Report the bucket midpoint, clamped to the observed range
+            uint64_t lower = HistogramLayout::bucket_lower_bound(i);
+            uint64_t upper = HistogramLayout::bucket_upper_bound(i);
+            uint64_t mid = lower + (upper - lower) / 2;
+            return std::clamp(mid, min(), max_);
+        }
+    }
+    return max_;
+}
+
+uint64_t HistogramSnapshot::count_at_or_below(uint64_t value_ns) const {
+    // Only whole buckets that end at or below the bound: the bucket straddling
+    // it may hold larger values, and counting them would break `le` semantics
+    size_t end = HistogramLayout::bucket_index(value_ns);
+    if (value_ns >= HistogramLayout::bucket_upper_bound(end)) {
+        ++end;
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i < end && i < buckets_.size(); ++i) {
+        total += buckets_[i];
+    }
+    return total;
+}
+
+void HistogramSnapshot::reset() {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+void HistogramSnapshot::recompute_bounds() {
+    min_ = UINT64_MAX;
+    max_ = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        if (buckets_[i] == 0) continue;
+        min_ = std::min(min_, HistogramLayout::bucket_lower_bound(i));
+        max_ = std::max(max_, HistogramLayout::bucket_upper_bound(i));
+    }
+}
+
+// LatencyHistogram implementation
+void LatencyHistogram::accumulate_into(HistogramSnapshot& snapshot) const {
+    // Derive the count from the buckets actually read so that quantiles stay
+    // consistent while the owning thread keeps recording.
+    uint64_t bucket_total = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        uint64_t value = buckets_[i].load(std::memory_order_relaxed);
+        snapshot.buckets_[i] += value;
+        bucket_total += value;
+    }
+
+    snapshot.count_ += bucket_total;
+    snapshot.sum_ += sum_.load(std::memory_order_relaxed);
+    snapshot.min_ = std::min(snapshot.min_, min_.load(std::memory_order_relaxed));
+    snapshot.max_ = std::max(snapshot.max_, max_.load(std::memory_order_relaxed));
+}
+
+} // namespace dmp
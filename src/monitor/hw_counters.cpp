@@ -0,0 +1,150 @@
+#include "utils/hw_counters.hpp"
+#include "common/config.hpp"
+#include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace dmp {
+
+namespace {
+    /**
+     * @brief The calling thread's perf event group
+     *
+     * slot[e] is the position of event e in a group read, or -1 when the
+     * event could not be opened on this thread.
+     */
+    struct ThreadGroup {
+        bool attempted = false;
+        int leader = -1;
+        std::array<int, HW_EVENT_COUNT> fds{};
+        std::array<int, HW_EVENT_COUNT> slot{};
+        size_t opened = 0;
+
+        ThreadGroup() {
+            fds.fill(-1);
+            slot.fill(-1);
+        }
+
+        ~ThreadGroup() {
+#if defined(__linux__)
+            for (int fd : fds) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+#endif
+        }
+    };
+
+    thread_local ThreadGroup tl_group;
+    thread_local uint32_t tl_request_count = 0;
+    thread_local bool tl_sampled = false;
+
+#if defined(__linux__)
+    constexpr uint64_t kEventConfigs[HW_EVENT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,  // Last-level cache on the common PMUs
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+
+    int open_event(uint64_t config, int group_fd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+#endif
+}
+
+HwCounters& HwCounters::instance() {
+    static HwCounters instance;
+    return instance;
+}
+
+void HwCounters::configure(const HardwareCountersConfig& config) {
+    sample_every_.store(std::max<uint32_t>(config.sample_every, 1), std::memory_order_relaxed);
+    if (config.enabled && !supported()) {
+        LOG_INFO("⚠️  Hardware counters requested but perf_event_open is Linux-only; disabled");
+    }
+    enabled_.store(config.enabled && supported(), std::memory_order_relaxed);
+}
+
+bool HwCounters::read(HwCounterValues& out) {
+#if defined(__linux__)
+    auto& group = tl_group;
+    if (!group.attempted) {
+        group.attempted = true;
+        for (size_t e = 0; e < HW_EVENT_COUNT; ++e) {
+            int fd = open_event(kEventConfigs[e], group.leader);
+            if (fd < 0) {
+                if (e == 0) {
+                    if (!warned_.exchange(true)) {
+                        LOG_INFO("⚠️  Hardware counters unavailable ({}); check "
+                                 "kernel.perf_event_paranoid or the VM's PMU", std::strerror(errno));
+                    }
+                    return false;
+                }
+                continue;  // Event not provided by this PMU; the rest still count
+            }
+            if (e == 0) {
+                group.leader = fd;
+            }
+            group.fds[e] = fd;
+            group.slot[e] = static_cast<int>(group.opened++);
+            available_events_.fetch_or(1u << e, std::memory_order_relaxed);
+        }
+    }
+    if (group.leader < 0) {
+        return false;
+    }
+
+    uint64_t buffer[1 + HW_EVENT_COUNT];
+    const ssize_t bytes = ::read(group.leader, buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(sizeof(uint64_t) * (1 + group.opened)) || buffer[0] != group.opened) {
+        return false;
+    }
+    for (size_t e = 0; e < HW_EVENT_COUNT; ++e) {
+        out.values[e] = group.slot[e] >= 0 ? buffer[1 + group.slot[e]] : 0;
+    }
+    return true;
+#else
+    (void)out;
+    return false;
+#endif
+}
+
+bool HwCounters::begin_request() {
+    tl_sampled = ++tl_request_count % sample_every_.load(std::memory_order_relaxed) == 0;
+    return tl_sampled;
+}
+
+void HwCounters::end_request() {
+    tl_sampled = false;
+}
+
+bool HwCounters::request_sampled() const {
+    return tl_sampled;
+}
+
+void HwCounters::record_span(PipelineStage stage, const HwCounterValues& start) {
+    HwCounterValues end;
+    if (read(end)) {
+        MetricsCollector::instance().record_stage_counters(stage, end - start);
+    }
+}
+
+} // namespace dmp
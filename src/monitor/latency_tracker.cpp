@@ -0,0 +1,164 @@
+#include "utils/latency_tracker.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace dmp {
+
+namespace {
+    // The decision stage spans the whole pipeline for one transaction
+    constexpr PipelineStage kEndToEndStage = PipelineStage::DECISION;
+
+    const char* const kTrackerGauges[] = {
+        "dmp_decision_latency_p50_milliseconds",
+        "dmp_decision_latency_p95_milliseconds",
+        "dmp_decision_latency_p99_milliseconds",
+        "dmp_decision_requests_per_second",
+    };
+}
+
+LatencyTracker::LatencyTracker(MetricsCollector& collector, uint32_t interval_seconds,
+                               uint32_t window_seconds, float slo_p99_ms)
+    : collector_(collector)
+    , interval_seconds_(std::max<uint32_t>(interval_seconds, 1))
+    , ring_size_(std::max<uint32_t>(window_seconds / std::max<uint32_t>(interval_seconds, 1), 1) + 1)
+    , slo_p99_ms_(slo_p99_ms) {
+    ring_.resize(ring_size_);
+}
+
+LatencyTracker::~LatencyTracker() {
+    stop();
+    if (gauges_registered_) {
+        for (const char* name : kTrackerGauges) {
+            collector_.unregister_gauge(name);
+        }
+    }
+}
+
+void LatencyTracker::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+    if (!gauges_registered_) {
+        collector_.register_gauge(kTrackerGauges[0], "Rolling-window P50 decision latency",
+                                  [this] { return latest().end_to_end.p50_ms; });
+        collector_.register_gauge(kTrackerGauges[1], "Rolling-window P95 decision latency",
+                                  [this] { return latest().end_to_end.p95_ms; });
+        collector_.register_gauge(kTrackerGauges[2], "Rolling-window P99 decision latency",
+                                  [this] { return latest().end_to_end.p99_ms; });
+        collector_.register_gauge(kTrackerGauges[3], "Decisions per second over the last interval",
+                                  [this] {
+                                      return static_cast<double>(latest().throughput.requests_per_second);
+                                  });
+        gauges_registered_ = true;
+    }
+
+    tick();  // Baseline sample so the first report covers exactly one interval
+    worker_thread_ = std::make_unique<std::thread>(&LatencyTracker::worker, this);
+}
+
+void LatencyTracker::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stop_cv_.notify_all();
+    }
+    if (worker_thread_ && worker_thread_->joinable()) {
+        worker_thread_->join();
+    }
+    worker_thread_.reset();
+}
+
+void LatencyTracker::worker() {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    while (running_.load()) {
+        stop_cv_.wait_for(lock, std::chrono::seconds(interval_seconds_),
+                          [this] { return !running_.load(); });
+        if (!running_.load()) {
+            break;
+        }
+
+        lock.unlock();
+        try {
+            tick();
+        } catch (const std::exception& e) {
+            std::cerr << "Latency tracker tick failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+void LatencyTracker::tick() {
+    // Snapshot outside our locks: it evaluates callback gauges that read latest()
+    MetricsSnapshot snapshot = collector_.snapshot();
+
+    std::lock_guard<std::mutex> lock(tick_mutex_);
+
+    auto& newest = ring_[ring_head_];
+    if (!newest) {
+        newest = std::make_unique<Sample>();
+    }
+    newest->stages = snapshot.stage_latency;
+    newest->errors = snapshot.counter(MetricCounter::ERRORS);
+
+    const size_t previous_index = (ring_head_ + ring_size_ - 1) % ring_size_;
+    const size_t oldest_index = (ring_head_ + 1) % ring_size_;
+    const Sample* previous = ring_filled_ > 0 ? ring_[previous_index].get() : nullptr;
+    const Sample* oldest = ring_filled_ + 1 >= ring_size_ ? ring_[oldest_index].get() : ring_[0].get();
+    size_t covered_intervals = std::min(ring_filled_, ring_size_ - 1);
+
+    LatencyReport report;
+    report.timestamp_ms = get_current_timestamp_ms();
+    report.window_seconds = static_cast<uint32_t>(covered_intervals * interval_seconds_);
+
+    HistogramSnapshot window;
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+        window = newest->stages[s];
+        if (covered_intervals > 0) {
+            window.subtract(oldest->stages[s]);
+        }
+        report.stages[s] = to_latency_metrics(window);
+        if (static_cast<PipelineStage>(s) == kEndToEndStage) {
+            report.end_to_end = report.stages[s];
+            report.window_samples = window.count();
+        }
+    }
+
+    const auto& end_to_end = newest->stages[static_cast<size_t>(kEndToEndStage)];
+    report.throughput.total_requests = end_to_end.count();
+    report.throughput.failed_requests = newest->errors;
+    if (previous) {
+        uint64_t prev_count = previous->stages[static_cast<size_t>(kEndToEndStage)].count();
+        uint64_t delta = end_to_end.count() >= prev_count ? end_to_end.count() - prev_count : 0;
+        report.throughput.requests_per_second = delta / interval_seconds_;
+    }
+
+    report.slo_violated = report.window_samples > 0 && report.end_to_end.p99_ms > slo_p99_ms_;
+
+    ring_head_ = (ring_head_ + 1) % ring_size_;
+    ring_filled_ = std::min(ring_filled_ + 1, ring_size_);
+
+    std::lock_guard<std::mutex> report_lock(report_mutex_);
+    report_ = report;
+}
+
+LatencyReport LatencyTracker::latest() const {
+    std::lock_guard<std::mutex> lock(report_mutex_);
+    return report_;
+}
+
+LatencyMetrics LatencyTracker::to_latency_metrics(const HistogramSnapshot& histogram) {
+    LatencyMetrics metrics{};
+    if (histogram.empty()) {
+        return metrics;
+    }
+    metrics.p50_ms = static_cast<float>(histogram.value_at_quantile(0.50) / 1e6);
+    metrics.p95_ms = static_cast<float>(histogram.value_at_quantile(0.95) / 1e6);
+    metrics.p99_ms = static_cast<float>(histogram.value_at_quantile(0.99) / 1e6);
+    metrics.avg_ms = static_cast<float>(histogram.mean() / 1e6);
+    return metrics;
+}
+
+} // namespace dmp
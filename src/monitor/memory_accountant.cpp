@@ -0,0 +1,248 @@
+#include "utils/memory_accountant.hpp"
+#include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace dmp {
+
+namespace {
+    constexpr uint64_t kMiB = 1024 * 1024;
+
+    // cgroup v1 reports "unlimited" as a page-rounded LLONG_MAX
+    constexpr uint64_t kUnlimitedThreshold = uint64_t{1} << 60;
+
+    uint64_t read_limit_file(const char* path) {
+        std::ifstream file(path);
+        std::string value;
+        if (!(file >> value) || value == "max") {
+            return 0;
+        }
+        uint64_t limit = std::strtoull(value.c_str(), nullptr, 10);
+        return limit >= kUnlimitedThreshold ? 0 : limit;
+    }
+}
+
+const char* memory_pressure_name(MemoryPressure pressure) {
+    switch (pressure) {
+        case MemoryPressure::NORMAL: return "normal";
+        case MemoryPressure::ELEVATED: return "elevated";
+        case MemoryPressure::CRITICAL: return "critical";
+    }
+    return "unknown";
+}
+
+MemoryAccountant& MemoryAccountant::instance() {
+    static MemoryAccountant accountant;
+    return accountant;
+}
+
+MemoryAccountant::~MemoryAccountant() {
+    stop();
+}
+
+uint64_t MemoryAccountant::resident_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size_pages = 0;
+    uint64_t resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+uint64_t MemoryAccountant::container_limit_bytes() {
+    if (uint64_t limit = read_limit_file("/sys/fs/cgroup/memory.max")) {
+        return limit;
+    }
+    return read_limit_file("/sys/fs/cgroup/memory/memory.limit_in_bytes");
+}
+
+Result<uint64_t> MemoryAccountant::configure(uint64_t max_memory_bytes, const MemoryConfig& config) {
+    if (!config.is_valid()) {
+        return {0, ErrorCode::INVALID_REQUEST, "Invalid memory limit thresholds"};
+    }
+
+    const uint64_t container_limit = container_limit_bytes();
+    uint64_t limit = max_memory_bytes;
+    if (container_limit != 0 && (limit == 0 || container_limit < limit)) {
+        limit = container_limit;
+    }
+    limit_bytes_.store(limit, std::memory_order_relaxed);
+    soft_bytes_.store(limit / 100 * config.soft_limit_percent, std::memory_order_relaxed);
+    hard_bytes_.store(limit / 100 * config.hard_limit_percent, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        check_interval_ms_ = config.check_interval_ms;
+    }
+
+    LOG_INFO("🧮 Memory budget {} MB (max_memory_gb {} MB, container {}), soft {}%, hard {}%",
+             limit / kMiB, max_memory_bytes / kMiB,
+             container_limit ? std::to_string(container_limit / kMiB) + " MB" : std::string("unlimited"),
+             config.soft_limit_percent, config.hard_limit_percent);
+    return {limit, ErrorCode::SUCCESS, ""};
+}
+
+void MemoryAccountant::register_consumer(const std::string& name, SizeFn size, ReclaimFn reclaim,
+                                         MemoryPressure reclaim_at) {
+    auto consumer = std::make_shared<Consumer>();
+    consumer->name = name;
+    consumer->size = std::move(size);
+    consumer->reclaim = std::move(reclaim);
+    consumer->reclaim_at = reclaim_at;
+    {
+        std::lock_guard<std::mutex> lock(consumers_mutex_);
+        auto it = std::find_if(consumers_.begin(), consumers_.end(),
+                               [&name](const auto& existing) { return existing->name == name; });
+        if (it != consumers_.end()) {
+            *it = consumer;
+        } else {
+            consumers_.push_back(consumer);
+        }
+    }
+    // Scrapes read the last sample; size callbacks only run on the sampling thread
+    MetricsCollector::instance().register_gauge(
+        "dmp_memory_" + name + "_bytes", "Bytes held by " + name + " at the last memory sample",
+        [consumer] { return static_cast<double>(consumer->bytes.load(std::memory_order_relaxed)); });
+}
+
+void MemoryAccountant::unregister_consumer(const std::string& name) {
+    {
+        std::lock_guard<std::mutex> lock(consumers_mutex_);
+        consumers_.erase(std::remove_if(consumers_.begin(), consumers_.end(),
+                                        [&name](const auto& consumer) { return consumer->name == name; }),
+                         consumers_.end());
+    }
+    MetricsCollector::instance().unregister_gauge("dmp_memory_" + name + "_bytes");
+}
+
+MemoryPressure MemoryAccountant::grade(uint64_t used) const {
+    if (limit_bytes_.load(std::memory_order_relaxed) == 0) {
+        return MemoryPressure::NORMAL;
+    }
+    if (used >= hard_bytes_.load(std::memory_order_relaxed)) {
+        return MemoryPressure::CRITICAL;
+    }
+    if (used >= soft_bytes_.load(std::memory_order_relaxed)) {
+        return MemoryPressure::ELEVATED;
+    }
+    return MemoryPressure::NORMAL;
+}
+
+MemoryPressure MemoryAccountant::check_now() {
+    std::lock_guard<std::mutex> check_lock(check_mutex_);
+
+    std::vector<std::shared_ptr<Consumer>> consumers;
+    {
+        std::lock_guard<std::mutex> lock(consumers_mutex_);
+        consumers = consumers_;
+    }
+    for (auto& consumer : consumers) {
+        try {
+            consumer->bytes.store(consumer->size(), std::memory_order_relaxed);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Memory consumer {} size failed: {}", consumer->name, e.what());
+        }
+    }
+
+    uint64_t used = resident_bytes();
+    MemoryPressure level = grade(used);
+
+    if (level != MemoryPressure::NORMAL) {
+        const uint64_t soft = soft_bytes_.load(std::memory_order_relaxed);
+        for (auto& consumer : consumers) {
+            if (!consumer->reclaim || level < consumer->reclaim_at || used <= soft) {
+                continue;
+            }
+            try {
+                uint64_t freed = consumer->reclaim(used - soft);
+                reclaimed_bytes_.fetch_add(freed, std::memory_order_relaxed);
+                used -= std::min(freed, used);
+                LOG_DEBUG("Memory consumer {} released {} KB", consumer->name, freed / 1024);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Memory consumer {} reclaim failed: {}", consumer->name, e.what());
+            }
+        }
+#if defined(__GLIBC__)
+        // Freed blocks stay resident in malloc arenas until trimmed
+        malloc_trim(0);
+#endif
+        used = resident_bytes();
+        level = grade(used);
+    }
+    used_bytes_.store(used, std::memory_order_relaxed);
+
+    const MemoryPressure previous = pressure_.exchange(level, std::memory_order_relaxed);
+    if (level > previous) {
+        LOG_INFO("⚠️  Memory pressure {}: {} MB resident of {} MB limit",
+                 memory_pressure_name(level), used / kMiB, limit_bytes() / kMiB);
+    } else if (level < previous) {
+        LOG_INFO("✅ Memory pressure back to {}: {} MB resident of {} MB limit",
+                 memory_pressure_name(level), used / kMiB, limit_bytes() / kMiB);
+    }
+    return level;
+}
+
+Result<void> MemoryAccountant::admit(const std::string& what, uint64_t bytes) {
+    const uint64_t hard = hard_bytes_.load(std::memory_order_relaxed);
+    if (limit_bytes_.load(std::memory_order_relaxed) == 0) {
+        return {ErrorCode::SUCCESS, ""};
+    }
+    const uint64_t used = resident_bytes();
+    used_bytes_.store(used, std::memory_order_relaxed);
+    if (used + bytes > hard) {
+        refused_.fetch_add(1, std::memory_order_relaxed);
+        return {ErrorCode::RESOURCE_EXHAUSTED,
+                fmt::format("{} needs {} MB but {} MB of the {} MB hard memory limit are resident",
+                            what, bytes / kMiB, used / kMiB, hard / kMiB)};
+    }
+    return {ErrorCode::SUCCESS, ""};
+}
+
+std::vector<MemoryConsumerUsage> MemoryAccountant::usage() const {
+    std::lock_guard<std::mutex> lock(consumers_mutex_);
+    std::vector<MemoryConsumerUsage> usage;
+    usage.reserve(consumers_.size());
+    for (const auto& consumer : consumers_) {
+        usage.push_back({consumer->name, consumer->bytes.load(std::memory_order_relaxed)});
+    }
+    return usage;
+}
+
+void MemoryAccountant::start() {
+    std::lock_guard<std::mutex> lock(worker_mutex_);
+    if (worker_.joinable()) {
+        return;
+    }
+    stop_requested_ = false;
+    worker_ = std::thread(&MemoryAccountant::run, this);
+}
+
+void MemoryAccountant::stop() {
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        stop_requested_ = true;
+    }
+    worker_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void MemoryAccountant::run() {
+    std::unique_lock<std::mutex> lock(worker_mutex_);
+    while (!stop_requested_) {
+        lock.unlock();
+        check_now();
+        lock.lock();
+        worker_cv_.wait_for(lock, std::chrono::milliseconds(check_interval_ms_),
+                            [this] { return stop_requested_; });
+    }
+}
+
+} // namespace dmp
@@ -1,178 +1,507 @@
 #include "utils/metrics.hpp"
+#include "utils/prometheus_exporter.hpp"
 #include <thread>
 #include <sstream>
 #include <iomanip>
 #include <iostream>
+#include <charconv>
+#include <algorithm>
 
 namespace dmp {
 
+/**
+ * @brief Per-thread metric storage
+ *
+ * Written only by the thread currently leasing it; read by scrapers.
+ * Aligned so neighbouring shards never share a cache line.
+ */
+struct alignas(64) MetricsCollector::Shard {
+    std::array<std::atomic<uint64_t>, METRIC_COUNTER_COUNT> counters{};
+    std::array<std::atomic<uint64_t>, MetricsCollector::kMaxLabeledSeries> labeled{};
+    std::array<LatencyHistogram, PIPELINE_STAGE_COUNT> stage_latency;
+    std::array<std::array<std::atomic<uint64_t>, HW_EVENT_COUNT>, PIPELINE_STAGE_COUNT> stage_hw_events{};
+    std::array<std::atomic<uint64_t>, PIPELINE_STAGE_COUNT> stage_hw_samples{};
+};
+
+/**
+ * @brief Thread-exit hook returning the leased shard to the pool
+ */
+struct ShardLease {
+    MetricsCollector::Shard* shard = nullptr;
+
+    ~ShardLease() {
+        if (shard) {
+            MetricsCollector::instance().release_shard(shard);
+        }
+    }
+};
+
+namespace {
+    thread_local ShardLease tl_shard_lease;
+
+    /**
+     * @brief Thread-local cache of interned label sets
+     *
+     * Keyed by a 64-bit hash of family and label values so that the hot path
+     * never builds a key string; a hit is confirmed against the interned
+     * labels, so colliding label sets never share a series. Open addressing
+     * with bounded probing; a full probe window evicts one of its entries.
+     */
+    struct SeriesCacheEntry {
+        uint64_t hash = 0;
+        uint32_t series_id = 0;
+        MetricFamily family = MetricFamily::kCount;
+        bool used = false;
+    };
+    constexpr size_t kSeriesCacheSize = 1024;
+    constexpr size_t kSeriesCacheProbe = 8;
+    thread_local std::array<SeriesCacheEntry, kSeriesCacheSize> tl_series_cache{};
+
+    constexpr uint32_t kOverflowSeriesId = MetricsCollector::kMaxLabeledSeries - 1;
+
+    uint64_t hash_labels(MetricFamily family, std::initializer_list<std::string_view> values) {
+        // FNV-1a over family id and values separated by a non-text byte
+        uint64_t hash = 1469598103934665603ULL;
+        auto mix = [&hash](unsigned char byte) {
+            hash ^= byte;
+            hash *= 1099511628211ULL;
+        };
+        mix(static_cast<unsigned char>(family));
+        for (auto value : values) {
+            for (char c : value) {
+                mix(static_cast<unsigned char>(c));
+            }
+            mix(0xff);
+        }
+        return hash;
+    }
+
+    void bump(std::atomic<uint64_t>& cell, uint64_t delta) {
+        // Single writer per shard: a plain load/store pair avoids locked instructions
+        cell.store(cell.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    uint64_t ms_to_ns(double duration_ms) {
+        return duration_ms > 0.0 ? static_cast<uint64_t>(duration_ms * 1e6) : 0;
+    }
+}
+
+const MetricFamilyInfo& metric_family_info(MetricFamily family) {
+    static const MetricFamilyInfo kFamilies[] = {
+        {"dmp_http_requests_total", "HTTP requests by method, path and status",
+         {"method", "path", "status"}},
+        {"dmp_errors_total", "Errors by type and component", {"type", "component"}},
+        {"dmp_ml_inferences_total", "ML inferences by model", {"model"}},
+        {"dmp_operations_total", "Timed operations by name", {"operation"}},
+        {"dmp_operation_duration_microseconds_total",
+         "Accumulated duration of timed operations", {"operation"}},
+        {"dmp_metrics_label_overflow_total",
+         "Observations dropped into the overflow series because the label table is full", {}},
+    };
+    return kFamilies[static_cast<size_t>(family)];
+}
+
 // Static instance
 MetricsCollector& MetricsCollector::instance() {
     static MetricsCollector instance;
     return instance;
 }
 
-Result<void> MetricsCollector::initialize(uint16_t port, const std::string& path) {
+MetricsCollector::MetricsCollector() {
+    // Fixed-size label table; the last id is reserved for overflow
+    series_.resize(kMaxLabeledSeries, SeriesInfo{MetricFamily::kCount, {}});
+    series_[kOverflowSeriesId].family = MetricFamily::LABEL_OVERFLOW;
+}
+
+MetricsCollector::~MetricsCollector() = default;
+
+Result<void> MetricsCollector::initialize(uint16_t port, const std::string& path,
+                                         uint32_t render_cache_ms) {
     try {
-        std::lock_guard<std::mutex> lock(metrics_mutex_);
-        
-        // Reset metrics
-        metrics_ = SimpleMetrics{};
-        
+        if (port != 0 && !exporter_) {
+            auto exporter = std::make_unique<PrometheusExporter>(*this);
+            auto result = exporter->start(port, path, render_cache_ms);
+            if (result.is_error()) {
+                return result;
+            }
+            exporter_ = std::move(exporter);
+        }
+
         initialized_.store(true);
-        
-        std::cout << "📊 Simplified metrics system initialized (Phase 1)" << std::endl;
-        std::cout << "📊 Metrics endpoint placeholder: http://0.0.0.0:" << port << path << std::endl;
-        
+
+        std::cout << "📊 Sharded metrics system initialized" << std::endl;
+        if (exporter_) {
+            std::cout << "📊 Metrics endpoint: http://0.0.0.0:" << exporter_->bound_port()
+                      << path << std::endl;
+        }
+
         return {ErrorCode::SUCCESS, ""};
-        
+
     } catch (const std::exception& e) {
-        return {ErrorCode::INTERNAL_ERROR, 
+        return {ErrorCode::INTERNAL_ERROR,
                std::string("Failed to initialize metrics system: ") + e.what()};
     }
 }
 
 void MetricsCollector::shutdown() {
+    if (exporter_) {
+        exporter_->stop();
+        exporter_.reset();
+    }
+
     if (initialized_.load()) {
-        std::lock_guard<std::mutex> lock(metrics_mutex_);
-        
+        auto summary = snapshot();
+        uint64_t decisions = summary.counter(MetricCounter::DECISIONS_APPROVE) +
+                             summary.counter(MetricCounter::DECISIONS_DECLINE) +
+                             summary.counter(MetricCounter::DECISIONS_REVIEW);
+
         // Print final metrics summary
         std::cout << "📊 Metrics Summary:" << std::endl;
-        std::cout << "   Total HTTP Requests: " << metrics_.http_requests_total << std::endl;
-        std::cout << "   Total Decisions: " << metrics_.decisions_total << std::endl;
-        std::cout << "   Total Errors: " << metrics_.errors_total << std::endl;
-        
-        if (metrics_.http_requests_total > 0) {
-            double avg_request_time = metrics_.total_request_time_ms / metrics_.http_requests_total;
-            std::cout << "   Average Request Time: " << std::fixed << std::setprecision(2) 
-                      << avg_request_time << "ms" << std::endl;
+        std::cout << "   Total HTTP Requests: " << summary.counter(MetricCounter::HTTP_REQUESTS) << std::endl;
+        std::cout << "   Total Decisions: " << decisions << std::endl;
+        std::cout << "   Total Errors: " << summary.counter(MetricCounter::ERRORS) << std::endl;
+
+        const auto& http = summary.latency(PipelineStage::HTTP_REQUEST);
+        if (!http.empty()) {
+            std::cout << "   Average Request Time: " << std::fixed << std::setprecision(2)
+                      << http.mean() / 1e6 << "ms" << std::endl;
         }
-        
-        if (metrics_.decisions_total > 0) {
-            double avg_decision_time = metrics_.total_decision_time_ms / metrics_.decisions_total;
-            std::cout << "   Average Decision Time: " << std::fixed << std::setprecision(2) 
-                      << avg_decision_time << "ms" << std::endl;
+
+        const auto& decision = summary.latency(PipelineStage::DECISION);
+        if (!decision.empty()) {
+            std::cout << "   Average Decision Time: " << std::fixed << std::setprecision(2)
+                      << decision.mean() / 1e6 << "ms (P99 "
+                      << decision.value_at_quantile(0.99) / 1e6 << "ms)" << std::endl;
         }
-        
+
         initialized_.store(false);
         std::cout << "📊 Metrics system shutdown completed" << std::endl;
     }
 }
 
+MetricsCollector::Shard& MetricsCollector::local_shard() {
+    if (!tl_shard_lease.shard) {
+        tl_shard_lease.shard = acquire_shard();
+    }
+    return *tl_shard_lease.shard;
+}
+
+MetricsCollector::Shard* MetricsCollector::acquire_shard() {
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    if (!free_shards_.empty()) {
+        Shard* shard = free_shards_.back();
+        free_shards_.pop_back();
+        return shard;
+    }
+    shards_.push_back(std::make_unique<Shard>());
+    return shards_.back().get();
+}
+
+void MetricsCollector::release_shard(Shard* shard) {
+    // Values stay in the shard so merged counters remain monotonic
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    free_shards_.push_back(shard);
+}
+
+bool MetricsCollector::series_matches(uint32_t id, MetricFamily family,
+                                      std::initializer_list<std::string_view> values) const {
+    // Interned entries are written once under series_mutex_ before any thread
+    // caches their id, so reading them here needs no lock
+    if (id == kOverflowSeriesId) return true;
+    const auto& info = series_[id];
+    if (info.family != family || info.label_values.size() != values.size()) return false;
+    size_t i = 0;
+    for (auto value : values) {
+        if (info.label_values[i++] != value) return false;
+    }
+    return true;
+}
+
+uint32_t MetricsCollector::series_id(MetricFamily family,
+                                     std::initializer_list<std::string_view> values) {
+    const uint64_t hash = hash_labels(family, values);
+
+    // Fast path: thread-local lookup, no locks, no allocation
+    size_t slot = hash & (kSeriesCacheSize - 1);
+    SeriesCacheEntry* free_entry = nullptr;
+    for (size_t probe = 0; probe < kSeriesCacheProbe; ++probe) {
+        auto& entry = tl_series_cache[(slot + probe) & (kSeriesCacheSize - 1)];
+        if (!entry.used) {
+            free_entry = &entry;
+            break;
+        }
+        if (entry.hash == hash && entry.family == family &&
+            series_matches(entry.series_id, family, values)) {
+            return entry.series_id;
+        }
+    }
+
+    // Slow path: intern in the shared registry
+    std::string key;
+    key.push_back(static_cast<char>(family));
+    for (auto value : values) {
+        key.append(value);
+        key.push_back('\xff');
+    }
+
+    uint32_t id = kOverflowSeriesId;
+    {
+        std::lock_guard<std::mutex> lock(series_mutex_);
+        auto it = series_index_.find(key);
+        if (it != series_index_.end()) {
+            id = it->second;
+        } else if (series_index_.size() < kMaxLabeledSeries - 1) {
+            id = static_cast<uint32_t>(series_index_.size());
+            SeriesInfo info{family, {}};
+            info.label_values.reserve(values.size());
+            for (auto value : values) {
+                info.label_values.emplace_back(value);
+            }
+            series_[id] = std::move(info);
+            series_index_.emplace(std::move(key), id);
+        }
+    }
+
+    // Crowded window: evict a hash-chosen entry so this label set hits next time
+    if (!free_entry) {
+        free_entry = &tl_series_cache[(slot + (hash >> 32) % kSeriesCacheProbe) & (kSeriesCacheSize - 1)];
+    }
+    *free_entry = SeriesCacheEntry{hash, id, family, true};
+    return id;
+}
+
+void MetricsCollector::add_labeled(MetricFamily family,
+                                   std::initializer_list<std::string_view> values,
+                                   uint64_t delta) {
+    uint32_t id = series_id(family, values);
+    // The overflow series counts observations, whatever the family measures
+    bump(local_shard().labeled[id], id == kOverflowSeriesId ? 1 : delta);
+}
+
 void MetricsCollector::record_http_request(const std::string& method, const std::string& path,
                                          int status_code, double duration_ms) {
-    if (!initialized_.load()) return;
-    
-    try {
-        std::lock_guard<std::mutex> lock(metrics_mutex_);
-        
-        metrics_.http_requests_total++;
-        metrics_.total_request_time_ms += duration_ms;
-        
-        // Log to console for Phase 1
-        std::cout << "📊 HTTP: " << method << " " << path << " -> " << status_code 
-                  << " (" << std::fixed << std::setprecision(2) << duration_ms << "ms)" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to record HTTP request metrics: " << e.what() << std::endl;
-    }
+    if (!is_initialized()) return;
+
+    auto& shard = local_shard();
+    bump(shard.counters[static_cast<size_t>(MetricCounter::HTTP_REQUESTS)], 1);
+    shard.stage_latency[static_cast<size_t>(PipelineStage::HTTP_REQUEST)].record(ms_to_ns(duration_ms));
+
+    char status_buf[8];
+    auto [end, ec] = std::to_chars(status_buf, status_buf + sizeof(status_buf), status_code);
+    std::string_view status(status_buf, ec == std::errc() ? end - status_buf : 0);
+    add_labeled(MetricFamily::HTTP_REQUESTS, {method, path, status}, 1);
 }
 
-void MetricsCollector::record_decision(Decision decision, float risk_score, 
+void MetricsCollector::record_decision(Decision decision, float risk_score,
                                      double processing_time_ms) {
-    if (!initialized_.load()) return;
-    
-    try {
-        std::lock_guard<std::mutex> lock(metrics_mutex_);
-        
-        metrics_.decisions_total++;
-        metrics_.total_decision_time_ms += processing_time_ms;
-        
-        // Log to console for Phase 1
-        std::cout << "📊 Decision: " << decision_to_string(decision) 
-                  << " (score: " << std::fixed << std::setprecision(1) << risk_score 
-                  << ", time: " << std::setprecision(2) << processing_time_ms << "ms)" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to record decision metrics: " << e.what() << std::endl;
+    (void)risk_score;
+    if (!is_initialized()) return;
+
+    MetricCounter counter = MetricCounter::DECISIONS_APPROVE;
+    switch (decision) {
+        case Decision::APPROVE: counter = MetricCounter::DECISIONS_APPROVE; break;
+        case Decision::DECLINE: counter = MetricCounter::DECISIONS_DECLINE; break;
+        case Decision::REVIEW: counter = MetricCounter::DECISIONS_REVIEW; break;
     }
+
+    auto& shard = local_shard();
+    bump(shard.counters[static_cast<size_t>(counter)], 1);
+    shard.stage_latency[static_cast<size_t>(PipelineStage::DECISION)].record(ms_to_ns(processing_time_ms));
 }
 
 void MetricsCollector::record_rule_evaluation(int rules_evaluated, int rules_triggered,
                                             double evaluation_time_ms) {
-    if (!initialized_.load()) return;
-    
-    try {
-        // Log to console for Phase 1
-        std::cout << "📊 Rules: evaluated=" << rules_evaluated 
-                  << ", triggered=" << rules_triggered
-                  << " (" << std::fixed << std::setprecision(2) << evaluation_time_ms << "ms)" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to record rule evaluation metrics: " << e.what() << std::endl;
-    }
+    if (!is_initialized()) return;
+
+    auto& shard = local_shard();
+    bump(shard.counters[static_cast<size_t>(MetricCounter::RULES_EVALUATED)],
+         static_cast<uint64_t>(std::max(rules_evaluated, 0)));
+    bump(shard.counters[static_cast<size_t>(MetricCounter::RULES_TRIGGERED)],
+         static_cast<uint64_t>(std::max(rules_triggered, 0)));
+    shard.stage_latency[static_cast<size_t>(PipelineStage::RULE_EVALUATION)].record(ms_to_ns(evaluation_time_ms));
 }
 
 void MetricsCollector::record_feature_extraction(bool cache_hit, double extraction_time_ms,
                                                 int feature_count) {
-    if (!initialized_.load()) return;
-    
-    try {
-        // Log to console for Phase 1
-        std::cout << "📊 Features: " << (cache_hit ? "cache_hit" : "cache_miss") 
-                  << ", count=" << feature_count
-                  << " (" << std::fixed << std::setprecision(2) << extraction_time_ms << "ms)" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to record feature extraction metrics: " << e.what() << std::endl;
-    }
+    if (!is_initialized()) return;
+
+    auto& shard = local_shard();
+    bump(shard.counters[static_cast<size_t>(cache_hit ? MetricCounter::FEATURE_CACHE_HITS
+                                                      : MetricCounter::FEATURE_CACHE_MISSES)], 1);
+    bump(shard.counters[static_cast<size_t>(MetricCounter::FEATURES_EXTRACTED)],
+         static_cast<uint64_t>(std::max(feature_count, 0)));
+    shard.stage_latency[static_cast<size_t>(PipelineStage::FEATURE_EXTRACTION)].record(ms_to_ns(extraction_time_ms));
 }
 
-void MetricsCollector::record_ml_inference(const std::string& model_name, 
+void MetricsCollector::record_ml_inference(const std::string& model_name,
                                          double inference_time_ms, float prediction_score) {
-    if (!initialized_.load()) return;
-    
-    try {
-        // Log to console for Phase 1
-        std::cout << "📊 ML: model=" << model_name 
-                  << ", score=" << std::fixed << std::setprecision(3) << prediction_score
-                  << " (" << std::setprecision(2) << inference_time_ms << "ms)" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to record ML inference metrics: " << e.what() << std::endl;
+    (void)prediction_score;
+    if (!is_initialized()) return;
+
+    auto& shard = local_shard();
+    bump(shard.counters[static_cast<size_t>(MetricCounter::ML_INFERENCES)], 1);
+    shard.stage_latency[static_cast<size_t>(PipelineStage::MODEL_INFERENCE)].record(ms_to_ns(inference_time_ms));
+    add_labeled(MetricFamily::ML_INFERENCES, {model_name}, 1);
+}
+
+void MetricsCollector::record_stage_latency(PipelineStage stage, uint64_t duration_ns) {
+    if (!is_initialized()) return;
+
+    local_shard().stage_latency[static_cast<size_t>(stage)].record(duration_ns);
+}
+
+void MetricsCollector::record_decision_allocations(uint64_t allocations, uint64_t bytes) {
+    if (!is_initialized()) return;
+
+    auto& shard = local_shard();
+    bump(shard.counters[static_cast<size_t>(MetricCounter::DECISION_ALLOCATIONS)], allocations);
+    bump(shard.counters[static_cast<size_t>(MetricCounter::DECISION_ALLOCATED_BYTES)], bytes);
+}
+
+void MetricsCollector::record_stage_counters(PipelineStage stage, const HwCounterValues& events) {
+    if (!is_initialized()) return;
+
+    auto& shard = local_shard();
+    const size_t s = static_cast<size_t>(stage);
+    for (size_t e = 0; e < HW_EVENT_COUNT; ++e) {
+        bump(shard.stage_hw_events[s][e], events.values[e]);
     }
+    bump(shard.stage_hw_samples[s], 1);
 }
 
-void MetricsCollector::update_system_metrics(double cpu_usage_percent, 
+void MetricsCollector::record_operation(std::string_view operation, double duration_ms) {
+    if (!is_initialized()) return;
+
+    add_labeled(MetricFamily::OPERATIONS, {operation}, 1);
+    add_labeled(MetricFamily::OPERATION_DURATION_US, {operation},
+                static_cast<uint64_t>(std::max(duration_ms, 0.0) * 1000.0));
+}
+
+void MetricsCollector::update_system_metrics(double cpu_usage_percent,
                                             double memory_usage_mb, int active_connections) {
-    if (!initialized_.load()) return;
-    
-    try {
-        // Log to console for Phase 1
-        std::cout << "📊 System: CPU=" << std::fixed << std::setprecision(1) << cpu_usage_percent << "%, "
-                  << "Memory=" << std::setprecision(1) << memory_usage_mb << "MB, "
-                  << "Connections=" << active_connections << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to update system metrics: " << e.what() << std::endl;
-    }
+    if (!is_initialized()) return;
+
+    cpu_usage_percent_.store(cpu_usage_percent, std::memory_order_relaxed);
+    memory_usage_mb_.store(memory_usage_mb, std::memory_order_relaxed);
+    active_connections_.store(active_connections, std::memory_order_relaxed);
 }
 
-void MetricsCollector::record_error(const std::string& error_type, 
+void MetricsCollector::record_error(const std::string& error_type,
                                   const std::string& component) {
-    if (!initialized_.load()) return;
-    
-    try {
-        std::lock_guard<std::mutex> lock(metrics_mutex_);
-        
-        metrics_.errors_total++;
-        
-        // Log to console for Phase 1
-        std::cout << "📊 Error: " << error_type << " in " << component << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to record error metrics: " << e.what() << std::endl;
+    if (!is_initialized()) return;
+
+    bump(local_shard().counters[static_cast<size_t>(MetricCounter::ERRORS)], 1);
+    add_labeled(MetricFamily::ERRORS, {error_type, component}, 1);
+}
+
+void MetricsCollector::register_gauge(const std::string& name, const std::string& help,
+                                      std::function<double()> read) {
+    register_callback(name, help, std::move(read), false);
+}
+
+void MetricsCollector::register_counter(const std::string& name, const std::string& help,
+                                        std::function<double()> read) {
+    register_callback(name, help, std::move(read), true);
+}
+
+void MetricsCollector::register_callback(const std::string& name, const std::string& help,
+                                         std::function<double()> read, bool counter) {
+    std::lock_guard<std::mutex> lock(gauges_mutex_);
+    for (auto& gauge : callback_gauges_) {
+        if (gauge.name == name) {
+            gauge.help = help;
+            gauge.read = std::move(read);
+            gauge.counter = counter;
+            return;
+        }
     }
+    callback_gauges_.push_back(CallbackGauge{name, help, std::move(read), counter});
+}
+
+void MetricsCollector::unregister_gauge(const std::string& name) {
+    std::lock_guard<std::mutex> lock(gauges_mutex_);
+    callback_gauges_.erase(std::remove_if(callback_gauges_.begin(), callback_gauges_.end(),
+                                          [&name](const CallbackGauge& gauge) {
+                                              return gauge.name == name;
+                                          }),
+                           callback_gauges_.end());
+}
+
+MetricsSnapshot MetricsCollector::snapshot() const {
+    MetricsSnapshot result;
+    std::array<uint64_t, kMaxLabeledSeries> labeled{};
+
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        result.shard_count = shards_.size();
+        for (const auto& shard : shards_) {
+            for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+                result.counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < kMaxLabeledSeries; ++i) {
+                labeled[i] += shard->labeled[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+                shard->stage_latency[i].accumulate_into(result.stage_latency[i]);
+                for (size_t e = 0; e < HW_EVENT_COUNT; ++e) {
+                    result.stage_hw_events[i].values[e] +=
+                        shard->stage_hw_events[i][e].load(std::memory_order_relaxed);
+                }
+                result.stage_hw_samples[i] += shard->stage_hw_samples[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(series_mutex_);
+        for (uint32_t id = 0; id < series_.size() && id < kMaxLabeledSeries; ++id) {
+            if (labeled[id] == 0) continue;
+            const auto& info = series_[id];
+            result.labeled.push_back(LabeledSeriesValue{id, info.family, info.label_values, labeled[id]});
+        }
+    }
+
+    result.cpu_usage_percent = cpu_usage_percent_.load(std::memory_order_relaxed);
+    result.memory_usage_mb = memory_usage_mb_.load(std::memory_order_relaxed);
+    result.active_connections = active_connections_.load(std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(gauges_mutex_);
+        result.gauges.reserve(callback_gauges_.size());
+        for (const auto& gauge : callback_gauges_) {
+            double value = 0.0;
+            try {
+                value = gauge.read ? gauge.read() : 0.0;
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to read gauge " << gauge.name << ": " << e.what() << std::endl;
+            }
+            result.gauges.emplace_back(gauge.name, value);
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::string> MetricsCollector::series_labels(uint32_t series_id) const {
+    std::lock_guard<std::mutex> lock(series_mutex_);
+    if (series_id >= series_.size()) return {};
+    return series_[series_id].label_values;
+}
+
+std::string MetricsCollector::gauge_help(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(gauges_mutex_);
+    for (const auto& gauge : callback_gauges_) {
+        if (gauge.name == name) return gauge.help;
+    }
+    return {};
+}
+
+const char* MetricsCollector::gauge_type(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(gauges_mutex_);
+    for (const auto& gauge : callback_gauges_) {
+        if (gauge.name == name) return gauge.counter ? "counter" : "gauge";
+    }
+    return "gauge";
 }
 
 std::string MetricsCollector::decision_to_string(Decision decision) {
@@ -187,20 +516,34 @@ std::string MetricsCollector::decision_to_string(Decision decision) {
 // MetricsTimer implementation
 MetricsTimer::MetricsTimer(const std::string& operation_name)
     : operation_name_(operation_name)
-    , start_time_(std::chrono::high_resolution_clock::now())
+    , stage_(PipelineStage::DECISION)
+    , has_stage_(false)
+    , start_time_(std::chrono::steady_clock::now())
+    , stopped_(false) {
+}
+
+MetricsTimer::MetricsTimer(PipelineStage stage)
+    : stage_(stage)
+    , has_stage_(true)
+    , start_time_(std::chrono::steady_clock::now())
     , stopped_(false) {
 }
 
 MetricsTimer::~MetricsTimer() {
     if (!stopped_) {
-        double duration = elapsed_ms();
-        std::cout << "📊 Timer: " << operation_name_ << " completed in " 
-                  << std::fixed << std::setprecision(2) << duration << "ms" << std::endl;
+        auto& collector = MetricsCollector::instance();
+        if (has_stage_) {
+            auto elapsed = std::chrono::steady_clock::now() - start_time_;
+            collector.record_stage_latency(stage_, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        } else {
+            collector.record_operation(operation_name_, elapsed_ms());
+        }
     }
 }
 
 double MetricsTimer::elapsed_ms() const {
-    auto now = std::chrono::high_resolution_clock::now();
+    auto now = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(now - start_time_);
     return duration.count() / 1000.0;
 }
@@ -215,7 +558,7 @@ uint64_t get_current_timestamp_ms() {
 std::string format_duration(double duration_ms) {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(1);
-    
+
     if (duration_ms < 1.0) {
         oss << (duration_ms * 1000.0) << "μs";
     } else if (duration_ms < 1000.0) {
@@ -223,8 +566,8 @@ std::string format_duration(double duration_ms) {
     } else {
         oss << (duration_ms / 1000.0) << "s";
     }
-    
+
     return oss.str();
 }
 
-} // namespace dmp
\ No newline at end of file
+} // namespace dmp
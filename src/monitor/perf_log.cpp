@@ -0,0 +1,223 @@
+#include "utils/perf_log.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace dmp {
+
+namespace {
+    constexpr size_t kFileBufferSize = 1 << 20;
+    constexpr auto kIdleSleep = std::chrono::milliseconds(5);
+    constexpr auto kFlushInterval = std::chrono::seconds(1);
+    constexpr const char* kFilePrefix = "dmp_perf_";
+    constexpr const char* kFileExtension = ".bin";
+    constexpr uint32_t kMaxNameSequence = 1000;  // Names tried per millisecond
+
+    uint64_t unix_now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    bool is_perf_file(const std::filesystem::path& path) {
+        auto name = path.filename().string();
+        return name.rfind(kFilePrefix, 0) == 0 && path.extension() == kFileExtension;
+    }
+}
+
+PerfLog& PerfLog::instance() {
+    static PerfLog instance;
+    return instance;
+}
+
+PerfLog::~PerfLog() {
+    stop();
+}
+
+Result<void> PerfLog::configure(const PerfLogConfig& config) {
+    if (!config.is_valid()) {
+        return {ErrorCode::INVALID_REQUEST, "Invalid perf_log configuration"};
+    }
+    if (running_.load()) {
+        return {ErrorCode::INVALID_REQUEST, "perf_log is running; stop() it before reconfiguring"};
+    }
+    config_ = config;
+    if (!config_.enabled) {
+        return {ErrorCode::SUCCESS, ""};
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.directory, ec);
+    if (ec) {
+        return {ErrorCode::INTERNAL_ERROR,
+               "Cannot create perf_log directory " + config_.directory + ": " + ec.message()};
+    }
+
+    // Safe to replace: enabled_ is false, so no submitter is using the old queue
+    queue_ = std::make_unique<MpmcQueue<PerfRecord>>(config_.queue_capacity);
+    running_.store(true);
+    writer_ = std::thread([this] { run(); });
+    enabled_.store(true);
+    return {ErrorCode::SUCCESS, ""};
+}
+
+void PerfLog::stop() {
+    enabled_.store(false);
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void PerfLog::submit(const PerfRecord& record) noexcept {
+    if (!enabled_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (!queue_->try_push(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PerfLog::run() {
+    auto last_flush = std::chrono::steady_clock::now();
+    const uint64_t max_file_bytes = static_cast<uint64_t>(config_.max_file_mb) << 20;
+    PerfRecord record;
+
+    auto drain = [&] {
+        size_t count = 0;
+        while (queue_->try_pop(record)) {
+            if ((!file_ || file_bytes_ >= max_file_bytes) && !open_next_file()) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (std::fwrite(&record, sizeof(record), 1, file_) == 1) {
+                file_bytes_ += sizeof(record);
+                ++count;
+            } else {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        written_.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    };
+
+    while (running_.load(std::memory_order_acquire)) {
+        size_t count = drain();
+        auto now = std::chrono::steady_clock::now();
+        if (file_ && now - last_flush >= kFlushInterval) {
+            std::fflush(file_);
+            last_flush = now;
+        }
+        if (count == 0) {
+            std::this_thread::sleep_for(kIdleSleep);
+        }
+    }
+
+    drain();
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool PerfLog::open_next_file() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    PerfLogHeader header;
+    header.created_unix_ns = unix_now_ns();
+    const std::string stem = kFilePrefix + std::to_string(header.created_unix_ns / 1000000);
+
+    // Never truncate an existing file: rotations within one millisecond (or a
+    // restart) get a sequence suffix, which still sorts after the plain name
+    std::filesystem::path path;
+    for (uint32_t sequence = 0; sequence < kMaxNameSequence; ++sequence) {
+        const std::string name = sequence == 0 ? stem + kFileExtension
+                                               : fmt::format("{}_{:03}{}", stem, sequence, kFileExtension);
+        path = std::filesystem::path(config_.directory) / name;
+        file_ = std::fopen(path.c_str(), "wbx");
+        if (file_ || errno != EEXIST) {
+            break;
+        }
+    }
+    if (!file_) {
+        LOG_ERROR("Failed to open perf log file {}: {}", path.string(), std::strerror(errno));
+        return false;
+    }
+    file_buffer_.resize(kFileBufferSize);
+    std::setvbuf(file_, file_buffer_.data(), _IOFBF, file_buffer_.size());
+    std::fwrite(&header, sizeof(header), 1, file_);
+    file_bytes_ = sizeof(header);
+
+    prune_old_files();
+    return true;
+}
+
+void PerfLog::prune_old_files() {
+    std::error_code ec;
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(config_.directory, ec)) {
+        if (entry.is_regular_file() && is_perf_file(entry.path())) {
+            files.push_back(entry.path());
+        }
+    }
+    if (files.size() <= config_.max_files) {
+        return;
+    }
+
+    // Names embed the creation time (then sequence), so lexical order is age order
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i + config_.max_files < files.size(); ++i) {
+        std::filesystem::remove(files[i], ec);
+    }
+}
+
+Result<std::vector<PerfRecord>> PerfLog::read_file(const std::string& path) {
+    std::vector<PerfRecord> records;
+    auto result = read_file(path, [&records](const PerfRecord& record) { records.push_back(record); });
+    if (result.is_error()) {
+        return {{}, result.error_code, result.error_message};
+    }
+    return {std::move(records), ErrorCode::SUCCESS, ""};
+}
+
+Result<size_t> PerfLog::read_file(const std::string& path,
+                                  const std::function<void(const PerfRecord&)>& visit) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return {0, ErrorCode::INVALID_REQUEST, "Cannot open " + path};
+    }
+
+    PerfLogHeader expected;
+    PerfLogHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) {
+        std::fclose(file);
+        return {0, ErrorCode::INVALID_REQUEST, path + " is not a DMP performance log"};
+    }
+    if (header.version != expected.version || header.record_size != expected.record_size ||
+        header.stage_count != expected.stage_count) {
+        std::fclose(file);
+        return {0, ErrorCode::INVALID_REQUEST, path + " has an incompatible record layout"};
+    }
+
+    size_t total = 0;
+    PerfRecord buffer[1024];
+    size_t count;
+    while ((count = std::fread(buffer, sizeof(PerfRecord), std::size(buffer), file)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            visit(buffer[i]);
+        }
+        total += count;
+    }
+    std::fclose(file);
+    return {total, ErrorCode::SUCCESS, ""};
+}
+
+} // namespace dmp
@@ -0,0 +1,452 @@
+#include "utils/profiler.hpp"
+#include "utils/logger.hpp"
+#include "utils/mpmc_queue.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define DMP_PROFILER_SUPPORTED 1
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <sys/prctl.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+namespace dmp {
+
+namespace {
+    constexpr size_t kMaxFrames = 128;
+    constexpr size_t kThreadNameLength = 16;                 // Including the terminator (TASK_COMM_LEN)
+    constexpr uintptr_t kMaxFrameSpan = 8u << 20;            // A saved frame pointer further away is garbage
+    constexpr auto kControlInterval = std::chrono::milliseconds(100);
+}
+
+/**
+ * @brief One captured stack, written by the SIGPROF handler
+ *
+ * frames[0] is the interrupted instruction; the rest are return
+ * addresses minus one, so they resolve to the calling instruction.
+ */
+struct SamplingProfiler::Sample {
+    uint32_t depth = 0;
+    char thread_name[kThreadNameLength] = {};
+    uintptr_t frames[kMaxFrames];
+};
+
+namespace {
+    std::atomic<SamplingProfiler*> g_profiler{nullptr};
+
+#if DMP_PROFILER_SUPPORTED
+    pid_t g_pid = 0;
+
+    /**
+     * @brief Copy memory of this process without faulting on bad addresses
+     */
+    bool safe_read(uintptr_t address, void* out, size_t size) {
+        iovec local{out, size};
+        iovec remote{reinterpret_cast<void*>(address), size};
+        return ::process_vm_readv(g_pid, &local, 1, &remote, 1, 0) == static_cast<ssize_t>(size);
+    }
+
+    /**
+     * @brief Walk the frame-pointer chain of the interrupted context (async-signal-safe)
+     */
+    uint32_t capture_stack(const ucontext_t* uc, uintptr_t* frames, uint32_t max_depth) {
+#if defined(__x86_64__)
+        uintptr_t pc = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+        uintptr_t fp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RBP]);
+        uintptr_t sp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RSP]);
+#elif defined(__aarch64__)
+        uintptr_t pc = static_cast<uintptr_t>(uc->uc_mcontext.pc);
+        uintptr_t fp = static_cast<uintptr_t>(uc->uc_mcontext.regs[29]);
+        uintptr_t sp = static_cast<uintptr_t>(uc->uc_mcontext.sp);
+#endif
+        uint32_t depth = 0;
+        frames[depth++] = pc;
+
+        // Frame record layout on both targets: [fp] = caller's fp, [fp + 8] = return address
+        while (depth < max_depth) {
+            if (fp < sp || fp - sp > kMaxFrameSpan || (fp & (sizeof(uintptr_t) - 1)) != 0) {
+                break;
+            }
+            uintptr_t record[2];
+            if (!safe_read(fp, record, sizeof(record)) || record[1] == 0) {
+                break;
+            }
+            frames[depth++] = record[1] - 1;
+            if (record[0] <= fp) {
+                break;  // Outermost frame, or not a frame pointer at all
+            }
+            sp = fp;
+            fp = record[0];
+        }
+        return depth;
+    }
+
+    std::string demangle(const char* symbol) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(symbol, nullptr, nullptr, &status);
+        std::string name = status == 0 && demangled ? demangled : symbol;
+        std::free(demangled);
+        return name;
+    }
+
+    std::string symbolize(uintptr_t address) {
+        Dl_info info{};
+        std::string name;
+        if (::dladdr(reinterpret_cast<void*>(address), &info) != 0) {
+            if (info.dli_sname) {
+                name = demangle(info.dli_sname);
+            } else if (info.dli_fname) {
+                char offset[32];
+                std::snprintf(offset, sizeof(offset), "+0x%lx",
+                              static_cast<unsigned long>(address - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+                name = std::filesystem::path(info.dli_fname).filename().string() + offset;
+            }
+        }
+        if (name.empty()) {
+            char raw[32];
+            std::snprintf(raw, sizeof(raw), "0x%lx", static_cast<unsigned long>(address));
+            name = raw;
+        }
+        // ';' separates frames in the folded format
+        std::replace(name.begin(), name.end(), ';', ':');
+        return name;
+    }
+#endif
+}
+
+SamplingProfiler& SamplingProfiler::instance() {
+    static SamplingProfiler instance;
+    return instance;
+}
+
+SamplingProfiler::SamplingProfiler() {
+    g_profiler.store(this, std::memory_order_release);
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    if (running()) {
+        disarm_timer();
+        running_.store(false, std::memory_order_release);
+    }
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        control_stop_ = true;
+    }
+    control_cv_.notify_all();
+    if (control_thread_.joinable()) {
+        control_thread_.join();
+    }
+    g_profiler.store(nullptr, std::memory_order_release);
+}
+
+Result<void> SamplingProfiler::configure(const ProfilerConfig& config) {
+    if (config.enabled && !supported()) {
+        return {ErrorCode::INVALID_REQUEST, "Sampling profiler is only supported on Linux x86_64/aarch64"};
+    }
+    if (running()) {
+        return {ErrorCode::INVALID_REQUEST, "Cannot reconfigure the profiler while a session is running"};
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(session_mutex_);
+        config_ = config;
+    }
+    max_depth_.store(std::min<uint32_t>(config.max_stack_depth, kMaxFrames), std::memory_order_relaxed);
+    enabled_.store(config.enabled, std::memory_order_release);
+    if (!config.enabled) {
+        return {ErrorCode::SUCCESS, ""};
+    }
+
+#if DMP_PROFILER_SUPPORTED
+    g_pid = ::getpid();
+
+    struct sigaction toggle{};
+    toggle.sa_handler = &SamplingProfiler::on_toggle;
+    sigemptyset(&toggle.sa_mask);
+    toggle.sa_flags = SA_RESTART;
+    if (::sigaction(SIGUSR2, &toggle, nullptr) != 0) {
+        return {ErrorCode::INTERNAL_ERROR, std::string("Cannot install SIGUSR2 handler: ") + std::strerror(errno)};
+    }
+
+    struct sigaction prof{};
+    prof.sa_sigaction = &SamplingProfiler::on_sigprof;
+    sigemptyset(&prof.sa_mask);
+    prof.sa_flags = SA_SIGINFO | SA_RESTART;
+    if (::sigaction(SIGPROF, &prof, nullptr) != 0) {
+        return {ErrorCode::INTERNAL_ERROR, std::string("Cannot install SIGPROF handler: ") + std::strerror(errno)};
+    }
+#endif
+
+    if (!control_thread_.joinable()) {
+        control_stop_ = false;
+        control_thread_ = std::thread(&SamplingProfiler::control_loop, this);
+    }
+    return {ErrorCode::SUCCESS, ""};
+}
+
+Result<void> SamplingProfiler::start(uint32_t duration_s) {
+    if (!enabled_.load(std::memory_order_acquire)) {
+        return {ErrorCode::INVALID_REQUEST, "Sampling profiler is disabled ([profiler] enabled = false)"};
+    }
+
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    if (running()) {
+        return {ErrorCode::INVALID_REQUEST, "A profiling session is already running"};
+    }
+
+    if (!queue_) {
+        queue_ = std::make_unique<MpmcQueue<Sample>>(config_.queue_capacity);
+    }
+    stacks_.clear();
+    samples_ = 0;
+    dropped_.store(0, std::memory_order_relaxed);
+    const uint32_t limit = duration_s == 0 ? config_.max_duration_s : std::min(duration_s, config_.max_duration_s);
+    started_at_ = std::chrono::steady_clock::now();
+    stop_at_ = started_at_ + std::chrono::seconds(limit);
+
+    running_.store(true, std::memory_order_release);
+    if (!arm_timer(config_.frequency_hz)) {
+        running_.store(false, std::memory_order_release);
+        return {ErrorCode::INTERNAL_ERROR, std::string("Cannot arm profiling timer: ") + std::strerror(errno)};
+    }
+    LOG_INFO("🔥 Profiling started: {} Hz, stops after {}s", config_.frequency_hz, limit);
+    return {ErrorCode::SUCCESS, ""};
+}
+
+Result<std::string> SamplingProfiler::stop() {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    return stop_locked();
+}
+
+Result<std::string> SamplingProfiler::stop_locked() {
+    if (!running()) {
+        return {"", ErrorCode::INVALID_REQUEST, "No profiling session is running"};
+    }
+
+    disarm_timer();
+    running_.store(false, std::memory_order_release);
+    // A handler that saw running_ == true may still be pushing
+    while (handlers_in_flight_.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    stopped_at_ = std::chrono::steady_clock::now();
+
+    Sample sample;
+    while (queue_->try_pop(sample)) {
+        stacks_[{sample.thread_name, std::vector<uintptr_t>(sample.frames, sample.frames + sample.depth)}]++;
+        ++samples_;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.output_directory, ec);
+    if (ec) {
+        return {"", ErrorCode::INTERNAL_ERROR,
+               "Cannot create profile directory " + config_.output_directory + ": " + ec.message()};
+    }
+    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string path = config_.output_directory + "/profile-" + std::to_string(now_ms) + ".folded";
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) {
+        return {"", ErrorCode::INTERNAL_ERROR, "Cannot open profile file: " + path};
+    }
+    file << folded_locked();
+    if (!file) {
+        return {"", ErrorCode::INTERNAL_ERROR, "Failed to write profile file: " + path};
+    }
+    last_output_ = path;
+
+    LOG_INFO("🔥 Profiling stopped: {} samples ({} dropped, {} unique stacks) written to {}",
+             samples_, dropped_.load(std::memory_order_relaxed), stacks_.size(), path);
+    return {path, ErrorCode::SUCCESS, ""};
+}
+
+ProfilerStats SamplingProfiler::stats() const {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    ProfilerStats stats;
+    stats.running = running();
+    stats.samples = samples_;
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.unique_stacks = stacks_.size();
+    if (started_at_ != std::chrono::steady_clock::time_point{}) {
+        auto end = stats.running ? std::chrono::steady_clock::now() : stopped_at_;
+        stats.elapsed_ms = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - started_at_).count());
+    }
+    stats.last_output = last_output_;
+    return stats;
+}
+
+std::string SamplingProfiler::folded() const {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    return folded_locked();
+}
+
+std::string SamplingProfiler::folded_locked() const {
+    std::string out;
+#if DMP_PROFILER_SUPPORTED
+    std::unordered_map<uintptr_t, std::string> names;
+    auto name_of = [&names](uintptr_t address) -> const std::string& {
+        auto it = names.find(address);
+        if (it == names.end()) {
+            it = names.emplace(address, symbolize(address)).first;
+        }
+        return it->second;
+    };
+
+    // Equal symbolized stacks (e.g. different offsets in one function) merge into one line
+    std::map<std::string, uint64_t> lines;
+    for (const auto& [key, count] : stacks_) {
+        const auto& [thread, frames] = key;
+        std::string line = thread.empty() ? "unknown" : thread;
+        std::replace(line.begin(), line.end(), ';', ':');
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+            line += ';';
+            line += name_of(*it);
+        }
+        lines[line] += count;
+    }
+    for (const auto& [line, count] : lines) {
+        out += line;
+        out += ' ';
+        out += std::to_string(count);
+        out += '\n';
+    }
+#endif
+    return out;
+}
+
+void SamplingProfiler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(session_mutex_);
+        if (running()) {
+            auto result = stop_locked();
+            if (result.is_error()) {
+                LOG_ERROR("Profile not written: {}", result.error_message);
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        control_stop_ = true;
+    }
+    control_cv_.notify_all();
+    if (control_thread_.joinable()) {
+        control_thread_.join();
+    }
+}
+
+void SamplingProfiler::control_loop() {
+    std::unique_lock<std::mutex> control_lock(control_mutex_);
+    while (!control_stop_) {
+        control_cv_.wait_for(control_lock, kControlInterval);
+        if (control_stop_) {
+            break;
+        }
+        control_lock.unlock();
+
+        if (toggle_requested_.exchange(false)) {
+            if (running()) {
+                auto result = stop();
+                if (result.is_error()) {
+                    LOG_ERROR("Profile not written: {}", result.error_message);
+                }
+            } else {
+                auto result = start();
+                if (result.is_error()) {
+                    LOG_ERROR("Profiling not started: {}", result.error_message);
+                }
+            }
+        }
+        drain();
+
+        control_lock.lock();
+    }
+}
+
+void SamplingProfiler::drain() {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    if (!running()) {
+        return;
+    }
+
+    Sample sample;
+    while (queue_->try_pop(sample)) {
+        stacks_[{sample.thread_name, std::vector<uintptr_t>(sample.frames, sample.frames + sample.depth)}]++;
+        ++samples_;
+    }
+
+    if (std::chrono::steady_clock::now() >= stop_at_) {
+        auto result = stop_locked();
+        if (result.is_error()) {
+            LOG_ERROR("Profile not written: {}", result.error_message);
+        }
+    }
+}
+
+bool SamplingProfiler::arm_timer(uint32_t frequency_hz) {
+#if DMP_PROFILER_SUPPORTED
+    const long interval_us = std::max(1L, 1000000L / static_cast<long>(frequency_hz));
+    itimerval timer{};
+    timer.it_interval.tv_sec = interval_us / 1000000;
+    timer.it_interval.tv_usec = interval_us % 1000000;
+    timer.it_value = timer.it_interval;
+    return ::setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+#else
+    (void)frequency_hz;
+    return false;
+#endif
+}
+
+void SamplingProfiler::disarm_timer() {
+#if DMP_PROFILER_SUPPORTED
+    itimerval timer{};
+    ::setitimer(ITIMER_PROF, &timer, nullptr);
+#endif
+}
+
+void SamplingProfiler::on_sigprof(int signo, siginfo_t* info, void* context) {
+    (void)signo;
+    (void)info;
+#if DMP_PROFILER_SUPPORTED
+    SamplingProfiler* self = g_profiler.load(std::memory_order_acquire);
+    if (!self) {
+        return;
+    }
+    const int saved_errno = errno;
+    self->handlers_in_flight_.fetch_add(1, std::memory_order_acq_rel);
+    if (self->running_.load(std::memory_order_acquire)) {
+        Sample sample;
+        ::prctl(PR_GET_NAME, sample.thread_name, 0, 0, 0);
+        sample.depth = capture_stack(static_cast<const ucontext_t*>(context), sample.frames,
+                                     self->max_depth_.load(std::memory_order_relaxed));
+        if (!self->queue_->try_push(sample)) {
+            self->dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    self->handlers_in_flight_.fetch_sub(1, std::memory_order_release);
+    errno = saved_errno;
+#else
+    (void)context;
+#endif
+}
+
+void SamplingProfiler::on_toggle(int signo) {
+    (void)signo;
+    if (SamplingProfiler* self = g_profiler.load(std::memory_order_acquire)) {
+        self->toggle_requested_.store(true, std::memory_order_relaxed);
+    }
+}
+
+} // namespace dmp
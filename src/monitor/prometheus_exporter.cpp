@@ -0,0 +1,500 @@
+#include "utils/prometheus_exporter.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace dmp {
+
+namespace {
+    constexpr int kPollIntervalMs = 200;           // Stop-flag check interval
+    constexpr size_t kMaxRequestHeaderBytes = 8192; // Scrapers send tiny requests
+    constexpr int kClientTimeoutSeconds = 2;
+
+    // Fixed histogram bucket bounds exposed to Prometheus (seconds)
+    constexpr double kLatencyBucketsSeconds[] = {
+        0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+        0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0
+    };
+    constexpr size_t kLatencyBucketCount = sizeof(kLatencyBucketsSeconds) / sizeof(double);
+
+    /**
+     * @brief Unlabeled counters and how they are exposed
+     */
+    struct CounterExposition {
+        MetricCounter counter;
+        const char* name;
+        const char* labels;   // Pre-rendered label set, may be empty
+        const char* help;
+    };
+
+    // HTTP requests, errors and ML inferences are exposed through their labeled families
+    constexpr CounterExposition kCounterExpositions[] = {
+        {MetricCounter::DECISIONS_APPROVE, "dmp_decisions_total", "{decision=\"approve\"}",
+         "Risk decisions by outcome"},
+        {MetricCounter::DECISIONS_DECLINE, "dmp_decisions_total", "{decision=\"decline\"}", nullptr},
+        {MetricCounter::DECISIONS_REVIEW, "dmp_decisions_total", "{decision=\"review\"}", nullptr},
+        {MetricCounter::RULES_EVALUATED, "dmp_rules_evaluated_total", "",
+         "Rules evaluated across all decisions"},
+        {MetricCounter::RULES_TRIGGERED, "dmp_rules_triggered_total", "",
+         "Rules triggered across all decisions"},
+        {MetricCounter::FEATURE_CACHE_HITS, "dmp_feature_cache_lookups_total", "{result=\"hit\"}",
+         "Feature cache lookups by result"},
+        {MetricCounter::FEATURE_CACHE_MISSES, "dmp_feature_cache_lookups_total", "{result=\"miss\"}", nullptr},
+        {MetricCounter::FEATURES_EXTRACTED, "dmp_features_extracted_total", "",
+         "Features extracted across all decisions"},
+        {MetricCounter::DECISION_ALLOCATIONS, "dmp_decision_heap_allocations_total", "",
+         "Heap allocations made while deciding (allocation tracking builds only)"},
+        {MetricCounter::DECISION_ALLOCATED_BYTES, "dmp_decision_heap_allocated_bytes_total", "",
+         "Heap bytes requested while deciding (allocation tracking builds only)"},
+    };
+
+    void append_escaped(std::string& out, const std::string& value) {
+        for (char c : value) {
+            switch (c) {
+                case '\\': out += "\\\\"; break;
+                case '"': out += "\\\""; break;
+                case '\n': out += "\\n"; break;
+                default: out += c; break;
+            }
+        }
+    }
+
+    void append_number(std::string& out, double value) {
+        char buf[32];
+        int len = std::snprintf(buf, sizeof(buf), "%.9g", value);
+        out.append(buf, len > 0 ? static_cast<size_t>(len) : 0);
+    }
+
+    void append_number(std::string& out, uint64_t value) {
+        char buf[24];
+        int len = std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(value));
+        out.append(buf, len > 0 ? static_cast<size_t>(len) : 0);
+    }
+
+    void append_header(std::string& out, const std::string& name, const char* type,
+                       const std::string& help) {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += '\n';
+    }
+
+    bool send_all(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+#ifdef MSG_NOSIGNAL
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#else
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+#endif
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    const char* reason_phrase(int status) {
+        switch (status) {
+            case 200: return "OK";
+            case 201: return "Created";
+            case 202: return "Accepted";
+            case 204: return "No Content";
+            case 400: return "Bad Request";
+            case 403: return "Forbidden";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 409: return "Conflict";
+            case 413: return "Payload Too Large";
+            case 429: return "Too Many Requests";
+            case 500: return "Internal Server Error";
+            case 501: return "Not Implemented";
+            case 502: return "Bad Gateway";
+            case 503: return "Service Unavailable";
+            case 504: return "Gateway Timeout";
+            default: return status < 500 ? "Bad Request" : "Internal Server Error";
+        }
+    }
+
+    std::string http_response(int status, const char* reason, const char* content_type,
+                              const std::string& body) {
+        std::string response;
+        response.reserve(body.size() + 160);
+        response += "HTTP/1.1 ";
+        response += std::to_string(status);
+        response += ' ';
+        response += reason;
+        response += "\r\nContent-Type: ";
+        response += content_type;
+        response += "\r\nContent-Length: ";
+        response += std::to_string(body.size());
+        response += "\r\nConnection: close\r\n\r\n";
+        response += body;
+        return response;
+    }
+}
+
+PrometheusExporter::PrometheusExporter(MetricsCollector& collector)
+    : collector_(collector) {
+}
+
+PrometheusExporter::~PrometheusExporter() {
+    stop();
+}
+
+Result<void> PrometheusExporter::start(uint16_t port, const std::string& path,
+                                       uint32_t render_cache_ms) {
+    if (running_.load()) {
+        return {ErrorCode::INVALID_REQUEST, "Prometheus exporter already running"};
+    }
+
+    path_ = path;
+    render_cache_ms_ = render_cache_ms;
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        return {ErrorCode::INTERNAL_ERROR,
+               std::string("Failed to create metrics socket: ") + std::strerror(errno)};
+    }
+
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 16) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return {ErrorCode::INTERNAL_ERROR,
+               "Failed to bind metrics endpoint on port " + std::to_string(port) + ": " + error};
+    }
+
+    socklen_t addr_len = sizeof(addr);
+    if (::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len) == 0) {
+        bound_port_.store(ntohs(addr.sin_port));
+    }
+
+    running_.store(true);
+    serve_thread_ = std::make_unique<std::thread>(&PrometheusExporter::serve_loop, this);
+    return {ErrorCode::SUCCESS, ""};
+}
+
+void PrometheusExporter::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (serve_thread_ && serve_thread_->joinable()) {
+        serve_thread_->join();
+    }
+    serve_thread_.reset();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void PrometheusExporter::add_route(const std::string& path, RouteHandler handler) {
+    add_status_route(path, [handler = std::move(handler)](const std::string& query) {
+        return RouteResponse{200, handler(query)};
+    });
+}
+
+void PrometheusExporter::add_status_route(const std::string& path, StatusRouteHandler handler) {
+    add_method_route("GET", path, std::move(handler));
+}
+
+void PrometheusExporter::add_post_route(const std::string& path, StatusRouteHandler handler) {
+    add_method_route("POST", path, std::move(handler));
+}
+
+void PrometheusExporter::add_method_route(const std::string& method, const std::string& path,
+                                          StatusRouteHandler handler) {
+    std::lock_guard<std::mutex> lock(routes_mutex_);
+    for (auto& route : routes_) {
+        if (route.method == method && route.path == path) {
+            route.handler = std::move(handler);
+            return;
+        }
+    }
+    routes_.push_back(Route{method, path, std::move(handler)});
+}
+
+void PrometheusExporter::serve_loop() {
+    while (running_.load()) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, kPollIntervalMs);
+        if (ready <= 0 || !(pfd.revents & POLLIN)) {
+            continue;
+        }
+
+        int client_fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (client_fd < 0) {
+            continue;
+        }
+
+        try {
+            handle_connection(client_fd);
+        } catch (const std::exception& e) {
+            std::cerr << "Metrics endpoint error: " << e.what() << std::endl;
+        }
+        ::close(client_fd);
+    }
+}
+
+void PrometheusExporter::handle_connection(int client_fd) {
+    timeval timeout{kClientTimeoutSeconds, 0};
+    ::setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int no_sigpipe = 1;
+    ::setsockopt(client_fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+    // Read until end of headers; the request body (if any) is ignored
+    std::string request;
+    char buffer[1024];
+    while (request.size() < kMaxRequestHeaderBytes &&
+           request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = ::recv(client_fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    size_t method_end = request.find(' ');
+    size_t target_end = method_end == std::string::npos ? std::string::npos
+                                                        : request.find(' ', method_end + 1);
+    if (target_end == std::string::npos) {
+        send_all(client_fd, http_response(400, "Bad Request", "text/plain", "bad request\n"));
+        return;
+    }
+
+    std::string method = request.substr(0, method_end);
+    std::string target = request.substr(method_end + 1, target_end - method_end - 1);
+    if (method != "GET" && method != "POST") {
+        send_all(client_fd, http_response(405, "Method Not Allowed", "text/plain",
+                                          "only GET and POST are supported\n"));
+        return;
+    }
+
+    std::string query;
+    size_t query_pos = target.find('?');
+    if (query_pos != std::string::npos) {
+        query = target.substr(query_pos + 1);
+        target.resize(query_pos);
+    }
+
+    if (target == path_ && method == "GET") {
+        send_all(client_fd, http_response(200, "OK", "text/plain; version=0.0.4; charset=utf-8",
+                                          render()));
+        return;
+    }
+
+    StatusRouteHandler handler;
+    bool path_known = target == path_;
+    {
+        std::lock_guard<std::mutex> lock(routes_mutex_);
+        for (const auto& route : routes_) {
+            if (route.path != target) {
+                continue;
+            }
+            path_known = true;
+            if (route.method == method) {
+                handler = route.handler;
+                break;
+            }
+        }
+    }
+
+    if (handler) {
+        auto response = handler(query);
+        send_all(client_fd, http_response(response.status, reason_phrase(response.status),
+                                          "text/plain; charset=utf-8", response.body));
+    } else if (path_known) {
+        send_all(client_fd, http_response(405, "Method Not Allowed", "text/plain",
+                                          "method not allowed for " + target + "\n"));
+    } else {
+        send_all(client_fd, http_response(404, "Not Found", "text/plain", "not found\n"));
+    }
+}
+
+std::string PrometheusExporter::render() {
+    std::lock_guard<std::mutex> lock(render_mutex_);
+
+    auto now = std::chrono::steady_clock::now();
+    if (!cached_body_.empty() &&
+        now - cached_at_ < std::chrono::milliseconds(render_cache_ms_)) {
+        return cached_body_;
+    }
+
+    cached_body_ = render_uncached(collector_.snapshot());
+    cached_at_ = now;
+    return cached_body_;
+}
+
+const std::string& PrometheusExporter::series_prefix(const LabeledSeriesValue& series) {
+    if (series.series_id >= series_prefixes_.size()) {
+        series_prefixes_.resize(series.series_id + 1);
+    }
+
+    std::string& prefix = series_prefixes_[series.series_id];
+    if (prefix.empty()) {
+        // Label values of a series id never change, so escape them only once
+        const auto& info = metric_family_info(series.family);
+        prefix = info.name;
+        if (!info.label_names.empty()) {
+            prefix += '{';
+            for (size_t i = 0; i < info.label_names.size(); ++i) {
+                if (i > 0) prefix += ',';
+                prefix += info.label_names[i];
+                prefix += "=\"";
+                if (i < series.label_values.size()) {
+                    append_escaped(prefix, series.label_values[i]);
+                }
+                prefix += '"';
+            }
+            prefix += '}';
+        }
+        prefix += ' ';
+    }
+    return prefix;
+}
+
+std::string PrometheusExporter::render_uncached(const MetricsSnapshot& snapshot) {
+    std::string out;
+    out.reserve(cached_body_.size() + 1024);
+
+    // Unlabeled counters
+    for (const auto& exposition : kCounterExpositions) {
+        if (exposition.help) {
+            append_header(out, exposition.name, "counter", exposition.help);
+        }
+        out += exposition.name;
+        out += exposition.labels;
+        out += ' ';
+        append_number(out, snapshot.counter(exposition.counter));
+        out += '\n';
+    }
+
+    // Labeled counter families, grouped so each family gets one header
+    for (size_t f = 0; f < static_cast<size_t>(MetricFamily::kCount); ++f) {
+        auto family = static_cast<MetricFamily>(f);
+        const auto& info = metric_family_info(family);
+        append_header(out, info.name, "counter", info.help);
+        for (const auto& series : snapshot.labeled) {
+            if (series.family != family) continue;
+            out += series_prefix(series);
+            append_number(out, series.value);
+            out += '\n';
+        }
+    }
+
+    // Stage latency histograms
+    append_header(out, "dmp_stage_latency_seconds", "histogram",
+                  "Latency of decision pipeline stages");
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+        const auto& histogram = snapshot.stage_latency[s];
+        const char* stage = pipeline_stage_name(static_cast<PipelineStage>(s));
+
+        for (size_t b = 0; b < kLatencyBucketCount; ++b) {
+            out += "dmp_stage_latency_seconds_bucket{stage=\"";
+            out += stage;
+            out += "\",le=\"";
+            append_number(out, kLatencyBucketsSeconds[b]);
+            out += "\"} ";
+            append_number(out, histogram.count_at_or_below(
+                static_cast<uint64_t>(kLatencyBucketsSeconds[b] * 1e9)));
+            out += '\n';
+        }
+        out += "dmp_stage_latency_seconds_bucket{stage=\"";
+        out += stage;
+        out += "\",le=\"+Inf\"} ";
+        append_number(out, histogram.count());
+        out += "\ndmp_stage_latency_seconds_sum{stage=\"";
+        out += stage;
+        out += "\"} ";
+        append_number(out, static_cast<double>(histogram.sum()) / 1e9);
+        out += "\ndmp_stage_latency_seconds_count{stage=\"";
+        out += stage;
+        out += "\"} ";
+        append_number(out, histogram.count());
+        out += '\n';
+    }
+
+    // Hardware events of sampled stages (only when [hardware_counters] is enabled)
+    const uint32_t hw_events = HwCounters::instance().available_events();
+    bool hw_header = false;
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+        if (snapshot.stage_hw_samples[s] == 0) continue;
+        if (!hw_header) {
+            append_header(out, "dmp_stage_hw_samples_total", "counter",
+                          "Pipeline stages measured with hardware counters");
+            hw_header = true;
+        }
+        out += "dmp_stage_hw_samples_total{stage=\"";
+        out += pipeline_stage_name(static_cast<PipelineStage>(s));
+        out += "\"} ";
+        append_number(out, snapshot.stage_hw_samples[s]);
+        out += '\n';
+    }
+    if (hw_header) {
+        append_header(out, "dmp_stage_hw_events_total", "counter",
+                      "Hardware events counted inside measured pipeline stages");
+        for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+            if (snapshot.stage_hw_samples[s] == 0) continue;
+            for (size_t e = 0; e < HW_EVENT_COUNT; ++e) {
+                if (!(hw_events & (1u << e))) continue;
+                out += "dmp_stage_hw_events_total{stage=\"";
+                out += pipeline_stage_name(static_cast<PipelineStage>(s));
+                out += "\",event=\"";
+                out += hw_event_name(static_cast<HwEvent>(e));
+                out += "\"} ";
+                append_number(out, snapshot.stage_hw_events[s].values[e]);
+                out += '\n';
+            }
+        }
+    }
+
+    // Built-in gauges
+    auto append_gauge = [&out](const std::string& name, const std::string& help, double value) {
+        append_header(out, name, "gauge", help);
+        out += name;
+        out += ' ';
+        append_number(out, value);
+        out += '\n';
+    };
+    append_gauge("dmp_cpu_usage_percent", "Process CPU usage percentage", snapshot.cpu_usage_percent);
+    append_gauge("dmp_memory_usage_megabytes", "Process memory usage", snapshot.memory_usage_mb);
+    append_gauge("dmp_active_connections", "Active client connections",
+                 static_cast<double>(snapshot.active_connections));
+
+    // Callback gauges and counters registered by other components
+    for (const auto& [name, value] : snapshot.gauges) {
+        append_header(out, name, collector_.gauge_type(name), collector_.gauge_help(name));
+        out += name;
+        out += ' ';
+        append_number(out, value);
+        out += '\n';
+    }
+
+    return out;
+}
+
+} // namespace dmp
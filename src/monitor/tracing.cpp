@@ -0,0 +1,417 @@
+#include "utils/tracing.hpp"
+#include "utils/logger.hpp"
+#include "utils/perf_log.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace dmp {
+
+/**
+ * @brief Per-thread span ring buffer
+ *
+ * Single writer; write_pos is published once per request, so up to
+ * kMaxSpansPerRequest slots past it may be in the middle of being
+ * overwritten. Readers validate against the write position after copying
+ * and discard every entry that window may have reached meanwhile.
+ */
+struct Tracer::SpanRing {
+    SpanRing(size_t capacity, uint32_t index)
+        : spans(capacity), mask(capacity - 1), thread_index(index) {}
+
+    std::vector<SpanRecord> spans;
+    size_t mask;
+    uint32_t thread_index;
+    std::atomic<uint64_t> write_pos{0};
+};
+
+/**
+ * @brief Thread-exit hook returning the ring to the pool
+ */
+struct SpanRingLease {
+    Tracer::SpanRing* ring = nullptr;
+
+    ~SpanRingLease() {
+        if (ring) {
+            Tracer::instance().release_ring(ring);
+        }
+    }
+};
+
+namespace {
+    constexpr size_t kMaxSpansPerRequest = 32;
+    constexpr auto kCalibrationTime = std::chrono::milliseconds(5);
+
+    /**
+     * @brief Spans of the request currently running on this thread
+     */
+    struct PendingRequest {
+        bool active = false;
+        TraceId trace_id;
+        uint64_t request_id = 0;
+        uint64_t start_tsc = 0;
+        uint64_t queue_wait_ns = 0;
+        Decision decision = Decision::APPROVE;
+        bool error = false;
+        size_t count = 0;
+        std::array<SpanRecord, kMaxSpansPerRequest> spans;
+    };
+
+    thread_local PendingRequest tl_pending;
+    thread_local SpanRingLease tl_ring_lease;
+
+    uint64_t hash_request_id(std::string_view request_id) {
+        // FNV-1a followed by a splitmix64 finalizer for uniform low bits
+        uint64_t hash = 1469598103934665603ULL;
+        for (char c : request_id) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        hash ^= hash >> 30;
+        hash *= 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 27;
+        hash *= 0x94d049bb133111ebULL;
+        hash ^= hash >> 31;
+        return hash;
+    }
+
+    size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    const char* format_extension(TraceExportFormat format) {
+        return format == TraceExportFormat::CHROME ? ".chrome.json" : ".otlp.json";
+    }
+
+    void append_format(std::string& out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    void append_format(std::string& out, const char* fmt, ...) {
+        char buf[1024];
+        va_list args;
+        va_start(args, fmt);
+        int len = std::vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (len > 0) {
+            out.append(buf, std::min(static_cast<size_t>(len), sizeof(buf) - 1));
+        }
+    }
+}
+
+Tracer& Tracer::instance() {
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::Tracer()
+    : tsc_anchor_(read_tsc())
+    , unix_anchor_ns_(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count()))
+    , steady_anchor_(std::chrono::steady_clock::now()) {
+    // Span durations also feed the PerfLog, which may run without tracing
+    // ever being configured, so never convert with an uncalibrated ratio
+    calibrate();
+}
+
+Tracer::~Tracer() = default;
+
+void Tracer::configure(const TracingConfig& config) {
+    double rate = std::clamp(config.sample_rate, 0.0, 1.0);
+    sample_threshold_.store(rate >= 1.0 ? UINT64_MAX
+                                        : static_cast<uint64_t>(rate * 18446744073709551616.0));
+    slow_threshold_ticks_.store(static_cast<uint64_t>(
+        config.slow_request_threshold_ms * 1e6 / ns_per_tick_.load()));
+    // A request must never wrap the ring onto itself (see SpanRing)
+    ring_capacity_.store(static_cast<uint32_t>(round_up_pow2(
+        std::max<size_t>(config.ring_buffer_spans, 2 * kMaxSpansPerRequest))));
+    export_directory_ = config.export_directory;
+    enabled_.store(config.enabled);
+}
+
+void Tracer::calibrate() {
+    auto steady_start = std::chrono::steady_clock::now();
+    uint64_t tsc_start = read_tsc();
+    while (std::chrono::steady_clock::now() - steady_start < kCalibrationTime) {
+        std::this_thread::yield();
+    }
+    uint64_t tsc_end = read_tsc();
+    auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - steady_start).count();
+
+    if (tsc_end > tsc_start) {
+        ns_per_tick_.store(static_cast<double>(elapsed_ns) / static_cast<double>(tsc_end - tsc_start));
+    }
+}
+
+void Tracer::begin_request() {
+    if (!enabled() && !PerfLog::instance().enabled()) return;
+
+    TraceId trace_id = TraceContext::current();
+    tl_pending.active = true;
+    tl_pending.trace_id = trace_id.empty() ? TraceId::generate() : trace_id;
+    tl_pending.request_id = 0;
+    tl_pending.count = 0;
+    tl_pending.queue_wait_ns = 0;
+    tl_pending.decision = Decision::APPROVE;
+    tl_pending.error = true;  // Cleared by record_outcome() on success paths
+    tl_pending.start_tsc = read_tsc();
+}
+
+void Tracer::record_queue_wait(uint64_t wait_ns) {
+    tl_pending.queue_wait_ns = wait_ns;
+}
+
+void Tracer::record_outcome(Decision decision, bool error) {
+    tl_pending.decision = decision;
+    tl_pending.error = error;
+}
+
+namespace {
+    /**
+     * @brief Summarize a finished request into the binary performance log
+     */
+    void submit_perf_record(const Tracer& tracer, const PendingRequest& pending) {
+        PerfRecord record;
+        record.timestamp_ns = tracer.tsc_to_unix_ns(pending.start_tsc);
+        record.trace_high = pending.trace_id.high;
+        record.trace_low = pending.trace_id.low;
+        for (size_t i = 0; i < pending.count; ++i) {
+            const auto& span = pending.spans[i];
+            uint32_t& slot = record.stage_ns[static_cast<size_t>(span.stage)];
+            uint64_t total = slot + static_cast<uint64_t>(tracer.ticks_to_ns(span.end_tsc - span.start_tsc));
+            slot = static_cast<uint32_t>(std::min<uint64_t>(total, UINT32_MAX));
+        }
+        record.queue_wait_ns = static_cast<uint32_t>(std::min<uint64_t>(pending.queue_wait_ns, UINT32_MAX));
+        record.decision = static_cast<uint8_t>(pending.decision);
+        record.flags = pending.error ? PerfRecord::kError : 0;
+        PerfLog::instance().submit(record);
+    }
+}
+
+void Tracer::set_request_id(std::string_view request_id) {
+    if (tl_pending.active) {
+        tl_pending.request_id = hash_request_id(request_id);
+    }
+}
+
+bool Tracer::request_active() const {
+    return tl_pending.active;
+}
+
+void Tracer::record_span(PipelineStage stage, uint64_t start_tsc, uint64_t end_tsc) {
+    auto& pending = tl_pending;
+    if (!pending.active || pending.count >= kMaxSpansPerRequest) return;
+
+    auto& span = pending.spans[pending.count++];
+    span.start_tsc = start_tsc;
+    span.end_tsc = end_tsc;
+    span.stage = stage;
+}
+
+void Tracer::end_request() {
+    auto& pending = tl_pending;
+    if (!pending.active) return;
+    pending.active = false;
+    if (pending.count == 0) return;
+
+    if (PerfLog::instance().enabled()) {
+        submit_perf_record(*this, pending);
+    }
+    if (!enabled()) return;
+
+    // Tail-based selection: sampled by trace id (uniformly random, and
+    // consistent across services sharing the id), or slow regardless
+    uint8_t flags = 0;
+    uint64_t threshold = sample_threshold_.load(std::memory_order_relaxed);
+    if (threshold == UINT64_MAX || pending.trace_id.low < threshold) {
+        flags |= SpanRecord::kSampled;
+    }
+    if (read_tsc() - pending.start_tsc >= slow_threshold_ticks_.load(std::memory_order_relaxed)) {
+        flags |= SpanRecord::kSlow;
+    }
+    if (flags == 0) return;
+
+    SpanRing& ring = local_ring();
+    uint64_t pos = ring.write_pos.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < pending.count; ++i) {
+        SpanRecord& slot = ring.spans[pos & ring.mask];
+        slot = pending.spans[i];
+        slot.trace_id = pending.trace_id;
+        slot.request_id = pending.request_id;
+        slot.thread_index = ring.thread_index;
+        slot.flags = flags;
+        ++pos;
+    }
+    ring.write_pos.store(pos, std::memory_order_release);
+}
+
+Tracer::SpanRing& Tracer::local_ring() {
+    if (!tl_ring_lease.ring) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        if (!free_rings_.empty()) {
+            tl_ring_lease.ring = free_rings_.back();
+            free_rings_.pop_back();
+        } else {
+            rings_.push_back(std::make_unique<SpanRing>(
+                ring_capacity_.load(), static_cast<uint32_t>(rings_.size())));
+            tl_ring_lease.ring = rings_.back().get();
+        }
+    }
+    return *tl_ring_lease.ring;
+}
+
+void Tracer::release_ring(SpanRing* ring) {
+    // Retained spans stay exportable after the thread exits
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    free_rings_.push_back(ring);
+}
+
+std::vector<SpanRecord> Tracer::collect() const {
+    std::vector<SpanRecord> result;
+
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+        const uint64_t capacity = ring->spans.size();
+        const uint64_t end = ring->write_pos.load(std::memory_order_acquire);
+        const uint64_t begin = end > capacity ? end - capacity : 0;
+
+        size_t first = result.size();
+        for (uint64_t i = begin; i < end; ++i) {
+            result.push_back(ring->spans[i & ring->mask]);
+        }
+
+        // Drop entries the writer may have overwritten while we copied: a
+        // request in flight writes [after, after + kMaxSpansPerRequest)
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t after = ring->write_pos.load(std::memory_order_relaxed);
+        const uint64_t reach = after + kMaxSpansPerRequest;
+        const uint64_t valid_begin = reach > capacity ? reach - capacity : 0;
+        if (valid_begin > begin) {
+            size_t torn = static_cast<size_t>(std::min(valid_begin, end) - begin);
+            result.erase(result.begin() + first, result.begin() + first + torn);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const SpanRecord& a, const SpanRecord& b) {
+        return a.start_tsc < b.start_tsc;
+    });
+    return result;
+}
+
+double Tracer::ticks_to_ns(uint64_t ticks) const {
+    return static_cast<double>(ticks) * ns_per_tick_.load(std::memory_order_relaxed);
+}
+
+uint64_t Tracer::tsc_to_unix_ns(uint64_t tsc) const {
+    if (tsc >= tsc_anchor_) {
+        return unix_anchor_ns_ + static_cast<uint64_t>(ticks_to_ns(tsc - tsc_anchor_));
+    }
+    return unix_anchor_ns_ - static_cast<uint64_t>(ticks_to_ns(tsc_anchor_ - tsc));
+}
+
+std::string Tracer::render(TraceExportFormat format, const std::vector<SpanRecord>& spans) const {
+    std::string out;
+    out.reserve(spans.size() * 256 + 256);
+    char trace_hex[TraceId::kHexLength + 1] = {};
+
+    if (format == TraceExportFormat::CHROME) {
+        const long pid = static_cast<long>(::getpid());
+        out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (size_t i = 0; i < spans.size(); ++i) {
+            const auto& span = spans[i];
+            double ts_us = static_cast<double>(tsc_to_unix_ns(span.start_tsc)) / 1e3;
+            double dur_us = ticks_to_ns(span.end_tsc - span.start_tsc) / 1e3;
+            span.trace_id.format_to(trace_hex);
+            append_format(out,
+                "%s{\"name\":\"%s\",\"cat\":\"dmp\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                "\"pid\":%ld,\"tid\":%u,\"args\":{\"trace_id\":\"%s\",\"request_id\":\"%016llx\","
+                "\"sampled\":%s,\"slow\":%s}}",
+                i == 0 ? "" : ",", pipeline_stage_name(span.stage), ts_us, dur_us, pid,
+                span.thread_index, trace_hex, static_cast<unsigned long long>(span.request_id),
+                (span.flags & SpanRecord::kSampled) ? "true" : "false",
+                (span.flags & SpanRecord::kSlow) ? "true" : "false");
+        }
+        out += "]}\n";
+        return out;
+    }
+
+    out += "{\"resourceSpans\":[{\"resource\":{\"attributes\":[{\"key\":\"service.name\","
+           "\"value\":{\"stringValue\":\"dmp-risk-control\"}}]},"
+           "\"scopeSpans\":[{\"scope\":{\"name\":\"dmp.tracing\"},\"spans\":[";
+    for (size_t i = 0; i < spans.size(); ++i) {
+        const auto& span = spans[i];
+        // Span ids only need to be unique within the export
+        uint64_t span_id = span.trace_id.high ^ (span.start_tsc * 0x9e3779b97f4a7c15ULL) ^ (i + 1);
+        span.trace_id.format_to(trace_hex);
+        append_format(out,
+            "%s{\"traceId\":\"%s\",\"spanId\":\"%016llx\",\"name\":\"%s\",\"kind\":1,"
+            "\"startTimeUnixNano\":\"%llu\",\"endTimeUnixNano\":\"%llu\",\"attributes\":["
+            "{\"key\":\"dmp.request_id\",\"value\":{\"stringValue\":\"%016llx\"}},"
+            "{\"key\":\"dmp.thread\",\"value\":{\"intValue\":\"%u\"}},"
+            "{\"key\":\"dmp.slow\",\"value\":{\"boolValue\":%s}}]}",
+            i == 0 ? "" : ",", trace_hex, static_cast<unsigned long long>(span_id), pipeline_stage_name(span.stage),
+            static_cast<unsigned long long>(tsc_to_unix_ns(span.start_tsc)),
+            static_cast<unsigned long long>(tsc_to_unix_ns(span.end_tsc)),
+            static_cast<unsigned long long>(span.request_id),
+            span.thread_index, (span.flags & SpanRecord::kSlow) ? "true" : "false");
+    }
+    out += "]}]}]}\n";
+    return out;
+}
+
+Result<size_t> Tracer::export_to_file(TraceExportFormat format, const std::string& path) const {
+    try {
+        auto spans = collect();
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file) {
+            return {0, ErrorCode::INTERNAL_ERROR, "Cannot open trace export file: " + path};
+        }
+        file << render(format, spans);
+        if (!file) {
+            return {0, ErrorCode::INTERNAL_ERROR, "Failed to write trace export file: " + path};
+        }
+        return {spans.size(), ErrorCode::SUCCESS, ""};
+    } catch (const std::exception& e) {
+        return {0, ErrorCode::INTERNAL_ERROR, std::string("Trace export failed: ") + e.what()};
+    }
+}
+
+Result<std::string> Tracer::export_snapshot(TraceExportFormat format) const {
+    std::error_code ec;
+    std::filesystem::create_directories(export_directory_, ec);
+    if (ec) {
+        return {"", ErrorCode::INTERNAL_ERROR,
+               "Cannot create trace directory " + export_directory_ + ": " + ec.message()};
+    }
+
+    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string path = export_directory_ + "/trace-" + std::to_string(now_ms) + format_extension(format);
+
+    auto result = export_to_file(format, path);
+    if (result.is_error()) {
+        return {"", result.error_code, result.error_message};
+    }
+    return {path, ErrorCode::SUCCESS, ""};
+}
+
+// TraceRequestScope implementation
+TraceRequestScope::TraceRequestScope()
+    : active_(Tracer::instance().enabled() || PerfLog::instance().enabled()) {
+    if (active_) {
+        Tracer::instance().begin_request();
+    }
+}
+
+TraceRequestScope::~TraceRequestScope() {
+    if (active_) {
+        Tracer::instance().end_request();
+    }
+}
+
+} // namespace dmp
@@ -7,11 +7,30 @@
 #include "common/types.hpp"
 #include "common/config.hpp"
 #include "core/transaction.hpp"
+#include "core/readiness.hpp"
+#include "utils/alloc_tracker.hpp"
+#include "utils/hw_counters.hpp"
 #include "utils/metrics.hpp"
 #include "utils/logger.hpp"
+#include "utils/structured_log.hpp"
+#include "utils/tracing.hpp"
 
 namespace dmp {
 
+namespace {
+    /**
+     * @brief Stable FNV-1a hash of a feature cache key, so traces replay across restarts
+     */
+    uint64_t hash_cache_key(std::string_view key) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (char c : key) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
 /**
  * @brief Simplified decision handler for Phase 1 (placeholder for Phase 2 HTTP implementation)
  * 
@@ -40,6 +59,15 @@ public:
      */
     static Result<DecisionResult> process_decision_json(const std::string& request_json) {
         auto start_time = std::chrono::high_resolution_clock::now();
+        AllocationProbe allocation_probe;
+        TraceScope trace_id_scope;
+        TraceRequestScope trace_scope;
+        HwCounterRequestScope hw_counter_scope;
+        DMP_TRACE_SPAN(PipelineStage::DECISION);
+        DMP_HW_COUNTERS(PipelineStage::DECISION);
+        
+        // Pinned for the whole request; a concurrent reload applies to the next one
+        const auto settings = current_config();
         
         try {
             // Validate request size
@@ -54,8 +82,12 @@ public:
             // Parse JSON with high-performance simdjson
             simdjson::dom::parser parser;
             simdjson::dom::element json_doc;
-            
-            auto parse_error = parser.parse(request_json).get(json_doc);
+            simdjson::error_code parse_error;
+            {
+                DMP_TRACE_SPAN(PipelineStage::PARSE);
+                DMP_HW_COUNTERS(PipelineStage::PARSE);
+                parse_error = parser.parse(request_json).get(json_doc);
+            }
             if (parse_error) {
                 return {DecisionResult{}, ErrorCode::INVALID_JSON_FORMAT, 
                        "Invalid JSON format: " + std::string(simdjson::error_message(parse_error))};
@@ -68,11 +100,16 @@ public:
             }
             
             auto& transaction_request = request_result.value;
+            Tracer::instance().set_request_id(transaction_request.request_id);
             
             // Validate transaction request
             if (!transaction_request.is_valid()) {
                 return {DecisionResult{}, ErrorCode::INVALID_REQUEST, "Invalid transaction data"};
             }
+            // Key trace for dmp_cachesim, off unless the log level is trace; hashed
+            // because the key carries customer and merchant ids
+            LOG_EVENT_TRACE("feature_cache_key",
+                            dmp::kv("key_hash", hash_cache_key(transaction_request.get_cache_key())));
             
             // Process decision
             auto decision_result = process_risk_decision(transaction_request);
@@ -83,15 +120,22 @@ public:
                 end_time - start_time).count();
             float latency_ms = latency_us / 1000.0f;
             
+            Tracer::instance().record_outcome(decision_result.decision);
+            
             // Record metrics
             MetricsCollector::instance().record_decision(decision_result.decision, 
                                                         decision_result.risk_score, latency_ms);
+            if constexpr (AllocationTracker::enabled()) {
+                const auto allocations = allocation_probe.delta();
+                MetricsCollector::instance().record_decision_allocations(allocations.allocations,
+                                                                         allocations.bytes);
+            }
             
-            LOG_INFO("Decision processed: {} -> {} (score: {:.1f}, latency: {:.2f}ms)", 
+            LOG_INFO("Decision processed: {} -> {} (score: {:.1f}, latency: {:.2f}ms, config v{})", 
                      transaction_request.request_id,
                      (decision_result.decision == Decision::APPROVE ? "APPROVE" :
                       decision_result.decision == Decision::DECLINE ? "DECLINE" : "REVIEW"),
-                     decision_result.risk_score, latency_ms);
+                     decision_result.risk_score, latency_ms, settings ? settings->version : 0);
             
             return {decision_result, ErrorCode::SUCCESS, ""};
             
@@ -123,6 +167,8 @@ private:
      * - Decision fusion algorithm
      */
     static DecisionResult process_risk_decision(const TransactionRequest& request) {
+        DMP_TRACE_SPAN(PipelineStage::RULE_EVALUATION);
+        DMP_HW_COUNTERS(PipelineStage::RULE_EVALUATION);
         DecisionResult result;
         result.risk_score = 0.0f;
         result.triggered_rules.clear();
@@ -217,20 +263,10 @@ public:
     
     /**
      * @brief Get readiness check status as JSON string
-     * @return JSON string with readiness status
+     * @return JSON string with lifecycle state and warm-up progress
      */
     static std::string get_ready_status() {
-        std::ostringstream oss;
-        oss << "{"
-            << "\"status\":\"ready\","
-            << "\"dependencies\":{"
-            << "\"configuration\":\"loaded\","
-            << "\"data_structures\":\"validated\","
-            << "\"metrics\":\"initialized\""
-            << "}"
-            << "}";
-        
-        return oss.str();
+        return Readiness::instance().to_json();
     }
 };
 
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include "core/readiness.hpp"
 
 namespace dmp {
 
@@ -34,21 +35,10 @@ public:
     
     /**
      * @brief Get readiness status as JSON string
-     * @return JSON string with current readiness status
+     * @return JSON string with lifecycle state and warm-up progress
      */
     static std::string get_ready_json() {
-        std::ostringstream oss;
-        oss << "{"
-            << "\"status\":\"ready\","
-            << "\"dependencies\":{"
-            << "\"configuration\":\"loaded\","
-            << "\"data_structures\":\"validated\","
-            << "\"metrics\":\"initialized\","
-            << "\"json_parser\":\"available\""
-            << "}"
-            << "}";
-        
-        return oss.str();
+        return Readiness::instance().to_json();
     }
     
     /**
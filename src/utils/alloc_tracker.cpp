@@ -0,0 +1,151 @@
+#include "utils/alloc_tracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace dmp {
+
+namespace {
+    // Threads beyond this share the overflow slot, which is updated atomically
+    constexpr size_t kMaxThreadSlots = 1024;
+
+    struct alignas(64) CounterSlot {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> deallocations{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    // Zero-initialized statics only: the hooks run before any constructor
+    CounterSlot g_slots[kMaxThreadSlots + 1];
+    std::atomic<size_t> g_slots_used{0};
+
+    struct ThreadCounters {
+        CounterSlot* slot;
+        bool shared;
+        AllocationStats stats;
+    };
+    thread_local ThreadCounters tl_counters{};
+}
+
+AllocationStats AllocationTracker::thread_stats() {
+    return tl_counters.stats;
+}
+
+AllocationStats AllocationTracker::process_stats() {
+    AllocationStats total;
+    const size_t used = std::min(g_slots_used.load(std::memory_order_relaxed), kMaxThreadSlots);
+    auto add = [&total](const CounterSlot& slot) {
+        total.allocations += slot.allocations.load(std::memory_order_relaxed);
+        total.deallocations += slot.deallocations.load(std::memory_order_relaxed);
+        total.bytes += slot.bytes.load(std::memory_order_relaxed);
+    };
+    for (size_t i = 0; i < used; ++i) {
+        add(g_slots[i]);
+    }
+    add(g_slots[kMaxThreadSlots]);
+    return total;
+}
+
+#if DMP_ENABLE_ALLOC_TRACKING
+
+namespace {
+    ThreadCounters& thread_counters() {
+        if (!tl_counters.slot) {
+            const size_t index = g_slots_used.fetch_add(1, std::memory_order_relaxed);
+            tl_counters.shared = index >= kMaxThreadSlots;
+            tl_counters.slot = &g_slots[tl_counters.shared ? kMaxThreadSlots : index];
+        }
+        return tl_counters;
+    }
+
+    void publish(std::atomic<uint64_t>& cell, uint64_t thread_value, uint64_t delta, bool shared) {
+        if (shared) {
+            cell.fetch_add(delta, std::memory_order_relaxed);
+        } else {
+            cell.store(thread_value, std::memory_order_relaxed);
+        }
+    }
+
+    void count_allocation(std::size_t size) {
+        auto& counters = thread_counters();
+        ++counters.stats.allocations;
+        counters.stats.bytes += size;
+        publish(counters.slot->allocations, counters.stats.allocations, 1, counters.shared);
+        publish(counters.slot->bytes, counters.stats.bytes, size, counters.shared);
+    }
+
+    void count_deallocation(void* ptr) {
+        if (!ptr) {
+            return;
+        }
+        auto& counters = thread_counters();
+        ++counters.stats.deallocations;
+        publish(counters.slot->deallocations, counters.stats.deallocations, 1, counters.shared);
+    }
+
+    void* tracked_alloc(std::size_t size, std::size_t alignment) {
+        count_allocation(size);
+        if (size == 0) {
+            size = 1;
+        }
+        if (alignment > alignof(std::max_align_t)) {
+            return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+        return std::malloc(size);
+    }
+
+    void* tracked_alloc_or_throw(std::size_t size, std::size_t alignment) {
+        for (;;) {
+            if (void* ptr = tracked_alloc(size, alignment)) {
+                return ptr;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void tracked_free(void* ptr) {
+        count_deallocation(ptr);
+        std::free(ptr);
+    }
+}
+
+#endif
+
+} // namespace dmp
+
+#if DMP_ENABLE_ALLOC_TRACKING
+
+void* operator new(std::size_t size) { return dmp::tracked_alloc_or_throw(size, 0); }
+void* operator new[](std::size_t size) { return dmp::tracked_alloc_or_throw(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return dmp::tracked_alloc(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return dmp::tracked_alloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al) {
+    return dmp::tracked_alloc_or_throw(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+    return dmp::tracked_alloc_or_throw(size, static_cast<std::size_t>(al));
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return dmp::tracked_alloc(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return dmp::tracked_alloc(size, static_cast<std::size_t>(al));
+}
+void operator delete(void* ptr) noexcept { dmp::tracked_free(ptr); }
+void operator delete[](void* ptr) noexcept { dmp::tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { dmp::tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { dmp::tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { dmp::tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { dmp::tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { dmp::tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { dmp::tracked_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { dmp::tracked_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { dmp::tracked_free(ptr); }
+
+#endif
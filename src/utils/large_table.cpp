@@ -0,0 +1,286 @@
+#include "utils/large_table.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace dmp {
+
+namespace {
+    // From <numaif.h>; declared here so the build does not need libnuma
+    constexpr int kMpolBind = 2;
+    constexpr int kMpolInterleave = 3;
+
+    size_t round_up(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Parse /sys/devices/system/node/online ("0", "0-1", "0-3,8-11")
+     */
+    std::vector<int> online_numa_nodes() {
+        std::vector<int> nodes;
+        std::ifstream file("/sys/devices/system/node/online");
+        std::string ranges;
+        if (!std::getline(file, ranges)) {
+            return nodes;
+        }
+        std::stringstream stream(ranges);
+        std::string range;
+        while (std::getline(stream, range, ',')) {
+            auto dash = range.find('-');
+            int first = std::atoi(range.c_str());
+            int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+            for (int node = first; node <= last; ++node) {
+                nodes.push_back(node);
+            }
+        }
+        return nodes;
+    }
+
+    bool bind_pages(void* ptr, size_t length, int mode, const std::vector<int>& nodes) {
+#ifdef __linux__
+        int max_node = 0;
+        for (int node : nodes) {
+            max_node = std::max(max_node, node);
+        }
+        constexpr size_t kBits = sizeof(unsigned long) * 8;
+        std::vector<unsigned long> mask(static_cast<size_t>(max_node) / kBits + 1, 0);
+        for (int node : nodes) {
+            mask[static_cast<size_t>(node) / kBits] |= 1UL << (static_cast<size_t>(node) % kBits);
+        }
+        // The kernel reads maxnode - 1 bits
+        return syscall(SYS_mbind, ptr, length, mode, mask.data(), mask.size() * kBits + 1, 0) == 0;
+#else
+        (void)ptr; (void)length; (void)mode; (void)nodes;
+        return false;
+#endif
+    }
+}
+
+LargeTableAllocator& LargeTableAllocator::instance() {
+    static LargeTableAllocator allocator;
+    return allocator;
+}
+
+LargeTableAllocator::LargeTableAllocator() : nodes_(online_numa_nodes()) {}
+
+Result<void> LargeTableAllocator::configure(const MemoryConfig& config) {
+    HugePageMode huge_pages;
+    if (config.huge_pages == "off") {
+        huge_pages = HugePageMode::OFF;
+    } else if (config.huge_pages == "transparent") {
+        huge_pages = HugePageMode::TRANSPARENT;
+    } else if (config.huge_pages == "explicit") {
+        huge_pages = HugePageMode::EXPLICIT;
+    } else {
+        return {ErrorCode::INVALID_REQUEST, "Unknown huge_pages mode: " + config.huge_pages};
+    }
+
+    NumaPolicy numa_policy;
+    if (config.numa_policy == "local") {
+        numa_policy = NumaPolicy::LOCAL;
+    } else if (config.numa_policy == "interleave") {
+        numa_policy = NumaPolicy::INTERLEAVE;
+    } else if (config.numa_policy == "shard") {
+        numa_policy = NumaPolicy::SHARD;
+    } else {
+        return {ErrorCode::INVALID_REQUEST, "Unknown numa_policy: " + config.numa_policy};
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        huge_pages_ = huge_pages;
+        numa_policy_ = numa_policy;
+        prefault_ = config.prefault;
+        pool_bytes_ = static_cast<size_t>(config.pool_size_mb) << 20;
+        warned_budget_ = false;
+    }
+
+    LOG_INFO("🧮 Large tables: huge_pages={}, numa_policy={} ({} node(s)), pool {} MB{}",
+             config.huge_pages, config.numa_policy, numa_nodes(), config.pool_size_mb,
+             config.prefault ? ", prefaulted" : "");
+    return {ErrorCode::SUCCESS, ""};
+}
+
+void* LargeTableAllocator::allocate(size_t bytes, int shard) {
+    if (bytes < kMinMappedBytes) {
+        return std::calloc(1, bytes);
+    }
+
+    const size_t length = round_up(bytes, kHugePageSize);
+    Mapping mapping;
+    mapping.length = length;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stats_.mapped_bytes + length > pool_bytes_) {
+            ++stats_.heap_fallbacks;
+            if (!warned_budget_) {
+                warned_budget_ = true;
+                LOG_INFO("⚠️  Large table pool exhausted ({} of {} MB mapped), using malloc for {} bytes",
+                         stats_.mapped_bytes >> 20, pool_bytes_ >> 20, bytes);
+            }
+            return std::calloc(1, bytes);
+        }
+        // Reserve before mapping so concurrent allocations respect the pool
+        stats_.mapped_bytes += length;
+    }
+
+    void* ptr = map_table(length, shard, mapping);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ptr) {
+        stats_.mapped_bytes -= length;
+        ++stats_.heap_fallbacks;
+        return std::calloc(1, bytes);
+    }
+    mappings_.emplace(ptr, mapping);
+    ++stats_.tables;
+    if (mapping.explicit_huge) {
+        stats_.explicit_huge_bytes += length;
+    }
+    if (mapping.transparent_huge) {
+        stats_.transparent_huge_bytes += length;
+    }
+    return ptr;
+}
+
+void* LargeTableAllocator::map_table(size_t length, int shard, Mapping& mapping) {
+    HugePageMode huge_pages;
+    bool prefault;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        huge_pages = huge_pages_;
+        prefault = prefault_;
+    }
+
+    void* ptr = nullptr;
+#ifdef MAP_HUGETLB
+    if (huge_pages == HugePageMode::EXPLICIT) {
+        void* mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapped != MAP_FAILED) {
+            ptr = mapped;
+            mapping.explicit_huge = true;
+        } else {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!warned_hugetlb_) {
+                warned_hugetlb_ = true;
+                LOG_INFO("⚠️  No reserved huge pages (vm.nr_hugepages), falling back to transparent huge pages");
+            }
+        }
+    }
+#endif
+
+    if (!ptr) {
+        // Over-map by one huge page and trim so the table starts on a 2 MiB boundary
+        const size_t span = huge_pages == HugePageMode::OFF ? length : length + kHugePageSize;
+        void* mapped = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) {
+            return nullptr;
+        }
+        auto base = reinterpret_cast<uintptr_t>(mapped);
+        auto aligned = huge_pages == HugePageMode::OFF ? base : round_up(base, kHugePageSize);
+        if (aligned > base) {
+            munmap(mapped, aligned - base);
+        }
+        if (base + span > aligned + length) {
+            munmap(reinterpret_cast<void*>(aligned + length), base + span - aligned - length);
+        }
+        ptr = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        if (huge_pages != HugePageMode::OFF && madvise(ptr, length, MADV_HUGEPAGE) == 0) {
+            mapping.transparent_huge = true;
+        }
+#endif
+    }
+
+    // Placement must precede the first touch
+    place(ptr, length, shard);
+
+    if (prefault) {
+        const size_t step = mapping.explicit_huge ? kHugePageSize : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        auto* bytes = static_cast<volatile char*>(ptr);
+        for (size_t offset = 0; offset < length; offset += step) {
+            bytes[offset] = 0;
+        }
+    }
+    return ptr;
+}
+
+void LargeTableAllocator::place(void* ptr, size_t length, int shard) {
+    NumaPolicy numa_policy;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        numa_policy = numa_policy_;
+    }
+    if (nodes_.size() < 2) {
+        return;
+    }
+
+    bool bound = true;
+    if (numa_policy == NumaPolicy::INTERLEAVE) {
+        bound = bind_pages(ptr, length, kMpolInterleave, nodes_);
+    } else if (numa_policy == NumaPolicy::SHARD && shard >= 0) {
+        bound = bind_pages(ptr, length, kMpolBind, {node_for_shard(static_cast<size_t>(shard))});
+    }
+
+    if (!bound) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!warned_mbind_) {
+            warned_mbind_ = true;
+            LOG_INFO("⚠️  mbind failed, large tables use first-touch NUMA placement");
+        }
+    }
+}
+
+void LargeTableAllocator::deallocate(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    Mapping mapping;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = mappings_.find(ptr);
+        if (it == mappings_.end()) {
+            std::free(ptr);
+            return;
+        }
+        mapping = it->second;
+        mappings_.erase(it);
+        --stats_.tables;
+        stats_.mapped_bytes -= mapping.length;
+        if (mapping.explicit_huge) {
+            stats_.explicit_huge_bytes -= mapping.length;
+        }
+        if (mapping.transparent_huge) {
+            stats_.transparent_huge_bytes -= mapping.length;
+        }
+    }
+    munmap(ptr, mapping.length);
+}
+
+void LargeTableAllocator::deallocate(void* ptr, size_t bytes) noexcept {
+    if (bytes < kMinMappedBytes) {
+        std::free(ptr);
+        return;
+    }
+    deallocate(ptr);
+}
+
+int LargeTableAllocator::node_for_shard(size_t shard) const {
+    return nodes_.size() < 2 ? -1 : nodes_[shard % nodes_.size()];
+}
+
+LargeTableStats LargeTableAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace dmp
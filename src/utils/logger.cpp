@@ -8,57 +8,82 @@
 namespace dmp {
 
 // TraceContext implementation
-thread_local std::string TraceContext::current_trace_id_;
-std::random_device TraceContext::rd_;
-std::mt19937_64 TraceContext::gen_{TraceContext::rd_()};
+TraceId TraceContext::generate() noexcept {
+    current_trace_id_ = TraceId::generate();
+    return current_trace_id_;
+}
 
 std::string TraceContext::get_trace_id() {
-    return current_trace_id_;
+    return current_trace_id_.to_string();
 }
 
 void TraceContext::set_trace_id(const std::string& trace_id) {
-    current_trace_id_ = trace_id;
+    current_trace_id_ = TraceId::from_hex(trace_id);
 }
 
 std::string TraceContext::generate_trace_id() {
-    // Generate 128-bit trace ID (32 hex characters)
-    std::uniform_int_distribution<uint64_t> dis;
-    uint64_t high = dis(gen_);
-    uint64_t low = dis(gen_);
-    
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0') << std::setw(16) << high 
-        << std::setw(16) << low;
-    
-    std::string trace_id = oss.str();
-    set_trace_id(trace_id);
-    return trace_id;
+    return generate().to_string();
 }
 
-void TraceContext::clear_trace_id() {
-    current_trace_id_.clear();
+// TraceScope implementation
+TraceScope::TraceScope(TraceId trace_id)
+    : trace_id_(trace_id), previous_trace_id_(TraceContext::current()) {
+    TraceContext::set(trace_id_);
 }
 
-// TraceScope implementation
-TraceScope::TraceScope(const std::string& trace_id) 
-    : trace_id_(trace_id), previous_trace_id_(TraceContext::get_trace_id()) {
-    TraceContext::set_trace_id(trace_id_);
+TraceScope::TraceScope(const std::string& trace_id)
+    : TraceScope(TraceId::from_hex(trace_id)) {
 }
 
-TraceScope::TraceScope() 
-    : trace_id_(TraceContext::generate_trace_id()), 
-      previous_trace_id_(TraceContext::get_trace_id()) {
-    // trace_id_ is already set by generate_trace_id()
+TraceScope::TraceScope()
+    : TraceScope(TraceId::generate()) {
 }
 
 TraceScope::~TraceScope() {
-    TraceContext::set_trace_id(previous_trace_id_);
+    TraceContext::set(previous_trace_id_);
 }
 
 // Logger implementation
 bool Logger::initialized_ = false;
 std::shared_ptr<spdlog::logger> Logger::default_logger_;
 std::string Logger::log_pattern_ = "[%Y-%m-%d %H:%M:%S.%f] [%l] [%s:%#] [%!] %v";
+size_t Logger::async_queue_size_ = 8192;
+size_t Logger::async_threads_ = 1;
+uint32_t Logger::flush_interval_ms_ = 100;
+spdlog::async_overflow_policy Logger::overflow_policy_ = spdlog::async_overflow_policy::overrun_oldest;
+spdlog::async_overflow_policy Logger::audit_overflow_policy_ = spdlog::async_overflow_policy::block;
+std::shared_ptr<spdlog::details::thread_pool> Logger::thread_pool_;
+std::array<std::shared_ptr<spdlog::logger>, Logger::kMaxLoggers> Logger::slot_owners_;
+std::array<std::string, Logger::kMaxLoggers> Logger::slot_names_ = {"dmp_default", "audit", "performance"};
+size_t Logger::slot_count_ = static_cast<size_t>(LoggerId::FIRST_DYNAMIC);
+std::vector<std::shared_ptr<spdlog::logger>> Logger::retired_loggers_;
+std::mutex Logger::slots_mutex_;
+
+namespace {
+    /**
+     * @brief Parse an overflow policy name from logging.toml
+     *
+     * "overrun_oldest" and "discard_new" never block the caller; "block"
+     * waits for queue space and should only be used where losing a record
+     * is worse than stalling the request path.
+     */
+    spdlog::async_overflow_policy parse_overflow_policy(const std::string& name,
+                                                        spdlog::async_overflow_policy fallback) {
+        if (name == "block") {
+            return spdlog::async_overflow_policy::block;
+        }
+        if (name == "overrun_oldest") {
+            return spdlog::async_overflow_policy::overrun_oldest;
+        }
+#if SPDLOG_VERSION >= 11200
+        if (name == "discard_new") {
+            return spdlog::async_overflow_policy::discard_new;
+        }
+#endif
+        std::cerr << "Unknown async overflow policy '" << name << "', keeping default" << std::endl;
+        return fallback;
+    }
+}
 
 bool Logger::initialize(const std::string& config_path) {
     if (initialized_) {
@@ -80,9 +105,13 @@ bool Logger::initialize(const std::string& config_path) {
         
         // Set environment variable for default level
         spdlog::cfg::load_env_levels();
+        active_level_.store(static_cast<int>(default_logger_->level()), std::memory_order_relaxed);
         
         initialized_ = true;
         
+        // Handles resolved before initialization point at the console fallback
+        reset_slots();
+        
         LOG_INFO("DMP logging system initialized successfully");
         LOG_INFO("Log pattern: {}", log_pattern_);
         
@@ -101,50 +130,103 @@ void Logger::shutdown() {
     LOG_INFO("Shutting down DMP logging system");
     flush_all();
     
-    // Shutdown async logging
+    // Shutdown async logging (drains the queue and joins the workers)
     spdlog::shutdown();
-    
     initialized_ = false;
+    reset_slots();
+    default_logger_.reset();
+    thread_pool_.reset();
 }
 
 std::shared_ptr<spdlog::logger> Logger::get_logger() {
     if (!initialized_) {
-        // Create a simple console logger as fallback
-        auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-        auto logger = std::make_shared<spdlog::logger>("default", console_sink);
-        logger->set_pattern(log_pattern_);
-        return logger;
+        return fallback_logger();
     }
     
     return default_logger_;
 }
 
 std::shared_ptr<spdlog::logger> Logger::get_logger(const std::string& name) {
+    if (!default_logger_) {
+        // Not registered, so initialize() can still create the real logger
+        return fallback_logger();
+    }
+    
     auto logger = spdlog::get(name);
     if (!logger) {
         // Create new logger with same sinks as default
-        if (default_logger_) {
-            logger = std::make_shared<spdlog::logger>(name, default_logger_->sinks().begin(), 
-                                                    default_logger_->sinks().end());
-            logger->set_pattern(log_pattern_);
-            logger->set_level(default_logger_->level());
-            spdlog::register_logger(logger);
-        } else {
-            // Fallback to console logger
-            auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-            logger = std::make_shared<spdlog::logger>(name, console_sink);
-            logger->set_pattern(log_pattern_);
-            spdlog::register_logger(logger);
-        }
+        logger = make_async_logger(name, default_logger_->sinks(), overflow_policy_);
+        logger->set_pattern(log_pattern_);
+        logger->set_level(default_logger_->level());
+        spdlog::register_logger(logger);
     }
     return logger;
 }
 
+LoggerId Logger::logger_id(std::string_view name) {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    for (size_t i = 0; i < slot_count_; ++i) {
+        if (slot_names_[i] == name) {
+            return static_cast<LoggerId>(i);
+        }
+    }
+    if (slot_count_ == kMaxLoggers) {
+        std::cerr << "Logger slot table full, '" << name << "' uses the default logger" << std::endl;
+        return LoggerId::DEFAULT;
+    }
+    slot_names_[slot_count_] = std::string(name);
+    return static_cast<LoggerId>(slot_count_++);
+}
+
+spdlog::logger* Logger::resolve_slot(LoggerId id) {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    const auto index = static_cast<size_t>(id);
+    if (auto* logger = slots_[index].load(std::memory_order_acquire)) {
+        return logger;
+    }
+    
+    std::shared_ptr<spdlog::logger> logger;
+    if (!initialized_) {
+        logger = fallback_logger();
+    } else if (id == LoggerId::DEFAULT) {
+        logger = default_logger_;
+    } else {
+        logger = get_logger(slot_names_[index]);
+    }
+    
+    slot_owners_[index] = logger;
+    slots_[index].store(logger.get(), std::memory_order_release);
+    return logger.get();
+}
+
+void Logger::reset_slots() {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    for (size_t i = 0; i < kMaxLoggers; ++i) {
+        slots_[i].store(nullptr, std::memory_order_release);
+        if (slot_owners_[i]) {
+            // Another thread may still hold the raw pointer; keep it alive
+            retired_loggers_.push_back(std::move(slot_owners_[i]));
+        }
+    }
+}
+
+std::shared_ptr<spdlog::logger> Logger::fallback_logger() {
+    // Console logger used before initialize(); created once, never registered
+    static const std::shared_ptr<spdlog::logger> fallback = [] {
+        auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        auto logger = std::make_shared<spdlog::logger>("dmp_fallback", console_sink);
+        logger->set_pattern(log_pattern_);
+        return logger;
+    }();
+    return fallback;
+}
+
 void Logger::set_level(spdlog::level::level_enum level) {
     spdlog::set_level(level);
     if (default_logger_) {
         default_logger_->set_level(level);
     }
+    active_level_.store(static_cast<int>(level), std::memory_order_relaxed);
 }
 
 void Logger::flush_all() {
@@ -153,6 +235,29 @@ void Logger::flush_all() {
     });
 }
 
+uint64_t Logger::dropped_messages() {
+    auto pool = thread_pool_;
+    if (!pool) {
+        return 0;
+    }
+    uint64_t dropped = pool->overrun_counter();
+#if SPDLOG_VERSION >= 11200
+    dropped += pool->discard_counter();
+#endif
+    return dropped;
+}
+
+std::shared_ptr<spdlog::logger> Logger::make_async_logger(const std::string& name,
+                                                          std::vector<spdlog::sink_ptr> sinks,
+                                                          spdlog::async_overflow_policy policy) {
+    if (!thread_pool_) {
+        // Async setup failed; stay functional with a synchronous logger
+        return std::make_shared<spdlog::logger>(name, sinks.begin(), sinks.end());
+    }
+    return std::make_shared<spdlog::async_logger>(name, sinks.begin(), sinks.end(),
+                                                  thread_pool_, policy);
+}
+
 bool Logger::load_config(const std::string& config_path) {
     try {
         if (!std::filesystem::exists(config_path)) {
@@ -169,6 +274,26 @@ bool Logger::load_config(const std::string& config_path) {
             }
         }
         
+        // Load async pipeline section
+        if (auto async_section = config["async"]) {
+            if (auto queue_size = async_section["queue_size"].value<int64_t>(); queue_size && *queue_size > 0) {
+                async_queue_size_ = static_cast<size_t>(*queue_size);
+            }
+            if (auto threads = async_section["threads"].value<int64_t>(); threads && *threads > 0) {
+                async_threads_ = static_cast<size_t>(*threads);
+            }
+            if (auto flush_ms = async_section["flush_interval_ms"].value<int64_t>(); flush_ms && *flush_ms >= 0) {
+                flush_interval_ms_ = static_cast<uint32_t>(*flush_ms);
+            }
+            if (auto policy = async_section["overflow_policy"].value<std::string>()) {
+                overflow_policy_ = parse_overflow_policy(*policy, overflow_policy_);
+            }
+            // Audit records are never dropped unless explicitly configured
+            if (auto policy = async_section["audit_overflow_policy"].value<std::string>()) {
+                audit_overflow_policy_ = parse_overflow_policy(*policy, audit_overflow_policy_);
+            }
+        }
+        
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error parsing logging config: " << e.what() << std::endl;
@@ -201,8 +326,8 @@ void Logger::setup_sinks() {
         error_sink->set_level(spdlog::level::err);
         sinks.push_back(error_sink);
         
-        // Create default logger
-        default_logger_ = std::make_shared<spdlog::logger>("dmp_default", sinks.begin(), sinks.end());
+        // Create default logger; formatting and I/O happen on the async workers
+        default_logger_ = make_async_logger("dmp_default", sinks, overflow_policy_);
         default_logger_->set_pattern(log_pattern_);
         default_logger_->set_level(spdlog::level::info);
         default_logger_->flush_on(spdlog::level::err);
@@ -215,7 +340,7 @@ void Logger::setup_sinks() {
             "logs/dmp_audit.log", 0, 0); // Roll at midnight
         audit_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%f] [AUDIT] [%s:%#] [%!] [%t] %v");
         
-        auto audit_logger = std::make_shared<spdlog::logger>("audit", audit_sink);
+        auto audit_logger = make_async_logger("audit", {audit_sink}, audit_overflow_policy_);
         audit_logger->set_level(spdlog::level::info);
         spdlog::register_logger(audit_logger);
         
@@ -224,7 +349,7 @@ void Logger::setup_sinks() {
             "logs/dmp_performance.log", 1024 * 1024 * 50, 3); // 50MB, 3 files
         perf_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%f] [PERF] [%s:%#] [%!] %v");
         
-        auto perf_logger = std::make_shared<spdlog::logger>("performance", perf_sink);
+        auto perf_logger = make_async_logger("performance", {perf_sink}, overflow_policy_);
         perf_logger->set_level(spdlog::level::info);
         spdlog::register_logger(perf_logger);
         
@@ -236,14 +361,22 @@ void Logger::setup_sinks() {
 
 void Logger::setup_async_logging() {
     try {
-        // Initialize async logging with queue size and thread count
-        spdlog::init_thread_pool(8192, 1);
+        // Dedicated pool shared by all DMP loggers, sized from [async]
+        thread_pool_ = std::make_shared<spdlog::details::thread_pool>(async_queue_size_, async_threads_);
         
-        // Set overflow policy to block (safer for important logs)
-        // Alternative: spdlog::async_overflow_policy::overrun_oldest
+        // Periodic flush so buffered records reach disk without per-call flushes
+        if (flush_interval_ms_ > 0) {
+#if SPDLOG_VERSION >= 11100
+            spdlog::flush_every(std::chrono::milliseconds(flush_interval_ms_));
+#else
+            // Older spdlog only accepts whole seconds
+            spdlog::flush_every(std::chrono::seconds((flush_interval_ms_ + 999) / 1000));
+#endif
+        }
         
     } catch (const std::exception& e) {
         std::cerr << "Error setting up async logging: " << e.what() << std::endl;
+        thread_pool_.reset();
         // Continue with synchronous logging
     }
 }
@@ -0,0 +1,191 @@
+#include "utils/structured_log.hpp"
+#include <algorithm>
+
+namespace dmp {
+
+namespace {
+    bool needs_quoting(std::string_view text) {
+        if (text.empty()) {
+            return true;
+        }
+        return std::any_of(text.begin(), text.end(), [](char c) {
+            return c == ' ' || c == '=' || c == '"' || c == '\n' || c == '\t';
+        });
+    }
+
+    void append_text(fmt::memory_buffer& out, std::string_view text, bool truncated) {
+        if (!truncated && !needs_quoting(text)) {
+            out.append(text);
+            return;
+        }
+        out.push_back('"');
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out.push_back('\\');
+                out.push_back(c);
+            } else if (c == '\n') {
+                out.append(std::string_view("\\n"));
+            } else {
+                out.push_back(c);
+            }
+        }
+        if (truncated) {
+            out.append(std::string_view("..."));
+        }
+        out.push_back('"');
+    }
+}
+
+StructuredLogger& StructuredLogger::instance() {
+    static StructuredLogger logger;
+    return logger;
+}
+
+StructuredLogger::~StructuredLogger() {
+    stop();
+}
+
+void StructuredLogger::start(size_t queue_capacity) {
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    if (running_.load()) {
+        return;
+    }
+    if (!queue_) {
+        queue_ = std::make_unique<MpmcQueue<LogRecord>>(queue_capacity);
+    }
+    running_.store(true);
+    worker_ = std::thread([this] { run(); });
+}
+
+void StructuredLogger::stop() {
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // Emitters that saw running_ set finish their push before the final drain;
+    // later ones see it cleared and format inline
+    while (in_flight_.load() != 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> wake_lock(wake_mutex_);
+        wake_.notify_one();
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void StructuredLogger::emit(const LogEventSite& site, std::initializer_list<LogField> fields) noexcept {
+    LogRecord record;
+    record.time = spdlog::log_clock::now();
+    record.trace_id = TraceContext::current();
+    record.site = &site;
+    for (const auto& field : fields) {
+        if (record.field_count == LogRecord::kMaxFields) {
+            break;
+        }
+        record.fields[record.field_count++] = field;
+    }
+
+    in_flight_.fetch_add(1);
+    if (!running_.load()) {
+        in_flight_.fetch_sub(1, std::memory_order_release);
+        try {
+            write(record);
+        } catch (...) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    const bool queued = queue_->try_push(record);
+    in_flight_.fetch_sub(1, std::memory_order_release);
+    if (!queued) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    wake_worker();
+}
+
+void StructuredLogger::wake_worker() {
+    // Pairs with the fence in run(): either the formatter sees the record or we see it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_.notify_one();
+    }
+}
+
+void StructuredLogger::run() {
+    LogRecord record;
+    while (true) {
+        while (queue_->try_pop(record)) {
+            write(record);
+        }
+        if (!running_.load()) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_->size_approx() == 0 && running_.load()) {
+            wake_.wait(lock);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+    // stop() waited for in-flight emitters, so this drain is final
+    while (queue_->try_pop(record)) {
+        write(record);
+    }
+}
+
+void StructuredLogger::format_record(const LogRecord& record, fmt::memory_buffer& out) {
+    if (!record.trace_id.empty()) {
+        char hex[TraceId::kHexLength];
+        record.trace_id.format_to(hex);
+        out.push_back('[');
+        out.append(std::string_view(hex, sizeof(hex)));
+        out.append(std::string_view("] "));
+    }
+    out.append(std::string_view(record.site->event));
+
+    for (uint8_t i = 0; i < record.field_count; ++i) {
+        const LogField& field = record.fields[i];
+        out.push_back(' ');
+        out.append(std::string_view(field.key));
+        out.push_back('=');
+        switch (field.type) {
+            case LogField::Type::INT:
+                fmt::format_to(std::back_inserter(out), "{}", field.value.i);
+                break;
+            case LogField::Type::UINT:
+                fmt::format_to(std::back_inserter(out), "{}", field.value.u);
+                break;
+            case LogField::Type::DOUBLE:
+                fmt::format_to(std::back_inserter(out), "{}", field.value.d);
+                break;
+            case LogField::Type::BOOL:
+                out.append(std::string_view(field.value.b ? "true" : "false"));
+                break;
+            case LogField::Type::TEXT:
+                append_text(out, std::string_view(field.text, field.text_length), field.truncated);
+                break;
+            case LogField::Type::NONE:
+                break;
+        }
+    }
+}
+
+void StructuredLogger::write(const LogRecord& record) {
+    auto* logger = Logger::handle(LoggerId::DEFAULT);
+    if (!logger || !logger->should_log(record.site->level)) {
+        return;
+    }
+    fmt::memory_buffer buffer;
+    format_record(record, buffer);
+    logger->log(record.time, record.site->location, record.site->level,
+                spdlog::string_view_t(buffer.data(), buffer.size()));
+}
+
+} // namespace dmp
@@ -0,0 +1,96 @@
+#include "utils/trace_id.hpp"
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace dmp {
+
+namespace {
+    uint64_t splitmix64(uint64_t& state) {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    /**
+     * @brief Per-thread xoshiro256** state, seeded once per thread
+     */
+    struct TraceIdGenerator {
+        uint64_t s[4];
+
+        TraceIdGenerator() {
+            // One random_device read per thread, mixed with thread identity and time
+            uint64_t seed = static_cast<uint64_t>(std::random_device{}()) << 32;
+            seed ^= static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            seed ^= static_cast<uint64_t>(
+                std::chrono::high_resolution_clock::now().time_since_epoch().count());
+            for (auto& word : s) {
+                word = splitmix64(seed);
+            }
+        }
+
+        uint64_t next() {
+            const uint64_t result = rotl(s[1] * 5, 7) * 9;
+            const uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+            return result;
+        }
+    };
+
+    thread_local TraceIdGenerator tl_generator;
+
+    int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+}
+
+TraceId TraceId::generate() noexcept {
+    TraceId id;
+    do {
+        id.high = tl_generator.next();
+        id.low = tl_generator.next();
+    } while (id.empty());
+    return id;
+}
+
+TraceId TraceId::from_hex(std::string_view hex) noexcept {
+    if (hex.size() != kHexLength) {
+        return {};
+    }
+
+    TraceId id;
+    for (size_t i = 0; i < kHexLength; ++i) {
+        int value = hex_value(hex[i]);
+        if (value < 0) {
+            return {};
+        }
+        uint64_t& word = i < 16 ? id.high : id.low;
+        word = (word << 4) | static_cast<uint64_t>(value);
+    }
+    return id;
+}
+
+std::string TraceId::to_string() const {
+    if (empty()) {
+        return {};
+    }
+    std::string text(kHexLength, '0');
+    format_to(text.data());
+    return text;
+}
+
+} // namespace dmp
@@ -0,0 +1,220 @@
+#include "bench_harness.hpp"
+#include "utils/alloc_tracker.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+#if !DMP_ENABLE_ALLOC_TRACKING
+    // Plain thread-locals: constant-initialized, so safe to touch from operator new
+    thread_local uint64_t tl_allocations = 0;
+    thread_local uint64_t tl_allocated_bytes = 0;
+
+    void* counted_alloc(std::size_t size, std::size_t alignment = 0) {
+        ++tl_allocations;
+        tl_allocated_bytes += size;
+        if (size == 0) {
+            size = 1;
+        }
+        if (alignment > alignof(std::max_align_t)) {
+            return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+        return std::malloc(size);
+    }
+
+    void* checked(void* ptr) {
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+#endif
+
+    double ipc(const dmp::bench::CaseResult& result) {
+        const double cycles = result.hw_per_op[static_cast<size_t>(dmp::HwEvent::CYCLES)];
+        return cycles > 0.0 ? result.hw_per_op[static_cast<size_t>(dmp::HwEvent::INSTRUCTIONS)] / cycles : 0.0;
+    }
+
+    std::string json_escape(const std::string& value) {
+        std::string escaped;
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+}
+
+// dmp_core provides the hooks itself when built with DMP_ENABLE_ALLOC_TRACKING
+#if !DMP_ENABLE_ALLOC_TRACKING
+void* operator new(std::size_t size) { return checked(counted_alloc(size)); }
+void* operator new[](std::size_t size) { return checked(counted_alloc(size)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t al) {
+    return checked(counted_alloc(size, static_cast<std::size_t>(al)));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+    return checked(counted_alloc(size, static_cast<std::size_t>(al)));
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+#endif
+
+namespace dmp::bench {
+
+AllocationCounters thread_allocations() {
+#if DMP_ENABLE_ALLOC_TRACKING
+    const auto stats = AllocationTracker::thread_stats();
+    return {stats.allocations, stats.bytes};
+#else
+    return {tl_allocations, tl_allocated_bytes};
+#endif
+}
+
+Runner::Runner(std::string suite, int argc, char* argv[]) : suite_(std::move(suite)) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter_ = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_path_ = argv[++i];
+        } else if (arg == "--min-time-ms" && i + 1 < argc) {
+            min_time_ns_ = std::strtoull(argv[++i], nullptr, 10) * 1'000'000;
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions_ = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--hw-counters") {
+            hw_counters_ = true;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--filter SUBSTR] [--json PATH] [--min-time-ms MS] [--repetitions N]"
+                         " [--hw-counters]\n",
+                         argv[0]);
+            usage_error_ = true;
+        }
+    }
+    if (min_time_ns_ == 0) {
+        min_time_ns_ = 1'000'000;
+    }
+    if (hw_counters_) {
+        HwCounterValues probe;
+        if (!HwCounters::instance().read(probe)) {
+            std::fprintf(stderr, "%s: hardware counters unavailable, --hw-counters ignored\n", suite_.c_str());
+            hw_counters_ = false;
+        }
+    }
+    if (!usage_error_) {
+        std::printf("%-44s %12s %8s %12s %12s %12s", suite_.c_str(), "ns/op", "cv%", "bytes/op",
+                    "allocs/op", "iterations");
+        if (hw_counters_) {
+            std::printf(" %10s %6s %10s %10s", "cycles/op", "IPC", "llc-miss", "br-miss");
+        }
+        std::printf("\n");
+    }
+}
+
+bool Runner::selected(const std::string& name) const {
+    return !usage_error_ && (filter_.empty() || name.find(filter_) != std::string::npos);
+}
+
+uint64_t Runner::now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+CaseResult Runner::summarize(const std::string& name, uint64_t iterations,
+                             const std::vector<double>& ns_per_op,
+                             const AllocationCounters& before, const AllocationCounters& after,
+                             const HwCounterValues* hw_events) const {
+    std::vector<double> sorted = ns_per_op;
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0.0;
+    for (double value : sorted) {
+        mean += value / static_cast<double>(sorted.size());
+    }
+    double variance = 0.0;
+    for (double value : sorted) {
+        variance += (value - mean) * (value - mean) / static_cast<double>(sorted.size());
+    }
+
+    CaseResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.ns_per_op = sorted[sorted.size() / 2];
+    result.cv_percent = mean > 0.0 ? std::sqrt(variance) / mean * 100.0 : 0.0;
+    const double operations = static_cast<double>(iterations) * static_cast<double>(ns_per_op.size());
+    result.bytes_per_op = static_cast<double>(after.bytes - before.bytes) / operations;
+    result.allocs_per_op = static_cast<double>(after.allocations - before.allocations) / operations;
+    if (hw_events) {
+        result.has_hw_counters = true;
+        for (size_t e = 0; e < HW_EVENT_COUNT; ++e) {
+            result.hw_per_op[e] = static_cast<double>(hw_events->values[e]) / operations;
+        }
+    }
+    return result;
+}
+
+void Runner::add_result(CaseResult result) {
+    std::printf("%-44s %12.1f %8.1f %12.1f %12.2f %12llu", result.name.c_str(), result.ns_per_op,
+                result.cv_percent, result.bytes_per_op, result.allocs_per_op,
+                static_cast<unsigned long long>(result.iterations));
+    if (result.has_hw_counters) {
+        std::printf(" %10.1f %6.2f %10.2f %10.2f", result.hw_per_op[0], ipc(result),
+                    result.hw_per_op[static_cast<size_t>(HwEvent::LLC_MISSES)],
+                    result.hw_per_op[static_cast<size_t>(HwEvent::BRANCH_MISSES)]);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+    results_.push_back(std::move(result));
+}
+
+int Runner::finish() {
+    if (usage_error_) {
+        return 2;
+    }
+    if (json_path_.empty()) {
+        return 0;
+    }
+    FILE* file = std::fopen(json_path_.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "%s: cannot write %s\n", suite_.c_str(), json_path_.c_str());
+        return 2;
+    }
+    std::fprintf(file, "{\"suite\":\"%s\",\"benchmarks\":[", json_escape(suite_).c_str());
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const auto& result = results_[i];
+        std::fprintf(file,
+                     "%s\n{\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.3f,\"cv_percent\":%.3f,"
+                     "\"bytes_per_op\":%.3f,\"allocs_per_op\":%.3f",
+                     i == 0 ? "" : ",", json_escape(result.name).c_str(),
+                     static_cast<unsigned long long>(result.iterations), result.ns_per_op,
+                     result.cv_percent, result.bytes_per_op, result.allocs_per_op);
+        if (result.has_hw_counters) {
+            for (size_t e = 0; e < HW_EVENT_COUNT; ++e) {
+                if (!(HwCounters::instance().available_events() & (1u << e))) {
+                    continue;  // Not provided by this PMU
+                }
+                std::fprintf(file, ",\"%s_per_op\":%.3f", hw_event_name(static_cast<HwEvent>(e)),
+                             result.hw_per_op[e]);
+            }
+            std::fprintf(file, ",\"ipc\":%.3f", ipc(result));
+        }
+        std::fprintf(file, "}");
+    }
+    std::fprintf(file, "\n]}\n");
+    std::fclose(file);
+    return 0;
+}
+
+} // namespace dmp::bench
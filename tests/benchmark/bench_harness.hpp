@@ -0,0 +1,145 @@
+/**
+ * @file bench_harness.hpp
+ * @brief Minimal microbenchmark runner shared by the bench_* targets
+ * @author Stan Jiang
+ * @date 2025-09-14
+ *
+ * Each case is calibrated to run for --min-time-ms, repeated
+ * --repetitions times, and reported as the median ns/op with the spread
+ * across repetitions, plus heap bytes and allocations per operation
+ * counted by the harness's operator new hooks. --json PATH writes the
+ * same figures in machine-readable form; --filter SUBSTR selects cases.
+ * --hw-counters adds cycles, instructions, LLC misses and branch misses
+ * per operation from perf_event_open (Linux, when the PMU is accessible).
+ */
+#pragma once
+
+#include "utils/hw_counters.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dmp::bench {
+
+/**
+ * @brief Keep a value alive so the optimizer cannot drop the computation
+ */
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Heap activity of the calling thread since it started
+ */
+struct AllocationCounters {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+AllocationCounters thread_allocations();
+
+/**
+ * @brief Measured figures of one benchmark case
+ */
+struct CaseResult {
+    std::string name;
+    uint64_t iterations = 0;     // Per repetition
+    double ns_per_op = 0.0;      // Median across repetitions
+    double cv_percent = 0.0;     // Relative standard deviation across repetitions
+    double bytes_per_op = 0.0;   // Heap bytes allocated per operation
+    double allocs_per_op = 0.0;  // Heap allocations per operation
+    bool has_hw_counters = false;                   // hw_per_op is valid
+    std::array<double, HW_EVENT_COUNT> hw_per_op{}; // Hardware events per operation, by HwEvent
+};
+
+/**
+ * @brief Runs and reports benchmark cases
+ */
+class Runner {
+public:
+    Runner(std::string suite, int argc, char* argv[]);
+
+    /**
+     * @brief Measure one case
+     * @param name Case name, conventionally "function/payload"
+     * @param body Called once per operation; pass results to do_not_optimize()
+     */
+    template<typename Body>
+    void run(const std::string& name, Body&& body) {
+        if (!selected(name)) {
+            return;
+        }
+        record(name, [&body](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                body();
+            }
+        });
+    }
+
+    /**
+     * @brief Print the report and write JSON if requested
+     * @return Process exit status
+     */
+    int finish();
+
+private:
+    template<typename Loop>
+    void record(const std::string& name, Loop&& loop);
+
+    bool selected(const std::string& name) const;
+    void add_result(CaseResult result);
+
+    std::string suite_;
+    std::string filter_;
+    std::string json_path_;
+    uint64_t min_time_ns_ = 200'000'000;
+    int repetitions_ = 5;
+    bool hw_counters_ = false;
+    bool usage_error_ = false;
+    std::vector<CaseResult> results_;
+
+    // Out-of-line measurement helpers used by record()
+    static uint64_t now_ns();
+    CaseResult summarize(const std::string& name, uint64_t iterations,
+                         const std::vector<double>& ns_per_op,
+                         const AllocationCounters& before, const AllocationCounters& after,
+                         const HwCounterValues* hw_events) const;
+};
+
+template<typename Loop>
+void Runner::record(const std::string& name, Loop&& loop) {
+    // Grow the batch until it runs long enough to time reliably
+    uint64_t iterations = 1;
+    const uint64_t target_ns = min_time_ns_ / static_cast<uint64_t>(repetitions_);
+    for (;;) {
+        const uint64_t start = now_ns();
+        loop(iterations);
+        const uint64_t elapsed = now_ns() - start;
+        if (elapsed >= target_ns || iterations >= (uint64_t{1} << 40)) {
+            break;
+        }
+        const uint64_t scaled = elapsed > 0 ? iterations * target_ns / elapsed : iterations * 100;
+        iterations = std::max(iterations * 2, scaled + scaled / 10);
+    }
+
+    std::vector<double> ns_per_op;
+    ns_per_op.reserve(static_cast<size_t>(repetitions_));
+    HwCounterValues hw_before;
+    HwCounterValues hw_after;
+    const bool hw_started = hw_counters_ && HwCounters::instance().read(hw_before);
+    const AllocationCounters before = thread_allocations();
+    for (int r = 0; r < repetitions_; ++r) {
+        const uint64_t start = now_ns();
+        loop(iterations);
+        ns_per_op.push_back(static_cast<double>(now_ns() - start) / static_cast<double>(iterations));
+    }
+    const AllocationCounters after = thread_allocations();
+    const HwCounterValues hw_events = hw_started && HwCounters::instance().read(hw_after)
+        ? hw_after - hw_before : HwCounterValues{};
+    add_result(summarize(name, iterations, ns_per_op, before, after,
+                         hw_started ? &hw_events : nullptr));
+}
+
+} // namespace dmp::bench
@@ -0,0 +1,128 @@
+/**
+ * @file bench_transaction.cpp
+ * @brief Parse/serialize microbenchmarks for the transaction data structures
+ * @author Stan Jiang
+ * @date 2025-09-14
+ *
+ * Covers TransactionRequest::from_json (including the simdjson parse),
+ * TransactionRequest::to_json, TransactionResponse::to_json,
+ * get_cache_key and FeatureSet::serialize/deserialize over small, typical
+ * and large payloads. transaction.hpp budgets 0.5 ms for parsing a
+ * typical 2 KB request and 0.1 ms for response serialization.
+ */
+#include "bench_harness.hpp"
+#include "core/transaction.hpp"
+#include "core/transaction_generator.hpp"
+#include <cstdio>
+
+using namespace dmp;
+using namespace dmp::bench;
+
+namespace {
+    struct Payload {
+        const char* name;
+        TransactionRequest request;
+        std::string json;
+        TransactionResponse response;
+        FeatureSet features;
+    };
+
+    // Fields clients send that the parser must skip over
+    std::string client_metadata(size_t bytes) {
+        std::string metadata = ",\"metadata\":{";
+        for (size_t i = 0; metadata.size() < bytes; ++i) {
+            if (i > 0) {
+                metadata += ',';
+            }
+            char field[96];
+            std::snprintf(field, sizeof(field), "\"attr_%04zu\":\"value_%04zu_abcdefghijklmnopqrstuvwxyz\"", i, i);
+            metadata += field;
+        }
+        metadata += '}';
+        return metadata;
+    }
+
+    Payload make_payload(const char* name, size_t metadata_bytes, size_t triggered_rules, bool max_fields) {
+        TransactionGeneratorOptions options;
+        options.seed = 7;
+        Payload payload{name, TransactionGenerator(options).next(), {}, {}, {}};
+        if (max_fields) {
+            payload.request.request_id = std::string(100, 'r');
+            payload.request.card.token = std::string(100, 't');
+            payload.request.device.fingerprint = std::string(100, 'f');
+            payload.request.device.user_agent = std::string(500, 'u');
+            payload.request.customer.id = std::string(50, 'c');
+        }
+
+        payload.json = payload.request.to_json();
+        if (metadata_bytes > 0) {
+            payload.json.insert(payload.json.size() - 1, client_metadata(metadata_bytes));
+        }
+
+        payload.response.request_id = payload.request.request_id;
+        payload.response.decision = Decision::REVIEW;
+        payload.response.risk_score = 42.5f;
+        payload.response.latency_ms = 3.2f;
+        payload.response.model_version = "xgb-2025.09";
+        payload.response.timestamp = payload.request.timestamp;
+        for (size_t i = 0; i < triggered_rules; ++i) {
+            payload.response.triggered_rules.push_back("RULE_" + std::to_string(1000 + i));
+        }
+
+        for (size_t i = 0; i < payload.features.values.size(); ++i) {
+            payload.features.values[i] = static_cast<float>(i) * 0.25f;
+        }
+        payload.features.computed_at = 1757808000000ULL;
+        payload.features.version = 3;
+        payload.features.cache_key = payload.request.get_cache_key();
+        return payload;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Runner runner("bench_transaction", argc, argv);
+
+    const Payload payloads[] = {
+        make_payload("small", 0, 0, false),
+        make_payload("typical", 2048 - 600, 3, false),
+        make_payload("large", 16384, 50, true),
+    };
+
+    for (const auto& payload : payloads) {
+        const std::string suffix = std::string("/") + payload.name;
+        std::printf("# %s: request %zu bytes, response %zu bytes\n", payload.name, payload.json.size(),
+                    payload.response.to_json().size());
+
+        simdjson::dom::parser parser;
+        runner.run("request_from_json" + suffix, [&] {
+            simdjson::dom::element json;
+            if (parser.parse(payload.json).get(json) == simdjson::SUCCESS) {
+                auto result = TransactionRequest::from_json(json);
+                do_not_optimize(result);
+            }
+        });
+        runner.run("request_to_json" + suffix, [&] {
+            auto json = payload.request.to_json();
+            do_not_optimize(json);
+        });
+        runner.run("response_to_json" + suffix, [&] {
+            auto json = payload.response.to_json();
+            do_not_optimize(json);
+        });
+        runner.run("get_cache_key" + suffix, [&] {
+            auto key = payload.request.get_cache_key();
+            do_not_optimize(key);
+        });
+        runner.run("features_serialize" + suffix, [&] {
+            auto bytes = payload.features.serialize();
+            do_not_optimize(bytes);
+        });
+        const std::vector<uint8_t> serialized = payload.features.serialize();
+        runner.run("features_deserialize" + suffix, [&] {
+            auto result = FeatureSet::deserialize(serialized);
+            do_not_optimize(result);
+        });
+    }
+
+    return runner.finish();
+}
@@ -0,0 +1,322 @@
+/**
+ * @file test_dependency_latency.cpp
+ * @brief Deadline propagation and degraded decisions against slow dependencies
+ * @author Stan Jiang
+ * @date 2025-09-18
+ *
+ * The L3 feature cache, model server and intel feed are replaced by local
+ * stand-ins with injected latency, errors and stalls. The RESP client
+ * must give up at the deadline and never reuse a connection with a reply
+ * still in flight; the dependency set must hand each call only the budget
+ * left; and a concurrent decision pipeline must keep its P99 under the
+ * configured target_p99_ms while some of its dependencies misbehave.
+ */
+#include <gtest/gtest.h>
+#include "common/config.hpp"
+#include "core/decision.hpp"
+#include "core/remote_lookup.hpp"
+#include "core/transaction_generator.hpp"
+#include "engine/rule_engine.hpp"
+#include "stand_in.hpp"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace dmp;
+using namespace dmp::standin;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Scheduler wake-up and loopback overhead allowed on top of a deadline
+constexpr auto kSlack = 10ms;
+
+// Half the shortest injected stall: a request reaching it waited out a stall
+constexpr auto kStallBound = 250ms;
+
+std::chrono::microseconds elapsed_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+float configured_target_p99_ms() {
+#ifdef DMP_SOURCE_DIR
+    auto config = SystemConfig::load_from_file(std::string(DMP_SOURCE_DIR) + "/config/server.toml");
+    if (config.is_success() && config.value) {
+        return config.value->get_server_config().target_p99_ms;
+    }
+#endif
+    return ServerConfig{}.target_p99_ms;
+}
+
+} // namespace
+
+// ============================================================================
+// RESP client against the cache stand-in
+// ============================================================================
+
+TEST(RespLookupTest, HitAndMissReuseOneConnection) {
+    RespStandIn server;
+    server.set("card:4111", "velocity=3");
+    RespLookup client("127.0.0.1", server.port());
+
+    auto hit = client.lookup("card:4111", Deadline::after(100ms));
+    ASSERT_TRUE(hit.is_success()) << hit.error_message;
+    EXPECT_TRUE(hit.value.found);
+    EXPECT_EQ(hit.value.value, "velocity=3");
+
+    auto miss = client.lookup("card:0000", Deadline::after(100ms));
+    ASSERT_TRUE(miss.is_success()) << miss.error_message;
+    EXPECT_FALSE(miss.value.found);
+
+    EXPECT_EQ(server.stats().connections, 1u);
+}
+
+TEST(RespLookupTest, StallEndsAtDeadlineAndConnectionIsNotReused) {
+    RespStandIn server(LatencyProfile::constant(0us).with_stalls(1.0, 300ms));
+    server.set("a", "first");
+    server.set("b", "second");
+    RespLookup client("127.0.0.1", server.port());
+
+    const auto start = std::chrono::steady_clock::now();
+    auto stalled = client.lookup("a", Deadline::after(20ms));
+    EXPECT_EQ(stalled.error_code, ErrorCode::DEADLINE_EXCEEDED);
+    EXPECT_LE(elapsed_since(start), 20ms + kSlack);
+
+    // The late reply to "a" must not be taken as the answer for "b"
+    server.set_profile(LatencyProfile::constant(0us));
+    auto next = client.lookup("b", Deadline::after(100ms));
+    ASSERT_TRUE(next.is_success()) << next.error_message;
+    EXPECT_EQ(next.value.value, "second");
+    EXPECT_EQ(server.stats().connections, 2u);
+}
+
+TEST(RespLookupTest, InjectedErrorsSurfaceAsCacheErrors) {
+    RespStandIn server(LatencyProfile::constant(0us).with_errors(1.0));
+    server.set("a", "value");
+    RespLookup client("127.0.0.1", server.port());
+
+    for (int i = 0; i < 3; ++i) {
+        auto result = client.lookup("a", Deadline::after(100ms));
+        EXPECT_EQ(result.error_code, ErrorCode::CACHE_ERROR);
+    }
+    // An error reply leaves the stream in sync, so the connection is kept
+    EXPECT_EQ(server.stats().connections, 1u);
+}
+
+TEST(RespLookupTest, IdleConnectionClosedByServerIsRetriedOnce) {
+    RespStandIn server;
+    server.set("a", "value");
+    RespLookup client("127.0.0.1", server.port());
+    ASSERT_TRUE(client.lookup("a", Deadline::after(100ms)).is_success());
+
+    server.drop_connections();
+    std::this_thread::sleep_for(20ms);  // Let the FIN reach the pooled socket
+
+    auto retried = client.lookup("a", Deadline::after(100ms));
+    ASSERT_TRUE(retried.is_success()) << retried.error_message;
+    EXPECT_EQ(retried.value.value, "value");
+    EXPECT_EQ(server.stats().connections, 2u);
+}
+
+TEST(RespLookupTest, UnresolvableHostFailsWithoutBlocking) {
+    RespLookup client("dmp-cache.invalid", 6379);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = client.lookup("a", Deadline::after(100ms));
+    EXPECT_EQ(result.error_code, ErrorCode::CACHE_ERROR);
+    EXPECT_LT(elapsed_since(start), 50ms);
+}
+
+TEST(RespLookupTest, ResolveRetryNeverBlocksConcurrentLookups) {
+    RespLookup client("dmp-cache.invalid", 6379);
+    std::this_thread::sleep_for(RespLookup::kResolveRetryInterval + 50ms);
+
+    // The retry is due: one caller starts it in the background, none waits on DNS
+    std::vector<std::thread> callers;
+    std::atomic<int> slow{0};
+    for (int i = 0; i < 8; ++i) {
+        callers.emplace_back([&] {
+            const auto start = std::chrono::steady_clock::now();
+            auto result = client.lookup("a", Deadline::after(100ms));
+            EXPECT_EQ(result.error_code, ErrorCode::CACHE_ERROR);
+            if (elapsed_since(start) >= 50ms) ++slow;
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(slow.load(), 0);
+}
+
+TEST(RespLookupTest, RefusedConnectionFailsFast) {
+    uint16_t port = 0;
+    {
+        RespStandIn server;
+        port = server.port();
+    }
+    RespLookup client("127.0.0.1", port);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = client.lookup("a", Deadline::after(100ms));
+    EXPECT_EQ(result.error_code, ErrorCode::CACHE_ERROR);
+    EXPECT_LT(elapsed_since(start), 100ms);
+}
+
+// ============================================================================
+// Deadline propagation across dependencies
+// ============================================================================
+
+TEST(DependencySetTest, LaterDependenciesSeeTheRemainingBudget) {
+    std::vector<std::shared_ptr<StandInLookup>> stand_ins;
+    std::vector<RemoteDependency> dependencies;
+    for (const char* name : {"l3_cache", "model_server", "intel_feed"}) {
+        stand_ins.push_back(std::make_shared<StandInLookup>(LatencyProfile::constant(4ms)));
+        dependencies.push_back({name, stand_ins.back(), 50ms});
+    }
+    DependencySet set(std::move(dependencies), 5ms);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = set.fetch({"k", "k", "k"}, Deadline::after(30ms));
+    EXPECT_FALSE(result.is_degraded());
+    EXPECT_LE(elapsed_since(start), 30ms);
+
+    std::vector<std::chrono::microseconds> budgets;
+    for (const auto& stand_in : stand_ins) {
+        ASSERT_EQ(stand_in->observed_budgets().size(), 1u);
+        budgets.push_back(stand_in->observed_budgets().front());
+    }
+    EXPECT_LE(budgets[0], 25ms);  // Request deadline minus the reserve, not the 50ms timeout
+    EXPECT_LE(budgets[1], budgets[0] - 4ms);
+    EXPECT_LE(budgets[2], budgets[1] - 4ms);
+}
+
+TEST(DependencySetTest, PerDependencyTimeoutCapsTheCall) {
+    auto slow = std::make_shared<StandInLookup>(LatencyProfile::constant(0us).with_stalls(1.0, 1s));
+    auto fast = std::make_shared<StandInLookup>(LatencyProfile::constant(100us));
+    fast->set("k", "v");
+    DependencySet set({{"model_server", slow, 5ms}, {"intel_feed", fast, 5ms}}, 5ms);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = set.fetch({"k", "k"}, Deadline::after(50ms));
+    EXPECT_LE(elapsed_since(start), 5ms + kSlack);
+    ASSERT_EQ(result.degraded, std::vector<std::string>{"model_server"});
+    EXPECT_FALSE(result.values[0].found);
+    EXPECT_TRUE(result.values[1].found);
+}
+
+TEST(DependencySetTest, ExhaustedBudgetSkipsRemainingDependencies) {
+    auto slow = std::make_shared<StandInLookup>(LatencyProfile::constant(0us).with_stalls(1.0, 1s));
+    auto never_called = std::make_shared<StandInLookup>();
+    DependencySet set({{"l3_cache", slow, 100ms}, {"intel_feed", never_called, 100ms}}, 5ms);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = set.fetch({"k", "k"}, Deadline::after(15ms));
+    EXPECT_LE(elapsed_since(start), 15ms + kSlack);
+    EXPECT_EQ(result.degraded, (std::vector<std::string>{"l3_cache", "intel_feed"}));
+    EXPECT_EQ(never_called->stats().requests, 0u);
+}
+
+// ============================================================================
+// Degraded decisions under a latency SLO
+// ============================================================================
+
+TEST(DegradedDecisionTest, P99StaysUnderTargetWithMisbehavingDependencies) {
+    const auto dir = std::filesystem::temp_directory_path() / ("dmp_dependency_latency_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "rules.json") << R"({
+        "version": "dependency-latency",
+        "rules": [
+            {"id": "HIGH_AMOUNT", "expression": "amount > 1000", "weight": 30.0, "enabled": true},
+            {"id": "RISKY_CUSTOMER", "expression": "customer_risk_score > 70", "weight": 25.0, "enabled": true}
+        ],
+        "thresholds": {"approve_threshold": 30.0, "review_threshold": 70.0}
+    })";
+    ReloadGeneration generation;
+    generation.rule_engine = std::make_shared<RuleEngine>();
+    ASSERT_TRUE(generation.rule_engine->load_rules((dir / "rules.json").string()).is_success());
+
+    const float target_p99_ms = configured_target_p99_ms();
+    const auto request_budget = std::chrono::microseconds(static_cast<int64_t>(target_p99_ms * 1000.0f));
+
+    // Tails well past the budget: without deadlines the P99 would be the stall time
+    RespStandIn cache_server(LatencyProfile::log_normal(300us, 3ms).with_errors(0.02).with_stalls(0.02, 500ms), 11);
+    auto model_server = std::make_shared<StandInLookup>(
+        LatencyProfile::log_normal(1ms, 8ms).with_stalls(0.01, 2s), 12);
+    auto intel_feed = std::make_shared<StandInLookup>(
+        LatencyProfile::uniform(500us, 2ms).with_errors(0.05), 13);
+    intel_feed->set("203.0.113.7", "blocked");
+
+    const auto per_call = std::max<std::chrono::microseconds>(request_budget / 4, 1ms);
+    DependencySet dependencies({
+        {"l3_cache", std::make_shared<RespLookup>("127.0.0.1", cache_server.port()), per_call},
+        {"model_server", model_server, per_call},
+        {"intel_feed", intel_feed, per_call},
+    }, request_budget / 10);
+
+    constexpr int kThreads = 4;
+    constexpr int kRequestsPerThread = 250;
+    std::vector<std::vector<double>> latencies(kThreads);
+    std::atomic<int> degraded{0};
+    std::atomic<int> degraded_approved{0};
+    std::atomic<int> declined{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t] {
+            TransactionGeneratorOptions options;
+            options.seed = 100 + t;
+            TransactionGenerator generator(options);
+            for (int i = 0; i < kRequestsPerThread; ++i) {
+                auto request = generator.next();
+                if (i % 10 == 0) {
+                    request.device.ip = "203.0.113.7";
+                }
+                const auto start = std::chrono::steady_clock::now();
+                const auto deadline = Deadline::after(request_budget);
+
+                auto enrichment = dependencies.fetch(
+                    {request.get_cache_key(), request.customer.id, request.device.ip}, deadline);
+                auto response = decide(generation, request, enrichment);
+                degraded_approved += enrichment.is_degraded() && response.decision == Decision::APPROVE;
+                // The intel feed's verdict is not part of the rule set
+                if (enrichment.values[2].found && enrichment.values[2].value == "blocked") {
+                    response.decision = Decision::DECLINE;
+                }
+                declined += response.decision == Decision::DECLINE;
+
+                degraded += enrichment.is_degraded();
+                latencies[t].push_back(elapsed_since(start).count() / 1000.0);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::filesystem::remove_all(dir);
+
+    std::vector<double> all;
+    for (const auto& per_thread : latencies) {
+        all.insert(all.end(), per_thread.begin(), per_thread.end());
+    }
+    std::sort(all.begin(), all.end());
+    const double p99 = all[all.size() * 99 / 100];
+    const double max = all.back();
+
+    RecordProperty("p99_ms", std::to_string(p99));
+    RecordProperty("max_ms", std::to_string(max));
+    RecordProperty("degraded", degraded.load());
+
+    // Loose wall-clock bounds so scheduler delay on a loaded machine cannot fail the run
+    const double slack_ms = std::chrono::duration<double, std::milli>(kSlack).count();
+    const double stall_bound_ms = std::chrono::duration<double, std::milli>(kStallBound).count();
+    EXPECT_LE(p99, target_p99_ms + slack_ms);
+    EXPECT_LT(max, stall_bound_ms);
+    EXPECT_GT(degraded.load(), 0);                            // The faults were actually hit
+    EXPECT_LT(degraded.load(), kThreads * kRequestsPerThread);  // ...without degrading everything
+    EXPECT_EQ(degraded_approved.load(), 0);                   // Degraded requests go to review
+    EXPECT_GT(declined.load(), 0);                            // Intel hits still drive decisions
+    EXPECT_GT(cache_server.stats().stalls, 0u);
+}
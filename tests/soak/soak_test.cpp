@@ -0,0 +1,655 @@
+/**
+ * @file soak_test.cpp
+ * @brief Sustained-load soak with periodic hot reloads and drift detection
+ * @author Stan Jiang
+ * @date 2025-09-19
+ *
+ * Usage:
+ *   soak_test [--duration S] [--window S] [--warmup-windows N]
+ *             [--reload-interval S] [--threads N] [--rate TPS]
+ *             [--config PATH] [--pool N] [--seed N] [--csv PATH]
+ *             [--max-rss-growth-mb MB] [--max-rss-slope-mb-h MB]
+ *             [--max-fragmentation-growth R] [--max-p99-drift R]
+ *             [--max-thread-growth N] [--max-live-generations N]
+ *
+ * Worker threads run the in-process decision path (parse, rules, patterns,
+ * response) against ReloadCoordinator::current() for --duration seconds,
+ * while --config itself and the rules and blocklist of its [reload]
+ * section are rewritten and reloaded every --reload-interval seconds.
+ * Copies of those files in a temporary directory are modified, never the
+ * originals.
+ *
+ * Every --window seconds (one minute by default) the test records resident
+ * memory, malloc arena fragmentation, the window's latency percentiles,
+ * the thread count and how many superseded rule engines, pattern matchers
+ * and configuration snapshots are still alive. After the warm-up windows
+ * the run fails when:
+ *   - RSS grew more than --max-rss-growth-mb over the run, or (runs of ten
+ *     minutes or more) its least-squares trend exceeds --max-rss-slope-mb-h
+ *   - free bytes held in malloc arenas grew by more than 8 MiB and their
+ *     share of the arenas rose by more than --max-fragmentation-growth
+ *   - the median P99 of the last quarter of windows is more than
+ *     --max-p99-drift above that of the first quarter (and 0.1 ms worse)
+ *   - the thread count grew by more than --max-thread-growth
+ *   - more than --max-live-generations rule engines, pattern matchers or
+ *     configuration snapshots are alive, i.e. a reload left an old
+ *     generation reachable
+ *
+ * Exit status is 0 when no drift was found, 1 when some was, and 2 on
+ * setup errors.
+ */
+#include "core/decision.hpp"
+#include "core/reload_coordinator.hpp"
+#include "core/transaction_generator.hpp"
+#include "utils/histogram.hpp"
+#include "utils/logger.hpp"
+#include "utils/memory_accountant.hpp"
+#include <simdjson.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace dmp;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr double kNsPerMs = 1e6;
+    constexpr double kBytesPerMiB = 1024.0 * 1024.0;
+    constexpr uint64_t kMinFreeGrowthBytes = 8ull << 20;   // Fragmentation below this is noise
+    constexpr double kP99NoiseFloorMs = 0.1;              // P99 drift below this is noise
+    constexpr double kMinSlopeSpanS = 600.0;              // RSS trend needs ten minutes of windows
+
+    void usage() {
+        std::fprintf(stderr,
+                     "usage: soak_test [options]\n"
+                     "  --duration S                 total seconds, warm-up included (default 3600)\n"
+                     "  --window S                   sampling window (default 60)\n"
+                     "  --warmup-windows N           windows before the baseline (default 2)\n"
+                     "  --reload-interval S          config/rules/patterns reload period (default 10)\n"
+                     "  --threads N                  worker threads (default 4)\n"
+                     "  --rate TPS                   total request rate, 0 = unpaced (default 2000)\n"
+                     "  --config PATH                server TOML naming the artifacts\n"
+                     "                               (default config/server.toml)\n"
+                     "  --pool N                     pre-generated requests per thread (default 5000)\n"
+                     "  --seed N                     generator seed (default 42)\n"
+                     "  --csv PATH                   write per-window samples\n"
+                     "  --max-rss-growth-mb MB       (default 64)\n"
+                     "  --max-rss-slope-mb-h MB      (default 32)\n"
+                     "  --max-fragmentation-growth R (default 0.25)\n"
+                     "  --max-p99-drift R            relative (default 0.5)\n"
+                     "  --max-thread-growth N        (default 0)\n"
+                     "  --max-live-generations N     (default 2)\n"
+                     "  --verbose                    keep engine logging\n");
+    }
+
+    struct Options {
+        double duration_s = 3600.0;
+        double window_s = 60.0;
+        size_t warmup_windows = 2;
+        double reload_interval_s = 10.0;
+        size_t threads = 4;
+        double rate = 2000.0;
+        std::string config_path = "config/server.toml";
+        size_t pool = 5000;
+        uint64_t seed = 42;
+        std::string csv_path;
+
+        double max_rss_growth_mb = 64.0;
+        double max_rss_slope_mb_h = 32.0;
+        double max_fragmentation_growth = 0.25;
+        double max_p99_drift = 0.5;
+        long max_thread_growth = 0;
+        size_t max_live_generations = 2;
+    };
+
+    /**
+     * @brief State of the process at the end of one window
+     */
+    struct WindowSample {
+        size_t index = 0;
+        double elapsed_s = 0.0;
+        uint64_t requests = 0;
+        uint64_t errors = 0;
+        double p50_ms = 0.0;
+        double p99_ms = 0.0;
+        double max_ms = 0.0;
+        uint64_t rss_bytes = 0;
+        uint64_t heap_in_use_bytes = 0;
+        uint64_t heap_free_bytes = 0;   // Free but still held by malloc arenas
+        double fragmentation = 0.0;     // heap_free / arena size, 0 when unknown
+        long threads = 0;
+        uint64_t generation = 0;
+        uint64_t reload_failures = 0;
+        size_t live_rule_engines = 0;
+        size_t live_pattern_matchers = 0;
+        size_t live_config_snapshots = 0;
+    };
+
+    struct HeapStats {
+        uint64_t in_use = 0;
+        uint64_t free = 0;
+        double fragmentation = 0.0;
+    };
+
+    HeapStats heap_stats() {
+        HeapStats stats;
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+        const struct mallinfo2 info = mallinfo2();
+        const uint64_t arena = info.arena;
+        stats.in_use = info.uordblks + info.hblkhd;
+        stats.free = info.fordblks;
+#elif defined(__GLIBC__)
+        const struct mallinfo info = mallinfo();
+        const uint64_t arena = static_cast<unsigned int>(info.arena);
+        stats.in_use = static_cast<unsigned int>(info.uordblks) + static_cast<unsigned int>(info.hblkhd);
+        stats.free = static_cast<unsigned int>(info.fordblks);
+#else
+        const uint64_t arena = 0;
+#endif
+        stats.fragmentation = arena > 0 ? static_cast<double>(stats.free) / static_cast<double>(arena) : 0.0;
+        return stats;
+    }
+
+    long thread_count() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("Threads:", 0) == 0) {
+                return std::strtol(line.c_str() + 8, nullptr, 10);
+            }
+        }
+        return 0;
+    }
+
+    std::string read_file(const std::string& path) {
+        std::ifstream file(path);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    bool write_file(const std::filesystem::path& path, const std::string& content) {
+        std::ofstream file(path, std::ios::trunc);
+        file << content;
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * @brief Rule file with one extra rule whose threshold changes every reload
+     */
+    std::string rules_variant(const std::string& base, uint64_t reload) {
+        const size_t rules_key = base.find("\"rules\"");
+        const size_t array_start = rules_key == std::string::npos ? rules_key : base.find('[', rules_key);
+        if (array_start == std::string::npos) {
+            return {};
+        }
+        std::string extra = "\n    {\"id\": \"SOAK_RELOAD\", \"expression\": \"amount > " +
+                            std::to_string(1000 + reload % 1000) +
+                            "\", \"weight\": 1.0, \"enabled\": true}";
+        const size_t next = base.find_first_not_of(" \t\r\n", array_start + 1);
+        if (next != std::string::npos && base[next] != ']') {
+            extra += ",";
+        }
+        return base.substr(0, array_start + 1) + extra + base.substr(array_start + 1);
+    }
+
+    /**
+     * @brief Blocklist with a few merchant patterns that change every reload
+     */
+    std::string blocklist_variant(const std::string& base, uint64_t reload) {
+        std::string content = base;
+        if (!content.empty() && content.back() != '\n') {
+            content += '\n';
+        }
+        for (int i = 0; i < 4; ++i) {
+            content += "SOAK_MERCH_" + std::to_string(reload) + "_" + std::to_string(i) + "_*\n";
+        }
+        return content;
+    }
+
+    /**
+     * @brief Weak references to every published rule engine, pattern matcher and config snapshot
+     */
+    class GenerationTracker {
+    public:
+        void add(const ReloadGeneration& generation) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation.rule_engine) {
+                engines_.push_back(generation.rule_engine);
+            }
+            if (generation.pattern_matcher) {
+                matchers_.push_back(generation.pattern_matcher);
+            }
+            if (generation.system_config) {
+                snapshots_.push_back(generation.system_config->snapshot());
+            }
+        }
+
+        std::tuple<size_t, size_t, size_t> live() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return {prune(engines_), prune(matchers_), prune(snapshots_)};
+        }
+
+    private:
+        template<typename T>
+        static size_t prune(std::vector<std::weak_ptr<T>>& pointers) {
+            pointers.erase(std::remove_if(pointers.begin(), pointers.end(),
+                                          [](const auto& pointer) { return pointer.expired(); }),
+                           pointers.end());
+            return pointers.size();
+        }
+
+        std::mutex mutex_;
+        std::vector<std::weak_ptr<RuleEngine>> engines_;
+        std::vector<std::weak_ptr<PatternMatcher>> matchers_;
+        std::vector<std::weak_ptr<const ConfigSnapshot>> snapshots_;
+    };
+
+    struct Worker {
+        LatencyHistogram latency;
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> errors{0};
+        std::vector<std::string> bodies;
+    };
+
+    double median_p99(const std::vector<WindowSample>& samples, size_t from, size_t count) {
+        std::vector<double> values;
+        for (size_t i = from; i < from + count; ++i) {
+            values.push_back(samples[i].p99_ms);
+        }
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2),
+                         values.end());
+        return values[values.size() / 2];
+    }
+
+    /**
+     * @brief Least-squares RSS trend in MiB per hour
+     */
+    double rss_slope_mb_per_hour(const std::vector<WindowSample>& samples, size_t from) {
+        const double n = static_cast<double>(samples.size() - from);
+        double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+        for (size_t i = from; i < samples.size(); ++i) {
+            const double x = samples[i].elapsed_s / 3600.0;
+            const double y = static_cast<double>(samples[i].rss_bytes) / kBytesPerMiB;
+            sum_x += x;
+            sum_y += y;
+            sum_xx += x * x;
+            sum_xy += x * y;
+        }
+        const double denominator = n * sum_xx - sum_x * sum_x;
+        return denominator > 0.0 ? (n * sum_xy - sum_x * sum_y) / denominator : 0.0;
+    }
+
+    void print_sample(const WindowSample& s, bool baseline) {
+        std::printf("%4zu %7.0f %9llu %6llu %8.3f %8.3f %8.3f %8.1f %8.1f %8.1f %6.3f %5ld %5llu %4llu %4zu/%zu/%-4zu%s\n",
+                    s.index, s.elapsed_s, static_cast<unsigned long long>(s.requests),
+                    static_cast<unsigned long long>(s.errors), s.p50_ms, s.p99_ms, s.max_ms,
+                    s.rss_bytes / kBytesPerMiB, s.heap_in_use_bytes / kBytesPerMiB,
+                    s.heap_free_bytes / kBytesPerMiB, s.fragmentation, s.threads,
+                    static_cast<unsigned long long>(s.generation),
+                    static_cast<unsigned long long>(s.reload_failures), s.live_rule_engines,
+                    s.live_pattern_matchers, s.live_config_snapshots, baseline ? "  <- baseline" : "");
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--duration" && i + 1 < argc) {
+            options.duration_s = std::atof(argv[++i]);
+        } else if (arg == "--window" && i + 1 < argc) {
+            options.window_s = std::atof(argv[++i]);
+        } else if (arg == "--warmup-windows" && i + 1 < argc) {
+            options.warmup_windows = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--reload-interval" && i + 1 < argc) {
+            options.reload_interval_s = std::atof(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rate" && i + 1 < argc) {
+            options.rate = std::atof(argv[++i]);
+        } else if (arg == "--config" && i + 1 < argc) {
+            options.config_path = argv[++i];
+        } else if (arg == "--pool" && i + 1 < argc) {
+            options.pool = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--csv" && i + 1 < argc) {
+            options.csv_path = argv[++i];
+        } else if (arg == "--max-rss-growth-mb" && i + 1 < argc) {
+            options.max_rss_growth_mb = std::atof(argv[++i]);
+        } else if (arg == "--max-rss-slope-mb-h" && i + 1 < argc) {
+            options.max_rss_slope_mb_h = std::atof(argv[++i]);
+        } else if (arg == "--max-fragmentation-growth" && i + 1 < argc) {
+            options.max_fragmentation_growth = std::atof(argv[++i]);
+        } else if (arg == "--max-p99-drift" && i + 1 < argc) {
+            options.max_p99_drift = std::atof(argv[++i]);
+        } else if (arg == "--max-thread-growth" && i + 1 < argc) {
+            options.max_thread_growth = std::strtol(argv[++i], nullptr, 10);
+        } else if (arg == "--max-live-generations" && i + 1 < argc) {
+            options.max_live_generations = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    const size_t window_count = options.window_s > 0.0
+        ? static_cast<size_t>(options.duration_s / options.window_s) : 0;
+    if (options.window_s <= 0.0 || options.reload_interval_s <= 0.0 || options.threads == 0 ||
+        options.pool == 0 || options.rate < 0.0 || window_count < options.warmup_windows + 2) {
+        std::fprintf(stderr, "soak_test: need at least two windows after the warm-up windows\n");
+        usage();
+        return 2;
+    }
+    if (!verbose) {
+        Logger::set_level(spdlog::level::warn);
+    }
+
+    // Reloads rewrite copies of the rules and blocklist; the originals are never touched
+    auto config_result = SystemConfig::load_from_file(options.config_path);
+    if (config_result.is_error()) {
+        std::fprintf(stderr, "soak_test: %s\n", config_result.error_message.c_str());
+        return 2;
+    }
+    const ReloadConfig reload_config = config_result.value->get_reload_config();
+    ReloadSources sources = ReloadSources::from_config(options.config_path, reload_config);
+
+    const std::string base_rules = read_file(sources.rules_path);
+    const std::string base_blocklist = read_file(sources.blacklist_path);
+    if (rules_variant(base_rules, 0).empty()) {
+        std::fprintf(stderr, "soak_test: no \"rules\" array in %s\n", sources.rules_path.c_str());
+        return 2;
+    }
+    const auto work_dir = std::filesystem::temp_directory_path() / ("dmp_soak_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(work_dir);
+    const auto rules_path = work_dir / "rules.json";
+    const auto blocklist_path = work_dir / "blocklist.txt";
+    if (!write_file(rules_path, base_rules) || !write_file(blocklist_path, base_blocklist)) {
+        std::fprintf(stderr, "soak_test: cannot write to %s\n", work_dir.c_str());
+        return 2;
+    }
+    sources.rules_path = rules_path.string();
+    sources.blacklist_path = blocklist_path.string();
+    // The system configuration is reloaded too, so its snapshots are tracked like the rules
+    const std::string base_config = read_file(options.config_path);
+    const auto config_path = work_dir / "server.toml";
+    if (!write_file(config_path, base_config)) {
+        std::fprintf(stderr, "soak_test: cannot write to %s\n", work_dir.c_str());
+        std::filesystem::remove_all(work_dir);
+        return 2;
+    }
+    sources.system_config_path = config_path.string();
+
+    GenerationTracker tracker;
+    ReloadCoordinator coordinator(sources, 0);
+    if (reload_config.preflight) {
+        coordinator.enable_preflight(PreflightOptions::from_config(reload_config));
+    }
+    coordinator.on_publish([&tracker](const ReloadGeneration& generation) { tracker.add(generation); });
+    auto load_result = coordinator.load_initial();
+    if (load_result.is_error()) {
+        std::fprintf(stderr, "soak_test: %s\n", load_result.error_message.c_str());
+        std::filesystem::remove_all(work_dir);
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (size_t t = 0; t < options.threads; ++t) {
+        auto worker = std::make_unique<Worker>();
+        TransactionGeneratorOptions generator_options;
+        generator_options.seed = options.seed + t;
+        generator_options.repeat_customer_ratio = 0.3;
+        TransactionGenerator generator(generator_options);
+        worker->bodies.reserve(options.pool);
+        for (size_t i = 0; i < options.pool; ++i) {
+            worker->bodies.push_back(generator.next().to_json());
+        }
+        workers.push_back(std::move(worker));
+    }
+
+    std::printf("soak_test: %zu threads at %s for %.0fs, %zu windows of %.0fs (%zu warm-up), "
+                "reload every %gs\n",
+                options.threads, options.rate > 0.0 ? (std::to_string(static_cast<long>(options.rate)) + " TPS").c_str()
+                                                    : "full speed",
+                options.duration_s, window_count, options.window_s, options.warmup_windows,
+                options.reload_interval_s);
+    std::printf("%4s %7s %9s %6s %8s %8s %8s %8s %8s %8s %6s %5s %5s %4s %11s\n", "win", "t_s", "requests",
+                "errors", "p50_ms", "p99_ms", "max_ms", "rss_mb", "heap_mb", "free_mb", "frag", "thr", "gen",
+                "fail", "live r/p/c");
+    std::fflush(stdout);
+
+    std::atomic<bool> stop{false};
+    std::mutex reload_mutex;  // Held while reloading and while counting threads
+    const auto start = Clock::now();
+    const auto interval = options.rate > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(static_cast<double>(options.threads) / options.rate))
+        : Clock::duration::zero();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < options.threads; ++t) {
+        threads.emplace_back([&, t] {
+            Worker& worker = *workers[t];
+            simdjson::dom::parser parser;
+            const auto first = start + interval * static_cast<int64_t>(t) / static_cast<int64_t>(options.threads);
+            for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+                if (interval > Clock::duration::zero()) {
+                    std::this_thread::sleep_until(first + interval * static_cast<int64_t>(i));
+                }
+                const auto begin = Clock::now();
+                auto response = decide(*coordinator.current(), parser, worker.bodies[i % worker.bodies.size()]);
+                const bool ok = response.is_success() && !response.value.to_json().empty();
+                worker.latency.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+                worker.requests.fetch_add(1, std::memory_order_relaxed);
+                if (!ok) {
+                    worker.errors.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    std::thread reloader([&] {
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(options.reload_interval_s));
+        for (uint64_t reload = 1; ; ++reload) {
+            const auto due = start + period * static_cast<int64_t>(reload);
+            while (!stop.load(std::memory_order_relaxed) && Clock::now() < due) {
+                std::this_thread::sleep_for(std::min<Clock::duration>(due - Clock::now(),
+                                                                      std::chrono::milliseconds(50)));
+            }
+            if (stop.load(std::memory_order_relaxed)) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(reload_mutex);
+            write_file(rules_path, rules_variant(base_rules, reload));
+            write_file(blocklist_path, blocklist_variant(base_blocklist, reload));
+            write_file(config_path, base_config + "\n# soak reload " + std::to_string(reload) + "\n");
+            coordinator.reload_now();
+        }
+    });
+
+    std::vector<WindowSample> samples;
+    HistogramSnapshot previous_latency;
+    uint64_t previous_requests = 0;
+    uint64_t previous_errors = 0;
+    const auto window = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.window_s));
+    const size_t baseline_index = std::max<size_t>(options.warmup_windows, 1) - 1;
+
+    for (size_t w = 0; w < window_count; ++w) {
+        std::this_thread::sleep_until(start + window * static_cast<int64_t>(w + 1));
+
+        WindowSample sample;
+        sample.index = w + 1;
+        sample.elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+        HistogramSnapshot cumulative;
+        uint64_t requests = 0;
+        uint64_t errors = 0;
+        for (const auto& worker : workers) {
+            worker->latency.accumulate_into(cumulative);
+            requests += worker->requests.load(std::memory_order_relaxed);
+            errors += worker->errors.load(std::memory_order_relaxed);
+        }
+        HistogramSnapshot latency = cumulative;
+        latency.subtract(previous_latency);
+        previous_latency = std::move(cumulative);
+        sample.requests = requests - previous_requests;
+        sample.errors = errors - previous_errors;
+        previous_requests = requests;
+        previous_errors = errors;
+        sample.p50_ms = latency.value_at_quantile(0.50) / kNsPerMs;
+        sample.p99_ms = latency.value_at_quantile(0.99) / kNsPerMs;
+        sample.max_ms = latency.max() / kNsPerMs;
+
+        {
+            // Staging threads of an in-progress reload are not a leak
+            std::lock_guard<std::mutex> lock(reload_mutex);
+            sample.threads = thread_count();
+            sample.generation = coordinator.generation_id();
+            sample.reload_failures = coordinator.failures();
+        }
+        sample.rss_bytes = MemoryAccountant::resident_bytes();
+        const HeapStats heap = heap_stats();
+        sample.heap_in_use_bytes = heap.in_use;
+        sample.heap_free_bytes = heap.free;
+        sample.fragmentation = heap.fragmentation;
+        std::tie(sample.live_rule_engines, sample.live_pattern_matchers, sample.live_config_snapshots) =
+            tracker.live();
+
+        print_sample(sample, w == baseline_index && options.warmup_windows > 0);
+        samples.push_back(sample);
+    }
+
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    reloader.join();
+    std::filesystem::remove_all(work_dir);
+
+    if (!options.csv_path.empty()) {
+        std::ofstream csv(options.csv_path);
+        csv << "window,elapsed_s,requests,errors,p50_ms,p99_ms,max_ms,rss_bytes,heap_in_use_bytes,"
+               "heap_free_bytes,fragmentation,threads,generation,reload_failures,live_rule_engines,"
+               "live_pattern_matchers,live_config_snapshots\n";
+        for (const auto& s : samples) {
+            csv << s.index << ',' << s.elapsed_s << ',' << s.requests << ',' << s.errors << ',' << s.p50_ms << ','
+                << s.p99_ms << ',' << s.max_ms << ',' << s.rss_bytes << ',' << s.heap_in_use_bytes << ','
+                << s.heap_free_bytes << ',' << s.fragmentation << ',' << s.threads << ',' << s.generation << ','
+                << s.reload_failures << ',' << s.live_rule_engines << ',' << s.live_pattern_matchers << ','
+                << s.live_config_snapshots << '\n';
+        }
+    }
+
+    // Drift is measured from the end of the warm-up to the last window
+    const WindowSample& baseline = samples[baseline_index];
+    const WindowSample& last = samples.back();
+    const size_t measured_from = baseline_index + 1;
+    const size_t measured = samples.size() - measured_from;
+    const size_t quarter = std::max<size_t>(1, measured / 4);
+    std::vector<std::string> failures;
+    char message[256];
+
+    const double rss_growth_mb = (static_cast<double>(last.rss_bytes) - static_cast<double>(baseline.rss_bytes))
+                                 / kBytesPerMiB;
+    if (rss_growth_mb > options.max_rss_growth_mb) {
+        std::snprintf(message, sizeof(message), "RSS grew %.1f MiB (limit %.1f)", rss_growth_mb,
+                      options.max_rss_growth_mb);
+        failures.push_back(message);
+    }
+    const double span_s = last.elapsed_s - baseline.elapsed_s;
+    const double rss_slope = rss_slope_mb_per_hour(samples, baseline_index);
+    if (span_s >= kMinSlopeSpanS && rss_slope > options.max_rss_slope_mb_h) {
+        std::snprintf(message, sizeof(message), "RSS trend %.1f MiB/h (limit %.1f)", rss_slope,
+                      options.max_rss_slope_mb_h);
+        failures.push_back(message);
+    }
+
+    const double fragmentation_growth = last.fragmentation - baseline.fragmentation;
+    if (last.heap_free_bytes > baseline.heap_free_bytes + kMinFreeGrowthBytes &&
+        fragmentation_growth > options.max_fragmentation_growth) {
+        std::snprintf(message, sizeof(message), "malloc fragmentation %.3f -> %.3f, %.1f MiB free held",
+                      baseline.fragmentation, last.fragmentation, last.heap_free_bytes / kBytesPerMiB);
+        failures.push_back(message);
+    }
+
+    const double early_p99 = median_p99(samples, measured_from, quarter);
+    const double late_p99 = median_p99(samples, samples.size() - quarter, quarter);
+    if (late_p99 > early_p99 * (1.0 + options.max_p99_drift) && late_p99 - early_p99 > kP99NoiseFloorMs) {
+        std::snprintf(message, sizeof(message), "P99 drifted %.3f -> %.3f ms (limit +%.0f%%)", early_p99,
+                      late_p99, options.max_p99_drift * 100.0);
+        failures.push_back(message);
+    }
+
+    if (last.threads - baseline.threads > options.max_thread_growth) {
+        std::snprintf(message, sizeof(message), "threads grew %ld -> %ld", baseline.threads, last.threads);
+        failures.push_back(message);
+    }
+
+    const size_t live = std::max({last.live_rule_engines, last.live_pattern_matchers, last.live_config_snapshots});
+    if (live > options.max_live_generations) {
+        std::snprintf(message, sizeof(message),
+                      "%zu rule engines / %zu pattern matchers / %zu config snapshots still alive after reloads",
+                      last.live_rule_engines, last.live_pattern_matchers, last.live_config_snapshots);
+        failures.push_back(message);
+    }
+
+    uint64_t total_requests = 0;
+    uint64_t total_errors = 0;
+    for (const auto& s : samples) {
+        total_requests += s.requests;
+        total_errors += s.errors;
+    }
+    std::printf("\nrequests    %llu (%llu errors), %llu generations published, %llu reloads rejected\n",
+                static_cast<unsigned long long>(total_requests), static_cast<unsigned long long>(total_errors),
+                static_cast<unsigned long long>(last.generation),
+                static_cast<unsigned long long>(last.reload_failures));
+    std::printf("rss         %+.1f MiB since baseline, trend %+.1f MiB/h%s\n", rss_growth_mb, rss_slope,
+                span_s >= kMinSlopeSpanS ? "" : " (not checked, run under ten minutes)");
+    std::printf("fragment    %.3f -> %.3f\n", baseline.fragmentation, last.fragmentation);
+    std::printf("p99         %.3f -> %.3f ms (median of first and last %zu windows)\n", early_p99, late_p99, quarter);
+    std::printf("threads     %ld -> %ld\n", baseline.threads, last.threads);
+
+    if (last.generation < 2) {
+        failures.push_back("no reload was published; the soak did not exercise hot reload");
+    }
+    if (total_errors > 0) {
+        failures.push_back(std::to_string(total_errors) + " requests failed");
+    }
+
+    if (failures.empty()) {
+        std::printf("\nPASS: no drift over %.0fs with %llu reloads\n", span_s,
+                    static_cast<unsigned long long>(last.generation - 1));
+        return 0;
+    }
+    std::printf("\nFAIL:\n");
+    for (const auto& failure : failures) {
+        std::printf("  - %s\n", failure.c_str());
+    }
+    return 1;
+}
@@ -0,0 +1,304 @@
+/**
+ * @file test_redos_stress.cpp
+ * @brief Worst-case input stress suite for the pattern and rule engines
+ * @author Stan Jiang
+ * @date 2025-09-16
+ *
+ * Adversarial pattern sets (nested wildcards, long wildcard chains, large
+ * sets) are scanned against adversarial inputs (long runs that almost
+ * match, maximum-length fields, oversized texts) on every available
+ * backend. Every field scan must finish within kFieldScanCap; the worst
+ * scan seen per backend is recorded as the worst_scan_us test property.
+ * A failure here is an input an attacker can send to stall a worker.
+ */
+#include <gtest/gtest.h>
+#include "core/transaction_generator.hpp"
+#include "engine/pattern_matcher.hpp"
+#include "engine/rule_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace dmp;
+
+namespace {
+
+// Generous for Debug and sanitizer builds; a backtracking blow-up takes seconds
+constexpr auto kFieldScanCap = std::chrono::milliseconds(20);
+
+constexpr size_t kMaxFieldLength = 512;  // Request parser limit for string fields
+
+const char* backend_name(PatternMatcher::Backend backend) {
+    switch (backend) {
+        case PatternMatcher::Backend::HYPERSCAN: return "Hyperscan";
+        case PatternMatcher::Backend::VECTORSCAN: return "Vectorscan";
+        case PatternMatcher::Backend::STD_REGEX: return "StdRegex";
+        default: return "Auto";
+    }
+}
+
+/**
+ * @brief Patterns whose regex translation backtracks O(text^stars) on near-misses
+ */
+std::vector<std::string> adversarial_wildcards() {
+    std::vector<std::string> patterns = {
+        "*a*a*a*a*a*a*a*a*b",
+        "*a**a***a****a*****b",
+        "?*?*?*?*?*?*?*?*?*?*c",
+        "MERCH_*_*_*_*_*_*_*_*_*_FRAUD",
+        "*.*.*.*.*.*.*.*.evil.example",
+        "Mozilla/*(*(*(*(*(*(*Bot)",
+    };
+    std::string chain;
+    while (chain.size() + 2 <= kMaxFieldLength) {
+        chain += "*a";
+    }
+    patterns.push_back(chain + "b");  // Maximum-length pattern, one star per two characters
+    return patterns;
+}
+
+/**
+ * @brief Inputs that keep every adversarial pattern one character short of matching
+ */
+std::vector<std::string> adversarial_inputs() {
+    std::vector<std::string> inputs;
+    inputs.push_back(std::string(kMaxFieldLength, 'a'));
+    inputs.push_back(std::string(kMaxFieldLength - 1, 'a') + "c");
+    inputs.push_back("MERCH" + std::string(kMaxFieldLength - 5, '_'));
+    inputs.push_back(std::string(kMaxFieldLength, '.'));
+
+    std::string user_agent = "Mozilla/";
+    while (user_agent.size() + 2 <= kMaxFieldLength) {
+        user_agent += "((";
+    }
+    inputs.push_back(user_agent);
+
+    std::string alternating;
+    while (alternating.size() < kMaxFieldLength) {
+        alternating += "a?";
+    }
+    inputs.push_back(alternating);
+
+    std::mt19937 rng(97);
+    std::uniform_int_distribution<int> printable(32, 126);
+    std::string noise;
+    for (size_t i = 0; i < kMaxFieldLength; ++i) {
+        noise += static_cast<char>(printable(rng));
+    }
+    inputs.push_back(noise);
+    return inputs;
+}
+
+class PatternStressTest : public ::testing::TestWithParam<PatternMatcher::Backend> {
+protected:
+    void SetUp() override {
+        matcher_ = std::make_unique<PatternMatcher>(GetParam());
+        if (GetParam() != PatternMatcher::Backend::STD_REGEX &&
+            matcher_->get_active_backend() == PatternMatcher::Backend::STD_REGEX) {
+            GTEST_SKIP() << backend_name(GetParam()) << " backend not available in this build";
+        }
+    }
+
+    void TearDown() override {
+        if (worst_scan_ > std::chrono::nanoseconds::zero()) {
+            RecordProperty("worst_scan_us", std::to_string(
+                std::chrono::duration_cast<std::chrono::microseconds>(worst_scan_).count()));
+        }
+    }
+
+    void add_wildcards(const std::vector<std::string>& patterns, const std::string& category = "blacklist") {
+        for (const auto& text : patterns) {
+            Pattern pattern(next_id_, "stress_" + std::to_string(next_id_), text, category);
+            ++next_id_;
+            ASSERT_TRUE(matcher_->add_pattern(pattern).is_success());
+        }
+    }
+
+    void compile() {
+        auto result = matcher_->compile_patterns();
+        ASSERT_TRUE(result.is_success()) << result.error_message;
+    }
+
+    /**
+     * @brief Scan one text, failing the test if it takes longer than the cap
+     */
+    PatternMatchResults timed_scan(const std::string& text) {
+        const auto start = std::chrono::steady_clock::now();
+        auto results = matcher_->match_text(text);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        worst_scan_ = std::max(worst_scan_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+        EXPECT_LE(elapsed, kFieldScanCap)
+            << backend_name(matcher_->get_active_backend()) << " took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+            << "us on a " << text.size() << "-byte input starting \"" << text.substr(0, 32) << "\"";
+        return results;
+    }
+
+    std::unique_ptr<PatternMatcher> matcher_;
+    uint32_t next_id_ = 1;
+    std::chrono::nanoseconds worst_scan_{0};
+};
+
+} // namespace
+
+TEST(WildcardTest, RepeatedStarsCollapse) {
+    EXPECT_EQ(PatternUtils::wildcard_to_regex("a***b"), "^a.*b$");
+    EXPECT_EQ(PatternUtils::wildcard_to_regex("**"), "^.*$");
+    EXPECT_EQ(PatternUtils::wildcard_to_regex("*?*"), "^.*..*$");
+}
+
+TEST(WildcardTest, MatchAgreesWithRegexTranslation) {
+    // Small alphabet so stars, '?', escaped '.' and the newline rule all get exercised
+    const std::string pattern_alphabet = "ab.*?*A";
+    const std::string text_alphabet = "abAB.\n";
+    std::mt19937 rng(1097);
+    auto pick = [&rng](const std::string& alphabet, size_t max_length) {
+        std::uniform_int_distribution<size_t> length(0, max_length);
+        std::uniform_int_distribution<size_t> index(0, alphabet.size() - 1);
+        std::string out(length(rng), ' ');
+        for (auto& c : out) {
+            c = alphabet[index(rng)];
+        }
+        return out;
+    };
+
+    for (int i = 0; i < 3000; ++i) {
+        const std::string pattern = pick(pattern_alphabet, 7);
+        const std::string text = pick(text_alphabet, 9);
+        const bool case_sensitive = i % 2 == 0;
+        auto flags = std::regex_constants::ECMAScript;
+        if (!case_sensitive) {
+            flags |= std::regex_constants::icase;
+        }
+        const std::regex reference(PatternUtils::wildcard_to_regex(pattern), flags);
+        EXPECT_EQ(PatternUtils::wildcard_match(pattern, text, case_sensitive), std::regex_search(text, reference))
+            << "pattern \"" << pattern << "\" text \"" << text << "\" case_sensitive " << case_sensitive;
+    }
+}
+
+TEST_P(PatternStressTest, NestedWildcardsOnNearMisses) {
+    add_wildcards(adversarial_wildcards());
+    compile();
+
+    for (const auto& input : adversarial_inputs()) {
+        timed_scan(input);
+    }
+
+    // Still matching when the last character arrives
+    auto hit = timed_scan(std::string(kMaxFieldLength - 1, 'a') + "b");
+    EXPECT_TRUE(hit.has_blacklist_matches());
+    EXPECT_EQ(hit.texts_over_budget, 0u);
+}
+
+TEST_P(PatternStressTest, LargePatternSetOnMaximumLengthFields) {
+    std::vector<std::string> patterns;
+    for (int i = 0; i < 2000; ++i) {
+        patterns.push_back("MERCH_" + std::to_string(i) + "_*_*_X");
+        patterns.push_back("*" + std::to_string(i) + "*" + std::to_string(i) + "*.example");
+    }
+    add_wildcards(patterns);
+    compile();
+
+    TransactionGeneratorOptions options;
+    auto request = TransactionGenerator(options).generate(1).front();
+    request.device.user_agent = std::string(kMaxFieldLength, '1');
+    request.device.fingerprint = std::string(kMaxFieldLength, '*');
+    request.transaction.merchant_id = "MERCH_1" + std::string(kMaxFieldLength - 7, '_');
+    request.customer.id = std::string(kMaxFieldLength, 'X');
+    request.card.token = std::string(kMaxFieldLength, '.');
+
+    for (const auto& [field, value] : PatternUtils::extract_match_fields(request)) {
+        SCOPED_TRACE(field);
+        timed_scan(value);
+    }
+}
+
+TEST_P(PatternStressTest, OversizedTextIsScannedUpToTheLengthCap) {
+    add_wildcards({"*a*a*a*a*b"});
+    ASSERT_TRUE(matcher_->add_pattern(Pattern(next_id_++, "needle", "NEEDLE", "blacklist")).is_success());
+    compile();
+
+    const size_t cap = matcher_->get_scan_limits().max_text_bytes;
+    std::string text(1 << 20, 'a');
+    text.replace(cap + 1, 6, "NEEDLE");
+    EXPECT_FALSE(timed_scan(text).has_blacklist_matches());
+
+    text.replace(cap - 6, 6, "NEEDLE");
+    EXPECT_TRUE(timed_scan(text).has_blacklist_matches());
+}
+
+TEST_P(PatternStressTest, TimeCapStopsSlowPatternSets) {
+    if (matcher_->get_active_backend() != PatternMatcher::Backend::STD_REGEX) {
+        GTEST_SKIP() << "only the std::regex backend needs a time cap";
+    }
+    for (uint32_t i = 0; i < 5000; ++i) {
+        Pattern pattern(next_id_++, "slow_" + std::to_string(i), "a+[0-9]{2,}z" + std::to_string(i), "blacklist");
+        pattern.is_regex = true;
+        ASSERT_TRUE(matcher_->add_pattern(pattern).is_success());
+    }
+    compile();
+    matcher_->set_scan_limits({4096, 1000});
+
+    auto results = timed_scan(std::string(64, 'a'));
+    EXPECT_EQ(results.texts_over_budget, 1u);
+    EXPECT_LT(results.patterns_checked, 5000u);
+    EXPECT_GE(matcher_->get_statistics()["scan_budget_exceeded"], 1u);
+
+    matcher_->set_scan_limits({4096, 0});
+    results = matcher_->match_text("aa99z7");
+    EXPECT_EQ(results.texts_over_budget, 0u);
+    EXPECT_EQ(results.patterns_checked, 5000u);
+    EXPECT_TRUE(results.has_blacklist_matches());
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, PatternStressTest,
+                         ::testing::Values(PatternMatcher::Backend::STD_REGEX, PatternMatcher::Backend::HYPERSCAN),
+                         [](const auto& info) { return std::string(backend_name(info.param)); });
+
+TEST(RuleStressTest, ExtremeValuesAndMaximumLengthFields) {
+    const auto dir = std::filesystem::temp_directory_path() / ("dmp_redos_stress_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "rules.json") << R"({
+        "version": "stress",
+        "rules": [
+            {"id": "HIGH_AMOUNT", "expression": "amount > 10000", "weight": 30.0, "enabled": true},
+            {"id": "RISKY_NEW_CUSTOMER", "expression": "customer_risk_score > 70 and account_age_days < 30",
+             "weight": 25.0, "enabled": true},
+            {"id": "GAMBLING_MCC", "expression": "merchant_category == 7995", "weight": 15.0, "enabled": true}
+        ],
+        "thresholds": {"approve_threshold": 30.0, "review_threshold": 70.0}
+    })";
+
+    RuleEngine engine;
+    ASSERT_TRUE(engine.load_rules((dir / "rules.json").string()).is_success());
+
+    TransactionGeneratorOptions options;
+    auto request = TransactionGenerator(options).generate(1).front();
+    request.transaction.amount = 1000000.0;
+    request.transaction.merchant_category = 65535;
+    request.transaction.merchant_id = std::string(kMaxFieldLength, '*');
+    request.customer.id = std::string(kMaxFieldLength, 'a');
+    request.customer.account_age_days = 0xFFFFFFFFu;
+    request.device.user_agent = std::string(kMaxFieldLength, '(');
+
+    auto worst = std::chrono::nanoseconds::zero();
+    for (int i = 0; i < 100; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        auto metrics = engine.evaluate_rules(request);
+        worst = std::max(worst, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start));
+        EXPECT_EQ(metrics.rules_evaluated, 3u);
+    }
+    EXPECT_LE(worst, kFieldScanCap);
+    RecordProperty("worst_evaluation_us",
+                   std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(worst).count()));
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
@@ -0,0 +1,341 @@
+#include "stand_in.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cctype>
+#include <cmath>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace dmp::standin {
+
+// ============================================================================
+// LatencyProfile / FaultInjector
+// ============================================================================
+
+LatencyProfile LatencyProfile::constant(std::chrono::microseconds delay) {
+    LatencyProfile profile;
+    profile.low = profile.high = delay;
+    return profile;
+}
+
+LatencyProfile LatencyProfile::uniform(std::chrono::microseconds min, std::chrono::microseconds max) {
+    LatencyProfile profile;
+    profile.distribution = Distribution::UNIFORM;
+    profile.low = min;
+    profile.high = max;
+    return profile;
+}
+
+LatencyProfile LatencyProfile::log_normal(std::chrono::microseconds median, std::chrono::microseconds p99) {
+    LatencyProfile profile;
+    profile.distribution = Distribution::LOG_NORMAL;
+    profile.low = median;
+    profile.high = p99;
+    return profile;
+}
+
+LatencyProfile& LatencyProfile::with_errors(double rate) {
+    error_rate = rate;
+    return *this;
+}
+
+LatencyProfile& LatencyProfile::with_stalls(double rate, std::chrono::microseconds stall) {
+    stall_rate = rate;
+    stall_time = stall;
+    return *this;
+}
+
+FaultInjector::FaultInjector(LatencyProfile profile, uint64_t seed)
+    : profile_(std::move(profile)), rng_(seed) {}
+
+void FaultInjector::set_profile(LatencyProfile profile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_ = std::move(profile);
+}
+
+InjectedFault FaultInjector::sample() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    if (profile_.stall_rate > 0.0 && unit(rng_) < profile_.stall_rate) {
+        return {profile_.stall_time, InjectedFault::Outcome::STALL};
+    }
+
+    double delay_us = static_cast<double>(profile_.low.count());
+    switch (profile_.distribution) {
+        case LatencyProfile::Distribution::CONSTANT:
+            break;
+        case LatencyProfile::Distribution::UNIFORM:
+            delay_us = std::uniform_real_distribution<double>(
+                static_cast<double>(profile_.low.count()), static_cast<double>(profile_.high.count()))(rng_);
+            break;
+        case LatencyProfile::Distribution::LOG_NORMAL: {
+            // P99 of a log-normal is median * exp(2.326 sigma)
+            const double median = std::max<double>(1.0, static_cast<double>(profile_.low.count()));
+            const double p99 = std::max<double>(median, static_cast<double>(profile_.high.count()));
+            delay_us = std::lognormal_distribution<double>(std::log(median), std::log(p99 / median) / 2.326)(rng_);
+            break;
+        }
+    }
+
+    InjectedFault fault;
+    fault.delay = std::chrono::microseconds(static_cast<int64_t>(delay_us));
+    if (profile_.error_rate > 0.0 && unit(rng_) < profile_.error_rate) {
+        fault.outcome = InjectedFault::Outcome::ERROR;
+    }
+    return fault;
+}
+
+// ============================================================================
+// RespStandIn
+// ============================================================================
+
+namespace {
+    std::string bulk(const std::string& value) {
+        return "$" + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+    }
+
+    /**
+     * @brief Parse one RESP array command from the front of buffer
+     * @return Bytes consumed, 0 when incomplete
+     */
+    size_t parse_command(const std::string& buffer, std::vector<std::string>& command) {
+        command.clear();
+        if (buffer.empty() || buffer[0] != '*') {
+            return buffer.empty() ? 0 : std::string::npos;
+        }
+        size_t line_end = buffer.find("\r\n");
+        if (line_end == std::string::npos) {
+            return 0;
+        }
+        const long count = std::strtol(buffer.c_str() + 1, nullptr, 10);
+        size_t pos = line_end + 2;
+        for (long i = 0; i < count; ++i) {
+            line_end = buffer.find("\r\n", pos);
+            if (line_end == std::string::npos) {
+                return 0;
+            }
+            if (buffer[pos] != '$') {
+                return std::string::npos;
+            }
+            const size_t length = std::strtoul(buffer.c_str() + pos + 1, nullptr, 10);
+            pos = line_end + 2;
+            if (buffer.size() < pos + length + 2) {
+                return 0;
+            }
+            command.emplace_back(buffer, pos, length);
+            pos += length + 2;
+        }
+        return pos;
+    }
+}
+
+RespStandIn::RespStandIn(LatencyProfile profile, uint64_t seed) : injector_(std::move(profile), seed) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("RespStandIn: socket failed");
+    }
+    int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd_, 128) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(listen_fd_);
+        throw std::runtime_error("RespStandIn: cannot listen on loopback");
+    }
+    port_ = ntohs(address.sin_port);
+    accept_thread_ = std::thread(&RespStandIn::accept_loop, this);
+}
+
+RespStandIn::~RespStandIn() {
+    stopping_ = true;
+    stop_cv_.notify_all();
+    accept_thread_.join();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int fd : connection_fds_) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+    for (auto& thread : connection_threads_) {
+        thread.join();
+    }
+    ::close(listen_fd_);
+}
+
+void RespStandIn::set(const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_[key] = value;
+}
+
+StandInStats RespStandIn::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void RespStandIn::drop_connections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : connection_fds_) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+}
+
+void RespStandIn::accept_loop() {
+    while (!stopping_) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, 20) <= 0) {
+            continue;
+        }
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.connections;
+        connection_fds_.push_back(fd);
+        connection_threads_.emplace_back(&RespStandIn::serve, this, fd);
+    }
+}
+
+bool RespStandIn::pause(std::chrono::microseconds delay) {
+    if (delay <= std::chrono::microseconds::zero()) {
+        return !stopping_;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    return !stop_cv_.wait_for(lock, delay, [this] { return stopping_.load(); });
+}
+
+std::string RespStandIn::execute(const std::vector<std::string>& command) {
+    if (command.empty()) {
+        return "-ERR empty command\r\n";
+    }
+    std::string name = command[0];
+    for (auto& c : name) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (name == "PING") {
+        return "+PONG\r\n";
+    }
+    if (name == "GET" && command.size() == 2) {
+        auto it = data_.find(command[1]);
+        return it == data_.end() ? "$-1\r\n" : bulk(it->second);
+    }
+    if (name == "SET" && command.size() >= 3) {
+        data_[command[1]] = command[2];
+        return "+OK\r\n";
+    }
+    return "-ERR unknown command '" + command[0] + "'\r\n";
+}
+
+void RespStandIn::serve(int fd) {
+    std::string buffer;
+    std::vector<std::string> command;
+    char chunk[4096];
+    bool open = true;
+
+    while (open && !stopping_) {
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+
+        while (open) {
+            const size_t consumed = parse_command(buffer, command);
+            if (consumed == 0) {
+                break;
+            }
+            if (consumed == std::string::npos) {
+                open = false;  // Not RESP: drop the client like a real server would
+                break;
+            }
+            buffer.erase(0, consumed);
+
+            const InjectedFault fault = injector_.sample();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.requests;
+                stats_.errors += fault.outcome == InjectedFault::Outcome::ERROR;
+                stats_.stalls += fault.outcome == InjectedFault::Outcome::STALL;
+            }
+            if (!pause(fault.delay)) {
+                open = false;
+                break;
+            }
+            const std::string reply = fault.outcome == InjectedFault::Outcome::ERROR
+                ? "-ERR injected\r\n" : execute(command);
+            if (::send(fd, reply.data(), reply.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(reply.size())) {
+                open = false;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    connection_fds_.erase(std::remove(connection_fds_.begin(), connection_fds_.end(), fd), connection_fds_.end());
+    ::close(fd);
+}
+
+// ============================================================================
+// StandInLookup
+// ============================================================================
+
+StandInLookup::StandInLookup(LatencyProfile profile, uint64_t seed) : injector_(std::move(profile), seed) {}
+
+void StandInLookup::set(const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_[key] = value;
+}
+
+StandInStats StandInLookup::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::vector<std::chrono::microseconds> StandInLookup::observed_budgets() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budgets_;
+}
+
+Result<LookupValue> StandInLookup::lookup(const std::string& key, const Deadline& deadline) {
+    const InjectedFault fault = injector_.sample();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budgets_.push_back(deadline.remaining());
+        ++stats_.requests;
+        stats_.errors += fault.outcome == InjectedFault::Outcome::ERROR;
+        stats_.stalls += fault.outcome == InjectedFault::Outcome::STALL;
+    }
+
+    if (fault.delay >= deadline.remaining()) {
+        std::this_thread::sleep_until(deadline.at());
+        return {LookupValue{}, ErrorCode::DEADLINE_EXCEEDED, "Stand-in reply would miss the deadline"};
+    }
+    std::this_thread::sleep_for(fault.delay);
+    if (fault.outcome == InjectedFault::Outcome::ERROR) {
+        return {LookupValue{}, ErrorCode::CACHE_ERROR, "Injected error"};
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = data_.find(key);
+    if (it == data_.end()) {
+        return {LookupValue{}, ErrorCode::SUCCESS, ""};
+    }
+    return {LookupValue{true, it->second}, ErrorCode::SUCCESS, ""};
+}
+
+} // namespace dmp::standin
@@ -0,0 +1,166 @@
+/**
+ * @file stand_in.hpp
+ * @brief Local stand-ins for remote dependencies with injected latency and failures
+ * @author Stan Jiang
+ * @date 2025-09-18
+ *
+ * RespStandIn is a loopback server speaking enough of the Redis protocol
+ * (GET, SET, PING) for the L3 cache client; StandInLookup is an in-process
+ * RemoteLookup for model servers, intel feeds and any other lookup that
+ * has no client yet. Both delay each request by a sample from a
+ * LatencyProfile and fail or stall a configurable fraction of them, so
+ * deadline handling and degraded decisions can be tested without the
+ * real services.
+ */
+#pragma once
+
+#include "core/remote_lookup.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dmp::standin {
+
+/**
+ * @brief Response time distribution and fault rates of a stand-in
+ */
+struct LatencyProfile {
+    enum class Distribution { CONSTANT, UNIFORM, LOG_NORMAL };
+
+    Distribution distribution = Distribution::CONSTANT;
+    std::chrono::microseconds low{0};   // Constant value, uniform minimum, log-normal median
+    std::chrono::microseconds high{0};  // Uniform maximum, log-normal P99
+    double error_rate = 0.0;            // Fraction answered with an error after the delay
+    double stall_rate = 0.0;            // Fraction held for stall_time before answering
+    std::chrono::microseconds stall_time{std::chrono::seconds(1)};
+
+    static LatencyProfile constant(std::chrono::microseconds delay);
+    static LatencyProfile uniform(std::chrono::microseconds min, std::chrono::microseconds max);
+    static LatencyProfile log_normal(std::chrono::microseconds median, std::chrono::microseconds p99);
+
+    LatencyProfile& with_errors(double rate);
+    LatencyProfile& with_stalls(double rate, std::chrono::microseconds stall);
+};
+
+/**
+ * @brief What a stand-in does with one request
+ */
+struct InjectedFault {
+    enum class Outcome { OK, ERROR, STALL };
+
+    std::chrono::microseconds delay{0};  // stall_time for STALL
+    Outcome outcome = Outcome::OK;
+};
+
+/**
+ * @brief Thread-safe, seeded sampler of a LatencyProfile
+ */
+class FaultInjector {
+public:
+    explicit FaultInjector(LatencyProfile profile, uint64_t seed = 1);
+
+    InjectedFault sample();
+    void set_profile(LatencyProfile profile);
+
+private:
+    std::mutex mutex_;
+    LatencyProfile profile_;
+    std::mt19937_64 rng_;
+};
+
+/**
+ * @brief Request counters of a stand-in
+ */
+struct StandInStats {
+    uint64_t requests = 0;
+    uint64_t errors = 0;       // Injected errors
+    uint64_t stalls = 0;       // Injected stalls
+    uint64_t connections = 0;  // Accepted connections (RespStandIn only)
+};
+
+/**
+ * @brief Loopback RESP server with injected latency
+ *
+ * Listens on 127.0.0.1 on an ephemeral port, one thread per connection.
+ * Injected errors are answered with "-ERR injected"; stalled requests are
+ * answered after stall_time, so a client that gave up must not read the
+ * late reply as the answer to its next request.
+ */
+class RespStandIn {
+public:
+    explicit RespStandIn(LatencyProfile profile = {}, uint64_t seed = 1);
+    ~RespStandIn();
+
+    RespStandIn(const RespStandIn&) = delete;
+    RespStandIn& operator=(const RespStandIn&) = delete;
+
+    uint16_t port() const { return port_; }
+    void set(const std::string& key, const std::string& value);
+    void set_profile(LatencyProfile profile) { injector_.set_profile(std::move(profile)); }
+    StandInStats stats() const;
+
+    /**
+     * @brief Close every open client connection, like an idle timeout or a restart
+     */
+    void drop_connections();
+
+private:
+    void accept_loop();
+    void serve(int fd);
+    std::string execute(const std::vector<std::string>& command);
+    bool pause(std::chrono::microseconds delay);  // false when stopping
+
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    FaultInjector injector_;
+    std::atomic<bool> stopping_{false};
+
+    mutable std::mutex mutex_;
+    std::condition_variable stop_cv_;
+    std::unordered_map<std::string, std::string> data_;
+    std::vector<int> connection_fds_;
+    std::vector<std::thread> connection_threads_;
+    StandInStats stats_;
+    std::thread accept_thread_;
+};
+
+/**
+ * @brief In-process RemoteLookup with injected latency
+ *
+ * Honours the deadline the way a well-behaved client does: when the
+ * sampled delay would overrun it, the call returns DEADLINE_EXCEEDED at
+ * the deadline. The budget left at each call is recorded so tests can
+ * check what the caller propagated.
+ */
+class StandInLookup : public RemoteLookup {
+public:
+    explicit StandInLookup(LatencyProfile profile = {}, uint64_t seed = 1);
+
+    Result<LookupValue> lookup(const std::string& key, const Deadline& deadline) override;
+
+    void set(const std::string& key, const std::string& value);
+    void set_profile(LatencyProfile profile) { injector_.set_profile(std::move(profile)); }
+    StandInStats stats() const;
+
+    /**
+     * @brief Close every open client connection, like an idle timeout or a restart
+     */
+    void drop_connections();
+    std::vector<std::chrono::microseconds> observed_budgets() const;
+
+private:
+    FaultInjector injector_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::string> data_;
+    std::vector<std::chrono::microseconds> budgets_;
+    StandInStats stats_;
+};
+
+} // namespace dmp::standin
@@ -0,0 +1,165 @@
+/**
+ * @file test_allocation_budget.cpp
+ * @brief Heap allocation budgets for the decision hot path
+ * @author Stan Jiang
+ * @date 2025-09-14
+ *
+ * Requires a build with -DDMP_ENABLE_ALLOC_TRACKING=ON; otherwise the
+ * budget tests are skipped. Budgets are steady-state allocations per call
+ * after the thread has compiled its rules, averaged over a synthetic
+ * corpus. An allocation regression fails here before it shows up as tail
+ * latency; raise a budget only together with the change that needs it.
+ */
+#include <gtest/gtest.h>
+#include "core/decision.hpp"
+#include "core/transaction_generator.hpp"
+#include "engine/pattern_matcher.hpp"
+#include "engine/rule_engine.hpp"
+#include "utils/alloc_tracker.hpp"
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+using namespace dmp;
+
+namespace {
+
+// Allocations per call; see the file comment before raising
+constexpr double kRuleEvaluationBudget = 8.0;
+constexpr double kPatternMatchBudget = 32.0;          // Hyperscan / Vectorscan
+constexpr double kStdRegexPatternMatchBudget = 160.0; // std::regex fallback copies match state per pattern
+constexpr double kDecisionOverheadBudget = 24.0;      // Parse, response and glue on top of rules + patterns
+
+constexpr size_t kSamples = 500;
+
+class AllocationBudgetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!AllocationTracker::enabled()) {
+            GTEST_SKIP() << "built without DMP_ENABLE_ALLOC_TRACKING";
+        }
+
+        dir_ = std::filesystem::temp_directory_path() /
+               ("dmp_alloc_budget_" + std::to_string(::getpid()));
+        std::filesystem::create_directories(dir_);
+        std::ofstream(dir_ / "rules.json") << R"({
+            "version": "budget",
+            "rules": [
+                {"id": "HIGH_AMOUNT", "expression": "amount > 10000", "weight": 30.0, "enabled": true},
+                {"id": "RISKY_NEW_CUSTOMER", "expression": "customer_risk_score > 70 and account_age_days < 30",
+                 "weight": 25.0, "enabled": true},
+                {"id": "GAMBLING_MCC", "expression": "merchant_category == 7995", "weight": 15.0, "enabled": true},
+                {"id": "BLACKLISTED_IP", "expression": "ip_blacklist_match > 0", "weight": 50.0, "enabled": true}
+            ],
+            "thresholds": {"approve_threshold": 30.0, "review_threshold": 70.0}
+        })";
+        std::ofstream(dir_ / "blacklist.txt") << "MERCH_FRAUD_001\nMERCH_FRAUD_002\n192.168.100.*\n";
+        std::ofstream(dir_ / "whitelist.txt") << "MERCH_00001\n";
+
+        rule_engine_ = std::make_shared<RuleEngine>();
+        ASSERT_TRUE(rule_engine_->load_rules((dir_ / "rules.json").string()).is_success());
+        pattern_matcher_ = std::make_shared<PatternMatcher>();
+        ASSERT_TRUE(pattern_matcher_->load_patterns((dir_ / "blacklist.txt").string(),
+                                                    (dir_ / "whitelist.txt").string()).is_success());
+        ASSERT_TRUE(pattern_matcher_->compile_patterns().is_success());
+        generation_.rule_engine = rule_engine_;
+        generation_.pattern_matcher = pattern_matcher_;
+
+        TransactionGeneratorOptions options;
+        options.blacklist_ratio = 0.1;
+        requests_ = TransactionGenerator(options).generate(kSamples);
+        for (const auto& request : requests_) {
+            bodies_.push_back(request.to_json());
+        }
+    }
+
+    double pattern_match_budget() const {
+        return pattern_matcher_->get_active_backend() == PatternMatcher::Backend::STD_REGEX
+            ? kStdRegexPatternMatchBudget : kPatternMatchBudget;
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove_all(dir_, ec);
+    }
+
+    /**
+     * @brief Mean allocations per call over the corpus, after one warm-up pass
+     */
+    template<typename Call>
+    double allocations_per_call(Call&& call) {
+        for (size_t i = 0; i < kSamples; ++i) {
+            call(i);
+        }
+        AllocationProbe probe;
+        for (size_t i = 0; i < kSamples; ++i) {
+            call(i);
+        }
+        return static_cast<double>(probe.delta().allocations) / static_cast<double>(kSamples);
+    }
+
+    std::filesystem::path dir_;
+    std::shared_ptr<RuleEngine> rule_engine_;
+    std::shared_ptr<PatternMatcher> pattern_matcher_;
+    ReloadGeneration generation_;
+    std::vector<TransactionRequest> requests_;
+    std::vector<std::string> bodies_;
+};
+
+} // namespace
+
+TEST_F(AllocationBudgetTest, ProbeCountsOnlyTheCallingThread) {
+    std::atomic<bool> go{false};
+    std::thread other([&go] {
+        while (!go.load()) {
+            std::this_thread::yield();
+        }
+        auto value = std::make_unique<int>(7);
+    });
+
+    AllocationProbe probe;
+    auto owned = std::make_unique<std::array<char, 256>>();
+    EXPECT_EQ(probe.delta().allocations, 1u);
+    EXPECT_GE(probe.delta().bytes, 256u);
+
+    go.store(true);
+    other.join();
+    EXPECT_EQ(probe.delta().allocations, 1u);
+
+    owned.reset();
+    EXPECT_EQ(probe.delta().deallocations, 1u);
+    EXPECT_GE(AllocationTracker::process_stats().allocations, AllocationTracker::thread_stats().allocations);
+}
+
+TEST_F(AllocationBudgetTest, EvaluateRules) {
+    const double per_call = allocations_per_call([this](size_t i) {
+        auto metrics = rule_engine_->evaluate_rules(requests_[i]);
+        EXPECT_EQ(metrics.rules_evaluated, 4u);
+    });
+    RecordProperty("allocations_per_call", std::to_string(per_call));
+    EXPECT_LE(per_call, kRuleEvaluationBudget);
+}
+
+TEST_F(AllocationBudgetTest, MatchTransaction) {
+    const double per_call = allocations_per_call([this](size_t i) {
+        auto matches = pattern_matcher_->match_transaction(requests_[i]);
+        (void)matches;
+    });
+    RecordProperty("allocations_per_call", std::to_string(per_call));
+    EXPECT_LE(per_call, pattern_match_budget());
+}
+
+TEST_F(AllocationBudgetTest, FullDecisionPath) {
+    simdjson::dom::parser parser;
+    const double per_call = allocations_per_call([&](size_t i) {
+        auto response = decide(generation_, parser, bodies_[i]);
+        ASSERT_TRUE(response.is_success()) << response.error_message;
+        EXPECT_FALSE(response.value.to_json().empty());
+    });
+    RecordProperty("allocations_per_call", std::to_string(per_call));
+    EXPECT_LE(per_call, kRuleEvaluationBudget + pattern_match_budget() + kDecisionOverheadBudget);
+}
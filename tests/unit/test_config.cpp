@@ -0,0 +1,119 @@
+/**
+ * @file test_config.cpp
+ * @brief Configuration snapshots: versioning, reload and snapshot lifetime
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "common/config.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+using namespace dmp;
+
+namespace {
+
+std::string server_toml(uint16_t port) {
+    return "[server]\nport = " + std::to_string(port) + "\nthreads = 4\n";
+}
+
+class ConfigTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = std::filesystem::temp_directory_path() /
+                ("dmp_config_test_" + std::to_string(::getpid()) + ".toml");
+        write(server_toml(8081));
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    void write(const std::string& content) const {
+        std::ofstream(path_, std::ios::trunc) << content;
+    }
+
+    std::shared_ptr<SystemConfig> load() const {
+        auto result = SystemConfig::load_from_file(path_.string());
+        EXPECT_TRUE(result.is_success()) << result.error_message;
+        return result.value;
+    }
+
+    std::filesystem::path path_;
+};
+
+TEST_F(ConfigTest, LoadPublishesFirstVersion) {
+    auto config = SystemConfig::load_from_string(server_toml(9000));
+    ASSERT_TRUE(config.is_success()) << config.error_message;
+    EXPECT_EQ(config.value->version(), 1u);
+    EXPECT_EQ(config.value->get_server_config().port, 9000);
+    EXPECT_EQ(config.value->snapshot()->version, 1u);
+}
+
+TEST_F(ConfigTest, ReloadKeepsPinnedSnapshotsValid) {
+    auto config = load();
+    ASSERT_TRUE(config);
+    const ServerConfig before = config->get_server_config();
+    const auto pinned = config->snapshot();
+
+    write(server_toml(8082));
+    ASSERT_TRUE(config->reload().is_success());
+
+    EXPECT_EQ(config->version(), 2u);
+    EXPECT_EQ(config->get_server_config().port, 8082);
+    EXPECT_EQ(before.port, 8081);
+    EXPECT_EQ(pinned->server.port, 8081);
+    EXPECT_EQ(pinned->version, 1u);
+}
+
+TEST_F(ConfigTest, FailedReloadPublishesNothing) {
+    auto config = load();
+    ASSERT_TRUE(config);
+
+    write("[server\nport = ");
+    EXPECT_TRUE(config->reload().is_error());
+    EXPECT_EQ(config->version(), 1u);
+    EXPECT_EQ(config->get_server_config().port, 8081);
+}
+
+TEST_F(ConfigTest, ReplacedSnapshotsAreFreedOnceUnpinned) {
+    auto config = load();
+    ASSERT_TRUE(config);
+    std::weak_ptr<const ConfigSnapshot> first = config->snapshot();
+    auto pinned = config->snapshot();
+
+    for (uint16_t port = 8100; port < 8150; ++port) {
+        write(server_toml(port));
+        ASSERT_TRUE(config->reload().is_success());
+    }
+    EXPECT_EQ(config->version(), 51u);
+    EXPECT_FALSE(first.expired());  // Still pinned
+    EXPECT_EQ(pinned->server.port, 8081);
+
+    pinned.reset();
+    EXPECT_TRUE(first.expired());
+}
+
+TEST_F(ConfigTest, CurrentConfigPinsReplacedInstance) {
+    auto first = SystemConfig::load_from_string(server_toml(7001));
+    auto second = SystemConfig::load_from_string(server_toml(7002));
+    ASSERT_TRUE(first.is_success() && second.is_success());
+
+    set_system_config(first.value);
+    const auto old_settings = current_config();
+    ASSERT_TRUE(old_settings);
+    EXPECT_EQ(old_settings->server.port, 7001);
+
+    std::weak_ptr<SystemConfig> replaced = first.value;
+    set_system_config(second.value);
+    first.value.reset();
+    EXPECT_TRUE(replaced.expired());  // Nothing retains replaced instances
+    EXPECT_EQ(old_settings->server.port, 7001);
+    EXPECT_EQ(current_config(), second.value->snapshot());
+    EXPECT_EQ(get_system_config(), second.value);
+    set_system_config(nullptr);
+}
+
+} // namespace
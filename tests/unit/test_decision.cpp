@@ -0,0 +1,154 @@
+/**
+ * @file test_decision.cpp
+ * @brief Shared decision pipeline: thresholds, blacklist and whitelist precedence, degraded enrichment, warm-up
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "core/decision.hpp"
+#include "core/transaction_generator.hpp"
+#include "core/warmup.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using namespace dmp;
+
+namespace {
+
+class DecisionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() /
+               ("dmp_decision_test_" + std::to_string(::getpid()));
+        std::filesystem::create_directories(dir_);
+        std::ofstream(dir_ / "rules.json") << R"({
+            "version": "decision",
+            "rules": [
+                {"id": "HIGH_AMOUNT", "expression": "amount > 10000", "weight": 80.0, "enabled": true}
+            ],
+            "thresholds": {"approve_threshold": 30.0, "review_threshold": 70.0}
+        })";
+        std::ofstream(dir_ / "blacklist.txt") << "MERCH_FRAUD_*\n";
+        std::ofstream(dir_ / "whitelist.txt") << "MERCH_FRAUD_TRUSTED\n";
+
+        auto rules = ReloadCoordinator::stage_rules((dir_ / "rules.json").string());
+        ASSERT_TRUE(rules.is_success()) << rules.error_message;
+        auto patterns = ReloadCoordinator::stage_patterns((dir_ / "blacklist.txt").string(),
+                                                          (dir_ / "whitelist.txt").string());
+        ASSERT_TRUE(patterns.is_success()) << patterns.error_message;
+        generation_.rule_engine = rules.value;
+        generation_.pattern_matcher = patterns.value;
+
+        TransactionGeneratorOptions options;
+        options.blacklist_ratio = 0.0;
+        options.high_amount_ratio = 0.0;
+        request_ = TransactionGenerator(options).next();
+        request_.transaction.amount = 100.0;
+        request_.transaction.merchant_id = "MERCH_00042";
+        request_.device.ip = "203.0.113.7";
+        ASSERT_TRUE(request_.is_valid());
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+
+    std::filesystem::path dir_;
+    ReloadGeneration generation_;
+    TransactionRequest request_;
+};
+
+TEST_F(DecisionTest, CleanTransactionIsApproved) {
+    const auto response = decide(generation_, request_);
+    EXPECT_EQ(response.decision, Decision::APPROVE);
+    EXPECT_EQ(response.request_id, request_.request_id);
+    EXPECT_TRUE(response.triggered_rules.empty());
+}
+
+TEST_F(DecisionTest, RuleScoreGoesThroughThresholds) {
+    request_.transaction.amount = 20000.0;
+    const auto response = decide(generation_, request_);
+    EXPECT_EQ(response.decision, Decision::DECLINE);
+    EXPECT_FLOAT_EQ(response.risk_score, 80.0f);
+    EXPECT_EQ(response.triggered_rules.size(), 1u);
+}
+
+TEST_F(DecisionTest, BlacklistDeclinesUnlessWhitelisted) {
+    request_.transaction.merchant_id = "MERCH_FRAUD_001";
+    EXPECT_EQ(decide(generation_, request_).decision, Decision::DECLINE);
+
+    request_.transaction.merchant_id = "MERCH_FRAUD_TRUSTED";
+    EXPECT_EQ(decide(generation_, request_).decision, Decision::APPROVE);
+}
+
+TEST_F(DecisionTest, ScanOverBudgetIsNeverApproved) {
+    auto matcher = std::make_shared<PatternMatcher>();
+    for (uint32_t i = 0; i < 2000; ++i) {
+        Pattern pattern(i + 1, "slow_" + std::to_string(i), "a+[0-9]{2,}z" + std::to_string(i), "blacklist");
+        pattern.is_regex = true;
+        ASSERT_TRUE(matcher->add_pattern(pattern).is_success());
+    }
+    ASSERT_TRUE(matcher->compile_patterns().is_success());
+    if (matcher->get_active_backend() != PatternMatcher::Backend::STD_REGEX) {
+        GTEST_SKIP() << "only the std::regex backend has a time cap";
+    }
+    matcher->set_scan_limits({512, 1});
+    generation_.pattern_matcher = matcher;
+
+    const uint64_t before = PatternMatcher::scans_over_budget();
+    EXPECT_EQ(decide(generation_, request_).decision, Decision::REVIEW);
+    EXPECT_GT(PatternMatcher::scans_over_budget(), before);
+}
+
+TEST_F(DecisionTest, DegradedEnrichmentIsNeverApproved) {
+    EnrichmentResult enrichment;
+    enrichment.values.resize(2);
+    EXPECT_EQ(decide(generation_, request_, enrichment).decision, Decision::APPROVE);
+
+    enrichment.degraded.push_back("model_server");
+    EXPECT_EQ(decide(generation_, request_, enrichment).decision, Decision::REVIEW);
+
+    request_.transaction.merchant_id = "MERCH_FRAUD_001";
+    EXPECT_EQ(decide(generation_, request_, enrichment).decision, Decision::DECLINE);
+}
+
+TEST_F(DecisionTest, EmptyGenerationApproves) {
+    request_.transaction.amount = 20000.0;
+    EXPECT_EQ(decide(ReloadGeneration{}, request_).decision, Decision::APPROVE);
+}
+
+TEST_F(DecisionTest, BodiesAreParsedAndValidated) {
+    simdjson::dom::parser parser;
+    auto response = decide(generation_, parser, request_.to_json());
+    ASSERT_TRUE(response.is_success()) << response.error_message;
+    EXPECT_EQ(response.value.request_id, request_.request_id);
+
+    EXPECT_EQ(decide(generation_, parser, "{ not json").error_code, ErrorCode::INVALID_JSON_FORMAT);
+    EXPECT_TRUE(decide(generation_, parser, "{}").is_error());
+}
+
+TEST_F(DecisionTest, WarmupRunsOnDispatchedThreadsAndLeavesNoStatistics) {
+    WarmupConfig config;
+    config.transactions_per_thread = 50;
+    WarmupRunner warmup(config);
+
+    std::vector<size_t> dispatched;
+    auto report = warmup.run(generation_, 2, [&](size_t threads, const std::function<void(size_t)>& task) {
+        for (size_t t = 0; t < threads; ++t) {
+            dispatched.push_back(t);
+            task(t);
+        }
+    });
+    ASSERT_TRUE(report.is_success()) << report.error_message;
+    EXPECT_EQ(dispatched, (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(report.value.transactions, 100u);
+    EXPECT_EQ(report.value.errors, 0u);
+
+    const auto stats = generation_.pattern_matcher->get_statistics();
+    ASSERT_TRUE(stats.count("match_count"));
+    EXPECT_EQ(stats.at("match_count"), 0u);
+    EXPECT_TRUE(warmup.run(generation_, 1, nullptr).is_error());
+}
+
+} // namespace
@@ -0,0 +1,106 @@
+/**
+ * @file test_histogram.cpp
+ * @brief Log-linear histogram bucket math, quantiles and snapshot arithmetic
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "utils/histogram.hpp"
+#include <cstdint>
+
+using namespace dmp;
+
+namespace {
+
+TEST(HistogramLayoutTest, BucketsTileTheValueRange) {
+    // Every bucket starts right after the previous one ends
+    for (size_t i = 1; i < HistogramLayout::kBucketCount; ++i) {
+        ASSERT_EQ(HistogramLayout::bucket_lower_bound(i),
+                  HistogramLayout::bucket_upper_bound(i - 1) + 1) << "bucket " << i;
+    }
+    EXPECT_EQ(HistogramLayout::bucket_upper_bound(HistogramLayout::kBucketCount - 1),
+              HistogramLayout::kMaxTrackableValue);
+}
+
+TEST(HistogramLayoutTest, ValuesMapIntoTheirBucketBounds) {
+    for (uint64_t value : {0ULL, 1ULL, 63ULL, 64ULL, 65ULL, 127ULL, 128ULL, 1000ULL,
+                           999999ULL, 1000000ULL, 123456789ULL, 1ULL << 39}) {
+        const size_t index = HistogramLayout::bucket_index(value);
+        EXPECT_LE(HistogramLayout::bucket_lower_bound(index), value) << value;
+        EXPECT_GE(HistogramLayout::bucket_upper_bound(index), value) << value;
+    }
+    // Small values are exact, larger ones bounded to ~1.6% relative error
+    EXPECT_EQ(HistogramLayout::bucket_index(17), 17u);
+    const size_t index = HistogramLayout::bucket_index(1000000);
+    const double width = static_cast<double>(HistogramLayout::bucket_upper_bound(index) -
+                                             HistogramLayout::bucket_lower_bound(index) + 1);
+    EXPECT_LE(width / 1000000.0, 0.033);
+}
+
+TEST(HistogramLayoutTest, OversizedValuesClampToLastBucket) {
+    EXPECT_EQ(HistogramLayout::bucket_index(UINT64_MAX), HistogramLayout::kBucketCount - 1);
+}
+
+TEST(HistogramSnapshotTest, QuantilesStayWithinObservedRange) {
+    HistogramSnapshot histogram;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v * 1000);
+    }
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.min(), 1000u);
+    EXPECT_EQ(histogram.max(), 1000000u);
+    EXPECT_NEAR(static_cast<double>(histogram.value_at_quantile(0.5)), 500000.0, 500000.0 * 0.02);
+    EXPECT_NEAR(static_cast<double>(histogram.value_at_quantile(0.99)), 990000.0, 990000.0 * 0.02);
+    EXPECT_EQ(histogram.value_at_quantile(0.0), 1000u);
+    EXPECT_LE(histogram.value_at_quantile(1.0), histogram.max());
+    EXPECT_EQ(HistogramSnapshot().value_at_quantile(0.5), 0u);
+}
+
+TEST(HistogramSnapshotTest, CountAtOrBelowNeverIncludesLargerValues) {
+    HistogramSnapshot histogram;
+    histogram.record(999000);   // Below 1ms, in a bucket ending before 1ms
+    histogram.record(1000000);  // Exactly 1ms, in a bucket straddling it
+    histogram.record(1001000);  // Above 1ms, same bucket as 1ms
+
+    const size_t straddling = HistogramLayout::bucket_index(1000000);
+    ASSERT_EQ(straddling, HistogramLayout::bucket_index(1001000));
+    ASSERT_LT(HistogramLayout::bucket_lower_bound(straddling), 1000000u);
+
+    EXPECT_EQ(histogram.count_at_or_below(1000000), 1u);
+    EXPECT_EQ(histogram.count_at_or_below(HistogramLayout::bucket_upper_bound(straddling)), 3u);
+    EXPECT_EQ(histogram.count_at_or_below(0), 0u);
+    EXPECT_EQ(histogram.count_at_or_below(UINT64_MAX), 3u);
+}
+
+TEST(HistogramSnapshotTest, SubtractYieldsWindowDelta) {
+    HistogramSnapshot older;
+    older.record(100, 5);
+
+    HistogramSnapshot newer = older;
+    newer.record(5000, 3);
+
+    newer.subtract(older);
+    EXPECT_EQ(newer.count(), 3u);
+    EXPECT_EQ(newer.sum(), 15000u);
+    EXPECT_EQ(newer.count_at_or_below(1000), 0u);
+    EXPECT_LE(newer.min(), 5000u);
+    EXPECT_GE(newer.max(), 5000u);
+}
+
+TEST(HistogramSnapshotTest, LatencyHistogramAccumulatesIntoSnapshot) {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    a.record(10);
+    a.record(20);
+    b.record(30000);
+
+    HistogramSnapshot merged;
+    a.accumulate_into(merged);
+    b.accumulate_into(merged);
+    EXPECT_EQ(merged.count(), 3u);
+    EXPECT_EQ(merged.sum(), 30030u);
+    EXPECT_EQ(merged.min(), 10u);
+    EXPECT_EQ(merged.max(), 30000u);
+}
+
+} // namespace
@@ -0,0 +1,113 @@
+/**
+ * @file test_large_table.cpp
+ * @brief Large table allocator: mapping threshold, alignment, pool budget and std allocator
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "utils/large_table.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace dmp;
+
+namespace {
+
+class LargeTableTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config_.huge_pages = "transparent";
+        config_.numa_policy = "local";
+        config_.prefault = false;
+        config_.pool_size_mb = 8;
+        ASSERT_TRUE(LargeTableAllocator::instance().configure(config_).is_success());
+    }
+
+    void TearDown() override {
+        LargeTableAllocator::instance().configure(MemoryConfig{});
+    }
+
+    static bool all_zero(const void* ptr, size_t bytes) {
+        const auto* begin = static_cast<const unsigned char*>(ptr);
+        return std::all_of(begin, begin + bytes, [](unsigned char byte) { return byte == 0; });
+    }
+
+    MemoryConfig config_;
+};
+
+TEST_F(LargeTableTest, SmallTablesComeFromTheHeap) {
+    auto& allocator = LargeTableAllocator::instance();
+    const auto before = allocator.stats();
+
+    void* table = allocator.allocate(4096);
+    ASSERT_NE(table, nullptr);
+    EXPECT_TRUE(all_zero(table, 4096));
+    EXPECT_EQ(allocator.stats().tables, before.tables);
+    EXPECT_EQ(allocator.stats().mapped_bytes, before.mapped_bytes);
+    allocator.deallocate(table, 4096);
+}
+
+TEST_F(LargeTableTest, LargeTablesAreMappedOnHugePageBoundaries) {
+    auto& allocator = LargeTableAllocator::instance();
+    const auto before = allocator.stats();
+    const size_t bytes = LargeTableAllocator::kHugePageSize + 1000;
+
+    void* table = allocator.allocate(bytes);
+    ASSERT_NE(table, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(table) % LargeTableAllocator::kHugePageSize, 0u);
+    EXPECT_TRUE(all_zero(table, bytes));
+
+    const auto mapped = allocator.stats();
+    EXPECT_EQ(mapped.tables, before.tables + 1);
+    EXPECT_EQ(mapped.mapped_bytes, before.mapped_bytes + 2 * LargeTableAllocator::kHugePageSize);
+
+    allocator.deallocate(table);
+    EXPECT_EQ(allocator.stats().tables, before.tables);
+    EXPECT_EQ(allocator.stats().mapped_bytes, before.mapped_bytes);
+}
+
+TEST_F(LargeTableTest, ExhaustedPoolFallsBackToHeap) {
+    auto& allocator = LargeTableAllocator::instance();
+    const auto before = allocator.stats();
+    const size_t bytes = 3 * LargeTableAllocator::kHugePageSize;
+
+    void* first = allocator.allocate(bytes);
+    void* second = allocator.allocate(bytes);  // 12 MiB would exceed the 8 MiB pool
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_TRUE(all_zero(second, bytes));
+
+    const auto after = allocator.stats();
+    EXPECT_EQ(after.tables, before.tables + 1);
+    EXPECT_EQ(after.heap_fallbacks, before.heap_fallbacks + 1);
+
+    allocator.deallocate(second, bytes);
+    allocator.deallocate(first, bytes);
+    EXPECT_EQ(allocator.stats().mapped_bytes, before.mapped_bytes);
+}
+
+TEST_F(LargeTableTest, UnknownModesAreRejected) {
+    auto config = config_;
+    config.huge_pages = "always";
+    EXPECT_TRUE(LargeTableAllocator::instance().configure(config).is_error());
+
+    config = config_;
+    config.numa_policy = "spread";
+    EXPECT_TRUE(LargeTableAllocator::instance().configure(config).is_error());
+}
+
+TEST_F(LargeTableTest, StdAllocatorBacksContainers) {
+    auto& allocator = LargeTableAllocator::instance();
+    const auto before = allocator.stats();
+    {
+        std::vector<uint64_t, LargeTableStdAllocator<uint64_t>> table(
+            LargeTableAllocator::kMinMappedBytes / sizeof(uint64_t), 0, LargeTableStdAllocator<uint64_t>(0));
+        table.back() = 42;
+        EXPECT_EQ(allocator.stats().tables, before.tables + 1);
+        EXPECT_EQ(table.get_allocator().shard(), 0);
+    }
+    EXPECT_EQ(allocator.stats().tables, before.tables);
+}
+
+} // namespace
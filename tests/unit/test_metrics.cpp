@@ -0,0 +1,109 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Sharded metrics collector: counters, labeled series and shard merge
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "utils/metrics.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dmp;
+
+namespace {
+
+uint64_t labeled_value(const MetricsSnapshot& snapshot, MetricFamily family,
+                       const std::vector<std::string>& labels) {
+    for (const auto& series : snapshot.labeled) {
+        if (series.family == family && series.label_values == labels) {
+            return series.value;
+        }
+    }
+    return 0;
+}
+
+class MetricsTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        ASSERT_TRUE(MetricsCollector::instance().initialize(0).is_success());
+    }
+};
+
+TEST_F(MetricsTest, LabeledSeriesAreKeptApart) {
+    auto& metrics = MetricsCollector::instance();
+    const auto before = metrics.snapshot();
+
+    for (int i = 0; i < 3; ++i) {
+        metrics.record_error("timeout", "cache");
+    }
+    metrics.record_error("timeout", "model");
+    // Same bytes split differently across labels must be a different series
+    metrics.record_error("timeoutc", "ache");
+
+    const auto after = metrics.snapshot();
+    EXPECT_EQ(labeled_value(after, MetricFamily::ERRORS, {"timeout", "cache"}) -
+              labeled_value(before, MetricFamily::ERRORS, {"timeout", "cache"}), 3u);
+    EXPECT_EQ(labeled_value(after, MetricFamily::ERRORS, {"timeout", "model"}) -
+              labeled_value(before, MetricFamily::ERRORS, {"timeout", "model"}), 1u);
+    EXPECT_EQ(labeled_value(after, MetricFamily::ERRORS, {"timeoutc", "ache"}) -
+              labeled_value(before, MetricFamily::ERRORS, {"timeoutc", "ache"}), 1u);
+    EXPECT_EQ(after.counter(MetricCounter::ERRORS) - before.counter(MetricCounter::ERRORS), 5u);
+}
+
+TEST_F(MetricsTest, CrowdedCacheStillCountsEverySeries) {
+    // Far more label sets than a probe window holds: every observation must
+    // still land on its own series, whether served from cache or registry
+    auto& metrics = MetricsCollector::instance();
+    constexpr int kSeries = 200;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < kSeries; ++i) {
+            metrics.record_ml_inference("model_" + std::to_string(i), 0.1, 0.5f);
+        }
+    }
+
+    const auto snapshot = metrics.snapshot();
+    for (int i = 0; i < kSeries; ++i) {
+        EXPECT_EQ(labeled_value(snapshot, MetricFamily::ML_INFERENCES, {"model_" + std::to_string(i)}), 3u)
+            << "model_" << i;
+    }
+}
+
+TEST_F(MetricsTest, FullLabelTableOverflows) {
+    auto& metrics = MetricsCollector::instance();
+    const auto before = metrics.snapshot();
+
+    for (size_t i = 0; i < MetricsCollector::kMaxLabeledSeries + 16; ++i) {
+        metrics.record_operation("overflow_op_" + std::to_string(i), 1.0);
+    }
+
+    const auto after = metrics.snapshot();
+    EXPECT_GT(labeled_value(after, MetricFamily::LABEL_OVERFLOW, {}),
+              labeled_value(before, MetricFamily::LABEL_OVERFLOW, {}));
+}
+
+TEST_F(MetricsTest, ShardsOfExitedThreadsStayCounted) {
+    auto& metrics = MetricsCollector::instance();
+    const auto before = metrics.snapshot();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&metrics] {
+            for (int i = 0; i < 100; ++i) {
+                metrics.record_decision(Decision::APPROVE, 10.0f, 0.5);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto after = metrics.snapshot();
+    EXPECT_EQ(after.counter(MetricCounter::DECISIONS_APPROVE) -
+              before.counter(MetricCounter::DECISIONS_APPROVE), 400u);
+    EXPECT_EQ(after.latency(PipelineStage::DECISION).count() -
+              before.latency(PipelineStage::DECISION).count(), 400u);
+}
+
+} // namespace
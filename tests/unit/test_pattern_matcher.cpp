@@ -0,0 +1,83 @@
+/**
+ * @file test_pattern_matcher.cpp
+ * @brief Pattern matcher: CIDR conversion, matching, shipped pattern files and statistics
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "engine/pattern_matcher.hpp"
+#include <regex>
+#include <string>
+
+using namespace dmp;
+
+namespace {
+
+bool cidr_matches(const std::string& cidr, const std::string& ip) {
+    auto regex = PatternUtils::cidr_to_regex(cidr);
+    EXPECT_TRUE(regex.is_success()) << regex.error_message;
+    return std::regex_match(ip, std::regex(regex.value));
+}
+
+TEST(PatternMatcherTest, CidrPrefixesMatchTheirRange) {
+    EXPECT_TRUE(cidr_matches("10.0.0.0/24", "10.0.0.7"));
+    EXPECT_FALSE(cidr_matches("10.0.0.0/24", "10.0.1.7"));
+    EXPECT_TRUE(cidr_matches("192.168.0.0/16", "192.168.42.1"));
+    EXPECT_FALSE(cidr_matches("192.168.0.0/16", "192.169.42.1"));
+    EXPECT_TRUE(cidr_matches("172.0.0.0/8", "172.31.0.1"));
+}
+
+TEST(PatternMatcherTest, CidrDotsAreLiteral) {
+    EXPECT_EQ(PatternUtils::cidr_to_regex("10.0.0.0/24").value, "^10\\.0\\.0\\.\\d{1,3}$");
+    EXPECT_FALSE(cidr_matches("10.0.0.0/24", "10a0b0.7"));
+    EXPECT_FALSE(cidr_matches("192.168.0.0/16", "192x168.1.1"));
+}
+
+TEST(PatternMatcherTest, MalformedCidrIsRejected) {
+    EXPECT_TRUE(PatternUtils::cidr_to_regex("10.0.0.0").is_error());
+    EXPECT_TRUE(PatternUtils::cidr_to_regex("10.0.0.0/33").is_error());
+    EXPECT_TRUE(PatternUtils::cidr_to_regex("10.0.0.0/x").is_error());
+}
+
+TEST(PatternMatcherTest, CidrPatternsBlockAddressesInRange) {
+    PatternMatcher matcher;
+    auto regex = PatternUtils::cidr_to_regex("203.0.113.0/24");
+    ASSERT_TRUE(regex.is_success());
+    Pattern pattern(1, "test_net_3", regex.value, "ip_blacklist");
+    pattern.is_regex = true;
+    ASSERT_TRUE(matcher.add_pattern(pattern).is_success());
+    ASSERT_TRUE(matcher.compile_patterns().is_success());
+
+    EXPECT_TRUE(matcher.match_text("203.0.113.9").has_blacklist_matches());
+    EXPECT_FALSE(matcher.match_text("203.0.114.9").has_blacklist_matches());
+    EXPECT_FALSE(matcher.match_text("203a0b113.9").has_blacklist_matches());
+}
+
+#ifdef DMP_SOURCE_DIR
+TEST(PatternMatcherTest, ShippedBlocklistCompilesOnStdRegex) {
+    // Its CIDR entries once became back-references and failed to compile
+    PatternMatcher matcher(PatternMatcher::Backend::STD_REGEX);
+    auto loaded = matcher.load_patterns(std::string(DMP_SOURCE_DIR) + "/data/blocklist.txt",
+                                        std::string(DMP_SOURCE_DIR) + "/data/whitelist.txt");
+    ASSERT_TRUE(loaded.is_success()) << loaded.error_message;
+    auto compiled = matcher.compile_patterns();
+    ASSERT_TRUE(compiled.is_success()) << compiled.error_message;
+
+    EXPECT_TRUE(matcher.match_text("192.168.100.23").has_blacklist_matches());
+    EXPECT_FALSE(matcher.match_text("192.168.101.23").has_blacklist_matches());
+}
+#endif
+
+TEST(PatternMatcherTest, ResetStatisticsClearsMatchCounters) {
+    PatternMatcher matcher;
+    ASSERT_TRUE(matcher.add_pattern(Pattern(1, "fraud", "MERCH_FRAUD_*", "blacklist")).is_success());
+    ASSERT_TRUE(matcher.compile_patterns().is_success());
+    matcher.match_text("MERCH_FRAUD_001");
+    matcher.match_text("MERCH_00042");
+    ASSERT_EQ(matcher.get_statistics().at("match_count"), 2u);
+
+    matcher.reset_statistics();
+    EXPECT_EQ(matcher.get_statistics().at("match_count"), 0u);
+}
+
+} // namespace
@@ -0,0 +1,183 @@
+/**
+ * @file test_perf_log.cpp
+ * @brief Binary performance log: write/read round trip and lifecycle
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "utils/perf_log.hpp"
+#include "utils/tracing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+
+using namespace dmp;
+
+namespace {
+
+class PerfLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() /
+               ("dmp_perf_log_test_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(dir_);
+        config_.enabled = true;
+        config_.directory = dir_.string();
+        config_.queue_capacity = 1024;
+    }
+
+    void TearDown() override {
+        PerfLog::instance().stop();
+        std::filesystem::remove_all(dir_);
+    }
+
+    std::vector<PerfRecord> read_all() const {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::directory_iterator(dir_)) {
+            files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+        std::vector<PerfRecord> records;
+        for (const auto& file : files) {
+            auto result = PerfLog::read_file(file.string());
+            EXPECT_TRUE(result.is_success()) << result.error_message;
+            records.insert(records.end(), result.value.begin(), result.value.end());
+        }
+        return records;
+    }
+
+    std::filesystem::path dir_;
+    PerfLogConfig config_;
+};
+
+TEST_F(PerfLogTest, RecordsRoundTrip) {
+    auto& log = PerfLog::instance();
+    ASSERT_TRUE(log.configure(config_).is_success());
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        PerfRecord record;
+        record.timestamp_ns = 1000 + i;
+        record.trace_low = i;
+        record.stage_ns[static_cast<size_t>(PipelineStage::DECISION)] = 5000 + i;
+        record.queue_wait_ns = i;
+        record.decision = static_cast<uint8_t>(i % 3);
+        record.flags = i % 10 == 0 ? PerfRecord::kError : 0;
+        log.submit(record);
+    }
+    log.stop();
+
+    const auto records = read_all();
+    ASSERT_EQ(records.size(), 100u);
+    for (uint32_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(records[i].timestamp_ns, 1000u + i);
+        EXPECT_EQ(records[i].trace_low, i);
+        EXPECT_EQ(records[i].stage(PipelineStage::DECISION), 5000u + i);
+        EXPECT_EQ(records[i].queue_wait_ns, i);
+        EXPECT_EQ(records[i].decision, i % 3);
+        EXPECT_EQ(records[i].flags, i % 10 == 0 ? PerfRecord::kError : 0);
+    }
+}
+
+TEST_F(PerfLogTest, StreamingReadVisitsEveryRecord) {
+    auto& log = PerfLog::instance();
+    const uint64_t written_before = log.written();
+    const uint64_t dropped_before = log.dropped();
+    ASSERT_TRUE(log.configure(config_).is_success());
+    for (int i = 0; i < 3000; ++i) {
+        PerfRecord record;
+        record.timestamp_ns = static_cast<uint64_t>(i);
+        log.submit(record);
+        if (i % 500 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));  // Let the writer keep up
+        }
+    }
+    log.stop();
+
+    size_t visited = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir_)) {
+        auto result = PerfLog::read_file(entry.path().string(), [&](const PerfRecord& record) {
+            EXPECT_LT(record.timestamp_ns, 3000u);
+            ++visited;
+        });
+        ASSERT_TRUE(result.is_success()) << result.error_message;
+    }
+    EXPECT_EQ(visited, log.written() - written_before);
+    EXPECT_EQ(visited + log.dropped() - dropped_before, 3000u);
+}
+
+TEST_F(PerfLogTest, RotationNeverOverwritesAnExistingFile) {
+    // Occupy every name the writer could pick in the next second
+    std::filesystem::create_directories(dir_);
+    const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (int64_t ms = now_ms; ms < now_ms + 1000; ++ms) {
+        std::FILE* file = std::fopen((dir_ / ("dmp_perf_" + std::to_string(ms) + ".bin")).c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fputs("earlier file", file);
+        std::fclose(file);
+    }
+
+    config_.max_files = 2000;
+    auto& log = PerfLog::instance();
+    ASSERT_TRUE(log.configure(config_).is_success());
+    PerfRecord record;
+    record.timestamp_ns = 42;
+    log.submit(record);
+    log.stop();
+
+    size_t earlier = 0;
+    std::vector<PerfRecord> records;
+    for (const auto& entry : std::filesystem::directory_iterator(dir_)) {
+        auto result = PerfLog::read_file(entry.path().string());
+        if (result.is_error()) {
+            EXPECT_EQ(entry.file_size(), 12u) << entry.path();
+            ++earlier;
+        } else {
+            records.insert(records.end(), result.value.begin(), result.value.end());
+        }
+    }
+    EXPECT_EQ(earlier, 1000u);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].timestamp_ns, 42u);
+}
+
+TEST_F(PerfLogTest, RejectsForeignFiles) {
+    std::filesystem::create_directories(dir_);
+    const auto path = dir_ / "dmp_perf_0.bin";
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("not a perf log at all, just some text", file);
+    std::fclose(file);
+
+    EXPECT_TRUE(PerfLog::read_file(path.string()).is_error());
+    EXPECT_TRUE(PerfLog::read_file((dir_ / "missing.bin").string()).is_error());
+}
+
+TEST_F(PerfLogTest, ReconfigureWhileRunningIsRefused) {
+    auto& log = PerfLog::instance();
+    ASSERT_TRUE(log.configure(config_).is_success());
+    EXPECT_TRUE(log.configure(config_).is_error());
+    log.stop();
+    EXPECT_TRUE(log.configure(config_).is_success());
+}
+
+TEST_F(PerfLogTest, SpanDurationsAreNanosecondsWithoutTracingConfigured) {
+    auto& log = PerfLog::instance();
+    ASSERT_TRUE(log.configure(config_).is_success());
+    {
+        TraceRequestScope request;
+        DMP_TRACE_SPAN(PipelineStage::DECISION);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    log.stop();
+
+    const auto records = read_all();
+    ASSERT_EQ(records.size(), 1u);
+    const uint32_t decision_ns = records[0].stage(PipelineStage::DECISION);
+    EXPECT_GE(decision_ns, 1500000u);
+    EXPECT_LT(decision_ns, 500000000u);
+}
+
+} // namespace
@@ -0,0 +1,155 @@
+/**
+ * @file test_prometheus_exporter.cpp
+ * @brief Prometheus text exposition format of merged metrics and admin route methods
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "utils/metrics.hpp"
+#include "utils/prometheus_exporter.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <sstream>
+#include <string>
+
+using namespace dmp;
+
+namespace {
+
+/**
+ * @brief Value of the first sample line starting with a given series prefix
+ */
+std::string sample(const std::string& body, const std::string& series) {
+    std::istringstream lines(body);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, series.size() + 1, series + " ") == 0) {
+            return line.substr(series.size() + 1);
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief Status line of one request against a local listener
+ */
+std::string status_line(uint16_t port, const std::string& method, const std::string& target) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return {};
+    }
+    const std::string request = method + " " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    ::send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buffer[512];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return response.substr(0, response.find("\r\n"));
+}
+
+class PrometheusExporterTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        ASSERT_TRUE(MetricsCollector::instance().initialize(0).is_success());
+    }
+};
+
+TEST_F(PrometheusExporterTest, CountersHaveHelpAndType) {
+    MetricsCollector::instance().record_http_request("POST", "/api/v1/decision", 200, 1.0);
+
+    PrometheusExporter exporter(MetricsCollector::instance());
+    const std::string body = exporter.render();
+
+    EXPECT_NE(body.find("# HELP dmp_http_requests_total "), std::string::npos);
+    EXPECT_NE(body.find("# TYPE dmp_http_requests_total counter\n"), std::string::npos);
+    EXPECT_EQ(sample(body, R"(dmp_http_requests_total{method="POST",path="/api/v1/decision",status="200"})"), "1");
+}
+
+TEST_F(PrometheusExporterTest, LabelValuesAreEscaped) {
+    MetricsCollector::instance().record_error("bad \"quote\"\\", "line\nbreak");
+
+    PrometheusExporter exporter(MetricsCollector::instance());
+    const std::string body = exporter.render();
+
+    EXPECT_EQ(sample(body, R"(dmp_errors_total{type="bad \"quote\"\\",component="line\nbreak"})"), "1");
+}
+
+TEST_F(PrometheusExporterTest, HistogramBucketsRespectLe) {
+    auto& metrics = MetricsCollector::instance();
+    metrics.record_stage_latency(PipelineStage::MODEL_INFERENCE, 999000);
+    metrics.record_stage_latency(PipelineStage::MODEL_INFERENCE, 1001000);
+    metrics.record_stage_latency(PipelineStage::MODEL_INFERENCE, 3000000);
+
+    PrometheusExporter exporter(metrics);
+    const std::string body = exporter.render();
+    const std::string bucket = R"(dmp_stage_latency_seconds_bucket{stage="model_inference",le=")";
+
+    EXPECT_NE(body.find("# TYPE dmp_stage_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_EQ(sample(body, bucket + R"(0.0005"})"), "0");
+    // 1.001ms shares a bucket with 1ms but must not be counted as <= 1ms
+    EXPECT_EQ(sample(body, bucket + R"(0.001"})"), "1");
+    EXPECT_EQ(sample(body, bucket + R"(0.0025"})"), "2");
+    EXPECT_EQ(sample(body, bucket + R"(0.005"})"), "3");
+    EXPECT_EQ(sample(body, bucket + R"(+Inf"})"), "3");
+    EXPECT_EQ(sample(body, R"(dmp_stage_latency_seconds_count{stage="model_inference"})"), "3");
+    EXPECT_EQ(sample(body, R"(dmp_stage_latency_seconds_sum{stage="model_inference"})"), "0.005");
+}
+
+TEST_F(PrometheusExporterTest, CallbackGaugesAreRendered) {
+    auto& metrics = MetricsCollector::instance();
+    metrics.register_gauge("dmp_test_gauge", "Gauge registered by the test", [] { return 42.5; });
+
+    PrometheusExporter exporter(metrics);
+    const std::string body = exporter.render();
+    metrics.unregister_gauge("dmp_test_gauge");
+
+    EXPECT_NE(body.find("# HELP dmp_test_gauge Gauge registered by the test\n"), std::string::npos);
+    EXPECT_EQ(sample(body, "dmp_test_gauge"), "42.5");
+}
+
+TEST_F(PrometheusExporterTest, CallbackCountersAreTypedCounter) {
+    auto& metrics = MetricsCollector::instance();
+    metrics.register_counter("dmp_test_events_total", "Counter registered by the test", [] { return 7.0; });
+
+    PrometheusExporter exporter(metrics);
+    const std::string body = exporter.render();
+    metrics.unregister_gauge("dmp_test_events_total");
+
+    EXPECT_NE(body.find("# TYPE dmp_test_events_total counter\n"), std::string::npos);
+    EXPECT_EQ(sample(body, "dmp_test_events_total"), "7");
+}
+
+TEST_F(PrometheusExporterTest, RoutesAreMatchedByMethod) {
+    PrometheusExporter exporter(MetricsCollector::instance());
+    int actions = 0;
+    exporter.add_status_route("/debug/action", [](const std::string&) {
+        return PrometheusExporter::RouteResponse{200, "status\n"};
+    });
+    exporter.add_post_route("/debug/action", [&actions](const std::string&) {
+        ++actions;
+        return PrometheusExporter::RouteResponse{409, "busy\n"};
+    });
+    ASSERT_TRUE(exporter.start(0, "/metrics").is_success());
+    const uint16_t port = exporter.bound_port();
+
+    EXPECT_EQ(status_line(port, "GET", "/debug/action"), "HTTP/1.1 200 OK");
+    EXPECT_EQ(actions, 0);
+    EXPECT_EQ(status_line(port, "POST", "/debug/action?go=1"), "HTTP/1.1 409 Conflict");
+    EXPECT_EQ(actions, 1);
+    EXPECT_EQ(status_line(port, "POST", "/metrics"), "HTTP/1.1 405 Method Not Allowed");
+    EXPECT_EQ(status_line(port, "DELETE", "/debug/action"), "HTTP/1.1 405 Method Not Allowed");
+    EXPECT_EQ(status_line(port, "POST", "/missing"), "HTTP/1.1 404 Not Found");
+    exporter.stop();
+}
+
+} // namespace
@@ -0,0 +1,178 @@
+/**
+ * @file test_reload_coordinator.cpp
+ * @brief Reload coordinator: generation publishing, pinning and moved sources
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "core/reload_coordinator.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+using namespace dmp;
+
+namespace {
+
+const char* kRules = R"({
+  "version": "v1",
+  "rules": [
+    {"id": "RULE_HIGH_AMOUNT", "name": "high amount", "expression": "amount > 10000",
+     "weight": 20.0, "enabled": true}
+  ]
+})";
+
+const char* kModels = R"([primary_model]
+name = "fraud_detector"
+path = "models/fraud.onnx"
+weight = 1.0
+)";
+
+class ReloadCoordinatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() /
+               ("dmp_reload_test_" + std::to_string(::getpid()));
+        std::filesystem::create_directories(dir_);
+        write("rules.json", kRules);
+        write("rules_moved.json", kRules);
+        write("blocklist.txt", "MERCH_FRAUD_001\n");
+        write("whitelist.txt", "MERCH_TRUSTED_001\n");
+        write("models.toml", kModels);
+        write_server("rules.json");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+
+    /**
+     * @brief Write a file with a distinct, already settled modification time
+     */
+    void write(const std::string& name, const std::string& content) {
+        const auto path = dir_ / name;
+        std::ofstream(path, std::ios::trunc) << content;
+        std::filesystem::last_write_time(
+            path, std::filesystem::file_time_type::clock::now() - std::chrono::hours(1) +
+                      std::chrono::seconds(++writes_));
+    }
+
+    void write_server(const std::string& rules_name) {
+        write("server.toml", "[reload]\n"
+                             "rules_path = \"" + path(rules_name) + "\"\n"
+                             "blacklist_path = \"" + path("blocklist.txt") + "\"\n"
+                             "whitelist_path = \"" + path("whitelist.txt") + "\"\n"
+                             "models_path = \"" + path("models.toml") + "\"\n");
+    }
+
+    std::string path(const std::string& name) const {
+        return (dir_ / name).string();
+    }
+
+    ReloadSources sources() {
+        auto config = SystemConfig::load_from_file(path("server.toml"));
+        EXPECT_TRUE(config.is_success()) << config.error_message;
+        return ReloadSources::from_config(path("server.toml"), config.value->get_reload_config());
+    }
+
+    std::filesystem::path dir_;
+    int writes_ = 0;
+};
+
+TEST_F(ReloadCoordinatorTest, InitialLoadPublishesGenerationOne) {
+    ReloadCoordinator coordinator(sources(), 0);
+    ASSERT_TRUE(coordinator.load_initial().is_success());
+
+    const auto generation = coordinator.current();
+    EXPECT_EQ(generation->id, 1u);
+    EXPECT_TRUE(generation->system_config);
+    EXPECT_TRUE(generation->rule_engine);
+    EXPECT_TRUE(generation->pattern_matcher);
+    EXPECT_TRUE(generation->models);
+
+    auto unchanged = coordinator.reload_now();
+    ASSERT_TRUE(unchanged.is_success());
+    EXPECT_FALSE(unchanged.value);
+}
+
+TEST_F(ReloadCoordinatorTest, PinnedGenerationSurvivesReload) {
+    ReloadCoordinator coordinator(sources(), 0);
+    ASSERT_TRUE(coordinator.load_initial().is_success());
+    const auto pinned = coordinator.current();
+
+    write("rules.json", kRules);
+    auto reloaded = coordinator.reload_now();
+    ASSERT_TRUE(reloaded.is_success()) << reloaded.error_message;
+    EXPECT_TRUE(reloaded.value);
+
+    const auto current = coordinator.current();
+    EXPECT_EQ(current->id, 2u);
+    EXPECT_EQ(pinned->id, 1u);
+    EXPECT_NE(current->rule_engine, pinned->rule_engine);
+    // Unchanged artifacts are shared, not restaged
+    EXPECT_EQ(current->pattern_matcher, pinned->pattern_matcher);
+    EXPECT_EQ(current->system_config, pinned->system_config);
+}
+
+TEST_F(ReloadCoordinatorTest, RejectedReloadKeepsCurrentGeneration) {
+    ReloadCoordinator coordinator(sources(), 0);
+    ASSERT_TRUE(coordinator.load_initial().is_success());
+
+    write("rules.json", "{ not json");
+    EXPECT_TRUE(coordinator.reload_now().is_error());
+    EXPECT_EQ(coordinator.current()->id, 1u);
+    EXPECT_EQ(coordinator.failures(), 1u);
+
+    // The same broken files are not retried
+    auto retried = coordinator.reload_now();
+    ASSERT_TRUE(retried.is_success());
+    EXPECT_FALSE(retried.value);
+    EXPECT_EQ(coordinator.failures(), 1u);
+}
+
+TEST_F(ReloadCoordinatorTest, FollowsMovedRulesPath) {
+    ReloadCoordinator coordinator(sources(), 0);
+    ASSERT_TRUE(coordinator.load_initial().is_success());
+    const auto before = coordinator.current();
+
+    write_server("rules_moved.json");
+    auto moved = coordinator.reload_now();
+    ASSERT_TRUE(moved.is_success()) << moved.error_message;
+    EXPECT_TRUE(moved.value);
+    EXPECT_NE(coordinator.current()->rule_engine, before->rule_engine);
+
+    // The old file is no longer watched, the new one is
+    write("rules.json", "{ not json");
+    auto ignored = coordinator.reload_now();
+    ASSERT_TRUE(ignored.is_success());
+    EXPECT_FALSE(ignored.value);
+
+    write("rules_moved.json", kRules);
+    auto followed = coordinator.reload_now();
+    ASSERT_TRUE(followed.is_success()) << followed.error_message;
+    EXPECT_TRUE(followed.value);
+    EXPECT_EQ(coordinator.current()->id, 3u);
+}
+
+TEST_F(ReloadCoordinatorTest, ConstructorOverridesSurviveConfigReload) {
+    auto overridden = sources();
+    overridden.rules_path = path("rules_moved.json");
+    ReloadCoordinator coordinator(overridden, 0);
+    ASSERT_TRUE(coordinator.load_initial().is_success());
+
+    // Reloading server.toml with an unchanged rules_path keeps watching the override
+    write("server.toml", "[reload]\n"
+                         "rules_path = \"" + path("rules.json") + "\"\n"
+                         "blacklist_path = \"" + path("blocklist.txt") + "\"\n"
+                         "whitelist_path = \"" + path("whitelist.txt") + "\"\n"
+                         "models_path = \"" + path("models.toml") + "\"\n"
+                         "settle_ms = 0\n");
+    ASSERT_TRUE(coordinator.reload_now().is_success());
+    write("rules.json", "{ not json");
+    auto ignored = coordinator.reload_now();
+    ASSERT_TRUE(ignored.is_success());
+    EXPECT_FALSE(ignored.value);
+}
+
+} // namespace
@@ -0,0 +1,72 @@
+/**
+ * @file test_structured_log.cpp
+ * @brief Structured event formatting and formatter thread lifecycle
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "utils/structured_log.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dmp;
+
+namespace {
+
+std::string format(const LogEventSite& site, std::initializer_list<LogField> fields) {
+    LogRecord record;
+    record.site = &site;
+    for (const auto& field : fields) {
+        record.fields[record.field_count++] = field;
+    }
+    fmt::memory_buffer out;
+    StructuredLogger::format_record(record, out);
+    return std::string(out.data(), out.size());
+}
+
+const LogEventSite kSite{"decision", spdlog::level::info, {}};
+
+TEST(StructuredLogTest, FormatsFieldsByType) {
+    EXPECT_EQ(format(kSite, {kv("rules", 3), kv("bytes", 42u), kv("ok", true), kv("id", "MERCH_1")}),
+              "decision rules=3 bytes=42 ok=true id=MERCH_1");
+}
+
+TEST(StructuredLogTest, DoublesKeepFullPrecision) {
+    EXPECT_EQ(format(kSite, {kv("score", 0.0001234), kv("amount", 12.5)}),
+              "decision score=0.0001234 amount=12.5");
+}
+
+TEST(StructuredLogTest, QuotesAndTruncatesText) {
+    EXPECT_EQ(format(kSite, {kv("note", "a b\"c")}), R"(decision note="a b\"c")");
+    const std::string long_text(LogField::kInlineText + 10, 'x');
+    EXPECT_EQ(format(kSite, {kv("long", long_text)}),
+              "decision long=\"" + std::string(LogField::kInlineText, 'x') + "...\"");
+}
+
+TEST(StructuredLogTest, RestartWhileEmittingIsSafe) {
+    auto& logger = StructuredLogger::instance();
+    std::atomic<bool> done{false};
+    std::vector<std::thread> emitters;
+    for (int t = 0; t < 4; ++t) {
+        emitters.emplace_back([&done, &logger] {
+            while (!done.load()) {
+                logger.emit(kSite, {kv("n", 1)});
+            }
+        });
+    }
+    for (int cycle = 0; cycle < 50; ++cycle) {
+        logger.start(64);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        logger.stop();
+    }
+    done.store(true);
+    for (auto& emitter : emitters) {
+        emitter.join();
+    }
+    logger.stop();
+    SUCCEED();
+}
+
+} // namespace
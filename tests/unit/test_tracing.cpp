@@ -0,0 +1,182 @@
+/**
+ * @file test_tracing.cpp
+ * @brief Trace id formatting, trace context scoping and span exports
+ * @author Stan Jiang
+ * @date 2025-09-16
+ */
+#include <gtest/gtest.h>
+#include "utils/logger.hpp"
+#include "utils/trace_id.hpp"
+#include "utils/tracing.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace dmp;
+
+namespace {
+
+/**
+ * @brief All values of a quoted string field in a JSON text
+ */
+std::vector<std::string> field_values(const std::string& json, const std::string& key) {
+    std::vector<std::string> values;
+    const std::string needle = "\"" + key + "\":\"";
+    for (size_t pos = json.find(needle); pos != std::string::npos; pos = json.find(needle, pos)) {
+        pos += needle.size();
+        values.push_back(json.substr(pos, json.find('"', pos) - pos));
+    }
+    return values;
+}
+
+std::string read_file(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+TEST(TraceIdTest, FormatsAs32LowercaseHexDigits) {
+    TraceId id{0x0123456789abcdefULL, 0xfedcba9876543210ULL};
+    EXPECT_EQ(id.to_string(), "0123456789abcdeffedcba9876543210");
+
+    char buffer[TraceId::kHexLength + 1] = {};
+    TraceId{0, 1}.format_to(buffer);
+    EXPECT_STREQ(buffer, "00000000000000000000000000000001");
+
+    EXPECT_EQ(TraceId{}.to_string(), "");
+}
+
+TEST(TraceIdTest, ParsesWhatItFormats) {
+    for (int i = 0; i < 100; ++i) {
+        TraceId id = TraceId::generate();
+        ASSERT_FALSE(id.empty());
+        EXPECT_EQ(TraceId::from_hex(id.to_string()), id);
+    }
+    EXPECT_EQ(TraceId::from_hex("0123456789ABCDEFFEDCBA9876543210"),
+              (TraceId{0x0123456789abcdefULL, 0xfedcba9876543210ULL}));
+}
+
+TEST(TraceIdTest, RejectsMalformedHex) {
+    EXPECT_TRUE(TraceId::from_hex("").empty());
+    EXPECT_TRUE(TraceId::from_hex("0123").empty());
+    EXPECT_TRUE(TraceId::from_hex("0123456789abcdefXedcba9876543210").empty());
+    EXPECT_TRUE(TraceId::from_hex("0123456789abcdeffedcba98765432100").empty());
+}
+
+TEST(TraceIdTest, GeneratedIdsAreDistinct) {
+    std::set<std::pair<uint64_t, uint64_t>> seen;
+    for (int i = 0; i < 10000; ++i) {
+        TraceId id = TraceId::generate();
+        EXPECT_TRUE(seen.emplace(id.high, id.low).second);
+    }
+}
+
+TEST(TraceScopeTest, NestedScopesRestoreOuterId) {
+    TraceContext::clear();
+    {
+        TraceScope outer;
+        const TraceId outer_id = TraceContext::current();
+        EXPECT_FALSE(outer_id.empty());
+        EXPECT_EQ(outer.get_trace_id(), outer_id);
+        {
+            TraceScope inner(TraceId{1, 2});
+            EXPECT_EQ(TraceContext::current(), (TraceId{1, 2}));
+        }
+        EXPECT_EQ(TraceContext::current(), outer_id);
+    }
+    EXPECT_TRUE(TraceContext::current().empty());
+}
+
+TEST(TracerTest, ExportsCarryTraceAndRequestIds) {
+    TracingConfig config;
+    config.enabled = true;
+    config.sample_rate = 1.0;
+    auto& tracer = Tracer::instance();
+    tracer.configure(config);
+
+    const TraceId first{0x1111, 0x2222};
+    const TraceId second{0x3333, 0x4444};
+    for (const auto& [trace_id, request_id] : {std::make_pair(first, "req-1"), std::make_pair(second, "req-2")}) {
+        TraceScope scope(trace_id);
+        TraceRequestScope request;
+        tracer.set_request_id(request_id);
+        DMP_TRACE_SPAN(PipelineStage::DECISION);
+    }
+
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("dmp_tracing_test_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    ASSERT_TRUE(tracer.export_to_file(TraceExportFormat::CHROME, (dir / "t.chrome.json").string()).is_success());
+    ASSERT_TRUE(tracer.export_to_file(TraceExportFormat::OTLP_JSON, (dir / "t.otlp.json").string()).is_success());
+    const std::string chrome = read_file(dir / "t.chrome.json");
+    const std::string otlp = read_file(dir / "t.otlp.json");
+    std::filesystem::remove_all(dir);
+
+    const auto trace_ids = field_values(chrome, "trace_id");
+    const auto request_ids = field_values(chrome, "request_id");
+    ASSERT_EQ(trace_ids.size(), 2u);
+    ASSERT_EQ(request_ids.size(), 2u);
+    EXPECT_EQ(trace_ids[0], first.to_string());
+    EXPECT_EQ(trace_ids[1], second.to_string());
+    EXPECT_EQ(request_ids[0].size(), 16u);
+    EXPECT_NE(request_ids[0], "0000000000000000");
+    EXPECT_NE(request_ids[0], request_ids[1]);
+
+    EXPECT_EQ(field_values(otlp, "traceId"), trace_ids);
+    EXPECT_NE(otlp.find("{\"key\":\"dmp.request_id\",\"value\":{\"stringValue\":\"" + request_ids[0] + "\"}}"),
+              std::string::npos);
+}
+
+TEST(TracerTest, CollectDropsSpansOverwrittenDuringCopy) {
+    TracingConfig config;
+    config.enabled = true;
+    config.sample_rate = 1.0;
+    config.ring_buffer_spans = 64;
+    auto& tracer = Tracer::instance();
+    tracer.configure(config);
+
+    // Each request fills a whole batch of spans whose fields all derive
+    // from the request number, so mixed or partial batches are detectable
+    constexpr uint64_t kMarker = 0x7e57;
+    constexpr uint64_t kSpans = 32;
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        for (uint64_t n = 1; !stop.load(std::memory_order_relaxed); ++n) {
+            TraceScope scope(TraceId{kMarker, n});
+            tracer.begin_request();
+            for (uint64_t i = 0; i < kSpans; ++i) {
+                tracer.record_span(PipelineStage::DECISION, n * kSpans + i, n * kSpans + i + 1);
+            }
+            tracer.end_request();
+        }
+    });
+
+    size_t checked = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::map<uint64_t, uint64_t> spans_per_request;
+        for (const auto& span : tracer.collect()) {
+            if (span.trace_id.high != kMarker) continue;
+            ASSERT_EQ(span.start_tsc / kSpans, span.trace_id.low);
+            ASSERT_EQ(span.end_tsc, span.start_tsc + 1);
+            ++spans_per_request[span.trace_id.low];
+            ++checked;
+        }
+        // Requests are written whole, so a partial one is a stale or torn copy
+        for (const auto& [request, count] : spans_per_request) {
+            ASSERT_EQ(count, kSpans) << "request " << request;
+        }
+    }
+    stop.store(true);
+    writer.join();
+    EXPECT_GT(checked, 0u);
+}
+
+} // namespace
@@ -0,0 +1,745 @@
+/**
+ * @file dmp_cachesim.cpp
+ * @brief Cache policy simulator replaying recorded key traces
+ * @author Stan Jiang
+ * @date 2025-09-17
+ *
+ * Usage:
+ *   dmp_cachesim [--policies LIST] [--sizes N,...] [--sizes-mb MB,...]
+ *                [--value-bytes N] [--field NAME] [--csv]
+ *                [--synthetic N [--repeat-ratio R] [--seed N]] [TRACE...]
+ *
+ * Replays a trace of cache keys against LRU, CLOCK, W-TinyLFU and S3-FIFO
+ * at several sizes and prints the hit ratio curve of each policy, so the
+ * FeatureConfig L1/L2 sizes can be chosen from real traffic.
+ *
+ * TRACE is a file ('-' for stdin) with one key per line, or a server log:
+ * lines carrying NAME=value or "NAME":"value" (NAME defaults to key_hash,
+ * as in the server's trace-level "feature_cache_key key_hash=..." event,
+ * which logs a hash rather than the key itself) yield that value, other
+ * lines are used whole if they contain no spaces and skipped otherwise. --synthetic generates keys with TransactionRequest::get_cache_key
+ * over the load generator's transaction mix instead.
+ *
+ * --sizes gives capacities in entries (default: 0.5% to 100% of the
+ * distinct keys); --sizes-mb gives memory budgets instead, converted to
+ * entries per policy with the estimated per-entry footprint (key + value
+ * of --value-bytes + the policy's own bookkeeping), so policies are
+ * compared at equal memory. Exit status is 0 on success and 2 on errors.
+ */
+#include "core/transaction_generator.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace dmp;
+
+namespace {
+    constexpr uint32_t kNil = UINT32_MAX;
+    constexpr uint8_t kNoList = 0xFF;
+    constexpr size_t kMinCapacity = 2;
+    constexpr size_t kStringOverhead = 32;  // std::string object holding the key
+    constexpr double kBytesPerMb = 1024.0 * 1024.0;
+
+    const std::array<double, 8> kDefaultSizeFractions = {0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0};
+
+    void usage() {
+        std::fprintf(stderr,
+                     "usage: dmp_cachesim [options] [TRACE...]\n"
+                     "  TRACE                one key per line, or a log with NAME=value fields ('-' = stdin)\n"
+                     "  --policies LIST      comma-separated: lru,clock,w-tinylfu,s3-fifo (default all)\n"
+                     "  --sizes N,...        capacities in entries (default 0.5%%..100%% of distinct keys)\n"
+                     "  --sizes-mb MB,...    capacities as memory budgets, converted per policy\n"
+                     "  --value-bytes N      cached value size for the memory estimate (default 256)\n"
+                     "  --field NAME         key field to extract from log lines (default key_hash)\n"
+                     "  --synthetic N        generate N keys instead of reading a trace\n"
+                     "  --repeat-ratio R     share of returning customers for --synthetic (default 0.3)\n"
+                     "  --seed N             generator seed for --synthetic (default 42)\n"
+                     "  --csv                machine-readable output, one row per policy and size\n");
+    }
+
+    /**
+     * @brief Distinct keys mapped to dense ids, and the access sequence over them
+     */
+    struct Trace {
+        std::unordered_map<std::string, uint32_t> ids;
+        std::vector<uint32_t> accesses;
+        size_t key_bytes = 0;  // Sum over distinct keys
+        size_t skipped_lines = 0;
+
+        void add(std::string_view key) {
+            auto [it, inserted] = ids.try_emplace(std::string(key), static_cast<uint32_t>(ids.size()));
+            if (inserted) {
+                key_bytes += key.size();
+            }
+            accesses.push_back(it->second);
+        }
+
+        size_t distinct() const { return ids.size(); }
+
+        double average_key_bytes() const {
+            return ids.empty() ? 0.0 : static_cast<double>(key_bytes) / static_cast<double>(ids.size());
+        }
+    };
+
+    // ------------------------------------------------------------------
+    // Trace input
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Value of NAME=value (optionally quoted) or "NAME":"value" in a log line
+     */
+    bool extract_field(std::string_view line, const std::string& field, std::string& out) {
+        const std::string assignment = field + "=";
+        for (size_t pos = line.find(assignment); pos != std::string_view::npos;
+             pos = line.find(assignment, pos + 1)) {
+            if (pos > 0 && line[pos - 1] != ' ' && line[pos - 1] != '\t') {
+                continue;  // Suffix of a longer field name
+            }
+            std::string_view rest = line.substr(pos + assignment.size());
+            out.clear();
+            if (!rest.empty() && rest.front() == '"') {
+                for (size_t i = 1; i < rest.size() && rest[i] != '"'; ++i) {
+                    if (rest[i] == '\\' && i + 1 < rest.size()) {
+                        ++i;
+                    }
+                    out += rest[i];
+                }
+            } else {
+                out.assign(rest.substr(0, rest.find_first_of(" \t")));
+            }
+            return true;
+        }
+
+        const std::string json_key = "\"" + field + "\":";
+        size_t pos = line.find(json_key);
+        if (pos == std::string_view::npos) {
+            return false;
+        }
+        std::string_view rest = line.substr(pos + json_key.size());
+        rest.remove_prefix(std::min(rest.find_first_not_of(' '), rest.size()));
+        if (rest.empty() || rest.front() != '"') {
+            return false;
+        }
+        size_t end = rest.find('"', 1);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+        out.assign(rest.substr(1, end - 1));
+        return true;
+    }
+
+    void read_trace(std::istream& in, const std::string& field, Trace& trace) {
+        std::string line;
+        std::string key;
+        while (std::getline(in, line)) {
+            std::string_view view(line);
+            while (!view.empty() && (view.back() == '\r' || view.back() == ' ' || view.back() == '\t')) {
+                view.remove_suffix(1);
+            }
+            view.remove_prefix(std::min(view.find_first_not_of(" \t"), view.size()));
+            if (view.empty()) {
+                continue;
+            }
+            if (extract_field(view, field, key)) {
+                trace.add(key);
+            } else if (view.find_first_of(" \t") == std::string_view::npos) {
+                trace.add(view);
+            } else {
+                ++trace.skipped_lines;
+            }
+        }
+    }
+
+    std::vector<double> parse_list(const std::string& text) {
+        std::vector<double> values;
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t end = text.find(',', start);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            if (end > start) {
+                values.push_back(std::atof(text.substr(start, end - start).c_str()));
+            }
+            start = end + 1;
+        }
+        return values;
+    }
+
+    // ------------------------------------------------------------------
+    // Policies
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Intrusive doubly-linked lists over dense key ids
+     *
+     * Every id is on at most one of the lists; front() is the oldest entry.
+     */
+    class IdLists {
+    public:
+        IdLists(size_t universe, size_t lists)
+            : prev_(universe, kNil), next_(universe, kNil), owner_(universe, kNoList), lists_(lists) {}
+
+        uint8_t owner(uint32_t id) const { return owner_[id]; }
+        size_t size(uint8_t list) const { return lists_[list].size; }
+        uint32_t front(uint8_t list) const { return lists_[list].head; }
+
+        void push_back(uint8_t list, uint32_t id) {
+            auto& l = lists_[list];
+            prev_[id] = l.tail;
+            next_[id] = kNil;
+            if (l.tail != kNil) {
+                next_[l.tail] = id;
+            } else {
+                l.head = id;
+            }
+            l.tail = id;
+            ++l.size;
+            owner_[id] = list;
+        }
+
+        void remove(uint32_t id) {
+            auto& l = lists_[owner_[id]];
+            if (prev_[id] != kNil) {
+                next_[prev_[id]] = next_[id];
+            } else {
+                l.head = next_[id];
+            }
+            if (next_[id] != kNil) {
+                prev_[next_[id]] = prev_[id];
+            } else {
+                l.tail = prev_[id];
+            }
+            --l.size;
+            owner_[id] = kNoList;
+        }
+
+        void move_to_back(uint32_t id) {
+            const uint8_t list = owner_[id];
+            remove(id);
+            push_back(list, id);
+        }
+
+    private:
+        struct List {
+            uint32_t head = kNil;
+            uint32_t tail = kNil;
+            size_t size = 0;
+        };
+
+        std::vector<uint32_t> prev_;
+        std::vector<uint32_t> next_;
+        std::vector<uint8_t> owner_;
+        std::vector<List> lists_;
+    };
+
+    class Policy {
+    public:
+        virtual ~Policy() = default;
+
+        /**
+         * @brief Access a key, admitting it on a miss
+         * @return true on a hit
+         */
+        virtual bool access(uint32_t id) = 0;
+    };
+
+    /**
+     * @brief Least recently used
+     */
+    class LruPolicy : public Policy {
+    public:
+        LruPolicy(size_t capacity, size_t universe) : capacity_(capacity), lists_(universe, 1) {}
+
+        bool access(uint32_t id) override {
+            if (lists_.owner(id) != kNoList) {
+                lists_.move_to_back(id);
+                return true;
+            }
+            if (lists_.size(0) >= capacity_) {
+                lists_.remove(lists_.front(0));
+            }
+            lists_.push_back(0, id);
+            return false;
+        }
+
+    private:
+        size_t capacity_;
+        IdLists lists_;
+    };
+
+    /**
+     * @brief CLOCK (second chance): one reference bit per slot, a sweeping hand
+     */
+    class ClockPolicy : public Policy {
+    public:
+        ClockPolicy(size_t capacity, size_t universe)
+            : slots_(capacity, kNil), referenced_(capacity, 0), slot_of_(universe, kNil) {}
+
+        bool access(uint32_t id) override {
+            if (slot_of_[id] != kNil) {
+                referenced_[slot_of_[id]] = 1;
+                return true;
+            }
+            if (used_ < slots_.size()) {
+                place(used_++, id);
+                return false;
+            }
+            while (referenced_[hand_]) {
+                referenced_[hand_] = 0;
+                hand_ = (hand_ + 1) % slots_.size();
+            }
+            slot_of_[slots_[hand_]] = kNil;
+            place(hand_, id);
+            hand_ = (hand_ + 1) % slots_.size();
+            return false;
+        }
+
+    private:
+        void place(size_t slot, uint32_t id) {
+            slots_[slot] = id;
+            referenced_[slot] = 0;
+            slot_of_[id] = static_cast<uint32_t>(slot);
+        }
+
+        std::vector<uint32_t> slots_;
+        std::vector<uint8_t> referenced_;
+        std::vector<uint32_t> slot_of_;
+        size_t used_ = 0;
+        size_t hand_ = 0;
+    };
+
+    /**
+     * @brief Count-Min sketch of 4-bit counters, halved every sample_size increments
+     */
+    class FrequencySketch {
+    public:
+        explicit FrequencySketch(size_t capacity) : sample_size_(10 * std::max<size_t>(capacity, 16)) {
+            size_t width = 16;
+            while (width < capacity) {
+                width <<= 1;
+            }
+            mask_ = width - 1;
+            counters_.assign(kDepth * width, 0);
+        }
+
+        void increment(uint32_t id) {
+            for (size_t row = 0; row < kDepth; ++row) {
+                auto& counter = counters_[index(row, id)];
+                if (counter < 15) {
+                    ++counter;
+                }
+            }
+            if (++additions_ >= sample_size_) {
+                for (auto& counter : counters_) {
+                    counter >>= 1;
+                }
+                additions_ /= 2;
+            }
+        }
+
+        uint8_t estimate(uint32_t id) const {
+            uint8_t frequency = 15;
+            for (size_t row = 0; row < kDepth; ++row) {
+                frequency = std::min(frequency, counters_[index(row, id)]);
+            }
+            return frequency;
+        }
+
+    private:
+        static constexpr size_t kDepth = 4;
+
+        size_t index(size_t row, uint32_t id) const {
+            // splitmix64 finalizer, seeded per row
+            uint64_t x = id + 0x9E3779B97F4A7C15ull * (row + 1);
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            x ^= x >> 31;
+            return row * (mask_ + 1) + (x & mask_);
+        }
+
+        std::vector<uint8_t> counters_;
+        size_t mask_ = 0;
+        size_t sample_size_;
+        size_t additions_ = 0;
+    };
+
+    /**
+     * @brief W-TinyLFU: 1% LRU window, 99% segmented LRU admitted by frequency
+     *
+     * A key evicted from the window replaces the main cache's victim only
+     * if the sketch has seen it more often (Caffeine's design, without the
+     * doorkeeper and adaptive window).
+     */
+    class WTinyLfuPolicy : public Policy {
+    public:
+        WTinyLfuPolicy(size_t capacity, size_t universe)
+            : window_capacity_(std::max<size_t>(1, capacity / 100)),
+              main_capacity_(capacity - window_capacity_),
+              protected_capacity_(main_capacity_ * 8 / 10),
+              lists_(universe, 3),
+              sketch_(capacity) {}
+
+        bool access(uint32_t id) override {
+            sketch_.increment(id);
+            switch (lists_.owner(id)) {
+                case kWindow:
+                case kProtected:
+                    lists_.move_to_back(id);
+                    return true;
+                case kProbation:
+                    lists_.remove(id);
+                    lists_.push_back(kProtected, id);
+                    if (lists_.size(kProtected) > protected_capacity_) {
+                        uint32_t demoted = lists_.front(kProtected);
+                        lists_.remove(demoted);
+                        lists_.push_back(kProbation, demoted);
+                    }
+                    return true;
+                default:
+                    break;
+            }
+
+            lists_.push_back(kWindow, id);
+            if (lists_.size(kWindow) <= window_capacity_) {
+                return false;
+            }
+            uint32_t candidate = lists_.front(kWindow);
+            lists_.remove(candidate);
+            if (lists_.size(kProbation) + lists_.size(kProtected) < main_capacity_) {
+                lists_.push_back(kProbation, candidate);
+                return false;
+            }
+            uint32_t victim = lists_.size(kProbation) > 0 ? lists_.front(kProbation) : lists_.front(kProtected);
+            if (sketch_.estimate(candidate) > sketch_.estimate(victim)) {
+                lists_.remove(victim);
+                lists_.push_back(kProbation, candidate);
+            }
+            return false;
+        }
+
+    private:
+        static constexpr uint8_t kWindow = 0;
+        static constexpr uint8_t kProbation = 1;
+        static constexpr uint8_t kProtected = 2;
+
+        size_t window_capacity_;
+        size_t main_capacity_;
+        size_t protected_capacity_;
+        IdLists lists_;
+        FrequencySketch sketch_;
+    };
+
+    /**
+     * @brief S3-FIFO: small FIFO (10%), main FIFO with reinsertion, ghost FIFO of keys
+     *
+     * New keys enter the small queue; a key re-accessed there moves to the
+     * main queue when it reaches the head, otherwise it is evicted and
+     * remembered in the ghost queue, from which a miss goes straight to main.
+     */
+    class S3FifoPolicy : public Policy {
+    public:
+        S3FifoPolicy(size_t capacity, size_t universe)
+            : capacity_(capacity),
+              small_capacity_(std::max<size_t>(1, capacity / 10)),
+              ghost_capacity_(capacity - small_capacity_),
+              lists_(universe, 2),
+              frequency_(universe, 0),
+              ghost_stamp_(universe, 0) {}
+
+        bool access(uint32_t id) override {
+            if (lists_.owner(id) != kNoList) {
+                frequency_[id] = static_cast<uint8_t>(std::min(frequency_[id] + 1, 3));
+                return true;
+            }
+            while (lists_.size(kSmall) + lists_.size(kMain) >= capacity_) {
+                evict();
+            }
+            frequency_[id] = 0;
+            if (in_ghost(id)) {
+                ghost_stamp_[id] = 0;
+                lists_.push_back(kMain, id);
+            } else {
+                lists_.push_back(kSmall, id);
+            }
+            return false;
+        }
+
+    private:
+        static constexpr uint8_t kSmall = 0;
+        static constexpr uint8_t kMain = 1;
+
+        bool in_ghost(uint32_t id) const {
+            // Stamps older than the last ghost_capacity_ insertions have aged out of the FIFO
+            return ghost_stamp_[id] != 0 && ghost_insertions_ - ghost_stamp_[id] < ghost_capacity_;
+        }
+
+        void evict() {
+            if (lists_.size(kSmall) >= small_capacity_ || lists_.size(kMain) == 0) {
+                while (lists_.size(kSmall) > 0) {
+                    uint32_t id = lists_.front(kSmall);
+                    lists_.remove(id);
+                    if (frequency_[id] > 0) {
+                        frequency_[id] = 0;
+                        lists_.push_back(kMain, id);
+                    } else {
+                        ghost_stamp_[id] = ++ghost_insertions_;
+                        return;
+                    }
+                }
+            }
+            while (lists_.size(kMain) > 0) {
+                uint32_t id = lists_.front(kMain);
+                lists_.remove(id);
+                if (frequency_[id] > 0) {
+                    --frequency_[id];
+                    lists_.push_back(kMain, id);
+                } else {
+                    return;
+                }
+            }
+        }
+
+        size_t capacity_;
+        size_t small_capacity_;
+        size_t ghost_capacity_;
+        IdLists lists_;
+        std::vector<uint8_t> frequency_;
+        std::vector<uint64_t> ghost_stamp_;
+        uint64_t ghost_insertions_ = 0;
+    };
+
+    /**
+     * @brief A policy the simulator can run, with its estimated bookkeeping per entry
+     *
+     * Overheads assume a production implementation with a node-based hash
+     * index (~32 B per entry) plus the policy's own links and counters.
+     */
+    struct PolicySpec {
+        const char* name;
+        size_t overhead_bytes;
+        std::unique_ptr<Policy> (*create)(size_t capacity, size_t universe);
+    };
+
+    const std::array<PolicySpec, 4> kPolicies = {{
+        {"lru", 32 + 16,
+         [](size_t capacity, size_t universe) -> std::unique_ptr<Policy> {
+             return std::make_unique<LruPolicy>(capacity, universe);
+         }},
+        {"clock", 32 + 8 + 1,
+         [](size_t capacity, size_t universe) -> std::unique_ptr<Policy> {
+             return std::make_unique<ClockPolicy>(capacity, universe);
+         }},
+        {"w-tinylfu", 32 + 16 + 1 + 2,  // Links, segment tag, 4 x 4-bit sketch counters
+         [](size_t capacity, size_t universe) -> std::unique_ptr<Policy> {
+             return std::make_unique<WTinyLfuPolicy>(capacity, universe);
+         }},
+        {"s3-fifo", 32 + 8 + 1 + 16,  // FIFO slot, frequency, ghost entry (hash + stamp)
+         [](size_t capacity, size_t universe) -> std::unique_ptr<Policy> {
+             return std::make_unique<S3FifoPolicy>(capacity, universe);
+         }},
+    }};
+
+    struct Options {
+        std::vector<const PolicySpec*> policies;
+        std::vector<double> sizes;
+        bool sizes_in_mb = false;
+        size_t value_bytes = 256;
+        std::string field = "key_hash";
+        size_t synthetic = 0;
+        TransactionGeneratorOptions generator;
+        bool csv = false;
+    };
+
+    struct Cell {
+        size_t capacity = 0;
+        double memory_mb = 0;
+        double hit_ratio = 0;
+    };
+
+    double entry_bytes(const Options& options, const Trace& trace, const PolicySpec& policy) {
+        return trace.average_key_bytes() + kStringOverhead + static_cast<double>(options.value_bytes) +
+               static_cast<double>(policy.overhead_bytes);
+    }
+
+    Cell simulate(const Options& options, const Trace& trace, const PolicySpec& spec, double size) {
+        const double per_entry = entry_bytes(options, trace, spec);
+        Cell cell;
+        cell.capacity = options.sizes_in_mb ? static_cast<size_t>(size * kBytesPerMb / per_entry)
+                                            : static_cast<size_t>(size);
+        cell.capacity = std::max(cell.capacity, kMinCapacity);
+        cell.memory_mb = static_cast<double>(cell.capacity) * per_entry / kBytesPerMb;
+
+        auto policy = spec.create(cell.capacity, trace.distinct());
+        size_t hits = 0;
+        for (uint32_t id : trace.accesses) {
+            hits += policy->access(id) ? 1 : 0;
+        }
+        cell.hit_ratio = trace.accesses.empty()
+            ? 0.0 : static_cast<double>(hits) / static_cast<double>(trace.accesses.size());
+        return cell;
+    }
+
+    bool parse_policies(const std::string& text, std::vector<const PolicySpec*>& out) {
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t end = text.find(',', start);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            const std::string name = text.substr(start, end - start);
+            auto it = std::find_if(kPolicies.begin(), kPolicies.end(),
+                                   [&name](const PolicySpec& spec) { return name == spec.name; });
+            if (it == kPolicies.end()) {
+                std::fprintf(stderr, "dmp_cachesim: unknown policy: %s\n", name.c_str());
+                return false;
+            }
+            out.push_back(&*it);
+            start = end + 1;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.generator.repeat_customer_ratio = 0.3;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--policies" && i + 1 < argc) {
+            if (!parse_policies(argv[++i], options.policies)) return 2;
+        } else if (arg == "--sizes" && i + 1 < argc) {
+            options.sizes = parse_list(argv[++i]);
+            options.sizes_in_mb = false;
+        } else if (arg == "--sizes-mb" && i + 1 < argc) {
+            options.sizes = parse_list(argv[++i]);
+            options.sizes_in_mb = true;
+        } else if (arg == "--value-bytes" && i + 1 < argc) {
+            options.value_bytes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--field" && i + 1 < argc) {
+            options.field = argv[++i];
+        } else if (arg == "--synthetic" && i + 1 < argc) {
+            options.synthetic = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat-ratio" && i + 1 < argc) {
+            options.generator.repeat_customer_ratio = std::atof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.generator.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--csv") {
+            options.csv = true;
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        } else if (arg != "-" && !arg.empty() && arg[0] == '-') {
+            usage();
+            return 2;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty() == (options.synthetic == 0)) {
+        usage();
+        return 2;
+    }
+    if (options.policies.empty()) {
+        for (const auto& spec : kPolicies) {
+            options.policies.push_back(&spec);
+        }
+    }
+
+    Trace trace;
+    if (options.synthetic > 0) {
+        TransactionGenerator generator(options.generator);
+        trace.accesses.reserve(options.synthetic);
+        for (size_t i = 0; i < options.synthetic; ++i) {
+            trace.add(generator.next().get_cache_key());
+        }
+    }
+    for (const auto& input : inputs) {
+        if (input == "-") {
+            read_trace(std::cin, options.field, trace);
+            continue;
+        }
+        std::ifstream file(input);
+        if (!file) {
+            std::fprintf(stderr, "dmp_cachesim: cannot open %s\n", input.c_str());
+            return 2;
+        }
+        read_trace(file, options.field, trace);
+    }
+    if (trace.accesses.empty()) {
+        std::fprintf(stderr, "dmp_cachesim: no keys found (%zu lines skipped); check --field\n",
+                     trace.skipped_lines);
+        return 2;
+    }
+
+    if (options.sizes.empty()) {
+        for (double fraction : kDefaultSizeFractions) {
+            double size = std::max<double>(kMinCapacity, static_cast<double>(trace.distinct()) * fraction);
+            if (options.sizes.empty() || size > options.sizes.back()) {
+                options.sizes.push_back(size);
+            }
+        }
+    }
+
+    // Every distinct key misses once however large the cache is
+    const double max_hit_ratio = 1.0 - static_cast<double>(trace.distinct()) /
+                                       static_cast<double>(trace.accesses.size());
+
+    std::vector<std::vector<Cell>> cells(options.sizes.size());
+    for (size_t row = 0; row < options.sizes.size(); ++row) {
+        for (const auto* spec : options.policies) {
+            cells[row].push_back(simulate(options, trace, *spec, options.sizes[row]));
+        }
+    }
+
+    if (options.csv) {
+        std::printf("policy,size,capacity_entries,memory_mb,requests,hit_ratio\n");
+        for (size_t row = 0; row < options.sizes.size(); ++row) {
+            for (size_t column = 0; column < options.policies.size(); ++column) {
+                const auto& cell = cells[row][column];
+                std::printf("%s,%g%s,%zu,%.3f,%zu,%.6f\n", options.policies[column]->name, options.sizes[row],
+                            options.sizes_in_mb ? "MB" : "", cell.capacity, cell.memory_mb,
+                            trace.accesses.size(), cell.hit_ratio);
+            }
+        }
+        return 0;
+    }
+
+    std::printf("trace: %zu requests, %zu distinct keys (avg %.0f B), %zu lines skipped\n",
+                trace.accesses.size(), trace.distinct(), trace.average_key_bytes(), trace.skipped_lines);
+    std::printf("infinite cache hit ratio: %.2f%%\n", max_hit_ratio * 100.0);
+    std::printf("bytes/entry (key + %zu B value + bookkeeping):", options.value_bytes);
+    for (const auto* spec : options.policies) {
+        std::printf(" %s %.0f", spec->name, entry_bytes(options, trace, *spec));
+    }
+    std::printf("\n\n%-14s", options.sizes_in_mb ? "size (MB)" : "size (entries)");
+    for (const auto* spec : options.policies) {
+        std::printf(" %11s", spec->name);
+    }
+    std::printf("\n");
+    for (size_t row = 0; row < options.sizes.size(); ++row) {
+        std::printf("%-14.*f", options.sizes_in_mb ? 1 : 0, options.sizes[row]);
+        for (const auto& cell : cells[row]) {
+            std::printf(" %10.2f%%", cell.hit_ratio * 100.0);
+        }
+        if (!options.sizes_in_mb) {
+            std::printf("   (%.1f-%.1f MB)",
+                        std::min_element(cells[row].begin(), cells[row].end(),
+                                         [](const Cell& a, const Cell& b) { return a.memory_mb < b.memory_mb; })->memory_mb,
+                        std::max_element(cells[row].begin(), cells[row].end(),
+                                         [](const Cell& a, const Cell& b) { return a.memory_mb < b.memory_mb; })->memory_mb);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
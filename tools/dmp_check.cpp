@@ -0,0 +1,115 @@
+/**
+ * @file dmp_check.cpp
+ * @brief Pre-flight validation and cost estimate of a configuration push
+ * @author Stan Jiang
+ * @date 2025-09-11
+ *
+ * Usage:
+ *   dmp_check [--config PATH] [--rules PATH] [--blacklist PATH]
+ *             [--whitelist PATH] [--models PATH] [--corpus N]
+ *             [--rules-budget-ms MS] [--patterns-budget-ms MS] [--top N]
+ *
+ * Artifact paths, budgets and the corpus size default to the [reload]
+ * section of --config (config/server.toml). Every rule and pattern is
+ * compiled, a synthetic corpus is evaluated, and compile time, memory
+ * growth and per-rule and per-pattern cost are printed. Exit status is 0 when the push fits the
+ * budgets, 1 when P99 cost exceeds them and 2 when anything fails to load
+ * or compile.
+ */
+#include "core/preflight.hpp"
+#include "core/reload_coordinator.hpp"
+#include "utils/logger.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace dmp;
+
+namespace {
+    void usage() {
+        std::fprintf(stderr,
+                     "usage: dmp_check [options]\n"
+                     "  --config PATH             server TOML providing [reload] defaults\n"
+                     "                            (default config/server.toml)\n"
+                     "  --rules PATH              rules JSON to check\n"
+                     "  --blacklist PATH          blocklist patterns to check\n"
+                     "  --whitelist PATH          whitelist patterns to check\n"
+                     "  --models PATH             models TOML to check\n"
+                     "  --corpus N                synthetic transactions (default: preflight_corpus_size)\n"
+                     "  --rules-budget-ms MS      P99 rule budget per transaction\n"
+                     "  --patterns-budget-ms MS   P99 pattern budget per transaction\n"
+                     "  --top N                   rules and patterns listed by cost (default 10)\n"
+                     "  --verbose                 keep engine logging\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string config_path = "config/server.toml";
+    std::string rules_path, blacklist_path, whitelist_path, models_path;
+    double rules_budget_ms = 0.0;
+    double patterns_budget_ms = 0.0;
+    size_t corpus_size = 0;
+    size_t top_n = 10;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (arg == "--rules" && i + 1 < argc) {
+            rules_path = argv[++i];
+        } else if (arg == "--blacklist" && i + 1 < argc) {
+            blacklist_path = argv[++i];
+        } else if (arg == "--whitelist" && i + 1 < argc) {
+            whitelist_path = argv[++i];
+        } else if (arg == "--models" && i + 1 < argc) {
+            models_path = argv[++i];
+        } else if (arg == "--corpus" && i + 1 < argc) {
+            corpus_size = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rules-budget-ms" && i + 1 < argc) {
+            rules_budget_ms = std::atof(argv[++i]);
+        } else if (arg == "--patterns-budget-ms" && i + 1 < argc) {
+            patterns_budget_ms = std::atof(argv[++i]);
+        } else if (arg == "--top" && i + 1 < argc) {
+            top_n = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!verbose) {
+        Logger::set_level(spdlog::level::warn);
+    }
+
+    auto config_result = SystemConfig::load_from_file(config_path);
+    if (config_result.is_error()) {
+        std::fprintf(stderr, "dmp_check: %s\n", config_result.error_message.c_str());
+        return 2;
+    }
+    const ReloadConfig reload_config = config_result.value->get_reload_config();
+
+    ReloadSources sources = ReloadSources::from_config(config_path, reload_config);
+    if (!rules_path.empty()) sources.rules_path = rules_path;
+    if (!blacklist_path.empty()) sources.blacklist_path = blacklist_path;
+    if (!whitelist_path.empty()) sources.whitelist_path = whitelist_path;
+    if (!models_path.empty()) sources.models_path = models_path;
+
+    PreflightOptions options = PreflightOptions::from_config(reload_config);
+    options.max_pattern_profiles = PreflightOptions{}.max_pattern_profiles;
+    if (rules_budget_ms > 0.0) options.rules_budget_ms = rules_budget_ms;
+    if (patterns_budget_ms > 0.0) options.patterns_budget_ms = patterns_budget_ms;
+    if (corpus_size > 0) options.corpus_size = corpus_size;
+
+    auto report = PreflightChecker(options).check_files(sources);
+    if (report.is_error()) {
+        std::fprintf(stderr, "dmp_check: %s\n", report.error_message.c_str());
+        return 2;
+    }
+    std::fputs(report.value.to_text(top_n).c_str(), stdout);
+    return report.value.passed() ? 0 : 1;
+}
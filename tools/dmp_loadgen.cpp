@@ -0,0 +1,474 @@
+/**
+ * @file dmp_loadgen.cpp
+ * @brief Open-loop load generator with coordinated-omission corrected latency
+ * @author Stan Jiang
+ * @date 2025-09-13
+ *
+ * Usage:
+ *   dmp_loadgen [--rate TPS] [--duration S] [--warmup S] [--threads N]
+ *               [--target inproc|HOST:PORT] [--config PATH] [--pool N]
+ *               [--repeat-ratio R] [--burst-ratio R] [--burst-length N]
+ *               [--seed N] [--p99-target-ms MS]
+ *
+ * Requests are issued on a fixed schedule (--rate spread evenly over
+ * --threads) whether or not earlier requests have completed. Latency is
+ * measured from each request's scheduled send time, so time spent queued
+ * behind a slow request is counted instead of silently dropped; the
+ * uncorrected service time is reported next to it for comparison.
+ *
+ * --target inproc (default) runs the decision path in this process on the
+ * rules and patterns of the [reload] section of --config; HOST:PORT posts
+ * to /api/v1/decision over one keep-alive connection per thread. Exit
+ * status is 0 when corrected P99 is within --p99-target-ms and at least
+ * 99% of the requested rate was sustained, 1 when not, and 2 on setup
+ * errors.
+ */
+#include "core/decision.hpp"
+#include "core/reload_coordinator.hpp"
+#include "core/transaction_generator.hpp"
+#include "utils/histogram.hpp"
+#include "utils/logger.hpp"
+#include <simdjson.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace dmp;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto kSpinThreshold = std::chrono::microseconds(200);  // Sleep until this close, then spin
+    constexpr double kNsPerMs = 1e6;
+
+    void usage() {
+        std::fprintf(stderr,
+                     "usage: dmp_loadgen [options]\n"
+                     "  --rate TPS               target arrival rate (default 10000)\n"
+                     "  --duration S             measured seconds (default 30)\n"
+                     "  --warmup S               unmeasured seconds before that (default 5)\n"
+                     "  --threads N              sender threads (default 8)\n"
+                     "  --target T               inproc or HOST:PORT (default inproc)\n"
+                     "  --config PATH            server TOML for inproc artifacts\n"
+                     "                           (default config/server.toml)\n"
+                     "  --pool N                 pre-generated requests per thread (default 20000)\n"
+                     "  --repeat-ratio R         share of returning customers (default 0.3)\n"
+                     "  --burst-ratio R          card-testing burst start chance (default 0.0005)\n"
+                     "  --burst-length N         transactions per burst (default 25)\n"
+                     "  --seed N                 generator seed (default 42)\n"
+                     "  --p99-target-ms MS       corrected P99 objective (default 50)\n"
+                     "  --verbose                keep engine logging\n");
+    }
+
+    struct Options {
+        double rate = 10000.0;
+        double duration_s = 30.0;
+        double warmup_s = 5.0;
+        size_t threads = 8;
+        std::string target = "inproc";
+        std::string config_path = "config/server.toml";
+        size_t pool = 20000;
+        TransactionGeneratorOptions generator;
+        double p99_target_ms = 50.0;
+    };
+
+    struct ThreadResult {
+        HistogramSnapshot corrected;  // Completion minus scheduled send time
+        HistogramSnapshot service;    // Completion minus actual send time
+        uint64_t sent = 0;
+        uint64_t errors = 0;
+        uint64_t decisions[3] = {0, 0, 0};  // Indexed by Decision
+        uint64_t max_lag_ns = 0;      // Worst delay between schedule and actual send
+        std::string first_error;
+    };
+
+    /**
+     * @brief Runs one request against the in-process decision path
+     */
+    class InprocTarget {
+    public:
+        explicit InprocTarget(std::shared_ptr<const ReloadGeneration> generation)
+            : generation_(std::move(generation)) {}
+
+        bool send(const std::string& body, Decision& decision, std::string& error) {
+            auto response = decide(*generation_, parser_, body);
+            if (response.is_error()) {
+                error = response.error_message;
+                return false;
+            }
+            decision = response.value.decision;
+            return !response.value.to_json().empty();
+        }
+
+    private:
+        std::shared_ptr<const ReloadGeneration> generation_;
+        simdjson::dom::parser parser_;
+    };
+
+    /**
+     * @brief Minimal HTTP/1.1 keep-alive client for POST /api/v1/decision
+     */
+    class HttpTarget {
+    public:
+        HttpTarget(std::string host, std::string port) : host_(std::move(host)), port_(std::move(port)) {}
+        ~HttpTarget() { disconnect(); }
+
+        HttpTarget(const HttpTarget&) = delete;
+        HttpTarget& operator=(const HttpTarget&) = delete;
+
+        bool send(const std::string& body, Decision& decision, std::string& error) {
+            if (fd_ < 0 && !connect_to_server(error)) {
+                return false;
+            }
+            request_.clear();
+            request_ += "POST /api/v1/decision HTTP/1.1\r\nHost: ";
+            request_ += host_;
+            request_ += "\r\nContent-Type: application/json\r\nContent-Length: ";
+            request_ += std::to_string(body.size());
+            request_ += "\r\n\r\n";
+            request_ += body;
+            if (!write_all(request_) || !read_response(error)) {
+                if (error.empty()) {
+                    error = std::string("connection: ") + std::strerror(errno);
+                }
+                disconnect();
+                return false;
+            }
+            if (status_ != 200) {
+                error = "HTTP " + std::to_string(status_);
+                return false;
+            }
+            decision = response_body_.find("DECLINE") != std::string::npos ? Decision::DECLINE
+                     : response_body_.find("REVIEW") != std::string::npos ? Decision::REVIEW
+                     : Decision::APPROVE;
+            return true;
+        }
+
+    private:
+        bool connect_to_server(std::string& error) {
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* addresses = nullptr;
+            if (int rc = getaddrinfo(host_.c_str(), port_.c_str(), &hints, &addresses); rc != 0) {
+                error = std::string("resolve: ") + gai_strerror(rc);
+                return false;
+            }
+            for (addrinfo* address = addresses; address; address = address->ai_next) {
+                fd_ = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+                if (fd_ < 0) {
+                    continue;
+                }
+                if (::connect(fd_, address->ai_addr, address->ai_addrlen) == 0) {
+                    int one = 1;
+                    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    break;
+                }
+                ::close(fd_);
+                fd_ = -1;
+            }
+            freeaddrinfo(addresses);
+            if (fd_ < 0) {
+                error = "connect " + host_ + ":" + port_ + ": " + std::strerror(errno);
+                return false;
+            }
+            buffer_.clear();
+            return true;
+        }
+
+        void disconnect() {
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        bool write_all(const std::string& data) {
+            size_t sent = 0;
+            while (sent < data.size()) {
+                ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) {
+                    return false;
+                }
+                sent += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        bool fill() {
+            char chunk[16384];
+            ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            buffer_.append(chunk, static_cast<size_t>(n));
+            return true;
+        }
+
+        bool read_response(std::string& error) {
+            size_t header_end;
+            while ((header_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+                if (!fill()) {
+                    return false;
+                }
+            }
+            status_ = buffer_.size() > 12 ? std::atoi(buffer_.c_str() + 9) : 0;
+            size_t content_length = 0;
+            for (const char* name : {"Content-Length:", "content-length:"}) {
+                size_t at = buffer_.find(name);
+                if (at != std::string::npos && at < header_end) {
+                    content_length = std::strtoull(buffer_.c_str() + at + std::strlen(name), nullptr, 10);
+                    break;
+                }
+            }
+            const size_t total = header_end + 4 + content_length;
+            while (buffer_.size() < total) {
+                if (!fill()) {
+                    error = "connection closed mid-response";
+                    return false;
+                }
+            }
+            response_body_.assign(buffer_, header_end + 4, content_length);
+            buffer_.erase(0, total);
+            return true;
+        }
+
+        std::string host_;
+        std::string port_;
+        int fd_ = -1;
+        int status_ = 0;
+        std::string request_;
+        std::string buffer_;
+        std::string response_body_;
+    };
+
+    template<typename Target>
+    void run_sender(Target& target, const std::vector<std::string>& bodies, Clock::time_point first_send,
+                    Clock::duration interval, Clock::time_point measure_from, Clock::time_point end,
+                    ThreadResult& result) {
+        for (uint64_t i = 0; ; ++i) {
+            const auto scheduled = first_send + interval * static_cast<int64_t>(i);
+            if (scheduled >= end) {
+                break;
+            }
+            auto now = Clock::now();
+            while (now < scheduled) {
+                if (scheduled - now > kSpinThreshold) {
+                    std::this_thread::sleep_for(scheduled - now - kSpinThreshold);
+                }
+                now = Clock::now();
+            }
+
+            Decision decision = Decision::APPROVE;
+            std::string error;
+            const bool ok = target.send(bodies[i % bodies.size()], decision, error);
+            const auto done = Clock::now();
+
+            if (scheduled < measure_from) {
+                continue;
+            }
+            const auto lag_ns = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - scheduled).count());
+            result.max_lag_ns = std::max(result.max_lag_ns, lag_ns);
+            ++result.sent;
+            if (!ok) {
+                ++result.errors;
+                if (result.first_error.empty()) {
+                    result.first_error = error;
+                }
+                continue;
+            }
+            ++result.decisions[static_cast<size_t>(decision)];
+            result.corrected.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(done - scheduled).count()));
+            result.service.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(done - now).count()));
+        }
+    }
+
+    void print_latency_row(const char* name, const HistogramSnapshot& histogram) {
+        std::printf("  %-10s %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", name,
+                    histogram.value_at_quantile(0.50) / kNsPerMs,
+                    histogram.value_at_quantile(0.90) / kNsPerMs,
+                    histogram.value_at_quantile(0.99) / kNsPerMs,
+                    histogram.value_at_quantile(0.999) / kNsPerMs,
+                    histogram.value_at_quantile(0.9999) / kNsPerMs,
+                    histogram.max() / kNsPerMs);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.generator.repeat_customer_ratio = 0.3;
+    options.generator.attack_burst_ratio = 0.0005;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rate" && i + 1 < argc) {
+            options.rate = std::atof(argv[++i]);
+        } else if (arg == "--duration" && i + 1 < argc) {
+            options.duration_s = std::atof(argv[++i]);
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            options.warmup_s = std::atof(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--target" && i + 1 < argc) {
+            options.target = argv[++i];
+        } else if (arg == "--config" && i + 1 < argc) {
+            options.config_path = argv[++i];
+        } else if (arg == "--pool" && i + 1 < argc) {
+            options.pool = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat-ratio" && i + 1 < argc) {
+            options.generator.repeat_customer_ratio = std::atof(argv[++i]);
+        } else if (arg == "--burst-ratio" && i + 1 < argc) {
+            options.generator.attack_burst_ratio = std::atof(argv[++i]);
+        } else if (arg == "--burst-length" && i + 1 < argc) {
+            options.generator.attack_burst_length = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.generator.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--p99-target-ms" && i + 1 < argc) {
+            options.p99_target_ms = std::atof(argv[++i]);
+        } else if (arg == "--verbose" || arg == "-v") {
+            verbose = true;
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (options.rate <= 0.0 || options.duration_s <= 0.0 || options.warmup_s < 0.0 ||
+        options.threads == 0 || options.pool == 0) {
+        usage();
+        return 2;
+    }
+    if (!verbose) {
+        Logger::set_level(spdlog::level::warn);
+    }
+
+    std::shared_ptr<const ReloadGeneration> generation;
+    std::string host, port;
+    if (options.target == "inproc") {
+        auto config_result = SystemConfig::load_from_file(options.config_path);
+        if (config_result.is_error()) {
+            std::fprintf(stderr, "dmp_loadgen: %s\n", config_result.error_message.c_str());
+            return 2;
+        }
+        ReloadCoordinator coordinator(
+            ReloadSources::from_config(options.config_path, config_result.value->get_reload_config()), 0);
+        auto load_result = coordinator.load_initial();
+        if (load_result.is_error()) {
+            std::fprintf(stderr, "dmp_loadgen: %s\n", load_result.error_message.c_str());
+            return 2;
+        }
+        generation = coordinator.current();
+    } else {
+        const size_t colon = options.target.rfind(':');
+        if (colon == std::string::npos || colon == 0 || colon + 1 == options.target.size()) {
+            std::fprintf(stderr, "dmp_loadgen: --target must be inproc or HOST:PORT\n");
+            return 2;
+        }
+        host = options.target.substr(0, colon);
+        port = options.target.substr(colon + 1);
+    }
+
+    // Serialization happens up front so the client's own cost stays off the schedule
+    std::vector<std::vector<std::string>> bodies(options.threads);
+    for (size_t t = 0; t < options.threads; ++t) {
+        TransactionGeneratorOptions generator_options = options.generator;
+        generator_options.seed += t;
+        TransactionGenerator generator(generator_options);
+        bodies[t].reserve(options.pool);
+        for (size_t i = 0; i < options.pool; ++i) {
+            bodies[t].push_back(generator.next().to_json());
+        }
+    }
+
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(options.threads) / options.rate));
+    const auto stagger = interval / static_cast<int64_t>(options.threads);
+    const auto start = Clock::now() + std::chrono::milliseconds(100);
+    const auto measure_from = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(options.warmup_s));
+    const auto end = measure_from + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(options.duration_s));
+
+    std::printf("dmp_loadgen: %.0f TPS open loop on %zu threads against %s, %.0fs warm-up + %.0fs measured\n",
+                options.rate, options.threads, options.target.c_str(), options.warmup_s, options.duration_s);
+    std::fflush(stdout);
+
+    std::vector<ThreadResult> results(options.threads);
+    std::vector<std::thread> senders;
+    senders.reserve(options.threads);
+    for (size_t t = 0; t < options.threads; ++t) {
+        senders.emplace_back([&, t] {
+            const auto first_send = start + stagger * static_cast<int64_t>(t);
+            if (generation) {
+                InprocTarget target(generation);
+                run_sender(target, bodies[t], first_send, interval, measure_from, end, results[t]);
+            } else {
+                HttpTarget target(host, port);
+                run_sender(target, bodies[t], first_send, interval, measure_from, end, results[t]);
+            }
+        });
+    }
+    for (auto& sender : senders) {
+        sender.join();
+    }
+    const double elapsed_s = std::chrono::duration<double>(Clock::now() - measure_from).count();
+
+    ThreadResult total;
+    for (const auto& result : results) {
+        total.corrected.merge(result.corrected);
+        total.service.merge(result.service);
+        total.sent += result.sent;
+        total.errors += result.errors;
+        for (size_t d = 0; d < 3; ++d) {
+            total.decisions[d] += result.decisions[d];
+        }
+        total.max_lag_ns = std::max(total.max_lag_ns, result.max_lag_ns);
+        if (total.first_error.empty()) {
+            total.first_error = result.first_error;
+        }
+    }
+
+    // Completions per second over the measured window, including any drain past its end
+    const double achieved = static_cast<double>(total.sent - total.errors) / elapsed_s;
+    const double p99_ms = total.corrected.value_at_quantile(0.99) / kNsPerMs;
+
+    std::printf("\nthroughput  %.0f TPS achieved of %.0f requested (%llu sent, %llu errors)\n",
+                achieved, options.rate, static_cast<unsigned long long>(total.sent),
+                static_cast<unsigned long long>(total.errors));
+    std::printf("decisions   approve %llu, review %llu, decline %llu\n",
+                static_cast<unsigned long long>(total.decisions[static_cast<size_t>(Decision::APPROVE)]),
+                static_cast<unsigned long long>(total.decisions[static_cast<size_t>(Decision::REVIEW)]),
+                static_cast<unsigned long long>(total.decisions[static_cast<size_t>(Decision::DECLINE)]));
+    std::printf("max lag     %.3f ms behind schedule\n", total.max_lag_ns / kNsPerMs);
+    if (!total.first_error.empty()) {
+        std::printf("first error %s\n", total.first_error.c_str());
+    }
+    std::printf("\nlatency ms       P50       P90       P99     P99.9    P99.99       max\n");
+    print_latency_row("corrected", total.corrected);
+    print_latency_row("service", total.service);
+
+    const bool rate_ok = achieved >= options.rate * 0.99;
+    const bool latency_ok = !total.corrected.empty() && p99_ms <= options.p99_target_ms;
+    std::printf("\n%s: corrected P99 %.3f ms %s %.1f ms, throughput %s\n",
+                rate_ok && latency_ok ? "PASS" : "FAIL", p99_ms, latency_ok ? "within" : "exceeds",
+                options.p99_target_ms, rate_ok ? "sustained" : "below target");
+    return rate_ok && latency_ok ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file dmp_perfstat.cpp
+ * @brief Offline percentile and regression report over binary performance logs
+ * @author Stan Jiang
+ * @date 2025-09-08
+ *
+ * Usage:
+ *   dmp_perfstat [--baseline PATH]... [--threshold PCT] PATH...
+ *
+ * PATH is a dmp_perf_*.bin file or a directory containing them. With
+ * --baseline, P50/P95/P99 of every stage are compared against the baseline
+ * files and the exit status is 1 if any grew by more than PCT percent
+ * (default 10).
+ *
+ * Records are streamed into one log-linear histogram per column, so memory
+ * stays constant however many files are read; percentiles carry the
+ * histogram's ~1.6% relative error. A stage has samples only where the
+ * server opens a span for it, and queue_wait only where a front end
+ * reports queueing (Tracer::record_queue_wait); columns without samples
+ * are listed rather than printed as zeros.
+ */
+#include "utils/histogram.hpp"
+#include "utils/perf_log.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace dmp;
+
+namespace {
+    constexpr size_t kQueueWaitColumn = PIPELINE_STAGE_COUNT;
+    constexpr size_t kColumnCount = PIPELINE_STAGE_COUNT + 1;
+    constexpr double kMinRegressionUs = 1.0;  // Ignore sub-microsecond noise
+
+    struct StageStats {
+        size_t count = 0;
+        double p50_us = 0, p95_us = 0, p99_us = 0, p999_us = 0, max_us = 0, mean_us = 0;
+    };
+
+    struct Report {
+        size_t records = 0;
+        size_t errors = 0;
+        uint64_t first_ns = 0;
+        uint64_t last_ns = 0;
+        std::array<StageStats, kColumnCount> stages;
+    };
+
+    const char* column_name(size_t column) {
+        return column == kQueueWaitColumn ? "queue_wait"
+                                          : pipeline_stage_name(static_cast<PipelineStage>(column));
+    }
+
+    uint32_t column_value(const PerfRecord& record, size_t column) {
+        return column == kQueueWaitColumn ? record.queue_wait_ns : record.stage_ns[column];
+    }
+
+    bool collect_files(const std::string& path, std::vector<std::string>& files) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(path, ec)) {
+            std::vector<std::string> found;
+            for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".bin") {
+                    found.push_back(entry.path().string());
+                }
+            }
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+            return true;
+        }
+        if (std::filesystem::is_regular_file(path, ec)) {
+            files.push_back(path);
+            return true;
+        }
+        std::fprintf(stderr, "dmp_perfstat: no such file or directory: %s\n", path.c_str());
+        return false;
+    }
+
+    /**
+     * @brief Stream every record of the files into a report
+     */
+    bool analyze(const std::vector<std::string>& files, Report& report) {
+        std::array<HistogramSnapshot, kColumnCount> columns;
+        report.first_ns = UINT64_MAX;
+
+        for (const auto& file : files) {
+            auto result = PerfLog::read_file(file, [&](const PerfRecord& record) {
+                ++report.records;
+                if (record.flags & PerfRecord::kError) ++report.errors;
+                report.first_ns = std::min(report.first_ns, record.timestamp_ns);
+                report.last_ns = std::max(report.last_ns, record.timestamp_ns);
+                for (size_t column = 0; column < kColumnCount; ++column) {
+                    // Zero means the stage did not run (or was not traced) for this request
+                    if (uint32_t value = column_value(record, column); value != 0) {
+                        columns[column].record(value);
+                    }
+                }
+            });
+            if (result.is_error()) {
+                std::fprintf(stderr, "dmp_perfstat: %s\n", result.error_message.c_str());
+                return false;
+            }
+        }
+        if (report.records == 0) {
+            report.first_ns = 0;
+        }
+
+        for (size_t column = 0; column < kColumnCount; ++column) {
+            const auto& histogram = columns[column];
+            if (histogram.empty()) continue;
+            auto& stats = report.stages[column];
+            stats.count = histogram.count();
+            stats.p50_us = histogram.value_at_quantile(0.50) / 1000.0;
+            stats.p95_us = histogram.value_at_quantile(0.95) / 1000.0;
+            stats.p99_us = histogram.value_at_quantile(0.99) / 1000.0;
+            stats.p999_us = histogram.value_at_quantile(0.999) / 1000.0;
+            stats.max_us = histogram.max() / 1000.0;
+            stats.mean_us = histogram.mean() / 1000.0;
+        }
+        return true;
+    }
+
+    void print_report(const char* title, const Report& report) {
+        double span_s = (report.last_ns - report.first_ns) / 1e9;
+        std::printf("%s: %zu requests (%zu errors) over %.1f s", title, report.records, report.errors, span_s);
+        if (span_s > 0) {
+            std::printf(", %.0f req/s", report.records / span_s);
+        }
+        std::printf("\n%-20s %10s %10s %10s %10s %10s %10s %10s\n",
+                    "stage (us)", "count", "mean", "p50", "p95", "p99", "p99.9", "max");
+        std::string unsampled;
+        for (size_t column = 0; column < kColumnCount; ++column) {
+            const auto& stats = report.stages[column];
+            if (stats.count == 0) {
+                unsampled += unsampled.empty() ? "" : ", ";
+                unsampled += column_name(column);
+                continue;
+            }
+            std::printf("%-20s %10zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                        column_name(column), stats.count, stats.mean_us, stats.p50_us,
+                        stats.p95_us, stats.p99_us, stats.p999_us, stats.max_us);
+        }
+        if (!unsampled.empty()) {
+            std::printf("no samples in these records: %s\n", unsampled.c_str());
+        }
+        std::printf("\n");
+    }
+
+    /**
+     * @brief Print per-stage percentile deltas
+     * @return Number of percentiles that regressed beyond the threshold
+     */
+    int compare(const Report& baseline, const Report& current, double threshold_pct) {
+        int regressions = 0;
+        std::printf("%-20s %-5s %12s %12s %9s\n", "stage", "pct", "baseline us", "current us", "change");
+        for (size_t column = 0; column < kColumnCount; ++column) {
+            const auto& base = baseline.stages[column];
+            const auto& cur = current.stages[column];
+            if (base.count == 0 || cur.count == 0) continue;
+
+            const std::array<std::pair<const char*, std::pair<double, double>>, 3> rows = {{
+                {"p50", {base.p50_us, cur.p50_us}},
+                {"p95", {base.p95_us, cur.p95_us}},
+                {"p99", {base.p99_us, cur.p99_us}},
+            }};
+            for (const auto& [label, values] : rows) {
+                auto [before, after] = values;
+                double change = before > 0 ? (after - before) / before * 100.0 : 0.0;
+                bool regressed = change > threshold_pct && after - before > kMinRegressionUs;
+                regressions += regressed ? 1 : 0;
+                std::printf("%-20s %-5s %12.1f %12.1f %+8.1f%%%s\n", column_name(column), label,
+                            before, after, change, regressed ? "  REGRESSION" : "");
+            }
+        }
+        return regressions;
+    }
+
+    void usage() {
+        std::fprintf(stderr,
+                     "usage: dmp_perfstat [--baseline PATH]... [--threshold PCT] PATH...\n"
+                     "  PATH            dmp_perf_*.bin file or directory of them\n"
+                     "  --baseline PATH compare against these files (repeatable)\n"
+                     "  --threshold PCT regression threshold in percent (default 10)\n"
+                     "Percentiles come from log-linear histograms (~1.6%% relative error).\n"
+                     "Only stages the server opens spans for have samples (parse, rule_evaluation\n"
+                     "and decision in the built-in handler); queue_wait is filled only by front\n"
+                     "ends that call Tracer::record_queue_wait(). Unsampled columns are listed,\n"
+                     "not reported as zero.\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> current_files;
+    std::vector<std::string> baseline_files;
+    double threshold_pct = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "--baseline" || arg == "-b") && i + 1 < argc) {
+            if (!collect_files(argv[++i], baseline_files)) return 2;
+        } else if ((arg == "--threshold" || arg == "-t") && i + 1 < argc) {
+            threshold_pct = std::atof(argv[++i]);
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            usage();
+            return 2;
+        } else if (!collect_files(arg, current_files)) {
+            return 2;
+        }
+    }
+    if (current_files.empty()) {
+        usage();
+        return 2;
+    }
+
+    Report current;
+    if (!analyze(current_files, current)) return 2;
+    print_report("current", current);
+
+    if (baseline_files.empty()) {
+        return 0;
+    }
+
+    Report baseline;
+    if (!analyze(baseline_files, baseline)) return 2;
+    print_report("baseline", baseline);
+
+    int regressions = compare(baseline, current, threshold_pct);
+    std::printf("\n%d regression(s) above %.1f%%\n", regressions, threshold_pct);
+    return regressions > 0 ? 1 : 0;
+}